@@ -1,26 +1,17 @@
 #include "Enemy.h"
-#include "2d/Sprite.h"
-#include "GaneScene.h"
-#include "KamataEngine.h"
 #include "Player.h"
-#include "base/TextureManager.h"
-#include "base/WinApp.h"
+#include "ScreenProjection.h"
 #include <algorithm>
 #include <cassert>
 #include <cmath>
-#include <cstdlib>
 
-Enemy::~Enemy() {
-	delete modelbullet_;
-	delete targetSprite_;
-	delete directionIndicatorSprite_;
-	delete assistLockSprite_;
-}
+Enemy::~Enemy() {}
 
-void Enemy::Initialize(KamataEngine::Model* model, const KamataEngine::Vector3& pos) {
-	assert(model);
-	model_ = model;
-	modelbullet_ = KamataEngine::Model::CreateFromOBJ("cube", true);
+void Enemy::Initialize(const KamataEngine::Vector3& pos, const RandomStream& random) {
+	random_ = random;
+	// 1 ステップに出す変更は死んだときの 2 つと弾 1 発まで
+	commands_.clear();
+	commands_.reserve(4);
 	worldtransfrom_.Initialize();
 	worldtransfrom_.translation_ = pos;
 
@@ -36,30 +27,8 @@ void Enemy::Initialize(KamataEngine::Model* model, const KamataEngine::Vector3&
 
 	hp_ = 5;
 
-	uint32_t indicatorHandle = TextureManager::Load("indicator.png");
-	directionIndicatorSprite_ = Sprite::Create(indicatorHandle, {0, 0});
-	if (directionIndicatorSprite_) {
-		directionIndicatorSprite_->SetSize({40.0f, 40.0f});
-		directionIndicatorSprite_->SetAnchorPoint({0.5f, 0.5f});
-	}
 	isOffScreen_ = false;
-
-	assistLockTextureHandle_ = TextureManager::Load("lockongreen.png");
-	assistLockSprite_ = Sprite::Create(assistLockTextureHandle_, {0, 0});
-	if (assistLockSprite_) {
-		assistLockSprite_->SetSize({1.0f, 1.0f});            // サイズは調整
-		assistLockSprite_->SetColor({0.0f, 1.0f, 0.0f, 1.0f}); // 緑色
-		assistLockSprite_->SetAnchorPoint({0.5f, 0.5f});
-	}
 	isAssistLocked_ = false;
-
-	uint32_t texHandle = TextureManager::Load("redbox.png");
-	targetSprite_ = Sprite::Create(texHandle, {0, 0});
-	if (targetSprite_) {
-		targetSprite_->SetSize({50.0f, 50.0f});
-		targetSprite_->SetColor({1.0f, 0.0f, 0.0f, 1.0f});
-		targetSprite_->SetAnchorPoint({0.5f, 0.5f});
-	}
 	isOnScreen_ = false;
 	wasOnScreenLastFrame_ = false;
 	lockOnAnimRotation_ = 0.0f;
@@ -70,14 +39,14 @@ void Enemy::Initialize(KamataEngine::Model* model, const KamataEngine::Vector3&
 	baseZ_ = pos.z;
 	// 初期にランダムにスポーンする処理
 	const float kInitMaxOffset = 4000.0f;
-	currentOffsetX_ = ((static_cast<float>(rand()) / RAND_MAX) * 2.0f - 1.0f) * kInitMaxOffset; // 初期位置をランダムに散らす
-	currentOffsetZ_ = ((static_cast<float>(rand()) / RAND_MAX) * 2.0f - 1.0f) * kInitMaxOffset; // 初期位置をランダムに散らす
-	moveSpeedX_ = 1.0f + (static_cast<float>(rand()) / RAND_MAX) * 1.0f; // X軸方向の速度
-	moveSpeedZ_ = 1.0f + (static_cast<float>(rand()) / RAND_MAX) * 0.8f; // Z軸方向の速度
-	directionX_ = (rand() % 2 == 0) ? 1.0f : -1.0f; // ランダムな初期X方向
-	directionZ_ = (rand() % 2 == 0) ? 1.0f : -1.0f; // ランダムな初期Z方向
-	directionChangeIntervalX_ = static_cast<float>(rand() % 180 + 90); // 90-270フレームのランダムな間隔
-	directionChangeIntervalZ_ = static_cast<float>(rand() % 200 + 100); // 100-300フレームのランダムな間隔
+	currentOffsetX_ = (random_.NextFloat() * 2.0f - 1.0f) * kInitMaxOffset; // 初期位置をランダムに散らす
+	currentOffsetZ_ = (random_.NextFloat() * 2.0f - 1.0f) * kInitMaxOffset; // 初期位置をランダムに散らす
+	moveSpeedX_ = 1.0f + random_.NextFloat() * 1.0f; // X軸方向の速度
+	moveSpeedZ_ = 1.0f + random_.NextFloat() * 0.8f; // Z軸方向の速度
+	directionX_ = random_.NextSign(); // ランダムな初期X方向
+	directionZ_ = random_.NextSign(); // ランダムな初期Z方向
+	directionChangeIntervalX_ = static_cast<float>(random_.RangeInt(90, 269)); // 90-270フレームのランダムな間隔
+	directionChangeIntervalZ_ = static_cast<float>(random_.RangeInt(100, 299)); // 100-300フレームのランダムな間隔
 	directionChangeTimerX_ = 0.0f;
 	directionChangeTimerZ_ = 0.0f;
 
@@ -86,11 +55,11 @@ void Enemy::Initialize(KamataEngine::Model* model, const KamataEngine::Vector3&
 	smoothedForward_ = {0.0f, 0.0f, 1.0f};
 
 	// ゆっくり大きく曲がる
-	wanderAngle_ = (static_cast<float>(rand()) / RAND_MAX) * (2.0f * 3.14159265f);
-	wanderJitter_ = 0.02f + (static_cast<float>(rand()) / RAND_MAX) * 0.03f;
-	wanderRadius_ = 1200.0f + (static_cast<float>(rand()) / RAND_MAX) * 800.0f;
-	wanderDistance_ = 900.0f + (static_cast<float>(rand()) / RAND_MAX) * 600.0f;
-	desiredSpeed_ = (0.6f + (static_cast<float>(rand()) / RAND_MAX) * 0.8f) * 3.0f;
+	wanderAngle_ = random_.NextFloat() * (2.0f * 3.14159265f);
+	wanderJitter_ = 0.02f + random_.NextFloat() * 0.03f;
+	wanderRadius_ = 1200.0f + random_.NextFloat() * 800.0f;
+	wanderDistance_ = 900.0f + random_.NextFloat() * 600.0f;
+	desiredSpeed_ = (0.6f + random_.NextFloat() * 0.8f) * 3.0f;
 
 	posSmoothFactor_ = 0.06f;    //  小さくすると遅れて滑らか
 	facingSmoothFactor_ = 0.04f; // 小さくするとゆっくり回る
@@ -105,15 +74,21 @@ KamataEngine::Vector3 Enemy::GetWorldPosition() {
 	return worldPos;
 }
 
+AABB Enemy::GetAABB() { return MakeAABB(GetWorldPosition(), kRadius); }
+
 void Enemy::OnCollision() {
 	hp_--;
 	if (hp_ <= 0) {
 		isDead_ = true;
-		if (gameScene_) {
-			gameScene_->RequestExplosion(GetWorldPosition());
-			// Award score for enemy death
-			gameScene_->AddScore(100);
-		}
+		EnemyCommand explosion;
+		explosion.type = EnemyCommand::Type::Explosion;
+		explosion.position = GetWorldPosition();
+		commands_.push_back(explosion);
+		// Award score for enemy death
+		EnemyCommand score;
+		score.type = EnemyCommand::Type::AddScore;
+		score.points = 100;
+		commands_.push_back(score);
 	};
 }
 
@@ -132,22 +107,19 @@ void Enemy::Fire() {
 
 		KamataEngine::Vector3 homingBullet = playerWorldtransform - enemyWorldtransform;
 
-		homingBullet = KamataEngine::MathUtility::Normalize(homingBullet);
+		homingBullet = Normalize(homingBullet);
 
 		velocity.x = kBulletSpeed * homingBullet.x;
 		velocity.y = kBulletSpeed * homingBullet.y;
 		velocity.z = kBulletSpeed * homingBullet.z;
 
-		EnemyBullet* newBullet = new EnemyBullet();
-		newBullet->Initialize(modelbullet_, moveBullet, velocity);
-
-		newBullet->SetHomingEnabled(true);
-		newBullet->SetHomingTarget(player_);
-		newBullet->SetSpeed(kBulletSpeed);
-
-		if (gameScene_) {
-			gameScene_->AddEnemyBullet(newBullet);
-		}
+		// 弾を出すのはワールドが後でまとめて行う
+		EnemyCommand fire;
+		fire.type = EnemyCommand::Type::FireBullet;
+		fire.position = moveBullet;
+		fire.velocity = velocity;
+		fire.speed = kBulletSpeed;
+		commands_.push_back(fire);
 
 		spawnTimer = kFireInterval;
 	}
@@ -164,19 +136,19 @@ void Enemy::Update() {
 	// X軸方向の変更処理
 	if (directionChangeTimerX_ >= directionChangeIntervalX_) {
 		// ランダムに方向を変更（-1.0f または 1.0f）
-		directionX_ = (rand() % 2 == 0) ? 1.0f : -1.0f;
+		directionX_ = random_.NextSign();
 		// 次の方向変更までの時間をランダムに設定（90-270フレーム）
 		directionChangeTimerX_ = 0.0f;
-		directionChangeIntervalX_ = static_cast<float>(rand() % 180 + 90);
+		directionChangeIntervalX_ = static_cast<float>(random_.RangeInt(90, 269));
 	}
 
 	// Z軸方向の変更処理
 	if (directionChangeTimerZ_ >= directionChangeIntervalZ_) {
 		// ランダムに方向を変更（-1.0f または 1.0f）
-		directionZ_ = (rand() % 2 == 0) ? 1.0f : -1.0f;
+		directionZ_ = random_.NextSign();
 		// 次の方向変更までの時間をランダムに設定（100-300フレーム）
 		directionChangeTimerZ_ = 0.0f;
-		directionChangeIntervalZ_ = static_cast<float>(rand() % 200 + 100);
+		directionChangeIntervalZ_ = static_cast<float>(random_.RangeInt(100, 299));
 	}
 
 	// 滑らかに補間
@@ -212,10 +184,6 @@ void Enemy::Update() {
 
 	worldtransfrom_.UpdateMatrix();
 
-	if (camera_ && targetSprite_) {
-		UpdateScreenPosition();
-	}
-
 	// ウォーカーステアリングによる大きな滑らかな曲線移動の実現
 	KamataEngine::Vector3 currentVelocity = { smoothedVelocity_.x, 0.0f, smoothedVelocity_.z };
 
@@ -231,7 +199,7 @@ void Enemy::Update() {
 	}
 	wanderCenter.x *= wanderDistance_;
 	wanderCenter.z *= wanderDistance_;
-	wanderAngle_ += ((static_cast<float>(rand()) / RAND_MAX) * 2.0f - 1.0f) * wanderJitter_;
+	wanderAngle_ += (random_.NextFloat() * 2.0f - 1.0f) * wanderJitter_;
 
 	KamataEngine::Vector3 wanderPoint = { std::sin(wanderAngle_) * wanderRadius_, 0.0f, std::cos(wanderAngle_) * wanderRadius_ };
 
@@ -275,47 +243,39 @@ void Enemy::Update() {
 	}
 }
 
-void Enemy::Draw(const KamataEngine::Camera& camera) { model_->Draw(worldtransfrom_, camera); }
-
-void Enemy::DrawSprite() {
-	if (isOnScreen_) {
-		if (useGreenLock_) {
-			if (assistLockSprite_) {
-				assistLockSprite_->Draw();
-			}
-		} else {
-			if (targetSprite_)
-				targetSprite_->Draw();
-		}
-	}
-
-	// 画面外 かつ インジケーター表示距離内の場合のみ、方向インジケーターを描画する
-	if (isOffScreen_ && showDirectionIndicator_ && directionIndicatorSprite_) {
-		directionIndicatorSprite_->Draw();
+EnemyScreenState Enemy::GetScreenState() const {
+	EnemyScreenState state;
+	state.isOnScreen = isOnScreen_;
+	state.isOffScreen = isOffScreen_;
+	state.showDirectionIndicator = showDirectionIndicator_;
+	state.useGreenLock = useGreenLock_;
+	state.isAssistLocked = isAssistLocked_;
+	state.screenPosition = screenPosition_;
+	state.indicatorPosition = indicatorPosition_;
+	state.indicatorRotation = indicatorRotation_;
+	state.assistLockRotation = assistLockRotation_;
+
+	/// 赤い回転ロックfalseの場合のみ、回転アニメーションを実行する
+	const float baseSize = 50.0f;
+	if (!useGreenLock_) {
+		state.targetRotation = lockOnAnimRotation_;
+		state.targetSize = baseSize * lockOnAnimScale_;
+	} else {
+		state.targetRotation = 0.0f;
+		state.targetSize = baseSize;
 	}
 
-	if (isAssistLocked_ && assistLockSprite_) {
-		// アシストロックオン中はロックオンスプライトも描画する
-		assistLockSprite_->Draw();
-	}
+	// 緑ロックの場合、アシストロックスプライトのサイズを設定する
+	state.assistLockSize = useGreenLock_ ? 15.0f : 20.0f;
+	return state;
 }
 
-void Enemy::UpdateScreenPosition() {
+void Enemy::UpdateScreenPosition(const ScreenProjection& projection) {
 
-	if (!camera_ || !targetSprite_ || !directionIndicatorSprite_) {
-		isOnScreen_ = false;
-		isOffScreen_ = false;
-		return;
-	}
-	const KamataEngine::Matrix4x4& viewMatrix = camera_->matView;
-	const KamataEngine::Matrix4x4& projMatrix = camera_->matProjection;
-	KamataEngine::Vector2 screenCenter = {KamataEngine::WinApp::kWindowWidth / 2.0f, KamataEngine::WinApp::kWindowHeight / 2.0f};
+	KamataEngine::Vector2 screenCenter = {SimCamera::kScreenWidth / 2.0f, SimCamera::kScreenHeight / 2.0f};
 
-	KamataEngine::Vector3 worldPos = GetWorldPosition();
-	KamataEngine::Vector3 viewPos;
-	viewPos.x = worldPos.x * viewMatrix.m[0][0] + worldPos.y * viewMatrix.m[1][0] + worldPos.z * viewMatrix.m[2][0] + 1.0f * viewMatrix.m[3][0];
-	viewPos.y = worldPos.x * viewMatrix.m[0][1] + worldPos.y * viewMatrix.m[1][1] + worldPos.z * viewMatrix.m[2][1] + 1.0f * viewMatrix.m[3][1];
-	viewPos.z = worldPos.x * viewMatrix.m[0][2] + worldPos.y * viewMatrix.m[1][2] + worldPos.z * viewMatrix.m[2][2] + 1.0f * viewMatrix.m[3][2];
+	ScreenPoint point = projection.Get(screenIndex_);
+	const KamataEngine::Vector3& viewPos = point.view;
 
 	// 距離に基づいて、緑ロックか赤ロックかを決定する
 	const float kLockDistanceThreshold = 3000.0f;
@@ -326,81 +286,42 @@ void Enemy::UpdateScreenPosition() {
 	float viewDist = std::sqrt(viewPos.x * viewPos.x + viewPos.y * viewPos.y + viewPos.z * viewPos.z);
 	showDirectionIndicator_ = (viewDist <= kIndicatorMaxDistance);
 
-	if (viewPos.z > 0.0f) {
-		float clipX = viewPos.x * projMatrix.m[0][0] + viewPos.y * projMatrix.m[1][0] + viewPos.z * projMatrix.m[2][0] + 1.0f * projMatrix.m[3][0];
-		float clipY = viewPos.x * projMatrix.m[0][1] + viewPos.y * projMatrix.m[1][1] + viewPos.z * projMatrix.m[2][1] + 1.0f * projMatrix.m[3][1];
-		float w_clip = viewPos.x * projMatrix.m[0][3] + viewPos.y * projMatrix.m[1][3] + viewPos.z * projMatrix.m[2][3] + 1.0f * projMatrix.m[3][3];
-
-		if (w_clip > 0.0f) {
-			float ndcX = clipX / w_clip;
-			float ndcY = clipY / w_clip;
-
-			if (ndcX >= -1.0f && ndcX <= 1.0f && ndcY >= -1.0f && ndcY <= 1.0f) {
-				// 画面内
-				isOnScreen_ = true;
-				isOffScreen_ = false;
-				float screenX = (ndcX + 1.0f) * 0.5f * KamataEngine::WinApp::kWindowWidth;
-				float screenY = (1.0f - ndcY) * 0.5f * KamataEngine::WinApp::kWindowHeight;
-				targetSprite_->SetPosition({screenX, screenY});
-				if (assistLockSprite_) {
-					assistLockSprite_->SetPosition({screenX, screenY});
-				}
-
-				// 距離に基づいて useGreenLock_ (緑ロックを使用するか) を設定する
-				useGreenLock_ = farForLock;
-			} else {
-				// 画面外・前方
-				isOnScreen_ = false;
-				isOffScreen_ = true;
-				float screenX = (ndcX + 1.0f) * 0.5f * KamataEngine::WinApp::kWindowWidth;
-				float screenY = (1.0f - ndcY) * 0.5f * KamataEngine::WinApp::kWindowHeight;
-				KamataEngine::Vector2 vecFromCenter = {screenX - screenCenter.x, screenY - screenCenter.y};
-				float angle = std::atan2(vecFromCenter.y, vecFromCenter.x);
-
-				const float kIndicatorRadius = 70.0f;
-				float indicatorX = screenCenter.x + kIndicatorRadius * std::cos(angle);
-				float indicatorY = screenCenter.y + kIndicatorRadius * std::sin(angle);
-
-				const float kScreenMargin = 20.0f;
-				indicatorX = std::clamp(indicatorX, kScreenMargin, KamataEngine::WinApp::kWindowWidth - kScreenMargin);
-				indicatorY = std::clamp(indicatorY, kScreenMargin, KamataEngine::WinApp::kWindowHeight - kScreenMargin);
-
-				directionIndicatorSprite_->SetPosition({indicatorX, indicatorY});
-				directionIndicatorSprite_->SetRotation(angle + KamataEngine::MathUtility::PI / 2.0f);
-			}
-		} else {
-			isOnScreen_ = false;
-			isOffScreen_ = true;
-
-			float angle = std::atan2(-viewPos.y, -viewPos.x);
-
-			const float kIndicatorRadius = 70.0f;
-			float indicatorX = screenCenter.x + kIndicatorRadius * std::cos(angle);
-			float indicatorY = screenCenter.y + kIndicatorRadius * std::sin(angle);
-
-			const float kScreenMargin = 20.0f;
-			indicatorX = std::clamp(indicatorX, kScreenMargin, KamataEngine::WinApp::kWindowWidth - kScreenMargin);
-			indicatorY = std::clamp(indicatorY, kScreenMargin, KamataEngine::WinApp::kWindowHeight - kScreenMargin);
+	if (point.isOnScreen) {
+		// 画面内
+		isOnScreen_ = true;
+		isOffScreen_ = false;
+		float screenX = (point.ndc.x + 1.0f) * 0.5f * SimCamera::kScreenWidth;
+		float screenY = (1.0f - point.ndc.y) * 0.5f * SimCamera::kScreenHeight;
+		screenPosition_ = {screenX, screenY};
 
-			directionIndicatorSprite_->SetPosition({indicatorX, indicatorY});
-			directionIndicatorSprite_->SetRotation(angle + 3.14159265f / 2.0f);// directionIndicatorSprite_->SetRotation(angle + KamataEngine::MathUtility::PI / 2.0f); どっちもかわらない
-		}
+		// 距離に基づいて useGreenLock_ (緑ロックを使用するか) を設定する
+		useGreenLock_ = farForLock;
 	} else {
 		isOnScreen_ = false;
 		isOffScreen_ = true;
 
-		float angle = std::atan2(-viewPos.y, -viewPos.x);
+		float angle = 0.0f;
+		if (point.isInFront) {
+			// 画面外・前方
+			float screenX = (point.ndc.x + 1.0f) * 0.5f * SimCamera::kScreenWidth;
+			float screenY = (1.0f - point.ndc.y) * 0.5f * SimCamera::kScreenHeight;
+			KamataEngine::Vector2 vecFromCenter = {screenX - screenCenter.x, screenY - screenCenter.y};
+			angle = std::atan2(vecFromCenter.y, vecFromCenter.x);
+		} else {
+			// カメラの後ろ
+			angle = std::atan2(-viewPos.y, -viewPos.x);
+		}
 
 		const float kIndicatorRadius = 70.0f;
 		float indicatorX = screenCenter.x + kIndicatorRadius * std::cos(angle);
 		float indicatorY = screenCenter.y + kIndicatorRadius * std::sin(angle);
 
 		const float kScreenMargin = 20.0f;
-		indicatorX = std::clamp(indicatorX, kScreenMargin, KamataEngine::WinApp::kWindowWidth - kScreenMargin);
-		indicatorY = std::clamp(indicatorY, kScreenMargin, KamataEngine::WinApp::kWindowHeight - kScreenMargin);
+		indicatorX = std::clamp(indicatorX, kScreenMargin, SimCamera::kScreenWidth - kScreenMargin);
+		indicatorY = std::clamp(indicatorY, kScreenMargin, SimCamera::kScreenHeight - kScreenMargin);
 
-		directionIndicatorSprite_->SetPosition({indicatorX, indicatorY});
-		directionIndicatorSprite_->SetRotation(angle + KamataEngine::MathUtility::PI / 2.0f);
+		indicatorPosition_ = {indicatorX, indicatorY};
+		indicatorRotation_ = angle + kPI / 2.0f;
 	}
 
 	bool justAppeared = (isOnScreen_ && !wasOnScreenLastFrame_);
@@ -430,33 +351,10 @@ void Enemy::UpdateScreenPosition() {
 		}
 	}
 
-	if (targetSprite_) {
-		/// 赤い回転ロックfalseの場合のみ、回転アニメーションを実行する
-		if (!useGreenLock_) {
-			targetSprite_->SetRotation(lockOnAnimRotation_);
-			const float baseSize = 50.0f;
-			targetSprite_->SetSize({baseSize * lockOnAnimScale_, baseSize * lockOnAnimScale_});
-		} else {
-			targetSprite_->SetRotation(0.0f);
-			const float baseSize = 50.0f;
-			targetSprite_->SetSize({baseSize, baseSize});
-		}
-	}
-
-	// 緑ロックの場合、アシストロックスプライトのサイズを設定する
-	if (assistLockSprite_) {
-		if (useGreenLock_) {
-			assistLockSprite_->SetSize({15.0f, 15.0f});
-		} else {
-			assistLockSprite_->SetSize({20.0f, 20.0f});
-		}
-		float rollAngle = std::atan2(viewMatrix.m[0][1], viewMatrix.m[1][1]);
-
-		// スプライトに回転を設定
-		assistLockSprite_->SetRotation(rollAngle);
-	}
+	// アシストロックスプライトの回転はカメラのロールに合わせる
+	assistLockRotation_ = projection.GetCameraRoll();
 
 	wasOnScreenLastFrame_ = isOnScreen_;
 }
 
-void Enemy::SetParent(const KamataEngine::WorldTransform* parent) { worldtransfrom_.parent_ = parent; }
\ No newline at end of file
+void Enemy::SetParent(const SimTransform* parent) { worldtransfrom_.parent_ = parent; }
\ No newline at end of file
@@ -1,32 +1,63 @@
 #pragma once
-#include <3d/Model.h>
-#include <3d/WorldTransform.h>
-#include "KamataEngine.h"
-#include <3d/Camera.h>
 #include "EnemyBullet.h"
 #include <cassert>
 #include "MT.h"
-#include "GaneScene.h"
+#include "RandomStream.h"
+#include "SimCamera.h"
+#include "SimTransform.h"
+#include <cstdint>
+#include <vector>
 
 // 前方宣言
-namespace KamataEngine { class Sprite; }
-class Vector2;
-
 class Player;
-class GameScene;
+class ScreenProjection;
 
 enum class Phase {
 	Approach, // 接近する
 	Leave,    // 離脱する
 };
 
+// ロックオン表示の状態（描画側がスプライトへ反映する）
+struct EnemyScreenState {
+	bool isOnScreen = false;
+	bool isOffScreen = false;
+	// 画面外方向インジケーターを表示するか（遠すぎると非表示）
+	bool showDirectionIndicator = true;
+	// 遠距離では赤い回転ロックの代わりに緑のロックを表示するか
+	bool useGreenLock = false;
+	bool isAssistLocked = false;
+
+	KamataEngine::Vector2 screenPosition = {0.0f, 0.0f};
+	float targetRotation = 0.0f;
+	float targetSize = 50.0f;
+
+	KamataEngine::Vector2 indicatorPosition = {0.0f, 0.0f};
+	float indicatorRotation = 0.0f;
+
+	float assistLockSize = 20.0f;
+	float assistLockRotation = 0.0f;
+};
+
+// 敵がワールドに頼む変更 (並列の更新中はワールドを直接書き換えず、敵ごとの出力に貯めて後でまとめて反映する)
+struct EnemyCommand {
+	enum class Type : uint8_t {
+		FireBullet, // 自機を追う弾を撃つ (position, velocity, speed)
+		Explosion,  // 爆発を出す (position)
+		AddScore,   // 得点を足す (points)
+	};
+	Type type = Type::Explosion;
+	KamataEngine::Vector3 position = {0.0f, 0.0f, 0.0f};
+	KamataEngine::Vector3 velocity = {0.0f, 0.0f, 0.0f};
+	float speed = 0.0f;
+	int points = 0;
+};
+
 class Enemy {
 public:
 
-	void Initialize(KamataEngine::Model* model, const KamataEngine::Vector3& pos);
+	// random はこの敵だけが使う乱数列 (ふらつき・方向転換に使う)
+	void Initialize(const KamataEngine::Vector3& pos, const RandomStream& random);
 	void Update();
-	void Draw(const KamataEngine::Camera& camera);
-	void DrawSprite(); // スプライトを描画
 	~Enemy();
 	void Fire();
 
@@ -35,62 +66,92 @@ public:
 	void OnCollision();
 
 	KamataEngine::Vector3 GetWorldPosition();
+	KamataEngine::Vector3 GetPreviousWorldPosition() const { return worldtransfrom_.GetPreviousWorldPosition(); }
+	// 当たり判定と検索用の箱 (中心 ± kRadius)
+	AABB GetAABB();
+
+	// 当たり判定の半径 (boat.obj の胴体の幅の半分)
+	static inline const float kRadius = 11.6f;
+
+	// GameWorld の敵の AABB 木での葉の番号
+	void SetTreeProxy(int32_t proxy) { treeProxy_ = proxy; }
+	int32_t GetTreeProxy() const { return treeProxy_; }
+
+	// 何番目に出た敵か (GameWorld の enemies_ の並び順と同じ)
+	void SetSpawnOrder(uint64_t order) { spawnOrder_ = order; }
+	uint64_t GetSpawnOrder() const { return spawnOrder_; }
 
 	void SetPlayer(Player* player) { player_ = player; }
-	void SetGameScene(GameScene* gameScene) { gameScene_ = gameScene; }
-	void SetCamera(const KamataEngine::Camera* camera) { camera_ = camera; }
+
+	// Update・Fire・OnCollision で貯めたワールドへの変更 (GameWorld が敵の並び順に反映して消す)
+	const std::vector<EnemyCommand>& GetCommands() const { return commands_; }
+	void ClearCommands() { commands_.clear(); }
 	// 画面内判定
 	bool IsOnScreen() const { return isOnScreen_; }
 
 	int GetHp() const { return hp_; }
 
-	// 画面座標の更新
-	void UpdateScreenPosition();
+	// GameWorld の画面投影の表での番号
+	void SetScreenIndex(int32_t index) { screenIndex_ = index; }
+	int32_t GetScreenIndex() const { return screenIndex_; }
+
+	// 画面座標の更新 (投影の結果は projection の表から読む)
+	void UpdateScreenPosition(const ScreenProjection& projection);
 
 	// 発射間隔
 	static const int kFireInterval = 20;
 
 	bool isDead_ = false;
 
-	void SetParent(const KamataEngine::WorldTransform* parent);
+	void SetParent(const SimTransform* parent);
 	void SetAssistLocked(bool isLocked) { isAssistLocked_ = isLocked; }
 	bool IsAssistLocked() const { return isAssistLocked_; }
 	void SetAssistLockId(int id) { assistLockId_ = id; }
 	int GetAssistLockId() const { return assistLockId_; }
 
-private:
+	const KamataEngine::Matrix4x4& GetWorldMatrix() const { return worldtransfrom_.matWorld_; }
+	// 描画の補間用: ステップ開始時の行列を保存する
+	void SavePreviousTransform() { worldtransfrom_.SavePrevious(); }
+	KamataEngine::Matrix4x4 GetInterpolatedMatrix(float alpha) const { return worldtransfrom_.GetInterpolatedMatrix(alpha); }
+	// ロックオン表示の状態を取得
+	EnemyScreenState GetScreenState() const;
 
-	KamataEngine::WorldTransform worldtransfrom_;
-	KamataEngine::Model* model_ = nullptr;
+private:
 
-	KamataEngine::Model* modelbullet_ = nullptr;
+	SimTransform worldtransfrom_;
+	// この敵専用の乱数列 (ほかの敵の更新順に左右されない)
+	RandomStream random_;
 
 	int hp_ = 1;
 
+	int32_t treeProxy_ = -1;
+	int32_t screenIndex_ = -1;
+	uint64_t spawnOrder_ = 0;
+
 	// 発射タイマー
 	int32_t spawnTimer = 0;
 
 	Player* player_ = nullptr;
-	GameScene* gameScene_ = nullptr;
-	const KamataEngine::Camera* camera_ = nullptr;
+	// この敵だけが書き込む出力 (ほかの敵と並列に更新しても競合しない)
+	std::vector<EnemyCommand> commands_;
 
 	Phase phase_ = Phase::Approach;
 
 	Phase Bulletphase_ = Phase::Approach;
 
 	// 追尾スプライト
-	class Sprite* targetSprite_ = nullptr;
 	bool isOnScreen_ = false;
-	KamataEngine::Vector2 screenPosition_;
+	KamataEngine::Vector2 screenPosition_ = {0.0f, 0.0f};
 
 	bool wasOnScreenLastFrame_ = false; // 1フレーム前の画面内判定
 	float lockOnAnimRotation_ = 0.0f;
 	float lockOnAnimScale_ = 1.0f;
 
-	KamataEngine::Sprite* directionIndicatorSprite_;
-	bool isOffScreen_;
+	bool isOffScreen_ = false;
 	// 画面外方向インジケーターを表示するか（遠すぎると非表示）
 	bool showDirectionIndicator_ = true;
+	KamataEngine::Vector2 indicatorPosition_ = {0.0f, 0.0f};
+	float indicatorRotation_ = 0.0f;
 
 	KamataEngine::Vector3 initialRelativePos_;
 	KamataEngine::Vector3 initialWorldPos_;
@@ -99,8 +160,7 @@ private:
 	bool isFollowing_ = false;
 	bool isFollowingFast_ = false;
 
-	KamataEngine::Sprite* assistLockSprite_ = nullptr;
-	uint32_t assistLockTextureHandle_ = 0;
+	float assistLockRotation_ = 0.0f;
 	bool isAssistLocked_ = false; // アシスト円に入っているか
 	int assistLockId_ = 0; // 現在のアシストロックID
 
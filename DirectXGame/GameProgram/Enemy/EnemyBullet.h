@@ -1,55 +1,70 @@
 #pragma once
-#include <3d/Camera.h>
-#include <3d/Model.h>
-#include <3d/WorldTransform.h>
 #include "AABB.h"
+#include "BulletStore.h"
+#include "SimClock.h"
+#include <cstdint>
+class HomingGuidance;
 class Player; // forward
 class EnemyBullet {
 public:
-    void Initialize(KamataEngine::Model* model, const KamataEngine::Vector3& position, const KamataEngine::Vector3& velocity);
-
-    void Update();
-
-    void Draw(const KamataEngine::Camera& camera);
+    // 寿命の単位 (秒)。BulletStore::Integrate に渡す
+    static inline const float kLifeStep = SimClock::kStepSeconds;
+
+    /// <summary>
+    /// 初期化
+    /// </summary>
+    /// <param name="store">位置・速度・寿命を置く場所</param>
+    /// <param name="slot">store 内のスロット (弾のプールのインデックス)</param>
+    void Initialize(BulletStore* store, uint32_t slot, const KamataEngine::Vector3& position, const KamataEngine::Vector3& velocity);
+
+    /// <summary>
+    /// 追尾・回避後のタイマーの更新 (向きを変える弾は guidance に登録する)
+    /// 向きの変更は HomingGuidance::Steer、移動と寿命は BulletStore::Integrate で全弾まとめて進める
+    /// </summary>
+    void UpdateHoming(HomingGuidance& guidance);
 
     void OnEvaded();
 
     ~EnemyBullet();
 
-    bool IsDead() const { return isDead_; }
+    bool IsDead() const { return isDead_ || (store_ && store_->IsExpired(slot_)); }
 
     void OnCollision();
 
-    KamataEngine::Vector3 GetWorldPosition();
+    KamataEngine::Vector3 GetWorldPosition() const { return store_->GetPosition(slot_); }
+    // ステップ開始時の位置 (このステップで通った線分の始点)
+    KamataEngine::Vector3 GetPreviousPosition() const { return store_->GetPreviousPosition(slot_); }
+    uint32_t GetSlot() const { return slot_; }
 
     AABB GetAABB();
 
+    KamataEngine::Matrix4x4 GetWorldMatrix() const { return store_->GetMatrix(slot_); }
+    KamataEngine::Matrix4x4 GetInterpolatedMatrix(float alpha) const { return store_->GetInterpolatedMatrix(slot_, alpha); }
+
     // Homing support
     void SetHomingTarget(Player* target) { homingTarget_ = target; }
     void SetHomingEnabled(bool enabled) { isHoming_ = enabled; }
     void SetSpeed(float s) { speed_ = s; }
     bool IsHoming() const { return isHoming_; }
     
-    // 回避後のタイマーを取得（-1は未回避、0以上は残りフレーム数）
-    int32_t GetEvadedDeathTimer() const { return evadedDeathTimer_; }
+    // 回避後のタイマーを取得（-1は未回避、0以上は残り秒数）
+    float GetEvadedDeathTimer() const { return evadedDeathTimer_; }
 
     void StopHoming() {
 		isHoming_ = false;
-		deathTimer_ = 60;
+		store_->SetLife(slot_, 1.0f);
 	}
 
-    void SetInvulnerableFrames(int frames) { invulnerableFrames_ = frames; }
+    void SetInvulnerableTime(float seconds) { invulnerableTime_ = seconds; }
 
 private:
 
-    KamataEngine::WorldTransform worldtransfrom_;
-    KamataEngine::Model* model_ = nullptr;
-    KamataEngine::Vector3 velocity_;
+    // 位置・速度・寿命 (残り秒数) は store_ の slot_ 番目にある
+    BulletStore* store_ = nullptr;
+    uint32_t slot_ = 0;
 
-    // 寿命　Enemyミサイル
-    static const int32_t kLifeTime = 60 * 10; // default 10 seconds
-    // デスタイマー
-    int32_t deathTimer_ = kLifeTime;
+    // 寿命　Enemyミサイル (秒)
+    static inline const float kLifeTime = 10.0f;
     // デスフラグ
     bool isDead_ = false;
 
@@ -61,8 +76,12 @@ private:
     bool isHoming_ = false;
     float speed_ = 1.0f; // units per frame
 
-    int invulnerableFrames_ = 0;
+    // 撃たれた直後の無敵時間 (秒)
+    static inline const float kInvulnerableTime = 8.0f * SimClock::kStepSeconds;
+    float invulnerableTime_ = 0.0f;
 
-    // 回避後のタイマー（1秒 = 60フレーム）
-    int32_t evadedDeathTimer_ = -1; // -1は未回避状態
+    // 回避されてから消えるまでの時間 (秒)
+    static inline const float kEvadedLifeTime = 1.0f;
+    // 回避後のタイマー (残り秒数)
+    float evadedDeathTimer_ = -1.0f; // -1は未回避状態
 };
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "AABB.h"
+#include <algorithm>
 
 // AABBの衝突判定
 bool IsCollisionAABB(const AABB& a, const AABB& b) {
@@ -9,3 +10,65 @@ bool IsCollisionAABB(const AABB& a, const AABB& b) {
 	}
 	return false;
 }
+
+AABB MakeAABB(const KamataEngine::Vector3& center, float radius) {
+	AABB aabb;
+	aabb.min = {center.x - radius, center.y - radius, center.z - radius};
+	aabb.max = {center.x + radius, center.y + radius, center.z + radius};
+	return aabb;
+}
+
+AABB MergeAABB(const AABB& a, const AABB& b) {
+	AABB aabb;
+	aabb.min = {std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z)};
+	aabb.max = {std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z)};
+	return aabb;
+}
+
+bool ContainsAABB(const AABB& outer, const AABB& inner) {
+	return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z && inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+}
+
+float SurfaceAreaAABB(const AABB& a) {
+	float x = a.max.x - a.min.x;
+	float y = a.max.y - a.min.y;
+	float z = a.max.z - a.min.z;
+	return 2.0f * (x * y + y * z + z * x);
+}
+
+float DistanceSquaredToAABB(const KamataEngine::Vector3& point, const AABB& a) {
+	// 各軸で箱からはみ出している分だけ足す
+	float dx = std::max({a.min.x - point.x, 0.0f, point.x - a.max.x});
+	float dy = std::max({a.min.y - point.y, 0.0f, point.y - a.max.y});
+	float dz = std::max({a.min.z - point.z, 0.0f, point.z - a.max.z});
+	return dx * dx + dy * dy + dz * dz;
+}
+
+bool RayIntersectsAABB(const KamataEngine::Vector3& origin, const KamataEngine::Vector3& direction, float maxDistance, const AABB& a, float& distance) {
+	// 軸ごとの板 (slab) に入る距離と出る距離を狭めていく
+	float enter = 0.0f;
+	float exit = maxDistance;
+	const float origins[3] = {origin.x, origin.y, origin.z};
+	const float directions[3] = {direction.x, direction.y, direction.z};
+	const float mins[3] = {a.min.x, a.min.y, a.min.z};
+	const float maxs[3] = {a.max.x, a.max.y, a.max.z};
+	for (int axis = 0; axis < 3; ++axis) {
+		if (directions[axis] == 0.0f) {
+			// この軸に平行なら、板の中にいなければ交わらない
+			if (origins[axis] < mins[axis] || maxs[axis] < origins[axis]) {
+				return false;
+			}
+			continue;
+		}
+		float inverse = 1.0f / directions[axis];
+		float t1 = (mins[axis] - origins[axis]) * inverse;
+		float t2 = (maxs[axis] - origins[axis]) * inverse;
+		enter = std::max(enter, std::min(t1, t2));
+		exit = std::min(exit, std::max(t1, t2));
+		if (enter > exit) {
+			return false;
+		}
+	}
+	distance = enter;
+	return true;
+}
@@ -6,4 +6,25 @@ struct AABB {
 	KamataEngine::Vector3 max;
 };
 
-bool IsCollisionAABB(const AABB& a, const AABB& b);
\ No newline at end of file
+bool IsCollisionAABB(const AABB& a, const AABB& b);
+
+// 中心と半径 (各軸の半分の長さ) から作る
+AABB MakeAABB(const KamataEngine::Vector3& center, float radius);
+
+// a と b の両方を含む最小の箱
+AABB MergeAABB(const AABB& a, const AABB& b);
+
+// outer が inner を完全に含むか
+bool ContainsAABB(const AABB& outer, const AABB& inner);
+
+// 表面積 (木に入れるときの評価に使う)
+float SurfaceAreaAABB(const AABB& a);
+
+// 点から箱までの距離の 2 乗 (中なら 0)
+float DistanceSquaredToAABB(const KamataEngine::Vector3& point, const AABB& a);
+
+/// <summary>
+/// origin から direction の向きに maxDistance まで伸ばした線分が箱と交わるか
+/// </summary>
+/// <param name="distance">交わったときの入り口までの距離 (direction の長さが単位、中から出る場合は 0)</param>
+bool RayIntersectsAABB(const KamataEngine::Vector3& origin, const KamataEngine::Vector3& direction, float maxDistance, const AABB& a, float& distance);
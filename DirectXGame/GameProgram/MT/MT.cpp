@@ -1,5 +1,8 @@
 #include "MT.h"
-#include <random>
+#include "Simd.h"
+
+// MT_SSE2 のときは行列の 1 行 (4 要素) をまとめて計算する
+// 足し算・掛け算の順番はスカラー版と同じにしてあるので、結果はビット単位で一致する
 
 Matrix4x4 MakeRotateXMatrix(float radian) {
 	Matrix4x4 result = {};
@@ -44,16 +47,31 @@ Matrix4x4 MakeRotateZMatrix(float radian) {
 
 Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2) {
 	Matrix4x4 m3;
+#ifdef MT_SSE2
+	// 結果の i 行目 = m1[i][0] * m2 の 0 行目 + ... + m1[i][3] * m2 の 3 行目
+	__m128 row0 = _mm_loadu_ps(m2.m[0]);
+	__m128 row1 = _mm_loadu_ps(m2.m[1]);
+	__m128 row2 = _mm_loadu_ps(m2.m[2]);
+	__m128 row3 = _mm_loadu_ps(m2.m[3]);
+	for (int i = 0; i < 4; i++) {
+		__m128 row = _mm_mul_ps(_mm_set1_ps(m1.m[i][0]), row0);
+		row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(m1.m[i][1]), row1));
+		row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(m1.m[i][2]), row2));
+		row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(m1.m[i][3]), row3));
+		_mm_storeu_ps(m3.m[i], row);
+	}
+#else
 	for (int i = 0; i < 4; i++) {
 		for (int j = 0; j < 4; j++) {
 			m3.m[i][j] = m1.m[i][0] * m2.m[0][j] + m1.m[i][1] * m2.m[1][j] + m1.m[i][2] * m2.m[2][j] + m1.m[i][3] * m2.m[3][j];
 		}
 	}
+#endif
 	return m3;
 }
 
 Vector3 Normalize(const Vector3& v) {
-	float len = KamataEngine::MathUtility::Length(v);
+	float len = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
 
 	Vector3 v2 = {};
 	if (len != 0.0f) {
@@ -64,6 +82,7 @@ Vector3 Normalize(const Vector3& v) {
 	return v2;
 }
 
+float Length(const Vector3& v) { return std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z); }
 
 Matrix4x4 MakeScaleMatrix(const Vector3& scale) {
 	Matrix4x4 m = {};
@@ -76,6 +95,20 @@ Matrix4x4 MakeScaleMatrix(const Vector3& scale) {
 
 Vector3 Transform(const Vector3& vector, const Matrix4x4& matrix) {
 	Vector3 result = {};
+#ifdef MT_SSE2
+	// (x, y, z, w) をまとめて計算し、w で割る
+	__m128 clip = _mm_mul_ps(_mm_set1_ps(vector.x), _mm_loadu_ps(matrix.m[0]));
+	clip = _mm_add_ps(clip, _mm_mul_ps(_mm_set1_ps(vector.y), _mm_loadu_ps(matrix.m[1])));
+	clip = _mm_add_ps(clip, _mm_mul_ps(_mm_set1_ps(vector.z), _mm_loadu_ps(matrix.m[2])));
+	clip = _mm_add_ps(clip, _mm_loadu_ps(matrix.m[3]));
+	float values[4];
+	_mm_storeu_ps(values, clip);
+	float w = values[3];
+	assert(w != 0.0f);
+	result.x = values[0] / w;
+	result.y = values[1] / w;
+	result.z = values[2] / w;
+#else
 	result.x = vector.x * matrix.m[0][0] + vector.y * matrix.m[1][0] + vector.z * matrix.m[2][0] + 1.0f * matrix.m[3][0];
 	result.y = vector.x * matrix.m[0][1] + vector.y * matrix.m[1][1] + vector.z * matrix.m[2][1] + 1.0f * matrix.m[3][1];
 	result.z = vector.x * matrix.m[0][2] + vector.y * matrix.m[1][2] + vector.z * matrix.m[2][2] + 1.0f * matrix.m[3][2];
@@ -85,10 +118,28 @@ Vector3 Transform(const Vector3& vector, const Matrix4x4& matrix) {
 	result.x /= w;
 	result.y /= w;
 	result.z /= w;
+#endif
 
 	return result;
 }
 
+Vector3 TransformNormal(const Vector3& vector, const Matrix4x4& matrix) {
+	Vector3 result = {};
+#ifdef MT_SSE2
+	__m128 v = _mm_mul_ps(_mm_set1_ps(vector.x), _mm_loadu_ps(matrix.m[0]));
+	v = _mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(vector.y), _mm_loadu_ps(matrix.m[1])));
+	v = _mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(vector.z), _mm_loadu_ps(matrix.m[2])));
+	float values[4];
+	_mm_storeu_ps(values, v);
+	result = {values[0], values[1], values[2]};
+#else
+	result.x = vector.x * matrix.m[0][0] + vector.y * matrix.m[1][0] + vector.z * matrix.m[2][0];
+	result.y = vector.x * matrix.m[0][1] + vector.y * matrix.m[1][1] + vector.z * matrix.m[2][1];
+	result.z = vector.x * matrix.m[0][2] + vector.y * matrix.m[1][2] + vector.z * matrix.m[2][2];
+#endif
+	return result;
+}
+
 Matrix4x4 MakeTranslateMatrix(const Vector3& translate) {
 	Matrix4x4 m = {};
 	m.m[0][0] = 1;
@@ -104,9 +155,38 @@ Matrix4x4 MakeTranslateMatrix(const Vector3& translate) {
 
 Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Vector3& rotate, const Vector3& translate) {
 
-	Matrix4x4 rotateXMatrix = MakeRotateXMatrix(rotate.x);
-	Matrix4x4 rotateYMatrix = MakeRotateYMatrix(rotate.y);
-	Matrix4x4 rotateZMatrix = MakeRotateZMatrix(rotate.z);
+	// sin / cos は軸ごとに 1 度だけ計算する (MakeRotateXMatrix などと同じ値の行列になる)
+	float sinX = std::sin(rotate.x);
+	float cosX = std::cos(rotate.x);
+	float sinY = std::sin(rotate.y);
+	float cosY = std::cos(rotate.y);
+	float sinZ = std::sin(rotate.z);
+	float cosZ = std::cos(rotate.z);
+
+	Matrix4x4 rotateXMatrix = {};
+	rotateXMatrix.m[0][0] = 1;
+	rotateXMatrix.m[1][1] = cosX;
+	rotateXMatrix.m[1][2] = sinX;
+	rotateXMatrix.m[2][1] = -sinX;
+	rotateXMatrix.m[2][2] = cosX;
+	rotateXMatrix.m[3][3] = 1;
+
+	Matrix4x4 rotateYMatrix = {};
+	rotateYMatrix.m[0][0] = cosY;
+	rotateYMatrix.m[0][2] = -sinY;
+	rotateYMatrix.m[1][1] = 1;
+	rotateYMatrix.m[2][0] = sinY;
+	rotateYMatrix.m[2][2] = cosY;
+	rotateYMatrix.m[3][3] = 1;
+
+	Matrix4x4 rotateZMatrix = {};
+	rotateZMatrix.m[0][0] = cosZ;
+	rotateZMatrix.m[0][1] = sinZ;
+	rotateZMatrix.m[1][0] = -sinZ;
+	rotateZMatrix.m[1][1] = cosZ;
+	rotateZMatrix.m[2][2] = 1;
+	rotateZMatrix.m[3][3] = 1;
+
 	Matrix4x4 rotateXYZMatrix = Multiply(rotateXMatrix, Multiply(rotateYMatrix, rotateZMatrix));
 
 	Matrix4x4 result = {};
@@ -174,7 +254,6 @@ Matrix4x4 MakePerspectiveMatrix(float fovY, float aspectRatio, float nearClip, f
 	return result;
 }
 
-
 Matrix4x4 Inverse(const Matrix4x4& m) {
 	float A;
 	A = m.m[0][0] * m.m[1][1] * m.m[2][2] * m.m[3][3] + m.m[0][0] * m.m[1][2] * m.m[2][3] * m.m[3][1] + m.m[0][0] * m.m[1][3] * m.m[2][1] * m.m[3][2] - m.m[0][0] * m.m[1][3] * m.m[2][2] * m.m[3][1] -
@@ -253,20 +332,36 @@ Matrix4x4 Inverse(const Matrix4x4& m) {
 	return m2;
 }
 
-int MT::GetRand(int max) {
-	// 乱数生成器（メルセンヌ・ツイスター）
-	// staticを付けて、関数が呼ばれるたびに初期化されないようにする
-	static std::random_device rd;
-	static std::mt19937 gen(rd());
-
-	// 0からmaxまでの整数を一様に分布させる
-	std::uniform_int_distribution<> distrib(0, max);
-
-	return distrib(gen);
+Matrix4x4 InverseRigid(const Matrix4x4& m) {
+	// 回転部分は転置、平行移動は -t * R^T
+	Matrix4x4 result = {};
+	for (int i = 0; i < 3; ++i) {
+		for (int j = 0; j < 3; ++j) {
+			result.m[i][j] = m.m[j][i];
+		}
+	}
+	for (int j = 0; j < 3; ++j) {
+		result.m[3][j] = -(m.m[3][0] * m.m[j][0] + m.m[3][1] * m.m[j][1] + m.m[3][2] * m.m[j][2]);
+	}
+	result.m[3][3] = 1.0f;
+	return result;
 }
 
-// 0からRAND_MAXまでのランダムな整数を返す
-int MT::GetRand() {
-	// 上の関数を呼び出す
-	return GetRand(RAND_MAX);
-}
\ No newline at end of file
+Matrix4x4 LerpMatrix(const Matrix4x4& m1, const Matrix4x4& m2, float t) {
+	Matrix4x4 result;
+#ifdef MT_SSE2
+	__m128 factor = _mm_set1_ps(t);
+	for (int i = 0; i < 4; ++i) {
+		__m128 a = _mm_loadu_ps(m1.m[i]);
+		__m128 b = _mm_loadu_ps(m2.m[i]);
+		_mm_storeu_ps(result.m[i], _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), factor)));
+	}
+#else
+	for (int i = 0; i < 4; ++i) {
+		for (int j = 0; j < 4; ++j) {
+			result.m[i][j] = m1.m[i][j] + (m2.m[i][j] - m1.m[i][j]) * t;
+		}
+	}
+#endif
+	return result;
+}
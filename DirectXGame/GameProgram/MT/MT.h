@@ -2,9 +2,15 @@
 #include <assert.h>
 #include <cmath>
 #include <stdio.h>
-#include <KamataEngine.h>
+#include <math/Matrix4x4.h>
+#include <math/Vector2.h>
+#include <math/Vector3.h>
+#include <math/Vector4.h>
 using namespace KamataEngine;
 
+// 円周率 (KamataEngine::MathUtility::PI と同じ値)
+const float kPI = 3.141592654f;
+
 Matrix4x4 MakeRotateXMatrix(float radian);
 
 Matrix4x4 MakeRotateYMatrix(float radian);
@@ -15,9 +21,13 @@ Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2);
 
 Vector3 Normalize(const Vector3& v);
 
+float Length(const Vector3& v);
+
 Matrix4x4 MakeScaleMatrix(const Vector3& scale);
 
 Vector3 Transform(const Vector3& vector, const Matrix4x4& matrix);
+// ベクトル変換（平行移動なし）
+Vector3 TransformNormal(const Vector3& vector, const Matrix4x4& matrix);
 Matrix4x4 MakeTranslateMatrix(const Vector3& translate);
 Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Vector3& rotate, const Vector3& translate);
 
@@ -30,12 +40,8 @@ Matrix4x4 MakeViewportMatrix(float left, float top, float width, float height, f
 Matrix4x4 MakePerspectiveMatrix(float fovY, float aspectRatio, float nearClip, float farClip);
 
 Matrix4x4 Inverse(const Matrix4x4& m);
+// 回転と平行移動だけの行列 (拡大縮小なし) の逆行列。カメラのワールド行列からビュー行列を作る用途
+Matrix4x4 InverseRigid(const Matrix4x4& m);
 
-class MT {
-public:
-
-static int GetRand();
-
-static int GetRand(int max);
-
-};
\ No newline at end of file
+// 行列の成分ごとの線形補間 (1ステップ分の小さな変化を補間する用途)
+Matrix4x4 LerpMatrix(const Matrix4x4& m1, const Matrix4x4& m2, float t);
@@ -1,5 +1,6 @@
 #pragma once
-#include "KamataEngine.h"
+#include <math/Matrix4x4.h>
+#include <math/Vector3.h>
 #include <cmath>
 
 namespace KamataEngine {
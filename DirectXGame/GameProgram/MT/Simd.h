@@ -0,0 +1,16 @@
+#pragma once
+#include <cstddef>
+
+// SIMD でまとめて計算するための共通の設定
+// x64 では SSE2 が必ず使えるので、MT_SSE2 を定義して <emmintrin.h> の命令で 4 要素ずつ計算する
+// MT_SSE2 が無いときは、それぞれのスカラー版を使う
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define MT_SSE2
+#endif
+
+// SIMD で一度に計算する要素の数 (__m128 の float の数)
+inline constexpr size_t kSimdLanes = 4;
+
+// SoA の配列の長さを kSimdLanes の倍数に切り上げる (端の 4 個に満たない分もまとめて計算できるようにする)
+constexpr size_t RoundUpToLanes(size_t count) { return (count + kSimdLanes - 1) / kSimdLanes * kSimdLanes; }
@@ -1,9 +1,8 @@
 #include "Meteorite.h"
 #include <cassert>
+#include <cmath>
 
-void Meteorite::Initialize(KamataEngine::Model* model, const KamataEngine::Vector3& pos, float baseScale, float radius) {
-	assert(model);
-	model_ = model;
+void Meteorite::Initialize(const KamataEngine::Vector3& pos, float baseScale, float radius) {
 	radius_ = radius;
 	baseScale_ = baseScale;
 
@@ -37,9 +36,8 @@ void Meteorite::Update(const KamataEngine::Vector3& playerPos) {
 		scaleFactor = kMinScaleFactor + (easedT * (kMaxScaleFactor - kMinScaleFactor));
 
 	} else {
-		// kMaxDistanceより遠い場合は見えない
+		// kMaxDistanceより遠い場合は見えない (消すのは MeteoriteField がカメラからの距離で行う)
 		scaleFactor = 0.0f;
-		isDead_ = true;
 	}
 
 	float finalScale = baseScale_ * scaleFactor;
@@ -48,12 +46,6 @@ void Meteorite::Update(const KamataEngine::Vector3& playerPos) {
 	worldtransfrom_.UpdateMatrix();
 }
 
-void Meteorite::Draw(const KamataEngine::Camera& camera) {
-	if (model_ && !isDead_) {
-		model_->Draw(worldtransfrom_, camera);
-	}
-}
-
 void Meteorite::OnCollision() {
 	isDead_ = true;
 }
@@ -1,19 +1,15 @@
 #pragma once
-#include "3d/Model.h"
-#include "3d/WorldTransform.h"
-#include <3d/Camera.h>
-#include <KamataEngine.h>
+#include "SimTransform.h"
+#include <math/Vector3.h>
 
 class Meteorite {
 public:
 	Meteorite() = default;
 	~Meteorite() = default;
 
-	void Initialize(KamataEngine::Model* model, const KamataEngine::Vector3& pos, float baseScale, float radius); /// @brief 更新処理
+	void Initialize(const KamataEngine::Vector3& pos, float baseScale, float radius); /// @brief 更新処理
 	void Update(const KamataEngine::Vector3& playerPos);
 
-	void Draw(const KamataEngine::Camera& camera);
-
 	void OnCollision();
 
 	float GetRadius() const { return radius_; }
@@ -22,9 +18,13 @@ public:
 
 	KamataEngine::Vector3 GetWorldPosition() const;
 
+	const KamataEngine::Matrix4x4& GetWorldMatrix() const { return worldtransfrom_.matWorld_; }
+	// 描画の補間用: ステップ開始時の行列を保存する
+	void SavePreviousTransform() { worldtransfrom_.SavePrevious(); }
+	KamataEngine::Matrix4x4 GetInterpolatedMatrix(float alpha) const { return worldtransfrom_.GetInterpolatedMatrix(alpha); }
+
 private:
-	KamataEngine::Model* model_ = nullptr;
-	KamataEngine::WorldTransform worldtransfrom_;
+	SimTransform worldtransfrom_;
 	KamataEngine::Vector3 velocity_ = {0.0f, 0.0f, 0.0f};
 	float radius_ = 1.0f;
 	float baseScale_ = 1.0f;
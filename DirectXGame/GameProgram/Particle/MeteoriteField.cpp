@@ -0,0 +1,91 @@
+#include "MeteoriteField.h"
+#include "JobSystem.h"
+#include "MT.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cmath>
+
+MeteoriteField::MeteoriteField() { Reserve(kMaxMeteorites, kDensityTarget); }
+
+void MeteoriteField::Reserve(size_t capacity, size_t densityTarget) {
+	Clear();
+	pool_.Reserve(capacity);
+	proxies_.assign(capacity, DynamicAABBTree<Meteorite*>::kNull);
+	meteorites_.reserve(capacity);
+	densityTarget_ = std::min(densityTarget, capacity);
+}
+
+void MeteoriteField::Clear() {
+	for (Meteorite* meteor : meteorites_) {
+		Release(meteor);
+	}
+	meteorites_.clear();
+}
+
+void MeteoriteField::Release(Meteorite* meteor) {
+	int32_t& proxy = proxies_[pool_.IndexOf(meteor)];
+	tree_.DestroyProxy(proxy);
+	proxy = DynamicAABBTree<Meteorite*>::kNull;
+	pool_.Release(meteor);
+}
+
+void MeteoriteField::Update(const KamataEngine::Vector3& cameraPos, const KamataEngine::Vector3& playerPos, JobSystem* jobs) {
+	PROFILE_ZONE("MeteoriteField::Update");
+
+	// カメラから離れた隕石と当たって壊れた隕石をプールに戻す
+	const float kDespawnDistanceSq = kDespawnDistance * kDespawnDistance;
+	std::erase_if(meteorites_, [this, &cameraPos, kDespawnDistanceSq](Meteorite* meteor) {
+		KamataEngine::Vector3 pos = meteor->GetWorldPosition();
+		float dx = pos.x - cameraPos.x;
+		float dy = pos.y - cameraPos.y;
+		float dz = pos.z - cameraPos.z;
+		if (meteor->IsDead() || dx * dx + dy * dy + dz * dz > kDespawnDistanceSq) {
+			Release(meteor);
+			return true;
+		}
+		return false;
+	});
+
+	// 空いたスロットを同じステップで使い、密度の目標まで補充する
+	for (size_t i = 0; i < kMaxSpawnsPerStep && meteorites_.size() < densityTarget_; ++i) {
+		Spawn(cameraPos);
+	}
+
+	// Playerの位置を渡して更新（近づくと大きくなる処理のため）
+	// 出し入れは済んでいて、隕石は自分の行列だけを書き換えるので並列にしてよい
+	ParallelFor(jobs, meteorites_.size(), kUpdateGrain, [this, &playerPos](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			meteorites_[i]->Update(playerPos);
+		}
+	});
+}
+
+void MeteoriteField::SavePreviousTransforms() {
+	for (Meteorite* meteor : meteorites_) {
+		meteor->SavePreviousTransform();
+	}
+}
+
+void MeteoriteField::Spawn(const KamataEngine::Vector3& cameraPos) {
+	Meteorite* newMeteor = pool_.Acquire();
+	if (!newMeteor) {
+		return;
+	}
+
+	// 球面上に一様に散らす
+	KamataEngine::Vector3 randomDir = random_.UnitVector();
+
+	KamataEngine::Vector3 spawnPos = cameraPos + randomDir * kSpawnDistance;
+
+	// スケールと半径をランダム
+	const float kBaseRadius = 2.0f;
+	const float kMinScale = 1.0f;
+	const float kMaxScale = 5.0f;
+
+	float randFactor = random_.NextFloat();
+	float randomBaseScale = kMinScale + (randFactor * (kMaxScale - kMinScale));
+	float randomRadius = kBaseRadius * randomBaseScale;
+	newMeteor->Initialize(spawnPos, randomBaseScale, randomRadius);
+	proxies_[pool_.IndexOf(newMeteor)] = tree_.CreateProxy(MakeAABB(spawnPos, randomRadius), newMeteor);
+	meteorites_.push_back(newMeteor);
+}
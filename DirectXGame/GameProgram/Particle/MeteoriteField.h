@@ -0,0 +1,78 @@
+#pragma once
+#include "DynamicAABBTree.h"
+#include "Meteorite.h"
+#include "ObjectPool.h"
+#include "RandomStream.h"
+#include <vector>
+
+class JobSystem;
+
+/// <summary>
+/// カメラの周りの隕石群
+/// 決まった数 (kMaxMeteorites) のプールから出し入れし、カメラから離れた隕石は同じステップで新しい隕石に使い回す
+/// 数が密度の目標 (kDensityTarget) に足りない分だけカメラから kSpawnDistance の球面上に出すので、
+/// ゲームの長さによらずメモリと更新・描画の負荷は一定になる
+/// 隕石は動かないので、出したときに AABB 木に入れ、消すときに抜くだけで当たり判定の検索に使える
+/// </summary>
+class MeteoriteField {
+public:
+	// 同時に存在できる隕石の上限
+	static const size_t kMaxMeteorites = 512;
+	// カメラの周りに保つ隕石の数
+	static const size_t kDensityTarget = 400;
+	// 1ステップに出す最大数 (一度に湧かないように少しずつ補充する)
+	static const size_t kMaxSpawnsPerStep = 2;
+	// 大きさの更新を並列にするときの 1 ジョブの隕石の数
+	static const size_t kUpdateGrain = 128;
+
+	// この距離 (カメラから) の球面上に出す。自機からこの距離で大きさが 0 になるので、遠くで急に現れることはない
+	static inline const float kSpawnDistance = 800.0f;
+	// カメラからこの距離より離れた隕石は消して使い回す
+	static inline const float kDespawnDistance = 850.0f;
+
+	MeteoriteField();
+
+	/// <summary>
+	/// 上限と密度の目標を変える (全隕石を消す)
+	/// </summary>
+	void Reserve(size_t capacity, size_t densityTarget);
+
+	// 全隕石を消す
+	void Clear();
+
+	// 出す位置と大きさに使う乱数列
+	void SetRandom(const RandomStream& random) { random_ = random; }
+
+	/// <summary>
+	/// 1ステップ分の更新
+	/// 離れた隕石を消し、足りない分を出し、自機との距離で大きさを更新する
+	/// </summary>
+	/// <param name="cameraPos">出現・消滅の中心 (レールカメラの位置)</param>
+	/// <param name="playerPos">大きさを決める基準 (自機の位置)</param>
+	/// <param name="jobs">大きさの更新を並列にする (null なら呼び出したスレッドだけで更新する)</param>
+	void Update(const KamataEngine::Vector3& cameraPos, const KamataEngine::Vector3& playerPos, JobSystem* jobs = nullptr);
+
+	// 描画の補間用: ステップ開始時の行列を保存する
+	void SavePreviousTransforms();
+
+	const std::vector<Meteorite*>& GetMeteorites() const { return meteorites_; }
+	const ObjectPool<Meteorite>& GetPool() const { return pool_; }
+	// 使用中の隕石の AABB 木 (箱は中心 ± 当たり判定の半径)
+	const DynamicAABBTree<Meteorite*>& GetTree() const { return tree_; }
+
+private:
+	// カメラの周りの球面上に 1 つ出す (満杯なら何もしない)
+	void Spawn(const KamataEngine::Vector3& cameraPos);
+	// 木から抜いてプールに戻す
+	void Release(Meteorite* meteor);
+
+	ObjectPool<Meteorite> pool_;
+	// 動かないので余白は要らない
+	DynamicAABBTree<Meteorite*> tree_{0.0f};
+	// プールのインデックスごとの木の葉の番号
+	std::vector<int32_t> proxies_;
+	// 使用中の隕石
+	std::vector<Meteorite*> meteorites_;
+	size_t densityTarget_ = kDensityTarget;
+	RandomStream random_;
+};
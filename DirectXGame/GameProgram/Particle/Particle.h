@@ -1,15 +1,10 @@
 #pragma once
-#include <KamataEngine.h>
+#include <math/Vector3.h>
+#include <math/Vector4.h>
 
-struct Particle {
-	KamataEngine::WorldTransform worldTransform_;
-	KamataEngine::Vector3 velocity_;             
-	KamataEngine::Vector4 color_;                                  
-	bool isActive_ = false;
-	uint32_t lifeTime_ = 100;
-	uint32_t currentTime_ = 0;
-
-	float startScale_ = 1.0f;
-	float endScale_ = 0.0f;
-	bool isExplosion_ = false;
-};
\ No newline at end of file
+// 描画に渡すパーティクル 1 個分 (パーティクルは回転しないので 位置・大きさ・色 だけ)
+struct ParticleInstance {
+	KamataEngine::Vector3 position = {0.0f, 0.0f, 0.0f};
+	float scale = 1.0f;
+	KamataEngine::Vector4 color = {1.0f, 1.0f, 1.0f, 1.0f};
+};
@@ -1,70 +1,123 @@
 #include "ParticleEmitter.h"
+#include "JobSystem.h"
 #include "MT.h"
+#include "Simd.h"
 #include <algorithm>
-#include <KamataEngine.h>
+#include <cmath>
 
-void ParticleEmitter::Initialize(KamataEngine::Model* model) {
-	model_ = model;
-	particles_.resize(100);
-	frequency_ = 1; // 発生頻度
-	frequencyTimer_ = 0;
-}
-
-void ParticleEmitter::Update() {
-	//particles_.remove_if([](Particle& particle) { return !particle.isActive_; });
-
-	for (Particle& particle : particles_) {
-		if (particle.isActive_) {
-			particle.currentTime_++;
-			if (particle.currentTime_ >= particle.lifeTime_) {
-				particle.isActive_ = false;
-				continue;
-			}
+namespace {
 
-			particle.worldTransform_.translation_ += particle.velocity_;
+// 排気の大きさ (寿命の間ずっと同じ)
+const float kExhaustScale = 0.3f;
 
-			if (particle.isExplosion_) {
-				// 1. (爆発用) だんだん小さくなる処理
-				float t = (float)particle.currentTime_ / (float)particle.lifeTime_;
-				t = std::clamp(t, 0.0f, 1.0f); // t を 0.0f～1.0f に制限
-				float scale = particle.startScale_ + (particle.endScale_ - particle.startScale_) * t;
-				particle.worldTransform_.scale_ = {scale, scale, scale};
+} // namespace
 
-			} else {
-				// 2. (排気用) 既存のロジック (一切変更しない)
-				float scale = 0.3f;
-				particle.worldTransform_.scale_ = {scale, scale, scale};
-			}
+void ParticleEmitter::Initialize(size_t capacity) {
+	capacity_ = capacity;
+	// SIMD の幅で端数が出ないように、配列は幅の倍数の長さにする
+	size_t padded = RoundUpToLanes(capacity);
+	for (std::vector<float>* array : {&posX_, &posY_, &posZ_, &prevX_, &prevY_, &prevZ_, &velX_, &velY_, &velZ_, &scale_, &prevScale_, &startScale_, &endScale_, &age_, &life_}) {
+		array->assign(padded, 0.0f);
+	}
+	frequency_ = 1; // 発生頻度
+	Clear();
+}
 
-			// ▲▲▲ 分岐終了 ▲▲▲
+void ParticleEmitter::Update(JobSystem* jobs) {
+	size_t rangeCount = (activeEnd_ + kUpdateGrain - 1) / kUpdateGrain;
+	if (expiredByRange_.size() < rangeCount) {
+		expiredByRange_.resize(rangeCount);
+	}
 
-			particle.worldTransform_.UpdateMatrix();
-		}
+	// 範囲ごとに進めて、空いたスロットは後から範囲の順に戻す (スレッド数によらず同じ順番になる)
+	ParallelFor(jobs, activeEnd_, kUpdateGrain, [this](size_t begin, size_t end) {
+		std::vector<uint32_t>& expired = expiredByRange_[begin / kUpdateGrain];
+		expired.clear();
+		UpdateRange(begin, end, expired);
+	});
+	for (size_t range = 0; range < rangeCount; ++range) {
+		const std::vector<uint32_t>& expired = expiredByRange_[range];
+		freeSlots_.insert(freeSlots_.end(), expired.begin(), expired.end());
+		activeCount_ -= expired.size();
 	}
 }
 
-void ParticleEmitter::Draw(const KamataEngine::Camera& camera) {
-	// Guard: model_ must be valid and there must be particles
-	if (!model_) {
-		return;
+void ParticleEmitter::UpdateRange(size_t begin, size_t end, std::vector<uint32_t>& expired) {
+	size_t i = begin;
+#ifdef MT_SSE2
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	for (; i < end; i += kSimdLanes) {
+		__m128 life = _mm_loadu_ps(&life_[i]);
+		__m128 alive = _mm_cmpgt_ps(life, zero);
+		__m128 age = _mm_add_ps(_mm_loadu_ps(&age_[i]), _mm_and_ps(alive, one));
+
+		// 寿命が尽きたものは動かさずに空きに戻す
+		__m128 dead = _mm_and_ps(alive, _mm_cmpge_ps(age, life));
+		__m128 live = _mm_andnot_ps(dead, alive);
+		_mm_storeu_ps(&age_[i], age);
+		_mm_storeu_ps(&life_[i], _mm_andnot_ps(dead, life));
+
+		_mm_storeu_ps(&posX_[i], _mm_add_ps(_mm_loadu_ps(&posX_[i]), _mm_and_ps(live, _mm_loadu_ps(&velX_[i]))));
+		_mm_storeu_ps(&posY_[i], _mm_add_ps(_mm_loadu_ps(&posY_[i]), _mm_and_ps(live, _mm_loadu_ps(&velY_[i]))));
+		_mm_storeu_ps(&posZ_[i], _mm_add_ps(_mm_loadu_ps(&posZ_[i]), _mm_and_ps(live, _mm_loadu_ps(&velZ_[i]))));
+
+		// だんだん大きさを変える (t は 0〜1)
+		__m128 safeLife = _mm_or_ps(_mm_and_ps(live, life), _mm_andnot_ps(live, one));
+		__m128 t = _mm_min_ps(_mm_div_ps(age, safeLife), one);
+		__m128 start = _mm_loadu_ps(&startScale_[i]);
+		__m128 scale = _mm_add_ps(start, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&endScale_[i]), start), t));
+		_mm_storeu_ps(&scale_[i], _mm_or_ps(_mm_and_ps(live, scale), _mm_andnot_ps(live, _mm_loadu_ps(&scale_[i]))));
+
+		int mask = _mm_movemask_ps(dead);
+		for (size_t lane = 0; mask != 0; ++lane, mask >>= 1) {
+			if (mask & 1) {
+				expired.push_back(static_cast<uint32_t>(i + lane));
+			}
+		}
 	}
+#endif
+	// SSE2 が無ければ全部
+	for (; i < end; ++i) {
+		if (life_[i] <= 0.0f) {
+			continue;
+		}
+		age_[i] += 1.0f;
+		if (age_[i] >= life_[i]) {
+			life_[i] = 0.0f;
+			expired.push_back(static_cast<uint32_t>(i));
+			continue;
+		}
 
-	// Ensure a valid command list is active (Model::PreDraw must have been called)
-	auto dx = KamataEngine::DirectXCommon::GetInstance();
-	if (!dx) return;
-	ID3D12GraphicsCommandList* cmdList = dx->GetCommandList();
-	if (!cmdList) {
-		// No active command list -> cannot draw models now
-		return;
+		posX_[i] += velX_[i];
+		posY_[i] += velY_[i];
+		posZ_[i] += velZ_[i];
+
+		float t = std::min(age_[i] / life_[i], 1.0f);
+		scale_[i] = startScale_[i] + (endScale_[i] - startScale_[i]) * t;
 	}
+}
 
-	for (Particle& particle : particles_) {
-		if (particle.isActive_) {
-			model_->Draw(particle.worldTransform_, camera);
+void ParticleEmitter::CollectInstances(std::vector<ParticleInstance>& out, float alpha) const {
+	for (size_t i = 0; i < activeEnd_; ++i) {
+		if (life_[i] <= 0.0f) {
+			continue;
 		}
+		ParticleInstance instance;
+		instance.position = {prevX_[i] + (posX_[i] - prevX_[i]) * alpha, prevY_[i] + (posY_[i] - prevY_[i]) * alpha, prevZ_[i] + (posZ_[i] - prevZ_[i]) * alpha};
+		instance.scale = prevScale_[i] + (scale_[i] - prevScale_[i]) * alpha;
+		instance.color = color_;
+		out.push_back(instance);
 	}
 }
 
+void ParticleEmitter::SavePreviousTransforms() {
+	std::copy(posX_.begin(), posX_.begin() + activeEnd_, prevX_.begin());
+	std::copy(posY_.begin(), posY_.begin() + activeEnd_, prevY_.begin());
+	std::copy(posZ_.begin(), posZ_.begin() + activeEnd_, prevZ_.begin());
+	std::copy(scale_.begin(), scale_.begin() + activeEnd_, prevScale_.begin());
+}
+
 void ParticleEmitter::Emit(const KamataEngine::Vector3& position, const KamataEngine::Vector3& velocity) {
 	frequencyTimer_++;
 	if (frequencyTimer_ >= frequency_) {
@@ -72,78 +125,64 @@ void ParticleEmitter::Emit(const KamataEngine::Vector3& position, const KamataEn
 		// 一回の発生のパーティクル数
 		const int particlesToEmit = 4;
 
-		for (int i = 0; i < particlesToEmit; ++i) {
-			CreateParticle(position, velocity);
+		for (int i = 0; i < particlesToEmit && !freeSlots_.empty(); ++i) {
+			// 少しだけランダムなばらつきを加える
+			KamataEngine::Vector3 randomVelocity = {(random_.NextFloat() - 0.8f) * 0.1f, (random_.NextFloat() - 0.5f) * 0.1f, (random_.NextFloat() - 0.5f) * 0.1f};
+			float lifeTime = static_cast<float>(random_.RangeInt(3, 5));
+			Spawn(position, velocity + randomVelocity, lifeTime, kExhaustScale, kExhaustScale);
 		}
 
 		frequencyTimer_ = 0;
 	}
 }
-void ParticleEmitter::CreateParticle(const KamataEngine::Vector3& position, const KamataEngine::Vector3& velocity) {
-	for (Particle& particle : particles_) {
-		if (!particle.isActive_) {
-			particle.isActive_ = true;
-			particle.worldTransform_.translation_ = position;
-			particle.worldTransform_.Initialize();
-
-			// 少しだけランダムなばらつきを加える
-			KamataEngine::Vector3 randomVelocity = {(MT::GetRand() / (float)RAND_MAX - 0.8f) * 0.1f, (MT::GetRand() / (float)RAND_MAX - 0.5f) * 0.1f, (MT::GetRand() / (float)RAND_MAX - 0.5f) * 0.1f};
-			particle.velocity_ = velocity + randomVelocity;
-
-			particle.lifeTime_ = 3 + MT::GetRand() % 3;
-			particle.currentTime_ = 0;
-
-			// Reuse safety: ensure this particle is treated as exhaust (not explosion)
-			particle.isExplosion_ = false;
-			particle.startScale_ = 1.0f;
-			particle.endScale_ = 0.0f;
-
-			return;
-		}
-	}
-}
 
 void ParticleEmitter::Clear() {
-	for (Particle& particle : particles_) {
-		particle.isActive_ = false;
+	std::fill(life_.begin(), life_.end(), 0.0f);
+	activeCount_ = 0;
+	activeEnd_ = 0;
+	// 小さい番号から使うように積む
+	freeSlots_.clear();
+	for (size_t slot = capacity_; slot > 0; --slot) {
+		freeSlots_.push_back(static_cast<uint32_t>(slot - 1));
 	}
 	frequencyTimer_ = 0;
 }
 
 void ParticleEmitter::EmitBurst(const KamataEngine::Vector3& position, int numParticles, float speed, float lifeTime, float startScale, float endScale) {
-	for (int i = 0; i < numParticles; ++i) {
+	if (numParticles <= 0) {
+		return;
+	}
 
-		// (※ MT::GetRand() がなければ std::rand() に変更)
-		KamataEngine::Vector3 velocity = {
-		    (MT::GetRand() / (float)RAND_MAX * 2.0f - 1.0f), // -1.0f ～ 1.0f
-		    (MT::GetRand() / (float)RAND_MAX * 2.0f - 1.0f), (MT::GetRand() / (float)RAND_MAX * 2.0f - 1.0f)};
-		velocity = KamataEngine::MathUtility::Normalize(velocity);
-		velocity = velocity * speed;
+	// 全方向に均等に飛ばす向きをまとめて作る
+	burstDirections_.resize(static_cast<size_t>(numParticles));
+	random_.FillUnitVectors(burstDirections_.data(), burstDirections_.size());
 
-		CreateExplosionParticle(position, velocity, lifeTime, startScale, endScale);
+	// 寿命はフレーム数 (端数は切り捨て、最低 1)
+	float lifeFrames = std::floor(std::fmax(1.0f, lifeTime));
+	for (const KamataEngine::Vector3& direction : burstDirections_) {
+		Spawn(position, direction * speed, lifeFrames, startScale, endScale);
 	}
 }
 
-
-void ParticleEmitter::CreateExplosionParticle(const KamataEngine::Vector3& position, const KamataEngine::Vector3& velocity, float lifeTime, float startScale, float endScale) {
-
-	// リスト内の非アクティブなパーティクルを探して再利用する
-	for (Particle& particle : particles_) {
-		if (!particle.isActive_) {
-			particle.isActive_ = true;
-			particle.worldTransform_.translation_ = position;
-			particle.worldTransform_.Initialize();
-
-			particle.velocity_ = velocity;
-			particle.currentTime_ = 0;
-
-			// (排気用とは違うロジック)
-			particle.lifeTime_ = static_cast<uint32_t>(std::fmax(1.0f, lifeTime));
-			particle.startScale_ = startScale;
-			particle.endScale_ = endScale;
-			particle.isExplosion_ = true; // ★ 爆発フラグを立てる
-
-			return; // 1つ生成したら終了
-		}
+void ParticleEmitter::Spawn(const KamataEngine::Vector3& position, const KamataEngine::Vector3& velocity, float lifeTime, float startScale, float endScale) {
+	if (freeSlots_.empty()) {
+		return;
 	}
-}
\ No newline at end of file
+	uint32_t slot = freeSlots_.back();
+	freeSlots_.pop_back();
+	++activeCount_;
+	activeEnd_ = std::max(activeEnd_, RoundUpToLanes(static_cast<size_t>(slot) + 1));
+
+	// 出した位置から補間する
+	posX_[slot] = prevX_[slot] = position.x;
+	posY_[slot] = prevY_[slot] = position.y;
+	posZ_[slot] = prevZ_[slot] = position.z;
+	velX_[slot] = velocity.x;
+	velY_[slot] = velocity.y;
+	velZ_[slot] = velocity.z;
+	scale_[slot] = prevScale_[slot] = startScale;
+	startScale_[slot] = startScale;
+	endScale_[slot] = endScale;
+	age_[slot] = 0.0f;
+	life_[slot] = lifeTime;
+}
@@ -1,25 +1,75 @@
 #pragma once
-#include "3d/Camera.h"
-#include "3d/Model.h"
 #include "Particle.h"
-#include <list>
+#include "RandomStream.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
 
+class JobSystem;
+
+/// <summary>
+/// パーティクルの発生と更新
+/// 位置・速度・大きさ・経過時間を成分ごとの配列 (SoA) で持ち、全スロットの更新を SSE2 で 4 個ずつ進める
+/// 空きスロットは free list (後に空いたものから使う) で持つので、出すのも消すのも O(1)
+/// 更新は kUpdateGrain 個ずつの範囲に分けて並列にでき、寿命が尽きたスロットは範囲ごとに集めて後から free list に戻す
+/// 描画には 位置・大きさ・色 だけの ParticleInstance の並びを渡す
+/// </summary>
 class ParticleEmitter {
 public:
-	void Initialize(KamataEngine::Model* model);
-	void Update();
-	void Draw(const KamataEngine::Camera& camera);
+	// 並列に更新する範囲の大きさ (SIMD の幅の倍数)
+	static const size_t kUpdateGrain = 1024;
+
+	// capacity は同時に出せるパーティクルの最大数 (全パーティクルを消す)
+	void Initialize(size_t capacity = 100);
+	// jobs が null なら呼び出したスレッドだけで更新する (結果は同じ)
+	void Update(JobSystem* jobs = nullptr);
+	// 有効なパーティクルを描画用に書き出す
+	// alpha は前のステップとの補間係数 (1 で現在の位置・大きさ)
+	void CollectInstances(std::vector<ParticleInstance>& out, float alpha = 1.0f) const;
+	// 描画の補間用: ステップ開始時の位置と大きさを保存する
+	void SavePreviousTransforms();
 	void Emit(const KamataEngine::Vector3& position, const KamataEngine::Vector3& velocity);
 	void Clear();
 	void EmitBurst(const KamataEngine::Vector3& position, int numParticles, float speed, float lifeTime, float startScale, float endScale);
+	// 速度のばらつきと寿命に使う乱数列
+	void SetRandom(const RandomStream& random) { random_ = random; }
+	// 描画するときの色 (このエミッタのパーティクル全部に使う)
+	void SetColor(const KamataEngine::Vector4& color) { color_ = color; }
+
+	size_t GetCapacity() const { return capacity_; }
+	size_t GetActiveCount() const { return activeCount_; }
 
 private:
-	void CreateParticle(const KamataEngine::Vector3& position, const KamataEngine::Vector3& velocity);
-	void CreateExplosionParticle(const KamataEngine::Vector3& position, const KamataEngine::Vector3& velocity, float lifeTime, float startScale, float endScale);
+	// 空きスロットを 1 つ取って使い始める (満杯なら何もしない)
+	// 大きさは 経過時間 / 寿命 に合わせて startScale から endScale へ変わる
+	void Spawn(const KamataEngine::Vector3& position, const KamataEngine::Vector3& velocity, float lifeTime, float startScale, float endScale);
+	// [begin, end) を 1 フレーム進め、寿命が尽きたスロットを expired に追加する
+	void UpdateRange(size_t begin, size_t end, std::vector<uint32_t>& expired);
+
+	size_t capacity_ = 0;
+	size_t activeCount_ = 0;
+	// 一度でも使ったスロットの末尾 (SIMD の幅に切り上げる)。Update はここまで回す
+	size_t activeEnd_ = 0;
+	// 空きスロット (末尾から取り出す)
+	std::vector<uint32_t> freeSlots_;
+	// Update の範囲ごとの寿命が尽きたスロット (範囲の順に free list に戻す)
+	std::vector<std::vector<uint32_t>> expiredByRange_;
+
+	// 使っていないスロットは寿命 0
+	std::vector<float> posX_, posY_, posZ_;
+	std::vector<float> prevX_, prevY_, prevZ_;
+	std::vector<float> velX_, velY_, velZ_;
+	std::vector<float> scale_, prevScale_;
+	std::vector<float> startScale_, endScale_;
+	// 経過フレーム数と寿命 (フレーム数)
+	std::vector<float> age_, life_;
 
-	KamataEngine::Model* model_ = nullptr;
-	std::list<Particle> particles_;
 	// ヘッダ内で初期化
 	int32_t frequency_ = 1;
 	int32_t frequencyTimer_ = 0;
-};
\ No newline at end of file
+
+	KamataEngine::Vector4 color_ = {1.0f, 1.0f, 1.0f, 1.0f};
+	RandomStream random_;
+	// EmitBurst で飛ばす向き (容量は使い回す)
+	std::vector<KamataEngine::Vector3> burstDirections_;
+};
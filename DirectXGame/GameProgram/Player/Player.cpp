@@ -1,42 +1,28 @@
 #include "Player.h"
 #include "Enemy.h"
+#include "GameWorld.h"
 #include "RailCamera.h"
+#include "ScreenProjection.h"
+#include "SimClock.h"
 #include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <limits>
-// For window size constants
-#include "base/WinApp.h"
-#include <Windows.h>
-#include <cstdio>
 #include <vector>
 
 Player::~Player() {
-	delete modelbullet_;
-	delete modelParticle_;
 	delete engineExhaust_;
-	for (PlayerBullet* bullet : bullets_) {
-		delete bullet;
-	}
 }
 
-void Player::Initialize(KamataEngine::Model* model, KamataEngine::Camera* camera, const KamataEngine::Vector3& pos) {
-	assert(model);
-	model_ = model;
-	camera_ = camera;
-	modelbullet_ = KamataEngine::Model::CreateFromOBJ("Bullet", true);
+void Player::Initialize(const KamataEngine::Vector3& pos, const SimInput* input) {
+	assert(input);
+	input_ = input;
 	worldtransfrom_.translation_ = pos;
-	input_ = KamataEngine::Input::GetInstance();
-	audio_ = KamataEngine::Audio::GetInstance();
-	if (audio_)
-		hitPlayerSoundHandle_ = audio_->LoadWave("./sound/parry.wav");
-
 
 	worldtransfrom_.Initialize();
 
-	modelParticle_ = KamataEngine::Model::CreateFromOBJ("flare", true);
 	engineExhaust_ = new ParticleEmitter();
-	engineExhaust_->Initialize(modelParticle_);
+	engineExhaust_->Initialize();
 
 	hp_ = 3;
 	isDead_ = false;
@@ -69,12 +55,11 @@ void Player::Attack() {
 	// これGameScene始まるまで撃たせないようにするやつ
 	specialTimer--;
 	if (specialTimer < 0) {
-		if (input_->PushKey(DIK_SPACE) && shotTimer_ <= 0) {
+		if (input_->PushKey(SimKey::Space) && shotTimer_ <= 0) {
 			assert(railCamera_);
 
 			// --- 弾発生位置の計算 ---
-			// ワールド行列が最新であることを保証
-			worldtransfrom_.UpdateMatrix();
+			// ワールド行列は Update で Attack の直前に作ったものを使う
 
 			// プレイヤーのワールド位置とローカル軸を取得してスポーン位置を計算する
 			KamataEngine::Vector3 playerWorldPos = GetWorldPosition();
@@ -82,9 +67,9 @@ void Player::Attack() {
 			KamataEngine::Vector3 localForward = {wm.m[2][0], wm.m[2][1], wm.m[2][2]};
 			KamataEngine::Vector3 localRight = {wm.m[0][0], wm.m[0][1], wm.m[0][2]};
 			KamataEngine::Vector3 localUp = {wm.m[1][0], wm.m[1][1], wm.m[1][2]};
-			localForward = KamataEngine::MathUtility::Normalize(localForward);
-			localRight = KamataEngine::MathUtility::Normalize(localRight);
-			localUp = KamataEngine::MathUtility::Normalize(localUp);
+			localForward = Normalize(localForward);
+			localRight = Normalize(localRight);
+			localUp = Normalize(localUp);
 
 			// 揺れの影響を除いたクリーンな基準位置を使う（縦揺れで発射位置がズレるのを防ぐ）
 			KamataEngine::Vector3 cleanPlayerPos = playerWorldPos;
@@ -102,27 +87,18 @@ void Player::Attack() {
 			if (std::abs(localForward.x) < 1e-6f && std::abs(localForward.y) < 1e-6f && std::abs(localForward.z) < 1e-6f) {
 				const KamataEngine::Matrix4x4& camMat = railCamera_->GetWorldTransform().matWorld_;
 				cameraForward = {camMat.m[2][0], camMat.m[2][1], camMat.m[2][2]};
-				cameraForward = KamataEngine::MathUtility::Normalize(cameraForward);
+				cameraForward = Normalize(cameraForward);
 				cameraPosition = {camMat.m[3][0], camMat.m[3][1], camMat.m[3][2]};
 			} else {
 				// それでも念のためカメラ前方向も取得
 				const KamataEngine::Matrix4x4& camMat = railCamera_->GetWorldTransform().matWorld_;
 				cameraForward = {camMat.m[2][0], camMat.m[2][1], camMat.m[2][2]};
-				cameraForward = KamataEngine::MathUtility::Normalize(cameraForward);
+				cameraForward = Normalize(cameraForward);
 				cameraPosition = {camMat.m[3][0], camMat.m[3][1], camMat.m[3][2]};
 			}
 
 			// 優先: プレイヤーの向きの反対方向（後方）へ大きくずらす
 			KamataEngine::Vector3 preferredMoveBullet = cleanPlayerPos - localForward * forwardOffset + localUp * upOffset + localRight * rightOffset;
-			KamataEngine::Vector3 cameraBasedMoveBullet = cleanPlayerPos + cameraForward * forwardOffset + localUp * upOffset + localRight * rightOffset;
-
-			// デバッグ出力: 座標を確認
-			char dbgBuf[256];
-			sprintf_s(
-			    dbgBuf, "playerPos=(%.2f,%.2f,%.2f) localF=(%.2f,%.2f,%.2f) camF=(%.2f,%.2f,%.2f) prefBullet=(%.2f,%.2f,%.2f) camBullet=(%.2f,%.2f,%.2f)\\n", playerWorldPos.x, playerWorldPos.y,
-			    playerWorldPos.z, localForward.x, localForward.y, localForward.z, cameraForward.x, cameraForward.y, cameraForward.z, preferredMoveBullet.x, preferredMoveBullet.y,
-			    preferredMoveBullet.z, cameraBasedMoveBullet.x, cameraBasedMoveBullet.y, cameraBasedMoveBullet.z);
-			OutputDebugStringA(dbgBuf);
 
 			// プレイヤー基準（今回は後方へ大きくずらした位置）を優先して使う
 			KamataEngine::Vector3 moveBullet = preferredMoveBullet;
@@ -132,114 +108,71 @@ void Player::Attack() {
 			const float kBulletSpeed = 60.0f; // 弾速
 			KamataEngine::Vector3 velocity;
 
-			float minDistanceSq = FLT_MAX;
-			Enemy* nearestOnScreenEnemy = nullptr;
-			const float maxHomingDistance = 1000.0f;
-
-			if (enemies_) {
-				for (Enemy* enemy : *enemies_) {
-					if (!enemy || enemy->IsDead())
-						continue;
-
-					if (enemy->IsOnScreen()) {
-						KamataEngine::Vector3 enemyPos = enemy->GetWorldPosition();
-						KamataEngine::Vector3 toEnemy = enemyPos - moveBullet;
-						float distanceSq = toEnemy.x * toEnemy.x + toEnemy.y * toEnemy.y + toEnemy.z * toEnemy.z;
-
-						if (distanceSq < minDistanceSq && distanceSq < maxHomingDistance * maxHomingDistance) {
-							float distance = sqrtf(distanceSq);
-							if (distance > 0.001f) {
-								minDistanceSq = distanceSq;
-								nearestOnScreenEnemy = enemy;
-							}
-						}
-					}
-				}
-			}
-
 			{
 				const KamataEngine::Matrix4x4& cameraWorldMatrix = railCamera_->GetWorldTransform().matWorld_;
 				// reuse previously declared cameraPosition and cameraForward instead of redeclaring
 				cameraPosition = {cameraWorldMatrix.m[3][0], cameraWorldMatrix.m[3][1], cameraWorldMatrix.m[3][2]};
 				cameraForward = {cameraWorldMatrix.m[2][0], cameraWorldMatrix.m[2][1], cameraWorldMatrix.m[2][2]};
-				cameraForward = KamataEngine::MathUtility::Normalize(cameraForward);
+				cameraForward = Normalize(cameraForward);
 				KamataEngine::Vector3 targetPosition = cameraPosition + cameraForward * 1000.0f;
 				velocity = targetPosition - moveBullet;
 			}
 
-			velocity = KamataEngine::MathUtility::Normalize(velocity);
+			velocity = Normalize(velocity);
 			velocity = velocity * kBulletSpeed;
 
-			PlayerBullet* newBullet = new PlayerBullet();
-			newBullet->Initialize(modelbullet_, moveBullet, velocity);
-
-			// ホーミング強度
-			newBullet->SetHomingStrength(1.0f);
-
-			// まず、アシストロック中の敵を優先して探す
-			Enemy* assistLockedEnemy = nullptr;
-			if (railCamera_ && enemies_) {
-				const float kVisualRadius = 0.08f;
-				// const float kDetectionRadius = 0.1f;
-				const float kAspect = (float)KamataEngine::WinApp::kWindowWidth / (float)KamataEngine::WinApp::kWindowHeight;
-				const float ndcVisualRadiusY = kVisualRadius * 2.0f;
-				const float ndcVisualRadiusX = ndcVisualRadiusY / kAspect;
-				// const float ndcDetectionRadiusY = kDetectionRadius * 2.0f;
-				// const float ndcDetectionRadiusX = ndcDetectionRadiusY / kAspect;
-
-				const KamataEngine::Matrix4x4& viewMatrix = railCamera_->GetViewProjection().matView;
-				const KamataEngine::Matrix4x4& projMatrix = railCamera_->GetViewProjection().matProjection;
-
-				// ロックオンされている敵（レティクルの円内）を探す
-				for (Enemy* e : *enemies_) {
-					if (!e || e->IsDead())
-						continue;
-					if (!e->IsOnScreen())
-						continue;
-					// ロックオンされている敵のみを対象にする
-					if (!e->IsAssistLocked())
-						continue;
-					// world -> view
-					KamataEngine::Vector3 worldPos = e->GetWorldPosition();
-					KamataEngine::Vector3 viewPos;
-					viewPos.x = worldPos.x * viewMatrix.m[0][0] + worldPos.y * viewMatrix.m[1][0] + worldPos.z * viewMatrix.m[2][0] + 1.0f * viewMatrix.m[3][0];
-					viewPos.y = worldPos.x * viewMatrix.m[0][1] + worldPos.y * viewMatrix.m[1][1] + worldPos.z * viewMatrix.m[2][1] + 1.0f * viewMatrix.m[3][1];
-					viewPos.z = worldPos.x * viewMatrix.m[0][2] + worldPos.y * viewMatrix.m[1][2] + worldPos.z * viewMatrix.m[2][2] + 1.0f * viewMatrix.m[3][2];
-					if (viewPos.z <= 0.0f)
-						continue;
-					float clipX = viewPos.x * projMatrix.m[0][0] + viewPos.y * projMatrix.m[1][0] + viewPos.z * projMatrix.m[2][0] + 1.0f * projMatrix.m[3][0];
-					float clipY = viewPos.x * projMatrix.m[0][1] + viewPos.y * projMatrix.m[1][1] + viewPos.z * projMatrix.m[2][1] + 1.0f * projMatrix.m[3][1];
-					float w_clip = viewPos.x * projMatrix.m[0][3] + viewPos.y * projMatrix.m[1][3] + viewPos.z * projMatrix.m[2][3] + 1.0f * projMatrix.m[3][3];
-					if (w_clip <= 0.0f)
-						continue;
-					float ndcX = clipX / w_clip;
-					float ndcY = clipY / w_clip;
-					float visualNormX = ndcX / ndcVisualRadiusX;
-					float visualNormY = ndcY / ndcVisualRadiusY;
-					float visualNormDistSq = (visualNormX * visualNormX) + (visualNormY * visualNormY);
-					// レティクルの円内の敵のみを対象にする
-					if (visualNormDistSq <= 1.0f) {
-						assistLockedEnemy = e;
-						break;
+			PlayerBullet* newBullet = SpawnBullet(moveBullet, velocity);
+			if (newBullet) {
+				// ホーミング強度
+				newBullet->SetHomingStrength(1.0f);
+
+				// まず、アシストロック中の敵を優先して探す
+				Enemy* assistLockedEnemy = nullptr;
+				if (screenProjection_ && enemies_) {
+					// レティクルの円はエイムアシストと同じ大きさ
+					const float kAspect = (float)SimCamera::kScreenWidth / (float)SimCamera::kScreenHeight;
+					const float ndcVisualRadiusY = GameWorld::kAimAssistVisualRadius * 2.0f;
+					const float ndcVisualRadiusX = ndcVisualRadiusY / kAspect;
+					// const float ndcDetectionRadiusY = kDetectionRadius * 2.0f;
+					// const float ndcDetectionRadiusX = ndcDetectionRadiusY / kAspect;
+
+					// ロックオンされている敵（レティクルの円内）を探す
+					for (Enemy* e : *enemies_) {
+						if (!e || e->IsDead())
+							continue;
+						// ロックオンされている敵のみを対象にする
+						if (!e->IsAssistLocked())
+							continue;
+						// 画面投影の表から読む (エイムアシストと同じ結果)
+						ScreenPoint point = screenProjection_->Get(e->GetScreenIndex());
+						if (!point.isOnScreen)
+							continue;
+						float ndcX = point.ndc.x;
+						float ndcY = point.ndc.y;
+						float visualNormX = ndcX / ndcVisualRadiusX;
+						float visualNormY = ndcY / ndcVisualRadiusY;
+						float visualNormDistSq = (visualNormX * visualNormX) + (visualNormY * visualNormY);
+						// レティクルの円内の敵のみを対象にする
+						if (visualNormDistSq <= 1.0f) {
+							assistLockedEnemy = e;
+							break;
+						}
 					}
 				}
-			}
-
-			// ホーミング消したいときはここをコメントアウト
-			// ロックオンされている敵（レティクルの円内）のみホーミングを有効化
-			if (assistLockedEnemy && assistLockedEnemy->IsAssistLocked()) {
-				// レティクル周辺の円内の敵に対してのみ即座にホーミングを有効化
-				newBullet->SetHomingTarget(assistLockedEnemy);
-				newBullet->SetHomingEnabled(true);
-				newBullet->SetAimAssistHoming(true);
-				newBullet->SetAssistLockId(assistLockedEnemy->GetAssistLockId());
-			}
 
-			bullets_.push_back(newBullet);
+				// ホーミング消したいときはここをコメントアウト
+				// ロックオンされている敵（レティクルの円内）のみホーミングを有効化
+				if (assistLockedEnemy && assistLockedEnemy->IsAssistLocked()) {
+					// レティクル周辺の円内の敵に対してのみ即座にホーミングを有効化
+					newBullet->SetHomingTarget(assistLockedEnemy);
+					newBullet->SetHomingEnabled(true);
+					newBullet->SetAimAssistHoming(true);
+					newBullet->SetAssistLockId(assistLockedEnemy->GetAssistLockId());
+				}
 
-			if (audio_){
-				audio_->playAudio(hitPlayerSound_, hitPlayerSoundHandle_, false, 0.5f);
-		}
+				// 発射音は描画側で再生する
+				isShotThisFrame_ = true;
+			}
 
 		// 連射の速度
 		shotTimer_ = 5;
@@ -264,44 +197,49 @@ AABB Player::GetAABB() {
 	return aabb;
 }
 
-void Player::SetParent(const KamataEngine::WorldTransform* parent) { worldtransfrom_.parent_ = parent; }
-
-void Player::Update() {
+void Player::SetParent(const SimTransform* parent) { worldtransfrom_.parent_ = parent; }
 
-	// Update bullets safely: copy pointers to a temporary vector so that
-	// if bullets_ is modified during an update (e.g. bullets marked dead by collision)
-	// we won't iterate invalidated iterators.
-	std::vector<PlayerBullet*> bulletSnapshot;
-	bulletSnapshot.reserve(bullets_.size());
-	for (PlayerBullet* b : bullets_) {
-		if (b)
-			bulletSnapshot.push_back(b);
+void Player::SavePreviousTransforms() {
+	worldtransfrom_.SavePrevious();
+	bulletStore_.SavePrevious();
+	if (engineExhaust_) {
+		engineExhaust_->SavePreviousTransforms();
 	}
+}
 
-	for (PlayerBullet* b : bulletSnapshot) {
-		if (b)
-			b->Update();
+void Player::UpdateBullets() {
+	// 追尾の判断は弾ごとに、向きの変更・移動・寿命は全弾まとめて進める
+	bulletGuidance_.Clear();
+	for (PlayerBullet* b : bullets_) {
+		b->UpdateHoming(bulletGuidance_);
 	}
+	bulletGuidance_.Steer(bulletStore_);
+	bulletStore_.Integrate(PlayerBullet::kLifeStep);
 
-	// Remove and delete dead bullets
-	bullets_.remove_if([](PlayerBullet* bullet) {
-		if (!bullet)
-			return true;
+	// Remove dead bullets and return them to the pool
+	std::erase_if(bullets_, [this](PlayerBullet* bullet) {
 		if (bullet->IsDead()) {
-			delete bullet;
+			ReleaseBullet(bullet);
 			return true;
 		}
 		return false;
 	});
+}
+
+void Player::Update() {
+
+	isShotThisFrame_ = false;
+
+	UpdateBullets();
 
 	if (dodgeTimer_ > 0) {
 		dodgeTimer_--;
 	} else {
-		if (input_->PushKey(DIK_LSHIFT)) {
+		if (input_->PushKey(SimKey::LShift)) {
 			float dodgeDir = 0.0f;
-			if (input_->PushKey(DIK_A))
+			if (input_->PushKey(SimKey::A))
 				dodgeDir = -1.0f;
-			else if (input_->PushKey(DIK_D))
+			else if (input_->PushKey(SimKey::D))
 				dodgeDir = 1.0f;
 
 			if (dodgeDir != 0.0f && railCamera_) {
@@ -321,7 +259,7 @@ void Player::Update() {
 
 	if (isRolling_) {
 		// === 回避アクション中 ===
-		rollTimer_ += 1.0f;
+		rollTimer_ += SimClock::kStepSeconds;
 		float t = rollTimer_ / kRollDuration_;
 		if (t >= 1.0f) {
 			t = 1.0f;
@@ -407,10 +345,10 @@ void Player::Update() {
 	// 排気パーティクル
 	if (engineExhaust_) {
 		KamataEngine::Vector3 exhaustOffset = {0.0f, -0.3f, -3.0f};
-		KamataEngine::Vector3 emitterPos = KamataEngine::MathUtility::Transform(exhaustOffset, worldtransfrom_.matWorld_);
+		KamataEngine::Vector3 emitterPos = Transform(exhaustOffset, worldtransfrom_.matWorld_);
 
 		KamataEngine::Vector3 playerBackVector = {-worldtransfrom_.matWorld_.m[2][0], -worldtransfrom_.matWorld_.m[2][1], -worldtransfrom_.matWorld_.m[2][2]};
-		playerBackVector = KamataEngine::MathUtility::Normalize(playerBackVector);
+		playerBackVector = Normalize(playerBackVector);
 
 		const float exhaustSpeed = 0.5f; // 排気速度
 		KamataEngine::Vector3 exhaustVelocity = playerBackVector * exhaustSpeed;
@@ -420,16 +358,6 @@ void Player::Update() {
 	}
 }
 
-void Player::Draw() {
-	model_->Draw(worldtransfrom_, *camera_);
-	if (engineExhaust_) {
-		engineExhaust_->Draw(*camera_);
-	}
-	for (PlayerBullet* bullet : bullets_) {
-		bullet->Draw(*camera_);
-	}
-}
-
 void Player::SetRailCamera(RailCamera* camera) { railCamera_ = camera; }
 
 void Player::ResetRotation() {
@@ -465,10 +393,10 @@ void Player::UpdateGameOver(float animationTime) {
 	// パーティクル放出
 	if (engineExhaust_) {
 		KamataEngine::Vector3 emitOffset = {0.8f, 0.0f, -0.8f};
-		KamataEngine::Vector3 worldEmitPos = KamataEngine::MathUtility::Transform(emitOffset, worldtransfrom_.matWorld_);
+		KamataEngine::Vector3 worldEmitPos = Transform(emitOffset, worldtransfrom_.matWorld_);
 		KamataEngine::Vector3 localVelocityDir = {1.0f, 1.0f, -0.5f};
-		localVelocityDir = KamataEngine::MathUtility::Normalize(localVelocityDir);
-		KamataEngine::Vector3 worldVelocityDir = KamataEngine::MathUtility::TransformNormal(localVelocityDir, worldtransfrom_.matWorld_);
+		localVelocityDir = Normalize(localVelocityDir);
+		KamataEngine::Vector3 worldVelocityDir = TransformNormal(localVelocityDir, worldtransfrom_.matWorld_);
 		const float smokeSpeed = 0.5f;
 		KamataEngine::Vector3 smokeVelocity = worldVelocityDir * smokeSpeed;
 		engineExhaust_->Emit(worldEmitPos, smokeVelocity);
@@ -481,12 +409,27 @@ void Player::UpdateGameOver(float animationTime) {
 
 void Player::ResetBullets() {
 	for (PlayerBullet* bullet : bullets_) {
-		delete bullet;
+		ReleaseBullet(bullet);
 	}
 	bullets_.clear();
 }
 
-void Player::EvadeBullets(std::list<EnemyBullet*>& bullets) {
+void Player::ReleaseBullet(PlayerBullet* bullet) {
+	bulletStore_.Deactivate(static_cast<uint32_t>(bulletPool_.IndexOf(bullet)));
+	bulletPool_.Release(bullet);
+}
+
+PlayerBullet* Player::SpawnBullet(const KamataEngine::Vector3& position, const KamataEngine::Vector3& velocity) {
+	PlayerBullet* bullet = bulletPool_.Acquire();
+	if (!bullet) {
+		return nullptr;
+	}
+	bullet->Initialize(&bulletStore_, static_cast<uint32_t>(bulletPool_.IndexOf(bullet)), position, velocity);
+	bullets_.push_back(bullet);
+	return bullet;
+}
+
+void Player::EvadeBullets(const std::vector<EnemyBullet*>& bullets) {
 
 	if (isRolling_) {
 
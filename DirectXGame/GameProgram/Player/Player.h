@@ -1,76 +1,112 @@
 #pragma once
 #include "AABB.h"
 #include "EnemyBullet.h"
-#include "KamataEngine.h"
+#include "HomingGuidance.h"
+#include "MT.h"
+#include "ObjectPool.h"
 #include "ParticleEmitter.h"
 #include "PlayerBullet.h"
+#include "SimInput.h"
+#include "SimTransform.h"
 #include <list>
-#include "EnemyBullet.h"
+#include <vector>
 
 using namespace KamataEngine;
 
 class Enemy;
 class RailCamera;
+class ScreenProjection;
 
 class Player {
 public:
 	Player() = default;
 	~Player();
 
-	void Initialize(KamataEngine::Model* model, KamataEngine::Camera* camera, const KamataEngine::Vector3& pos);
+	void Initialize(const KamataEngine::Vector3& pos, const SimInput* input);
 	void Update();
-	void Draw();
 	void Attack();
 	void OnCollision();
 
 	bool IsDead() const { return isDead_; }
-	KamataEngine::WorldTransform& GetWorldTransform() { return worldtransfrom_; }
+	int GetHp() const { return hp_; }
+	SimTransform& GetWorldTransform() { return worldtransfrom_; }
 
 	void UpdateGameOver(float animationTime);
 
 	KamataEngine::Vector3 GetWorldPosition();
+	KamataEngine::Vector3 GetPreviousWorldPosition() const { return worldtransfrom_.GetPreviousWorldPosition(); }
 	AABB GetAABB();
-	const std::list<PlayerBullet*>& GetBullets() const { return bullets_; }
-
-	void SetParent(const KamataEngine::WorldTransform* parent);
+	const std::vector<PlayerBullet*>& GetBullets() const { return bullets_; }
+	const BulletStore& GetBulletStore() const { return bulletStore_; }
+	/// <summary>
+	/// 弾をプールから取り出して発射する
+	/// </summary>
+	/// <returns>プールが満杯なら nullptr (弾は出ない)</returns>
+	PlayerBullet* SpawnBullet(const KamataEngine::Vector3& position, const KamataEngine::Vector3& velocity);
+	// 弾の最大数を変える (弾が 1 つも無いときだけ呼べる)
+	void ReserveBullets(size_t capacity) {
+		bulletPool_.Reserve(capacity);
+		bulletStore_.Reserve(capacity);
+	}
+	// 弾の追尾と移動を 1 ステップ進め、消えた弾をプールに戻す (Update の最初に呼ばれる)
+	void UpdateBullets();
+	const ObjectPool<PlayerBullet>& GetBulletPool() const { return bulletPool_; }
+	const ParticleEmitter* GetExhaust() const { return engineExhaust_; }
+	// 排気のばらつきに使う乱数列
+	void SetExhaustRandom(const RandomStream& random) { engineExhaust_->SetRandom(random); }
+	// 描画の補間用: 自機・弾・排気のステップ開始時の行列を保存する
+	void SavePreviousTransforms();
+
+	// このフレームに弾を撃ったか（発射音の再生用）
+	bool IsShotThisFrame() const { return isShotThisFrame_; }
+
+	void SetParent(const SimTransform* parent);
 	void SetRailCamera(RailCamera* camera);
 	void SetEnemies(std::list<Enemy*>* enemies) { enemies_ = enemies; }
+	// ロックオンで読む画面投影の表 (GameWorld が持つ)
+	void SetScreenProjection(const ScreenProjection* projection) { screenProjection_ = projection; }
 
 	void ResetRotation();
 	void ResetParticles();
 	void ResetBullets();
 
+	// 同時に出せる弾の数 (5フレームごとに撃ち、寿命は 90 フレーム弱なので余裕を持たせる)
+	static const size_t kMaxBullets = 256;
+
 	// 当たり判定用のサイズ
 	static inline const float kWidth = 1.0f;
 	static inline const float kHeight = 1.0f;
 
-	void EvadeBullets(std::list<EnemyBullet*>& bullets);
+	void EvadeBullets(const std::vector<EnemyBullet*>& bullets);
 	
 	// 回避中かどうかを取得
 	bool IsRolling() const { return isRolling_; }
 
 private:
-	KamataEngine::WorldTransform worldtransfrom_;
-	KamataEngine::Model* model_ = nullptr;
-	KamataEngine::Camera* camera_ = nullptr;
-	KamataEngine::Input* input_ = nullptr;
-	RailCamera* railCamera_ = nullptr;
+	// 弾をプールに戻す
+	void ReleaseBullet(PlayerBullet* bullet);
 
-	Audio* audio_ = nullptr;
+	SimTransform worldtransfrom_;
+	const SimInput* input_ = nullptr;
+	RailCamera* railCamera_ = nullptr;
 
-	KamataEngine::Model* modelbullet_ = nullptr;
-	std::list<PlayerBullet*> bullets_;
+	// 弾はプールが持ち、bullets_ は使用中の弾を指す
+	// 位置・速度・寿命はプールと同じ番号で bulletStore_ に置く
+	ObjectPool<PlayerBullet> bulletPool_{kMaxBullets};
+	BulletStore bulletStore_{kMaxBullets};
+	std::vector<PlayerBullet*> bullets_;
+	// 追尾弾の向きをまとめて変える
+	HomingGuidance bulletGuidance_;
 
 	std::list<Enemy*>* enemies_ = nullptr;
+	const ScreenProjection* screenProjection_ = nullptr;
 
 	int specialTimer = 20;
 	bool isParry_ = false;
 
-	int hitPlayerSoundHandle_ = 0;
-	int hitPlayerSound_ = -1;
+	bool isShotThisFrame_ = false;
 
 	// パーティクル
-	KamataEngine::Model* modelParticle_ = nullptr;
 	ParticleEmitter* engineExhaust_ = nullptr;
 
 	int hp_ = 3;
@@ -80,9 +116,9 @@ private:
 	int dodgeTimer_ = 0;
 
 	bool isRolling_ = false;     // 回転中か
-	float rollTimer_ = 0.0f;     // 回転タイマー
+	float rollTimer_ = 0.0f;     // 回転タイマー (秒)
 	float rollDirection_ = 0.0f; // 回転方向
-	const float kRollDuration_ = 60.0f;
+	const float kRollDuration_ = 1.0f;
 
 	// --- 被弾時の揺れ ---
 	float hitShakeTime_ = 0.0f;       // 経過フレーム数
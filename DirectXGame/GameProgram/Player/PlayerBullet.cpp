@@ -1,53 +1,35 @@
 #include "PlayerBullet.h"
 #include "Enemy.h"
-#include "base/TextureManager.h"
-#include <algorithm>
+#include "HomingGuidance.h"
 #include <cassert>
 #include <math.h>
 
-PlayerBullet::~PlayerBullet() { model_ = nullptr; }
+PlayerBullet::~PlayerBullet() {}
 
-void PlayerBullet::Initialize(KamataEngine::Model* model, const KamataEngine::Vector3& position, const KamataEngine::Vector3& velocity) {
-	assert(model);
-	model_ = model;
-	worldtransfrom_.translation_ = position;
-	worldtransfrom_.Initialize();
-	velocity_ = velocity;
+void PlayerBullet::Initialize(BulletStore* store, uint32_t slot, const KamataEngine::Vector3& position, const KamataEngine::Vector3& velocity) {
+	assert(store);
+	// プールで使い回すので、前回の弾の状態 (追尾・タイマー・デスフラグ) を初期値に戻す
+	*this = PlayerBullet();
+	store_ = store;
+	slot_ = slot;
 
+	float lifeTime = kLifeTime;
 	const float kDesiredRange = 5000.0f;
-	float speed = sqrtf(velocity_.x * velocity_.x + velocity_.y * velocity_.y + velocity_.z * velocity_.z);
+	float speed = sqrtf(velocity.x * velocity.x + velocity.y * velocity.y + velocity.z * velocity.z);
 	if (speed > 0.001f) {
-		int32_t frames = static_cast<int32_t>(ceilf(kDesiredRange / speed));
-		frames += 2;
-		deathTimer_ = frames;
+		// 速度は 1 ステップの移動量なので、射程を進むのに要るステップ数を秒にする
+		int32_t steps = static_cast<int32_t>(ceilf(kDesiredRange / speed));
+		steps += 2;
+		lifeTime = static_cast<float>(steps) * kLifeStep;
 	}
+	store_->Activate(slot_, position, velocity, lifeTime);
 }
 
 void PlayerBullet::OnCollision() { isDead_ = true; }
 
-// SlerpRotate関数（PlayerBullet内にも定義、あるいはヘッダーなどで共有しても良い）
-KamataEngine::Vector3 PlayerBulletSlerp(const KamataEngine::Vector3& current, const KamataEngine::Vector3& target, float maxAngle) {
-	float dot = current.x * target.x + current.y * target.y + current.z * target.z;
-	dot = std::clamp(dot, -1.0f, 1.0f);
-	float angle = std::acos(dot);
-	if (std::abs(angle) < 0.001f || std::abs(angle - 3.14159f) < 0.001f)
-		return target;
-	float t = 1.0f;
-	if (angle > maxAngle)
-		t = maxAngle / angle;
-	float sinTheta = std::sin(angle);
-	float ps = std::sin(angle * (1.0f - t)) / sinTheta;
-	float pt = std::sin(angle * t) / sinTheta;
-	KamataEngine::Vector3 result;
-	result.x = current.x * ps + target.x * pt;
-	result.y = current.y * ps + target.y * pt;
-	result.z = current.z * ps + target.z * pt;
-	return result;
-}
-
-void PlayerBullet::Update() {
-	if (--deathTimer_ <= 0) {
-		isDead_ = true;
+void PlayerBullet::UpdateHoming(HomingGuidance& guidance) {
+	// このステップで寿命が尽きる弾は追尾しない (Integrate で消える)
+	if (store_->GetLife(slot_) - kLifeStep <= 0.0f) {
 		return;
 	}
 
@@ -92,29 +74,17 @@ void PlayerBullet::Update() {
 			if (distance <= kHitRadius) {
 				homingTarget_->OnCollision();
 				isDead_ = true;
+				// 当たった位置で止める
+				store_->Deactivate(slot_);
 				return;
 			}
 
 			if (distance > 0.001f) {
-				// 現在の速度（大きさ）
-				float currentSpeed = sqrtf(velocity_.x * velocity_.x + velocity_.y * velocity_.y + velocity_.z * velocity_.z);
-
-				// 正規化ベクトル
-				KamataEngine::Vector3 currentDir = velocity_;
-				if (currentSpeed > 0.001f) {
-					currentDir.x /= currentSpeed;
-					currentDir.y /= currentSpeed;
-					currentDir.z /= currentSpeed;
-				}
-
-				KamataEngine::Vector3 targetDir = toTarget;
-				targetDir.x /= distance;
-				targetDir.y /= distance;
-				targetDir.z /= distance;
-
-				// 通り過ぎ判定
-				float dot = currentDir.x * targetDir.x + currentDir.y * targetDir.y + currentDir.z * targetDir.z;
-				if (dot < -0.2f) {
+				// 通り過ぎ判定 (速度と目標方向のなす角の cos が -0.2 未満)
+				KamataEngine::Vector3 velocity = store_->GetVelocity(slot_);
+				float currentSpeed = sqrtf(velocity.x * velocity.x + velocity.y * velocity.y + velocity.z * velocity.z);
+				float dot = velocity.x * toTarget.x + velocity.y * toTarget.y + velocity.z * toTarget.z;
+				if (dot < -0.2f * currentSpeed * distance) {
 					// 通り過ぎたらホーミング終了
 					isHomingEnabled_ = false;
 				} else {
@@ -130,19 +100,10 @@ void PlayerBullet::Update() {
 						baseTurn += rate * 0.2f * homingStrength_;
 					}
 
-					// Slerpで向きを変える
-					KamataEngine::Vector3 newDir = PlayerBulletSlerp(currentDir, targetDir, baseTurn);
-
-					// 長さを整えて速度適用
-					float len = sqrtf(newDir.x * newDir.x + newDir.y * newDir.y + newDir.z * newDir.z);
-					if (len > 0.001f) {
-						newDir.x /= len;
-						newDir.y /= len;
-						newDir.z /= len;
-					}
-					velocity_.x = newDir.x * currentSpeed;
-					velocity_.y = newDir.y * currentSpeed;
-					velocity_.z = newDir.z * currentSpeed;
+					// 向きを変えるのは全弾まとめて (Player::UpdateBullets の HomingGuidance::Steer)
+					KamataEngine::Vector3 targetPrev = homingTarget_->GetPreviousWorldPosition();
+					KamataEngine::Vector3 targetVelocity = {targetPos.x - targetPrev.x, targetPos.y - targetPrev.y, targetPos.z - targetPrev.z};
+					guidance.Add(slot_, targetPos, targetVelocity, baseTurn);
 				}
 			}
 		}
@@ -150,24 +111,4 @@ void PlayerBullet::Update() {
 		isHomingEnabled_ = false;
 		homingTarget_ = nullptr;
 	}
-
-	worldtransfrom_.translation_.x += velocity_.x;
-	worldtransfrom_.translation_.y += velocity_.y;
-	worldtransfrom_.translation_.z += velocity_.z;
-	worldtransfrom_.UpdateMatrix();
-}
-
-KamataEngine::Vector3 PlayerBullet::GetWorldPosition() {
-	worldtransfrom_.UpdateMatrix();
-	KamataEngine::Vector3 worldPos;
-	worldPos.x = worldtransfrom_.matWorld_.m[3][0];
-	worldPos.y = worldtransfrom_.matWorld_.m[3][1];
-	worldPos.z = worldtransfrom_.matWorld_.m[3][2];
-	return worldPos;
-}
-
-void PlayerBullet::Draw(const KamataEngine::Camera& camera) {
-	if (!isDead_) {
-		model_->Draw(worldtransfrom_, camera);
-	}
 }
\ No newline at end of file
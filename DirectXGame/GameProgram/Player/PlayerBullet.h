@@ -1,7 +1,7 @@
 #pragma once
-#include <3d/Camera.h>
-#include <3d/Model.h>
-#include <3d/WorldTransform.h>
+#include "BulletStore.h"
+#include "SimClock.h"
+#include <cstdint>
 #include <vector>
 
 // 前方宣言
@@ -10,20 +10,37 @@ struct Vector3;
 }
 
 class Enemy;
+class HomingGuidance;
 
 class PlayerBullet {
 public:
-	void Initialize(KamataEngine::Model* model, const KamataEngine::Vector3& position, const KamataEngine::Vector3& velocity);
-
-	void Update();
-
-	KamataEngine::Vector3 GetWorldPosition();
-
-	void Draw(const KamataEngine::Camera& camera);
+	// 寿命の単位 (秒)。BulletStore::Integrate に渡す
+	static inline const float kLifeStep = SimClock::kStepSeconds;
+
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="store">位置・速度・寿命を置く場所</param>
+	/// <param name="slot">store 内のスロット (弾のプールのインデックス)</param>
+	void Initialize(BulletStore* store, uint32_t slot, const KamataEngine::Vector3& position, const KamataEngine::Vector3& velocity);
+
+	/// <summary>
+	/// 追尾の更新 (命中・追尾の解除を判断し、向きを変える弾は guidance に登録する)
+	/// 向きの変更は HomingGuidance::Steer、移動と寿命は BulletStore::Integrate で全弾まとめて進める
+	/// </summary>
+	void UpdateHoming(HomingGuidance& guidance);
+
+	KamataEngine::Vector3 GetWorldPosition() const { return store_->GetPosition(slot_); }
+	// ステップ開始時の位置 (このステップで通った線分の始点)
+	KamataEngine::Vector3 GetPreviousPosition() const { return store_->GetPreviousPosition(slot_); }
+	uint32_t GetSlot() const { return slot_; }
+
+	KamataEngine::Matrix4x4 GetWorldMatrix() const { return store_->GetMatrix(slot_); }
+	KamataEngine::Matrix4x4 GetInterpolatedMatrix(float alpha) const { return store_->GetInterpolatedMatrix(slot_, alpha); }
 
 	~PlayerBullet();
 
-	bool IsDead() const { return isDead_; }
+	bool IsDead() const { return isDead_ || (store_ && store_->IsExpired(slot_)); }
 
 	// 衝突を検出したら呼び出されるコールバック関数
 	void OnCollision();
@@ -46,14 +63,12 @@ public:
 	void SetPendingHomingTarget(Enemy* target, float lockDistance) { pendingHomingTarget_ = target; pendingLockDistance_ = lockDistance; }
 
 private:
-	KamataEngine::WorldTransform worldtransfrom_;
-
-	KamataEngine::Model* model_ = nullptr;
+	// 位置・速度・寿命は store_ の slot_ 番目にある
+	BulletStore* store_ = nullptr;
+	uint32_t slot_ = 0;
 
 	// uint32_t textureHandle_ = 0;
 
-	KamataEngine::Vector3 velocity_;
-
 	// 追尾関連
 	Enemy* homingTarget_ = nullptr;
 	bool isHomingEnabled_ = false;
@@ -65,10 +80,8 @@ private:
 	Enemy* pendingHomingTarget_ = nullptr;
 	float pendingLockDistance_ = 0.0f;
 
-	// 寿命<frm>
-	static const int32_t kLifeTime = 60 * 2; // 増加して3000まで移動できるようにする (元は60*1)
-	// デスタイマー
-	int32_t deathTimer_ = kLifeTime;
+	// 寿命 (秒)。速度が 0 のときだけ使い、動く弾は射程から決める
+	static inline const float kLifeTime = 2.0f; // 増加して3000まで移動できるようにする (元は1秒)
 	// デスフラグ
 	bool isDead_ = false;
 
@@ -0,0 +1,119 @@
+#include "Profiler.h"
+
+#ifdef USE_PROFILER
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+// スレッドごとのリングバッファ
+// 書き込むのは持ち主のスレッドだけなので、head の更新だけを atomic にする
+struct ThreadBuffer {
+	uint32_t threadIndex = 0;
+	std::atomic<uint64_t> head{0};      // これまでに書いた区間の数
+	std::atomic<uint64_t> clearedAt{0}; // Clear した時点の head
+	Profiler::Zone zones[Profiler::kRingSize];
+};
+
+// 登録はスレッドの初回記録時だけなので mutex で守る
+std::mutex& RegistryMutex() {
+	static std::mutex mutex;
+	return mutex;
+}
+
+// スレッドが終了しても記録を残すため、バッファはプロセス終了まで解放しない
+std::vector<std::unique_ptr<ThreadBuffer>>& Registry() {
+	static std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+	return buffers;
+}
+
+ThreadBuffer* GetThreadBuffer() {
+	thread_local ThreadBuffer* buffer = nullptr;
+	if (!buffer) {
+		std::lock_guard<std::mutex> lock(RegistryMutex());
+		std::vector<std::unique_ptr<ThreadBuffer>>& buffers = Registry();
+		buffers.push_back(std::make_unique<ThreadBuffer>());
+		buffer = buffers.back().get();
+		buffer->threadIndex = static_cast<uint32_t>(buffers.size());
+	}
+	return buffer;
+}
+
+const std::chrono::steady_clock::time_point kStartTime = std::chrono::steady_clock::now();
+
+void WriteEscaped(std::ofstream& file, const char* text) {
+	for (const char* c = text; *c; ++c) {
+		if (*c == '"' || *c == '\\') {
+			file.put('\\');
+		}
+		file.put(*c);
+	}
+}
+
+} // namespace
+
+uint64_t Profiler::NowNs() { return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - kStartTime).count()); }
+
+void Profiler::Record(const char* name, uint64_t beginNs, uint64_t endNs) {
+	ThreadBuffer* buffer = GetThreadBuffer();
+	uint64_t head = buffer->head.load(std::memory_order_relaxed);
+	Zone& zone = buffer->zones[head & (kRingSize - 1)];
+	zone.name = name;
+	zone.beginNs = beginNs;
+	zone.endNs = endNs;
+	// 区間を書き終えてから公開する
+	buffer->head.store(head + 1, std::memory_order_release);
+}
+
+bool Profiler::WriteChromeTrace(const std::string& path) {
+	std::ofstream file(path);
+	if (!file.is_open()) {
+		return false;
+	}
+
+	file << "{\"traceEvents\":[\n";
+	bool first = true;
+	{
+		std::lock_guard<std::mutex> lock(RegistryMutex());
+		for (const std::unique_ptr<ThreadBuffer>& buffer : Registry()) {
+			uint64_t head = buffer->head.load(std::memory_order_acquire);
+			uint64_t begin = buffer->clearedAt.load(std::memory_order_relaxed);
+			// 上書きされた古い区間は捨てる
+			if (head - begin > kRingSize) {
+				begin = head - kRingSize;
+			}
+			for (uint64_t i = begin; i < head; ++i) {
+				const Zone& zone = buffer->zones[i & (kRingSize - 1)];
+				if (!zone.name) {
+					continue;
+				}
+				file << (first ? "" : ",\n");
+				first = false;
+				file << "{\"name\":\"";
+				WriteEscaped(file, zone.name);
+				// ts / dur はマイクロ秒
+				char fields[128];
+				std::snprintf(
+				    fields, sizeof(fields), "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", buffer->threadIndex, static_cast<double>(zone.beginNs) / 1000.0,
+				    static_cast<double>(zone.endNs - zone.beginNs) / 1000.0);
+				file << fields;
+			}
+		}
+	}
+	file << "\n],\"displayTimeUnit\":\"ns\"}\n";
+	return file.good();
+}
+
+void Profiler::Clear() {
+	std::lock_guard<std::mutex> lock(RegistryMutex());
+	for (const std::unique_ptr<ThreadBuffer>& buffer : Registry()) {
+		buffer->clearedAt.store(buffer->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+	}
+}
+
+#endif
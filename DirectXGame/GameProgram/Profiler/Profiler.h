@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+
+// フレーム内の処理時間を計測するプロファイラ
+// USE_PROFILER が定義されていないビルドでは、マクロごと消えて何も残らない
+//
+// 使い方:
+//   void Foo() {
+//       PROFILE_ZONE("Foo");
+//       ...
+//   }
+//   Profiler::WriteChromeTrace("trace.json"); // chrome://tracing や Perfetto で開く
+
+#ifdef USE_PROFILER
+
+#include <atomic>
+#include <string>
+
+class Profiler {
+public:
+	// 1 スレッドが保持できる区間の数 (古いものから上書きされる)
+	static const uint32_t kRingSize = 1u << 16;
+
+	// 1 区間分の記録
+	struct Zone {
+		const char* name = nullptr; // 文字列リテラルのみ (ポインタだけ保存する)
+		uint64_t beginNs = 0;
+		uint64_t endNs = 0;
+	};
+
+	/// <summary>
+	/// スコープの間を 1 区間として記録する
+	/// </summary>
+	class ScopedZone {
+	public:
+		explicit ScopedZone(const char* name) : name_(name), beginNs_(Profiler::NowNs()) {}
+		~ScopedZone() { Profiler::Record(name_, beginNs_, Profiler::NowNs()); }
+
+		ScopedZone(const ScopedZone&) = delete;
+		ScopedZone& operator=(const ScopedZone&) = delete;
+
+	private:
+		const char* name_;
+		uint64_t beginNs_;
+	};
+
+	// プロファイラ起動からの経過時間 (ナノ秒)
+	static uint64_t NowNs();
+
+	// 呼び出したスレッドのリングバッファに区間を追加する (ロックしない)
+	static void Record(const char* name, uint64_t beginNs, uint64_t endNs);
+
+	/// <summary>
+	/// 全スレッドの記録を Chrome の trace_event 形式 (JSON) で書き出す
+	/// 記録中のスレッドがあっても書き出せるが、書き込み中の区間は欠けることがある
+	/// </summary>
+	/// <returns>書き出せたら true</returns>
+	static bool WriteChromeTrace(const std::string& path);
+
+	// 全スレッドの記録を捨てる
+	static void Clear();
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+// 現在のスコープを name の区間として記録する
+#define PROFILE_ZONE(name) Profiler::ScopedZone PROFILE_CONCAT(profileZone_, __LINE__)(name)
+
+#else
+
+#define PROFILE_ZONE(name) ((void)0)
+
+#endif
@@ -1,12 +1,14 @@
 #include "RailCamera.h"
-#include "../../Quaternion.h"
-#include <KamataEngine.h>
+#include "Profiler.h"
+#include "Quaternion.h"
 #include <algorithm>
+#include <cassert>
 #include <cmath>
 
 using namespace KamataEngine;
 
-void RailCamera::Initialize(const KamataEngine::Vector3& pos, const KamataEngine::Vector3& rad) {
+void RailCamera::Initialize(const KamataEngine::Vector3& pos, const KamataEngine::Vector3& rad, const SimInput* input) {
+	input_ = input;
 	initialPosition_ = pos;
 	initialRotationEuler_ = rad;
 
@@ -25,7 +27,9 @@ void RailCamera::Initialize(const KamataEngine::Vector3& pos, const KamataEngine
 }
 
 void RailCamera::Update() {
-	KamataEngine::Input* input = KamataEngine::Input::GetInstance();
+	PROFILE_ZONE("RailCamera::Update");
+	assert(input_);
+	const SimInput* input = input_;
 
 	// 自動飛行の速度
 	const float kCameraSpeed = 6.0f;          // 5
@@ -39,30 +43,30 @@ void RailCamera::Update() {
 	Vector3 rotAcceleration = assistAcceleration_;
 	assistAcceleration_ = {0.0f, 0.0f, 0.0f};
 
-	if (input->PushKey(DIK_W)) {
+	if (input->PushKey(SimKey::W)) {
 		rotAcceleration.x = -kPitchAcceleration;
 	}
-	if (input->PushKey(DIK_S)) {
+	if (input->PushKey(SimKey::S)) {
 		rotAcceleration.x = kPitchAcceleration;
 	}
-	if (input->PushKey(DIK_LEFT)) {
+	if (input->PushKey(SimKey::Left)) {
 		rotAcceleration.z = kRollAcceleration; // ロール
 	}
-	if (input->PushKey(DIK_RIGHT)) {
+	if (input->PushKey(SimKey::Right)) {
 		rotAcceleration.z = -kRollAcceleration; // ロール
 	}
 
-	if (input->PushKey(DIK_A)) {
+	if (input->PushKey(SimKey::A)) {
 		rotAcceleration.y = -kYawAcceleration; // ヨー
 	}
-	if (input->PushKey(DIK_D)) {
+	if (input->PushKey(SimKey::D)) {
 		rotAcceleration.y = kYawAcceleration; // ヨー
 	}
 
 	rotationVelocity_ += rotAcceleration;
 
 	// 自動水平
-	if (input->PushKey(DIK_R)) {
+	if (input->PushKey(SimKey::R)) {
 
 		const float kRestoreAcceleration = 0.001f;
 
@@ -127,7 +131,7 @@ void RailCamera::Update() {
 		move.x += dodgeDirection_ * kDodgeMoveSpeed * (1.0f - t);
 	}
 
-	move = KamataEngine::MathUtility::TransformNormal(move, rotationMatrix);
+	move = TransformNormal(move, rotationMatrix);
 	Vector3 currentPosition = worldtransfrom_.translation_;
 	Vector3 newPosition = currentPosition + move;
 	
@@ -146,14 +150,15 @@ void RailCamera::Update() {
 		newPosition = initialPosition_ + directionToInitial * kMaxMoveRadius_;
 	}
 	
-	worldtransfrom_.matWorld_ = rotationMatrix;
-	worldtransfrom_.matWorld_.m[3][0] = newPosition.x;
-	worldtransfrom_.matWorld_.m[3][1] = newPosition.y;
-	worldtransfrom_.matWorld_.m[3][2] = newPosition.z;
+	Matrix4x4 matWorld = rotationMatrix;
+	matWorld.m[3][0] = newPosition.x;
+	matWorld.m[3][1] = newPosition.y;
+	matWorld.m[3][2] = newPosition.z;
+	// 直接設定して版を進める (親にしている自機が次の UpdateMatrix で作り直す)
+	worldtransfrom_.SetWorldMatrix(matWorld);
 	worldtransfrom_.translation_ = newPosition;
 
-	camera_.matView = KamataEngine::MathUtility::Inverse(worldtransfrom_.matWorld_);
-	camera_.TransferMatrix();
+	camera_.matView = InverseRigid(worldtransfrom_.matWorld_);
 }
 
 void RailCamera::Reset() {
@@ -166,14 +171,14 @@ void RailCamera::Reset() {
 	rotationVelocity_ = {0.0f, 0.0f, 0.0f};
 	assistAcceleration_ = {0.0f, 0.0f, 0.0f};
 
-	worldtransfrom_.matWorld_ = MakeIdentityMatrix();
-	worldtransfrom_.matWorld_.m[3][0] = initialPosition_.x;
-	worldtransfrom_.matWorld_.m[3][1] = initialPosition_.y;
-	worldtransfrom_.matWorld_.m[3][2] = initialPosition_.z;
+	Matrix4x4 matWorld = MakeIdentityMatrix();
+	matWorld.m[3][0] = initialPosition_.x;
+	matWorld.m[3][1] = initialPosition_.y;
+	matWorld.m[3][2] = initialPosition_.z;
+	worldtransfrom_.SetWorldMatrix(matWorld);
 	worldtransfrom_.translation_ = initialPosition_;
 
-	camera_.matView = KamataEngine::MathUtility::Inverse(worldtransfrom_.matWorld_);
-	camera_.TransferMatrix();
+	camera_.matView = InverseRigid(worldtransfrom_.matWorld_);
 
 	canMove_ = false;
 }
@@ -1,8 +1,9 @@
 #pragma once
-#include "../../Quaternion.h"
+#include "Quaternion.h"
 #include "MT.h"
-#include <3d/Camera.h>
-#include <3d/WorldTransform.h>
+#include "SimCamera.h"
+#include "SimInput.h"
+#include "SimTransform.h"
 
 class Player;
 
@@ -16,14 +17,16 @@ public:
 		float top = 1.0f;
 	};
 
-	void Initialize(const KamataEngine::Vector3& pos, const KamataEngine::Vector3& rad);
+	void Initialize(const KamataEngine::Vector3& pos, const KamataEngine::Vector3& rad, const SimInput* input);
 	void Update();
 
 	Player* target_ = nullptr;
 
 	void setTarget(Player* target) { target_ = target; }
-	const Camera& GetViewProjection() { return camera_; }
-	const WorldTransform& GetWorldTransform() { return worldtransfrom_; }
+	const SimCamera& GetViewProjection() { return camera_; }
+	// 描画の補間用: ステップ開始時のビュー行列を保存する
+	void SavePreviousView() { camera_.SavePrevious(); }
+	const SimTransform& GetWorldTransform() { return worldtransfrom_; }
 
 	const KamataEngine::Vector3& GetRotationVelocity() const { return rotationVelocity_; }
 
@@ -38,7 +41,9 @@ public:
 	void Dodge(float direction);
 
 private:
-	KamataEngine::WorldTransform worldtransfrom_;
+	SimTransform worldtransfrom_;
+
+	const SimInput* input_ = nullptr;
 
 	KamataEngine::Vector3 initialPosition_;
 	KamataEngine::Vector3 initialRotationEuler_;
@@ -52,7 +57,7 @@ private:
 
 	KamataEngine::Vector3 assistAcceleration_ = {0.0f, 0.0f, 0.0f}; // アシストによる加速度
 
-	Camera camera_;
+	SimCamera camera_;
 
 	bool canMove_;
 
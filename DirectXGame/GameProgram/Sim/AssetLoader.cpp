@@ -0,0 +1,219 @@
+#include "AssetLoader.h"
+#include "Profiler.h"
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+// path の最後の区切りまで (区切りが無ければ空)
+std::string GetDirectory(const std::string& path) {
+	size_t slash = path.find_last_of("/\\");
+	return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+}
+
+bool HasExtension(const std::string& path, const char* extension) {
+	size_t dot = path.find_last_of('.');
+	if (dot == std::string::npos) {
+		return false;
+	}
+	std::string ext = path.substr(dot + 1);
+	for (char& c : ext) {
+		if (c >= 'A' && c <= 'Z') {
+			c = static_cast<char>(c - 'A' + 'a');
+		}
+	}
+	return ext == extension;
+}
+
+// text の中の "keyword 名前" の行の名前を集める (相対パスは directory から)
+// OBJ は頂点の行が何万もあるので、行ごとに文字列を作らずにその場で調べる
+void CollectReferences(const std::string& text, const char* keyword, const std::string& directory, std::vector<std::string>& paths) {
+	const size_t keywordLength = std::strlen(keyword);
+	size_t lineStart = 0;
+	while (lineStart < text.size()) {
+		size_t lineEnd = text.find('\n', lineStart);
+		if (lineEnd == std::string::npos) {
+			lineEnd = text.size();
+		}
+		size_t begin = text.find_first_not_of(" \t", lineStart);
+		if (begin < lineEnd && text.compare(begin, keywordLength, keyword) == 0 && begin + keywordLength < lineEnd &&
+		    (text[begin + keywordLength] == ' ' || text[begin + keywordLength] == '\t')) {
+			size_t nameBegin = text.find_first_not_of(" \t", begin + keywordLength);
+			size_t nameEnd = lineEnd;
+			while (nameEnd > nameBegin && (text[nameEnd - 1] == '\r' || text[nameEnd - 1] == ' ' || text[nameEnd - 1] == '\t')) {
+				nameEnd--;
+			}
+			if (nameBegin < nameEnd) {
+				std::string name = text.substr(nameBegin, nameEnd - nameBegin);
+				bool isAbsolute = name[0] == '/' || name[0] == '\\' || name.find(':') != std::string::npos;
+				paths.push_back(isAbsolute ? name : directory + name);
+			}
+		}
+		lineStart = lineEnd + 1;
+	}
+}
+
+} // namespace
+
+AssetLoader::AssetLoader(JobSystem* jobs) : jobs_(jobs) {}
+
+AssetLoader::~AssetLoader() { Wait(); }
+
+AssetLoader::Handle AssetLoader::Request(const std::string& path, Finalizer finalizer) {
+	Handle handle = static_cast<Handle>(entries_.size());
+	entries_.push_back(std::make_unique<Entry>());
+	Entry* entry = entries_.back().get();
+	entry->path = path;
+	entry->finalizer = std::move(finalizer);
+
+	// jobs_ が無いかワーカーが無ければ、ここで読み終わる
+	JobSystem::Job job;
+	job.function = &AssetLoader::ReadJob;
+	job.data = entry;
+	job.begin = 0;
+	job.end = 1;
+	job.counter = &pending_;
+	if (jobs_) {
+		jobs_->Run(job);
+	} else {
+		ReadJob(entry, 0, 1);
+	}
+	return handle;
+}
+
+size_t AssetLoader::Finalize(double budgetSeconds) {
+	PROFILE_ZONE("AssetLoader::Finalize");
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	// 仕上げの中で Request されてもよいように、毎回 size を見る
+	for (size_t i = firstUnready_; i < entries_.size(); ++i) {
+		Entry& entry = *entries_[i];
+		if (entry.state.load(std::memory_order_acquire) != State::Read) {
+			continue;
+		}
+		if (entry.finalizer) {
+			entry.finalizer();
+			entry.finalizer = nullptr;
+		}
+		entry.state.store(State::Ready, std::memory_order_relaxed);
+		readyCount_++;
+
+		if (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() >= budgetSeconds) {
+			break;
+		}
+	}
+
+	while (firstUnready_ < entries_.size() && entries_[firstUnready_]->state.load(std::memory_order_relaxed) == State::Ready) {
+		firstUnready_++;
+	}
+	return entries_.size() - readyCount_;
+}
+
+void AssetLoader::FinalizeAll() {
+	while (!IsDone()) {
+		Wait();
+		Finalize(1.0e9);
+	}
+}
+
+void AssetLoader::Wait() {
+	if (jobs_) {
+		jobs_->Wait(pending_);
+	}
+}
+
+AssetLoader::State AssetLoader::GetState(Handle handle) const {
+	assert(handle < entries_.size());
+	return entries_[handle]->state.load(std::memory_order_acquire);
+}
+
+size_t AssetLoader::GetFilesRead() const {
+	size_t count = 0;
+	for (const std::unique_ptr<Entry>& entry : entries_) {
+		if (entry->state.load(std::memory_order_acquire) != State::Reading) {
+			count += entry->filesRead;
+		}
+	}
+	return count;
+}
+
+uint64_t AssetLoader::GetBytesRead() const {
+	uint64_t bytes = 0;
+	for (const std::unique_ptr<Entry>& entry : entries_) {
+		if (entry->state.load(std::memory_order_acquire) != State::Reading) {
+			bytes += entry->bytesRead;
+		}
+	}
+	return bytes;
+}
+
+size_t AssetLoader::GetMissingCount() const {
+	size_t count = 0;
+	for (const std::unique_ptr<Entry>& entry : entries_) {
+		if (entry->state.load(std::memory_order_acquire) != State::Reading) {
+			count += entry->missingCount;
+		}
+	}
+	return count;
+}
+
+void AssetLoader::ReadJob(void* data, size_t, size_t) {
+	Entry& entry = *static_cast<Entry*>(data);
+	ReadEntry(entry);
+	entry.state.store(State::Read, std::memory_order_release);
+}
+
+void AssetLoader::ReadEntry(Entry& entry) {
+	PROFILE_ZONE("AssetLoader::Read");
+	if (!HasExtension(entry.path, "obj")) {
+		ReadFile(entry.path, entry, nullptr);
+		return;
+	}
+
+	// OBJ → MTL → テクスチャの順にたどる (エンジンが仕上げのときに開くファイルを先に読んでおく)
+	std::string text;
+	if (!ReadFile(entry.path, entry, &text)) {
+		return;
+	}
+	std::vector<std::string> materials;
+	CollectReferences(text, "mtllib", GetDirectory(entry.path), materials);
+	for (const std::string& material : materials) {
+		if (!ReadFile(material, entry, &text)) {
+			continue;
+		}
+		std::vector<std::string> textures;
+		CollectReferences(text, "map_Kd", GetDirectory(material), textures);
+		for (const std::string& texture : textures) {
+			ReadFile(texture, entry, nullptr);
+		}
+	}
+}
+
+bool AssetLoader::ReadFile(const std::string& path, Entry& entry, std::string* text) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open()) {
+		entry.missingCount++;
+		return false;
+	}
+
+	// テキストは中身を返し、それ以外は読み捨てる (OS のファイルキャッシュに載せるだけ)
+	char buffer[64 * 1024];
+	if (text) {
+		text->clear();
+	}
+	while (file) {
+		file.read(buffer, sizeof(buffer));
+		std::streamsize count = file.gcount();
+		if (count <= 0) {
+			break;
+		}
+		entry.bytesRead += static_cast<uint64_t>(count);
+		if (text) {
+			text->append(buffer, static_cast<size_t>(count));
+		}
+	}
+	entry.filesRead++;
+	return true;
+}
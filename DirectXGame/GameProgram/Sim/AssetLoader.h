@@ -0,0 +1,101 @@
+#pragma once
+#include "JobSystem.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// 起動時のアセットを裏で読み込む
+/// ファイルの読み込み (OBJ なら参照している MTL とテクスチャも) はワーカースレッドで行い、
+/// 読み終わったものの仕上げ (GPU へのアップロードなど、メインスレッドでしかできない処理) は Finalize で依頼順に行う
+/// Finalize に時間の上限を渡せるので、タイトル画面を出したまま 1 フレームに少しずつ仕上げられる
+///
+/// 使い方:
+///   AssetLoader loader(&jobs);   // シミュレーションと同じスレッドを使う
+///   AssetLoader::Handle sky = loader.Request("Resources/skydome/skydome.obj", [&]() { model = Model::CreateFromOBJ("skydome", true); });
+///   // 毎フレーム
+///   loader.Finalize(0.004);
+///   if (loader.IsReady(sky)) { ... }
+/// </summary>
+class AssetLoader {
+public:
+	// Request が返す番号 (仕上がったかどうかを問い合わせる)
+	using Handle = uint32_t;
+	// メインスレッドで行う仕上げ
+	using Finalizer = std::function<void()>;
+
+	enum class State : uint8_t {
+		Reading, // ワーカーで読み込み中
+		Read,    // 読み終わって仕上げ待ち
+		Ready,   // 仕上げ済み
+	};
+
+	/// <summary>
+	/// jobs のスレッドで読む (jobs が null かワーカーが無ければ Request の中で読む)
+	/// jobs はこのローダーより後に消すこと
+	/// </summary>
+	explicit AssetLoader(JobSystem* jobs);
+	// 読み込み中のファイルは読み終わるのを待つ (仕上げはしない)
+	~AssetLoader();
+
+	AssetLoader(const AssetLoader&) = delete;
+	AssetLoader& operator=(const AssetLoader&) = delete;
+
+	/// <summary>
+	/// path のファイルを読み、読み終わったら Finalize の中で finalizer を呼ぶ
+	/// 見つからないファイルも仕上げは行う (finalizer の側で読み込みに失敗したときの処理をする)
+	/// </summary>
+	Handle Request(const std::string& path, Finalizer finalizer);
+
+	/// <summary>
+	/// 読み終わったものを依頼順に仕上げる。budgetSeconds を超えたら残りは次に回す (1 つは必ず仕上げる)
+	/// </summary>
+	/// <returns>まだ仕上げていない数</returns>
+	size_t Finalize(double budgetSeconds);
+
+	/// <summary>
+	/// 全部読み終わるのを待って (読み込みを手伝いながら)、全部仕上げる
+	/// </summary>
+	void FinalizeAll();
+
+	State GetState(Handle handle) const;
+	bool IsReady(Handle handle) const { return GetState(handle) == State::Ready; }
+	// 依頼したものが全部仕上がったか
+	bool IsDone() const { return readyCount_ == entries_.size(); }
+
+	// 読み終わったものについて、読んだファイルの数・バイト数・見つからなかったファイルの数 (参照先を含む)
+	size_t GetFilesRead() const;
+	uint64_t GetBytesRead() const;
+	size_t GetMissingCount() const;
+
+private:
+	struct Entry {
+		std::string path;
+		Finalizer finalizer;
+		std::atomic<State> state{State::Reading};
+		// ワーカーが書き、state を Read にしてからメインスレッドが読む
+		uint32_t filesRead = 0;
+		uint32_t missingCount = 0;
+		uint64_t bytesRead = 0;
+	};
+
+	static void ReadJob(void* data, size_t begin, size_t end);
+	// 読み込み中のものが読み終わるのを (読み込みを手伝いながら) 待つ
+	void Wait();
+	// entry.path と、OBJ なら mtllib・map_Kd で参照しているファイルを読む
+	static void ReadEntry(Entry& entry);
+	// 1 ファイル読み込む (見つからなければ false)
+	static bool ReadFile(const std::string& path, Entry& entry, std::string* text);
+
+	JobSystem* jobs_ = nullptr;
+	// 読み込み中の数
+	JobSystem::Counter pending_;
+	std::vector<std::unique_ptr<Entry>> entries_;
+	// 仕上げた数と、ここより前は全部仕上げ済みという位置
+	size_t readyCount_ = 0;
+	size_t firstUnready_ = 0;
+};
@@ -0,0 +1,149 @@
+#include "BulletStore.h"
+#include "MT.h"
+#include "Simd.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// 原点を中心とする半径の 2 乗 radiusSq の球と、線分 a → b が当たっているか
+bool SegmentHitsOrigin(float ax, float ay, float az, float bx, float by, float bz, float radiusSq) {
+	float dx = bx - ax;
+	float dy = by - ay;
+	float dz = bz - az;
+	// 線分上で原点に一番近い点の位置 (0 で a、1 で b)
+	float lengthSq = dx * dx + dy * dy + dz * dz;
+	float t = lengthSq > 0.0f ? std::clamp(-(ax * dx + ay * dy + az * dz) / lengthSq, 0.0f, 1.0f) : 0.0f;
+	float qx = ax + dx * t;
+	float qy = ay + dy * t;
+	float qz = az + dz * t;
+	return qx * qx + qy * qy + qz * qz <= radiusSq;
+}
+
+} // namespace
+
+void BulletStore::Reserve(size_t capacity) {
+	capacity_ = capacity;
+	activeEnd_ = 0;
+	// 端数の処理を無くすため、配列は SIMD の幅に切り上げておく (余りのスロットは寿命 0 のまま)
+	size_t size = RoundUpToLanes(capacity);
+	for (std::vector<float>* array : {&posX_, &posY_, &posZ_, &prevX_, &prevY_, &prevZ_, &velX_, &velY_, &velZ_, &life_}) {
+		array->assign(size, 0.0f);
+	}
+}
+
+void BulletStore::Activate(uint32_t slot, const KamataEngine::Vector3& position, const KamataEngine::Vector3& velocity, float life) {
+	posX_[slot] = prevX_[slot] = position.x;
+	posY_[slot] = prevY_[slot] = position.y;
+	posZ_[slot] = prevZ_[slot] = position.z;
+	SetVelocity(slot, velocity);
+	life_[slot] = life;
+	activeEnd_ = std::max(activeEnd_, RoundUpToLanes(static_cast<size_t>(slot) + 1));
+}
+
+void BulletStore::Deactivate(uint32_t slot) {
+	SetVelocity(slot, {0.0f, 0.0f, 0.0f});
+	life_[slot] = 0.0f;
+}
+
+void BulletStore::SetVelocity(uint32_t slot, const KamataEngine::Vector3& velocity) {
+	velX_[slot] = velocity.x;
+	velY_[slot] = velocity.y;
+	velZ_[slot] = velocity.z;
+}
+
+void BulletStore::Integrate(float lifeStep) {
+#ifdef MT_SSE2
+	const __m128 step = _mm_set1_ps(lifeStep);
+	const __m128 zero = _mm_setzero_ps();
+	for (size_t i = 0; i < activeEnd_; i += kSimdLanes) {
+		// 寿命を減らし、まだ残っている弾だけ動かす (尽きた弾は元の位置に残す)
+		__m128 life = _mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&life_[i]), step), zero);
+		__m128 alive = _mm_cmpgt_ps(life, zero);
+		_mm_storeu_ps(&life_[i], life);
+		_mm_storeu_ps(&posX_[i], _mm_add_ps(_mm_loadu_ps(&posX_[i]), _mm_and_ps(_mm_loadu_ps(&velX_[i]), alive)));
+		_mm_storeu_ps(&posY_[i], _mm_add_ps(_mm_loadu_ps(&posY_[i]), _mm_and_ps(_mm_loadu_ps(&velY_[i]), alive)));
+		_mm_storeu_ps(&posZ_[i], _mm_add_ps(_mm_loadu_ps(&posZ_[i]), _mm_and_ps(_mm_loadu_ps(&velZ_[i]), alive)));
+	}
+#else
+	for (size_t i = 0; i < activeEnd_; ++i) {
+		life_[i] = std::max(life_[i] - lifeStep, 0.0f);
+		if (life_[i] > 0.0f) {
+			posX_[i] += velX_[i];
+			posY_[i] += velY_[i];
+			posZ_[i] += velZ_[i];
+		}
+	}
+#endif
+}
+
+void BulletStore::SavePrevious() {
+	if (activeEnd_ == 0) {
+		return;
+	}
+	std::memcpy(prevX_.data(), posX_.data(), activeEnd_ * sizeof(float));
+	std::memcpy(prevY_.data(), posY_.data(), activeEnd_ * sizeof(float));
+	std::memcpy(prevZ_.data(), posZ_.data(), activeEnd_ * sizeof(float));
+}
+
+void BulletStore::SweepSphere(const KamataEngine::Vector3& centerPrev, const KamataEngine::Vector3& center, float radius, const std::vector<uint32_t>& slots, std::vector<uint8_t>& hits) const {
+	hits.resize(slots.size());
+	const float radiusSq = radius * radius;
+	size_t i = 0;
+#ifdef MT_SSE2
+	const __m128 prevCenterX = _mm_set1_ps(centerPrev.x);
+	const __m128 prevCenterY = _mm_set1_ps(centerPrev.y);
+	const __m128 prevCenterZ = _mm_set1_ps(centerPrev.z);
+	const __m128 centerX = _mm_set1_ps(center.x);
+	const __m128 centerY = _mm_set1_ps(center.y);
+	const __m128 centerZ = _mm_set1_ps(center.z);
+	const __m128 radiusSq4 = _mm_set1_ps(radiusSq);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	// 止まっている弾 (長さ 0) で 0 除算しないための下限
+	const __m128 minLengthSq = _mm_set1_ps(1.0e-12f);
+	for (; i + kSimdLanes <= slots.size(); i += kSimdLanes) {
+		// 候補のスロットは飛び飛びなので 4 発分を集めてから、球から見た相対位置にする
+		const uint32_t* s = &slots[i];
+		__m128 ax = _mm_sub_ps(_mm_set_ps(prevX_[s[3]], prevX_[s[2]], prevX_[s[1]], prevX_[s[0]]), prevCenterX);
+		__m128 ay = _mm_sub_ps(_mm_set_ps(prevY_[s[3]], prevY_[s[2]], prevY_[s[1]], prevY_[s[0]]), prevCenterY);
+		__m128 az = _mm_sub_ps(_mm_set_ps(prevZ_[s[3]], prevZ_[s[2]], prevZ_[s[1]], prevZ_[s[0]]), prevCenterZ);
+		__m128 dx = _mm_sub_ps(_mm_sub_ps(_mm_set_ps(posX_[s[3]], posX_[s[2]], posX_[s[1]], posX_[s[0]]), centerX), ax);
+		__m128 dy = _mm_sub_ps(_mm_sub_ps(_mm_set_ps(posY_[s[3]], posY_[s[2]], posY_[s[1]], posY_[s[0]]), centerY), ay);
+		__m128 dz = _mm_sub_ps(_mm_sub_ps(_mm_set_ps(posZ_[s[3]], posZ_[s[2]], posZ_[s[1]], posZ_[s[0]]), centerZ), az);
+
+		__m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+		__m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, dx), _mm_mul_ps(ay, dy)), _mm_mul_ps(az, dz));
+		__m128 t = _mm_div_ps(_mm_sub_ps(zero, dot), _mm_max_ps(lengthSq, minLengthSq));
+		t = _mm_min_ps(_mm_max_ps(t, zero), one);
+
+		__m128 qx = _mm_add_ps(ax, _mm_mul_ps(dx, t));
+		__m128 qy = _mm_add_ps(ay, _mm_mul_ps(dy, t));
+		__m128 qz = _mm_add_ps(az, _mm_mul_ps(dz, t));
+		__m128 distanceSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(qx, qx), _mm_mul_ps(qy, qy)), _mm_mul_ps(qz, qz));
+		int mask = _mm_movemask_ps(_mm_cmple_ps(distanceSq, radiusSq4));
+		for (size_t lane = 0; lane < kSimdLanes; ++lane) {
+			hits[i + lane] = static_cast<uint8_t>((mask >> lane) & 1);
+		}
+	}
+#endif
+	// SIMD の幅に足りない残り (SSE2 が無ければ全部)
+	for (; i < slots.size(); ++i) {
+		uint32_t slot = slots[i];
+		hits[i] = SegmentHitsOrigin(
+		              prevX_[slot] - centerPrev.x, prevY_[slot] - centerPrev.y, prevZ_[slot] - centerPrev.z, posX_[slot] - center.x, posY_[slot] - center.y, posZ_[slot] - center.z, radiusSq)
+		              ? 1
+		              : 0;
+	}
+}
+
+KamataEngine::Matrix4x4 BulletStore::GetMatrix(uint32_t slot) const { return MakeTranslateMatrix(GetPosition(slot)); }
+
+KamataEngine::Matrix4x4 BulletStore::GetInterpolatedMatrix(uint32_t slot, float alpha) const {
+	KamataEngine::Vector3 position = {
+	    prevX_[slot] + (posX_[slot] - prevX_[slot]) * alpha,
+	    prevY_[slot] + (posY_[slot] - prevY_[slot]) * alpha,
+	    prevZ_[slot] + (posZ_[slot] - prevZ_[slot]) * alpha,
+	};
+	return MakeTranslateMatrix(position);
+}
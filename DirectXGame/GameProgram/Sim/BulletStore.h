@@ -0,0 +1,77 @@
+#pragma once
+#include <math/Matrix4x4.h>
+#include <math/Vector3.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// 弾の移動に使う値を成分ごとの配列 (SoA) で持つ
+/// 位置・前ステップの位置・速度・寿命を連続した配列に置き、全弾の移動を SIMD でまとめて進める
+/// スロット番号は ObjectPool のインデックスと同じものを使い、追尾などの挙動は弾のクラス側に残す
+/// 弾は拡大・回転しないので行列は持たず、描画するときに位置から作る
+/// </summary>
+class BulletStore {
+public:
+	BulletStore() = default;
+	explicit BulletStore(size_t capacity) { Reserve(capacity); }
+
+	/// <summary>
+	/// スロット数を設定して全スロットを空きにする
+	/// </summary>
+	void Reserve(size_t capacity);
+
+	size_t GetCapacity() const { return capacity_; }
+
+	/// <summary>
+	/// スロットを使い始める (前ステップの位置も同じ位置にするので、最初のフレームは補間しない)
+	/// </summary>
+	/// <param name="life">寿命 (Integrate の lifeStep と同じ単位)</param>
+	void Activate(uint32_t slot, const KamataEngine::Vector3& position, const KamataEngine::Vector3& velocity, float life);
+
+	// スロットを空きにする (速度と寿命を 0 にして、Integrate で動かないようにする)
+	void Deactivate(uint32_t slot);
+
+	KamataEngine::Vector3 GetPosition(uint32_t slot) const { return {posX_[slot], posY_[slot], posZ_[slot]}; }
+	KamataEngine::Vector3 GetPreviousPosition(uint32_t slot) const { return {prevX_[slot], prevY_[slot], prevZ_[slot]}; }
+	KamataEngine::Vector3 GetVelocity(uint32_t slot) const { return {velX_[slot], velY_[slot], velZ_[slot]}; }
+	void SetVelocity(uint32_t slot, const KamataEngine::Vector3& velocity);
+
+	float GetLife(uint32_t slot) const { return life_[slot]; }
+	void SetLife(uint32_t slot, float life) { life_[slot] = life; }
+	// 寿命が尽きたか (Integrate の後に確認する)
+	bool IsExpired(uint32_t slot) const { return life_[slot] <= 0.0f; }
+
+	/// <summary>
+	/// 全スロットの寿命を lifeStep 減らし、寿命が残っているスロットだけ位置に速度を足す
+	/// </summary>
+	void Integrate(float lifeStep);
+
+	// ステップ開始時の位置を補間用に保存する
+	void SavePrevious();
+
+	/// <summary>
+	/// 弾がこのステップで通った線分 (前ステップの位置 → 今の位置) と球が当たったかを、slots の弾について 4 発ずつまとめて調べる
+	/// 球も動く場合は球から見た相対的な線分で調べるので、速い弾が球を通り抜けても見逃さない
+	/// </summary>
+	/// <param name="centerPrev">前ステップの球の中心</param>
+	/// <param name="center">今の球の中心</param>
+	/// <param name="radius">球の半径と弾の半径の和</param>
+	/// <param name="slots">調べるスロット (飛び飛びで良い)</param>
+	/// <param name="hits">slots と同じ順番で、当たったら 1、外れたら 0 を入れる</param>
+	void SweepSphere(const KamataEngine::Vector3& centerPrev, const KamataEngine::Vector3& center, float radius, const std::vector<uint32_t>& slots, std::vector<uint8_t>& hits) const;
+
+	// 描画用の行列 (平行移動だけ)
+	KamataEngine::Matrix4x4 GetMatrix(uint32_t slot) const;
+	KamataEngine::Matrix4x4 GetInterpolatedMatrix(uint32_t slot, float alpha) const;
+
+private:
+	size_t capacity_ = 0;
+	// 一度でも使ったスロットの末尾 (SIMD の幅に切り上げる)。Integrate はここまで回す
+	size_t activeEnd_ = 0;
+
+	std::vector<float> posX_, posY_, posZ_;
+	std::vector<float> prevX_, prevY_, prevZ_;
+	std::vector<float> velX_, velY_, velZ_;
+	std::vector<float> life_;
+};
@@ -0,0 +1,429 @@
+#pragma once
+#include "AABB.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/// <summary>
+/// 動くオブジェクト用の AABB の木 (BVH)
+/// 葉には少し大きめの箱 (fat AABB) を入れておき、オブジェクトがその箱からはみ出したときだけ入れ直す
+/// 入れる場所は表面積の増え方が一番小さい所を選び (SAH)、木の高さは回転で揃えるので、問い合わせは O(log n)
+/// 敵や隕石のように、大きくてゆっくり動くものを長く入れておく用途に向いている
+/// (毎ステップ作り直す小さくて速い弾は SpatialHashGrid の方が向いている)
+///
+/// 問い合わせの途中の作業用配列を使い回すので、コールバックの中から同じ木に問い合わせないこと
+/// </summary>
+/// <typeparam name="T">葉に持たせる値 (オブジェクトのポインタなど)</typeparam>
+template <typename T> class DynamicAABBTree {
+public:
+	static constexpr int32_t kNull = -1;
+
+	/// <param name="margin">fat AABB の余白 (この分動くまでは入れ直さない)</param>
+	/// <param name="displacementMultiplier">動いた向きに余白を伸ばす倍率 (移動量 × この値)</param>
+	explicit DynamicAABBTree(float margin = 1.0f, float displacementMultiplier = 4.0f) : margin_(margin), displacementMultiplier_(displacementMultiplier) {}
+
+	DynamicAABBTree(const DynamicAABBTree&) = delete;
+	DynamicAABBTree& operator=(const DynamicAABBTree&) = delete;
+
+	/// <summary>
+	/// 葉を追加する
+	/// </summary>
+	/// <returns>葉の番号 (MoveProxy / DestroyProxy に渡す)</returns>
+	int32_t CreateProxy(const AABB& aabb, const T& userData) {
+		int32_t proxy = AllocateNode();
+		Node& node = nodes_[proxy];
+		node.tight = aabb;
+		node.fat = Fatten(aabb, {0.0f, 0.0f, 0.0f});
+		node.userData = userData;
+		node.height = 0;
+		InsertLeaf(proxy);
+		proxyCount_++;
+		return proxy;
+	}
+
+	void DestroyProxy(int32_t proxy) {
+		assert(IsLeaf(proxy));
+		RemoveLeaf(proxy);
+		FreeNode(proxy);
+		proxyCount_--;
+	}
+
+	/// <summary>
+	/// 葉の箱を更新する。fat AABB に収まっている間は箱を覚えるだけで、木は変えない
+	/// </summary>
+	/// <param name="displacement">このステップの移動量 (この向きに余白を伸ばして、次の入れ直しを減らす)</param>
+	/// <returns>入れ直したら true</returns>
+	bool MoveProxy(int32_t proxy, const AABB& aabb, const KamataEngine::Vector3& displacement) {
+		assert(IsLeaf(proxy));
+		nodes_[proxy].tight = aabb;
+		if (ContainsAABB(nodes_[proxy].fat, aabb)) {
+			return false;
+		}
+		RemoveLeaf(proxy);
+		nodes_[proxy].fat = Fatten(aabb, displacement);
+		InsertLeaf(proxy);
+		return true;
+	}
+
+	// 全ての葉を消す (確保した配列は残す)
+	void Clear() {
+		nodes_.clear();
+		root_ = kNull;
+		freeList_ = kNull;
+		proxyCount_ = 0;
+	}
+
+	const T& GetUserData(int32_t proxy) const { return nodes_[proxy].userData; }
+	const AABB& GetFatAABB(int32_t proxy) const { return nodes_[proxy].fat; }
+	size_t GetProxyCount() const { return proxyCount_; }
+	// 木の高さ (葉だけなら 0、空なら -1)
+	int32_t GetHeight() const { return root_ == kNull ? -1 : nodes_[root_].height; }
+
+	/// <summary>
+	/// 木の形が正しいか確かめる (テスト用)
+	/// 親子のつながり、親の箱が子の箱を含むこと、葉の fat AABB が実際の箱を含むこと、高さと左右の高さの差 (1 以下)、葉の数を見る
+	/// </summary>
+	bool IsValid() const {
+		size_t leafCount = 0;
+		if (root_ != kNull && !IsValidNode(root_, kNull, leafCount)) {
+			return false;
+		}
+		return leafCount == proxyCount_;
+	}
+
+	/// <summary>
+	/// aabb と fat AABB が重なる葉を全て callback(userData) に渡す
+	/// callback が false を返したらそこで止める
+	/// </summary>
+	template <typename Callback> void Query(const AABB& aabb, Callback callback) const {
+		stack_.clear();
+		if (root_ != kNull) {
+			stack_.push_back(root_);
+		}
+		while (!stack_.empty()) {
+			int32_t index = stack_.back();
+			stack_.pop_back();
+			const Node& node = nodes_[index];
+			if (!IsCollisionAABB(node.fat, aabb)) {
+				continue;
+			}
+			if (node.IsLeaf()) {
+				if (!callback(node.userData)) {
+					return;
+				}
+			} else {
+				stack_.push_back(node.child1);
+				stack_.push_back(node.child2);
+			}
+		}
+	}
+
+	/// <summary>
+	/// origin から direction の向きに maxDistance まで伸ばした線分と fat AABB が交わる葉を callback(userData, distance) に渡す
+	/// callback は以降の探索の最大距離を返す (当たった距離を返せば一番近いもの、0 を返せばそこで止まる、maxDistance を返せば全部)
+	/// </summary>
+	template <typename Callback> void RayCast(const KamataEngine::Vector3& origin, const KamataEngine::Vector3& direction, float maxDistance, Callback callback) const {
+		stack_.clear();
+		if (root_ != kNull) {
+			stack_.push_back(root_);
+		}
+		while (!stack_.empty()) {
+			int32_t index = stack_.back();
+			stack_.pop_back();
+			const Node& node = nodes_[index];
+			float distance = 0.0f;
+			if (!RayIntersectsAABB(origin, direction, maxDistance, node.fat, distance)) {
+				continue;
+			}
+			if (node.IsLeaf()) {
+				maxDistance = std::min(maxDistance, callback(node.userData, distance));
+				if (maxDistance <= 0.0f) {
+					return;
+				}
+			} else {
+				stack_.push_back(node.child1);
+				stack_.push_back(node.child2);
+			}
+		}
+	}
+
+	/// <summary>
+	/// point に近い順に、filter(userData) が true の葉を最大 count 個 out に入れる (out は消さずに末尾に足す)
+	/// 距離は葉の実際の箱 (MoveProxy で渡した箱) までの距離で、maxDistance より遠い葉は入れない
+	/// </summary>
+	template <typename Filter> void QueryNearest(const KamataEngine::Vector3& point, size_t count, float maxDistance, std::vector<T>& out, Filter filter) const {
+		// 近い順に取り出す。途中の節は fat AABB (子の箱を全部含む) までの距離で並べるので、葉は必ず近い順に出てくる
+		heap_.clear();
+		if (root_ == kNull || count == 0) {
+			return;
+		}
+		const float maxDistanceSq = maxDistance * maxDistance;
+		auto push = [this, &point](int32_t index) {
+			const Node& node = nodes_[index];
+			heap_.push_back({DistanceSquaredToAABB(point, node.IsLeaf() ? node.tight : node.fat), index});
+			std::push_heap(heap_.begin(), heap_.end(), std::greater<>());
+		};
+		push(root_);
+		size_t found = 0;
+		while (!heap_.empty()) {
+			std::pop_heap(heap_.begin(), heap_.end(), std::greater<>());
+			auto [distanceSq, index] = heap_.back();
+			heap_.pop_back();
+			if (distanceSq > maxDistanceSq) {
+				break;
+			}
+			const Node& node = nodes_[index];
+			if (node.IsLeaf()) {
+				if (filter(node.userData)) {
+					out.push_back(node.userData);
+					if (++found >= count) {
+						break;
+					}
+				}
+			} else {
+				push(node.child1);
+				push(node.child2);
+			}
+		}
+	}
+
+private:
+	struct Node {
+		// 葉はオブジェクトの箱に余白を足した箱、途中の節は子の箱を全部含む箱
+		AABB fat;
+		// 葉のオブジェクトの実際の箱
+		AABB tight;
+		T userData{};
+		// 空きノードのときは次の空きノード
+		int32_t parent = kNull;
+		int32_t child1 = kNull;
+		int32_t child2 = kNull;
+		// 葉は 0、空きノードは -1
+		int32_t height = -1;
+
+		bool IsLeaf() const { return child1 == kNull; }
+	};
+
+	bool IsLeaf(int32_t index) const { return index >= 0 && index < static_cast<int32_t>(nodes_.size()) && nodes_[index].height == 0; }
+
+	bool IsValidNode(int32_t index, int32_t parent, size_t& leafCount) const {
+		const Node& node = nodes_[index];
+		if (node.parent != parent) {
+			return false;
+		}
+		if (node.IsLeaf()) {
+			leafCount++;
+			return node.child2 == kNull && node.height == 0 && ContainsAABB(node.fat, node.tight);
+		}
+		const Node& child1 = nodes_[node.child1];
+		const Node& child2 = nodes_[node.child2];
+		if (node.height != 1 + std::max(child1.height, child2.height) || std::abs(child1.height - child2.height) > 1) {
+			return false;
+		}
+		if (!ContainsAABB(node.fat, child1.fat) || !ContainsAABB(node.fat, child2.fat)) {
+			return false;
+		}
+		return IsValidNode(node.child1, index, leafCount) && IsValidNode(node.child2, index, leafCount);
+	}
+
+	AABB Fatten(const AABB& aabb, const KamataEngine::Vector3& displacement) const {
+		AABB fat = aabb;
+		fat.min = {fat.min.x - margin_, fat.min.y - margin_, fat.min.z - margin_};
+		fat.max = {fat.max.x + margin_, fat.max.y + margin_, fat.max.z + margin_};
+		// 動いている向きにだけ伸ばす
+		KamataEngine::Vector3 d = {displacement.x * displacementMultiplier_, displacement.y * displacementMultiplier_, displacement.z * displacementMultiplier_};
+		(d.x < 0.0f ? fat.min.x : fat.max.x) += d.x;
+		(d.y < 0.0f ? fat.min.y : fat.max.y) += d.y;
+		(d.z < 0.0f ? fat.min.z : fat.max.z) += d.z;
+		return fat;
+	}
+
+	int32_t AllocateNode() {
+		int32_t index;
+		if (freeList_ != kNull) {
+			index = freeList_;
+			freeList_ = nodes_[index].parent;
+		} else {
+			index = static_cast<int32_t>(nodes_.size());
+			nodes_.emplace_back();
+		}
+		nodes_[index] = Node();
+		return index;
+	}
+
+	void FreeNode(int32_t index) {
+		nodes_[index] = Node();
+		nodes_[index].parent = freeList_;
+		freeList_ = index;
+	}
+
+	void InsertLeaf(int32_t leaf) {
+		if (root_ == kNull) {
+			root_ = leaf;
+			nodes_[leaf].parent = kNull;
+			return;
+		}
+
+		// 兄弟にする節を探す (表面積の増え方が一番小さい所)
+		const AABB leafAABB = nodes_[leaf].fat;
+		int32_t index = root_;
+		while (!nodes_[index].IsLeaf()) {
+			const Node& node = nodes_[index];
+			float area = SurfaceAreaAABB(node.fat);
+			float combinedArea = SurfaceAreaAABB(MergeAABB(node.fat, leafAABB));
+			// ここに新しい親を作る場合のコスト
+			float cost = 2.0f * combinedArea;
+			// 下に降りる場合、この節から上の箱が広がる分のコスト
+			float inheritanceCost = 2.0f * (combinedArea - area);
+
+			float cost1 = ChildCost(node.child1, leafAABB) + inheritanceCost;
+			float cost2 = ChildCost(node.child2, leafAABB) + inheritanceCost;
+			if (cost < cost1 && cost < cost2) {
+				break;
+			}
+			index = cost1 < cost2 ? node.child1 : node.child2;
+		}
+		int32_t sibling = index;
+
+		// 兄弟と新しい葉をまとめる親を作る
+		int32_t oldParent = nodes_[sibling].parent;
+		int32_t newParent = AllocateNode();
+		nodes_[newParent].parent = oldParent;
+		nodes_[newParent].fat = MergeAABB(leafAABB, nodes_[sibling].fat);
+		nodes_[newParent].height = nodes_[sibling].height + 1;
+		nodes_[newParent].child1 = sibling;
+		nodes_[newParent].child2 = leaf;
+		nodes_[sibling].parent = newParent;
+		nodes_[leaf].parent = newParent;
+		if (oldParent == kNull) {
+			root_ = newParent;
+		} else if (nodes_[oldParent].child1 == sibling) {
+			nodes_[oldParent].child1 = newParent;
+		} else {
+			nodes_[oldParent].child2 = newParent;
+		}
+
+		// 上に向かって箱と高さを直す
+		RefitFrom(nodes_[leaf].parent);
+	}
+
+	// child の下に葉を入れた場合に増える表面積
+	float ChildCost(int32_t child, const AABB& leafAABB) const {
+		const Node& node = nodes_[child];
+		float merged = SurfaceAreaAABB(MergeAABB(leafAABB, node.fat));
+		return node.IsLeaf() ? merged : merged - SurfaceAreaAABB(node.fat);
+	}
+
+	void RemoveLeaf(int32_t leaf) {
+		if (leaf == root_) {
+			root_ = kNull;
+			return;
+		}
+
+		// 親を消して、兄弟を祖父につなぐ
+		int32_t parent = nodes_[leaf].parent;
+		int32_t grandParent = nodes_[parent].parent;
+		int32_t sibling = nodes_[parent].child1 == leaf ? nodes_[parent].child2 : nodes_[parent].child1;
+		FreeNode(parent);
+		nodes_[leaf].parent = kNull;
+
+		if (grandParent == kNull) {
+			root_ = sibling;
+			nodes_[sibling].parent = kNull;
+			return;
+		}
+		if (nodes_[grandParent].child1 == parent) {
+			nodes_[grandParent].child1 = sibling;
+		} else {
+			nodes_[grandParent].child2 = sibling;
+		}
+		nodes_[sibling].parent = grandParent;
+		RefitFrom(grandParent);
+	}
+
+	// index から根まで、回転で高さを揃えながら箱と高さを直す
+	void RefitFrom(int32_t index) {
+		while (index != kNull) {
+			index = Balance(index);
+			Node& node = nodes_[index];
+			node.height = 1 + std::max(nodes_[node.child1].height, nodes_[node.child2].height);
+			node.fat = MergeAABB(nodes_[node.child1].fat, nodes_[node.child2].fat);
+			index = node.parent;
+		}
+	}
+
+	/// <summary>
+	/// 左右の高さの差が 2 以上なら、高い方の子を a の位置に持ち上げる (AVL 木の回転)
+	/// </summary>
+	/// <returns>回転後に a の位置にある節</returns>
+	int32_t Balance(int32_t a) {
+		if (nodes_[a].IsLeaf() || nodes_[a].height < 2) {
+			return a;
+		}
+		int32_t b = nodes_[a].child1;
+		int32_t c = nodes_[a].child2;
+		int32_t balance = nodes_[c].height - nodes_[b].height;
+		if (balance > 1) {
+			return Rotate(a, c, b);
+		}
+		if (balance < -1) {
+			return Rotate(a, b, c);
+		}
+		return a;
+	}
+
+	// a の高い方の子 high を a の位置に上げ、a は high の低い方の孫と low を子に持つ
+	int32_t Rotate(int32_t a, int32_t high, int32_t low) {
+		int32_t f = nodes_[high].child1;
+		int32_t g = nodes_[high].child2;
+
+		// high を a の位置に
+		nodes_[high].child1 = a;
+		nodes_[high].parent = nodes_[a].parent;
+		nodes_[a].parent = high;
+		int32_t parent = nodes_[high].parent;
+		if (parent == kNull) {
+			root_ = high;
+		} else if (nodes_[parent].child1 == a) {
+			nodes_[parent].child1 = high;
+		} else {
+			nodes_[parent].child2 = high;
+		}
+
+		// 高い方の孫は high に残し、低い方の孫を a に付ける
+		int32_t keep = nodes_[f].height > nodes_[g].height ? f : g;
+		int32_t move = keep == f ? g : f;
+		nodes_[high].child2 = keep;
+		if (nodes_[a].child1 == high) {
+			nodes_[a].child1 = move;
+		} else {
+			nodes_[a].child2 = move;
+		}
+		nodes_[move].parent = a;
+
+		nodes_[a].fat = MergeAABB(nodes_[low].fat, nodes_[move].fat);
+		nodes_[a].height = 1 + std::max(nodes_[low].height, nodes_[move].height);
+		// 背の高い節の隣に葉を入れた直後などは、下ろした a の左右の差がまだ 2 以上あるので、a の下も揃える
+		int32_t lowered = Balance(a);
+		nodes_[high].fat = MergeAABB(nodes_[lowered].fat, nodes_[keep].fat);
+		nodes_[high].height = 1 + std::max(nodes_[lowered].height, nodes_[keep].height);
+		return high;
+	}
+
+	float margin_;
+	float displacementMultiplier_;
+
+	std::vector<Node> nodes_;
+	int32_t root_ = kNull;
+	int32_t freeList_ = kNull;
+	size_t proxyCount_ = 0;
+
+	// 問い合わせの作業用 (使い回してメモリ確保を減らす)
+	mutable std::vector<int32_t> stack_;
+	mutable std::vector<std::pair<float, int32_t>> heap_;
+};
@@ -0,0 +1,61 @@
+#include "GameFlow.h"
+#include "GameWorld.h"
+
+void GameFlow::Step(GameWorld& world) {
+	switch (state_) {
+	case State::Start:
+		if (world.GetInput().TriggerKey(SimKey::Space)) {
+			state_ = State::TransitionToGame;
+			transitionTimer_ = 0;
+		}
+		break;
+	case State::TransitionToGame:
+		transitionTimer_++;
+		if (transitionTimer_ >= kTransitionSteps) {
+			state_ = State::TransitionFromGame;
+			transitionTimer_ = 0;
+		}
+		break;
+	case State::TransitionFromGame:
+		transitionTimer_++;
+		if (transitionTimer_ >= kTransitionSteps) {
+			state_ = State::GameIntro;
+			world.StartIntro();
+		}
+		world.UpdateTransition();
+		break;
+	case State::GameIntro:
+		if (world.UpdateIntro()) {
+			state_ = State::Game;
+		}
+		break;
+	case State::Game:
+		switch (world.UpdateGame()) {
+		case GameWorld::Result::ReturnToTitle:
+			// デバッグ: 指定秒数経過したのでタイトルへ戻す
+			state_ = State::Start;
+			break;
+		case GameWorld::Result::GameOver:
+			state_ = State::over;
+			break;
+		case GameWorld::Result::Clear:
+			// スコアとワールドのリセットは GameWorld::UpdateGame で済んでいる
+			state_ = State::Clear;
+			break;
+		default:
+			break;
+		}
+		break;
+	case State::Clear:
+		// タイトルへ戻る
+		if (world.GetInput().TriggerKey(SimKey::Space)) {
+			state_ = State::Start;
+		}
+		break;
+	case State::over:
+		if (world.UpdateGameOver()) {
+			state_ = State::Start;
+		}
+		break;
+	}
+}
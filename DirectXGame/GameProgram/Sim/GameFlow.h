@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+
+class GameWorld;
+
+/// <summary>
+/// タイトル → 暗転 → イントロ → ゲーム → クリア / ゲームオーバー → タイトル の流れ
+/// ステップごとに今の状態に合ったワールドの更新を呼び、入力とワールドの結果で次の状態に進める
+/// 描画・音・スプライトには触れないので、ワールドと一緒にワーカースレッドで回せる (演出は描画側が状態を見て行う)
+/// </summary>
+class GameFlow {
+public:
+	enum class State : uint8_t { Start, TransitionToGame, TransitionFromGame, GameIntro, Game, Clear, over };
+
+	// 暗転・明転にかけるステップ数
+	static const int kTransitionSteps = 30;
+
+	/// <summary>
+	/// 1 ステップ進める (world の入力は先に設定しておく)
+	/// </summary>
+	void Step(GameWorld& world);
+
+	State GetState() const { return state_; }
+	// 暗転・明転を始めてからのステップ数
+	int GetTransitionTimer() const { return transitionTimer_; }
+
+private:
+	State state_ = State::Start;
+	int transitionTimer_ = 0;
+};
@@ -0,0 +1,983 @@
+#include "GameWorld.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+
+KamataEngine::Vector3 Lerp(const KamataEngine::Vector3& start, const KamataEngine::Vector3& end, float t) {
+	t = std::clamp(t, 0.0f, 1.0f);
+	return start + (end - start) * t;
+}
+float Distance(const KamataEngine::Vector3& v1, const KamataEngine::Vector3& v2) {
+	float dx = v1.x - v2.x;
+	float dy = v1.y - v2.y;
+	float dz = v1.z - v2.z;
+	return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+float GameWorld::DistanceSquared(const KamataEngine::Vector3& v1, const KamataEngine::Vector3& v2) {
+	float dx = v1.x - v2.x;
+	float dy = v1.y - v2.y;
+	float dz = v1.z - v2.z;
+	return dx * dx + dy * dy + dz * dz;
+}
+
+GameWorld::GameWorld() {}
+
+GameWorld::~GameWorld() {
+	for (Enemy* enemy : enemies_) {
+		delete enemy;
+	}
+	delete player_;
+	delete railCamera_;
+	delete explosionEmitter_;
+}
+
+void GameWorld::Initialize(const std::string& enemyPopPath, uint32_t seed) {
+	enemyPopPath_ = enemyPopPath;
+	seed_ = seed;
+	enemySpawnCount_ = 0;
+
+	explosionEmitter_ = new ParticleEmitter();
+	explosionEmitter_->Initialize();
+	explosionEmitter_->SetRandom(RandomStream(seed, RandomStreamId::kExplosion));
+	meteoriteField_.SetRandom(RandomStream(seed, RandomStreamId::kMeteorite));
+
+	playerIntroTargetPosition_ = {0.0f, -3.0f, 20.0f};
+	playerIntroStartPosition_ = playerIntroTargetPosition_;
+	playerIntroStartPosition_.z += -50.0f;
+
+	player_ = new Player();
+	player_->Initialize(playerIntroStartPosition_, &input_);
+	player_->SetExhaustRandom(RandomStream(seed, RandomStreamId::kEngineExhaust));
+	// Initialize last player position for minimap rotation tracking
+	lastPlayerPos_ = player_->GetWorldPosition();
+
+	railCamera_ = new RailCamera();
+	railCamera_->Initialize(railcameraPos, railcameraRad, &input_);
+	player_->SetParent(&railCamera_->GetWorldTransform());
+	player_->SetRailCamera(railCamera_);
+	player_->SetEnemies(&enemies_);
+	player_->SetScreenProjection(&screenProjection_);
+
+	LoadEnemyPopData();
+
+	// ホーミング弾生成タイマー初期化
+	homingSpawnTimer_ = kHomingIntervalSeconds_; // 最初のショットが間隔後に発生するようタイマー初期化
+
+	minimapEnemyPositions_.reserve(kMaxMinimapEnemies);
+	minimapEnemyBulletPositions_.reserve(kMaxMinimapEnemyBullets);
+}
+
+void GameWorld::Reset() {
+	if (railCamera_) {
+		railCamera_->Reset();
+	}
+
+	if (player_) {
+		player_->ResetRotation();
+		player_->GetWorldTransform().translation_ = playerIntroStartPosition_;
+		player_->GetWorldTransform().UpdateMatrix();
+		player_->ResetParticles();
+		player_->ResetBullets();
+	}
+
+	for (Enemy* enemy : enemies_) {
+		delete enemy;
+	}
+	enemies_.clear();
+	enemyTree_.Clear();
+	for (EnemyBullet* bullet : enemyBullets_) {
+		ReleaseEnemyBullet(bullet);
+	}
+	enemyBullets_.clear();
+
+	meteoriteField_.Clear();
+
+	gameOverTimer_ = 0;
+	debug10ElapsedSec_ = 0.0f;
+	gameSceneTimer_ = 0;
+
+	LoadEnemyPopData();
+	hasSpawnedEnemies_ = false;
+	snapInterpolation_ = true;
+}
+
+void GameWorld::SavePreviousTransforms() {
+	railCamera_->SavePreviousView();
+	player_->SavePreviousTransforms();
+	if (explosionEmitter_) {
+		explosionEmitter_->SavePreviousTransforms();
+	}
+	for (Enemy* enemy : enemies_) {
+		enemy->SavePreviousTransform();
+	}
+	enemyBulletStore_.SavePrevious();
+	meteoriteField_.SavePreviousTransforms();
+	snapInterpolation_ = false;
+}
+
+void GameWorld::UpdateTransition() {
+	SavePreviousTransforms();
+	if (railCamera_) {
+		railCamera_->Update();
+	}
+	UpdateTransforms();
+}
+
+void GameWorld::StartIntro() {
+	gameIntroTimer_ = 0.0f;
+	player_->GetWorldTransform().translation_ = playerIntroStartPosition_;
+	player_->GetWorldTransform().UpdateMatrix();
+	isGameIntroFinished_ = false;
+	gameSceneTimer_ = 0;
+	UpdateEnemyPopCommands();
+	snapInterpolation_ = true;
+}
+
+bool GameWorld::UpdateIntro() {
+	PROFILE_ZONE("GameWorld::UpdateIntro");
+	SavePreviousTransforms();
+	gameIntroTimer_++;
+
+	float t = gameIntroTimer_ / kGameIntroDuration_;
+	t = 1.0f - std::pow(1.0f - t, 3.0f);
+	t = std::clamp(t, 0.0f, 1.0f);
+
+	player_->GetWorldTransform().translation_ = Lerp(playerIntroStartPosition_, playerIntroTargetPosition_, t);
+
+	UpdateScreenProjection();
+	UpdateAimAssist();
+	railCamera_->Update();
+	UpdateTransforms();
+
+	if (explosionEmitter_) {
+		explosionEmitter_->Update(jobs_);
+	}
+
+	const float kArrivalThreshold = 0.1f;
+	if (gameIntroTimer_ >= kGameIntroDuration_ || Distance(player_->GetWorldTransform().translation_, playerIntroTargetPosition_) < kArrivalThreshold) {
+		player_->GetWorldTransform().translation_ = playerIntroTargetPosition_;
+		UpdateTransforms();
+		isGameIntroFinished_ = true;
+		gameSceneTimer_ = 0;
+
+		// Gameが始まってから移動するようにする
+		if (railCamera_) {
+			railCamera_->SetCanMove(true);
+		}
+
+		// デバッグ10秒タイマーをリセット（ゲーム開始時にカウント開始）
+		// これにより、ゲーム開始から kDebug10Seconds 秒後に自動でタイトルへ戻る
+		debug10ElapsedSec_ = 0.0f;
+		return true;
+	}
+	return false;
+}
+
+GameWorld::Result GameWorld::UpdateGame() {
+	PROFILE_ZONE("GameWorld::UpdateGame");
+	SavePreviousTransforms();
+
+	// デバッグ: ゲーム開始から10秒でタイトルへ戻す処理
+	// 有効な場合、毎ステップ経過秒数を加算し、指定秒数経過後にタイトルへ遷移する
+	if (debug10 && isGameIntroFinished_) {
+		debug10ElapsedSec_ += SimClock::kStepSeconds;
+		if (debug10ElapsedSec_ >= kDebug10Seconds) {
+			// 10秒経過したのでタイトルへ戻す（リセット処理）
+			Reset();
+			return Result::ReturnToTitle;
+		}
+	}
+
+	// --- 自動ゲームオーバー(25秒) / タイマー更新 ---
+	if (isGameIntroFinished_) {
+		gameSceneTimer_ += SimClock::kStepSeconds;
+		const float kAutoGameOverSeconds = 40.0f; // 25秒でゲームオーバー
+		if (gameSceneTimer_ >= kAutoGameOverSeconds) {
+			// 時間切れ -> ゲームオーバー
+			TransitionToGameOver();
+			return Result::GameOver;
+		}
+	}
+
+	// --- 通常のゲーム処理 ---
+	railCamera_->Update();
+
+	UpdateScreenProjection();
+	UpdateAimAssist();
+
+	if (explosionEmitter_) {
+		explosionEmitter_->Update(jobs_);
+	}
+
+	if (isGameIntroFinished_) {
+		// Playerを先に更新して、最新の位置を取得できるようにする
+		{
+			PROFILE_ZONE("Player::Update");
+			player_->Update();
+			if (player_->IsShotThisFrame()) {
+				shotsSinceSnapshot_++;
+			}
+
+			// 回避処理（Player更新後に実行）>
+			player_->EvadeBullets(enemyBullets_);
+		}
+
+		{
+			PROFILE_ZONE("Enemy::Update");
+			// 敵は自分の状態と自分の出力だけを書き換えるので並列に進め、
+			// 木の入れ直しとワールドへの変更は全員が動いてからまとめて行う
+			enemyUpdateList_.assign(enemies_.begin(), enemies_.end());
+			ParallelFor(jobs_, enemyUpdateList_.size(), kEnemyUpdateGrain, [this](size_t begin, size_t end) {
+				for (size_t i = begin; i < end; ++i) {
+					enemyUpdateList_[i]->Update();
+				}
+			});
+			UpdateEnemyTree();
+			// 自機の弾の Update で倒された敵の分もここで反映される
+			ApplyEnemyCommands();
+		}
+
+		UpdateMeteorites();
+
+		// 弾の更新（Player更新後なので、最新のPlayer位置を追尾できる）>
+		UpdateEnemyBullets();
+
+		if (homingSpawnTimer_ > 0.0f) {
+			homingSpawnTimer_ -= SimClock::kStepSeconds;
+		} else {
+			Enemy* shooter = nullptr;
+			KamataEngine::Vector3 playerPosForHoming = player_->GetWorldPosition();
+			float maxDistSq = kHomingMaxDistance_ * kHomingMaxDistance_;
+			// この距離にPlayerが近づくとEnemyが弾を撃たなくなります
+			const float kMinHomingDistance = 1000.0f;
+			float minDistSq = kMinHomingDistance * kMinHomingDistance;
+			// 撃てる距離にいる敵のうち、enemies_ で一番前 (一番先に出た) の敵が撃つ
+			// 候補は AABB 木で自機のまわりから集め、並び順は出た順番で比べる
+			enemyQueryResults_.clear();
+			enemyTree_.Query(MakeAABB(playerPosForHoming, kHomingMaxDistance_), [this](Enemy* enemy) {
+				enemyQueryResults_.push_back(enemy);
+				return true;
+			});
+			for (Enemy* enemy : enemyQueryResults_) {
+				if (!enemy || enemy->IsDead())
+					continue;
+				float distSq = DistanceSquared(enemy->GetWorldPosition(), playerPosForHoming);
+				if (distSq <= maxDistSq && distSq > minDistSq && (!shooter || enemy->GetSpawnOrder() < shooter->GetSpawnOrder())) {
+					shooter = enemy;
+				}
+			}
+
+			if (shooter) {
+
+				KamataEngine::Vector3 moveBullet = shooter->GetWorldPosition();
+				KamataEngine::Vector3 playerPos = player_->GetWorldPosition();
+				KamataEngine::Vector3 toPlayer = playerPos - moveBullet;
+				float len = std::sqrt(toPlayer.x * toPlayer.x + toPlayer.y * toPlayer.y + toPlayer.z * toPlayer.z);
+				if (len > 0.001f) {
+					toPlayer.x /= len;
+					toPlayer.y /= len;
+					toPlayer.z /= len;
+				}
+				KamataEngine::Vector3 vel = {toPlayer.x * kHomingBulletSpeed_, toPlayer.y * kHomingBulletSpeed_, toPlayer.z * kHomingBulletSpeed_};
+
+				EnemyBullet* newBullet = SpawnEnemyBullet(moveBullet, vel);
+				if (newBullet) {
+					newBullet->SetHomingEnabled(true);
+					newBullet->SetHomingTarget(player_);
+					newBullet->SetSpeed(kHomingBulletSpeed_);
+				}
+
+				// reset timer
+				homingSpawnTimer_ = kHomingIntervalSeconds_;
+			}
+		}
+
+		CheckAllCollisions();
+		if (player_->IsDead()) {
+			TransitionToGameOver();
+			return Result::GameOver;
+		}
+
+		UpdateMinimap();
+
+	} else { // イントロ中
+		UpdateTransforms();
+	}
+
+	// Deferred scene clear: perform transition at a safe point after game update
+	if (requestSceneClear_) {
+		requestSceneClear_ = false;
+		// reset score on clear
+		score_ = 0;
+		hitCount = 0; // 撃破数リセット
+		Reset();
+		return Result::Clear;
+	}
+	return Result::Continue;
+}
+
+bool GameWorld::UpdateGameOver() {
+	SavePreviousTransforms();
+	gameOverTimer_++;
+
+	if (player_) {
+		player_->UpdateGameOver(gameOverTimer_);
+	}
+
+	// --- リセット処理 ---
+	if (input_.TriggerKey(SimKey::Space) || gameOverTimer_ >= 90) {
+		Reset();
+		return true;
+	}
+	return false;
+}
+
+void GameWorld::TransitionToGameOver() {
+	// reset score on game over
+	score_ = 0;
+	requestSceneClear_ = false;
+	gameOverTimer_ = 0;
+}
+
+void GameWorld::BuildSnapshot(WorldSnapshot& snapshot, float alpha) {
+	PROFILE_ZONE("GameWorld::BuildSnapshot");
+	snapshot.Clear();
+
+	// ワープ直後は前のステップの行列が別の場所なので補間しない
+	if (snapInterpolation_) {
+		alpha = 1.0f;
+	}
+
+	const SimCamera& camera = railCamera_->GetViewProjection();
+	snapshot.matView = camera.GetInterpolatedView(alpha);
+	snapshot.matProjection = camera.matProjection;
+
+	snapshot.playerMatrix = player_->GetWorldTransform().GetInterpolatedMatrix(alpha);
+	for (PlayerBullet* bullet : player_->GetBullets()) {
+		if (bullet && !bullet->IsDead()) {
+			snapshot.playerBullets.push_back(bullet->GetInterpolatedMatrix(alpha));
+		}
+	}
+	if (player_->GetExhaust()) {
+		player_->GetExhaust()->CollectInstances(snapshot.exhaustParticles, alpha);
+	}
+	if (explosionEmitter_) {
+		explosionEmitter_->CollectInstances(snapshot.explosionParticles, alpha);
+	}
+
+	for (Enemy* enemy : enemies_) {
+		if (enemy) {
+			snapshot.enemies.push_back(enemy->GetInterpolatedMatrix(alpha));
+			// 何も描かない (画面外でインジケーターも出さない) 敵のスプライトは送らない
+			EnemyScreenState screen = enemy->GetScreenState();
+			if (screen.isOnScreen || (screen.isOffScreen && screen.showDirectionIndicator) || screen.isAssistLocked) {
+				snapshot.enemyScreens.push_back(screen);
+			}
+		}
+	}
+	for (EnemyBullet* bullet : enemyBullets_) {
+		if (bullet && !bullet->IsDead()) {
+			snapshot.enemyBullets.push_back(bullet->GetInterpolatedMatrix(alpha));
+		}
+	}
+	for (const Meteorite* meteor : meteoriteField_.GetMeteorites()) {
+		snapshot.meteorites.push_back(meteor->GetInterpolatedMatrix(alpha));
+	}
+
+	// 視錐台の外のモデルは描画しない (隕石はカメラの周り全方向に出るので、大半がここで消える)
+	{
+		PROFILE_ZONE("GameWorld::CullSnapshot");
+		snapshotFrustum_.SetViewProjection(Multiply(snapshot.matView, snapshot.matProjection));
+		snapshotFrustum_.CullMatrices(snapshot.playerBullets, kPlayerBulletModelRadius);
+		snapshotFrustum_.CullInstances(snapshot.exhaustParticles, kParticleModelRadius);
+		snapshotFrustum_.CullInstances(snapshot.explosionParticles, kParticleModelRadius);
+		snapshotFrustum_.CullMatrices(snapshot.enemies, kEnemyModelRadius);
+		snapshotFrustum_.CullMatrices(snapshot.enemyBullets, kEnemyBulletModelRadius);
+		snapshotFrustum_.CullMatrices(snapshot.meteorites, kMeteoriteModelRadius);
+	}
+
+	snapshot.minimapEnemies = minimapEnemyPositions_;
+	snapshot.minimapEnemyBullets = minimapEnemyBulletPositions_;
+	snapshot.minimapPlayerRotation = minimapPlayerRotation_;
+
+	snapshot.score = score_;
+	snapshot.playerShot = shotsSinceSnapshot_ > 0;
+	snapshot.enemiesKilled = killsSinceSnapshot_;
+	shotsSinceSnapshot_ = 0;
+	killsSinceSnapshot_ = 0;
+}
+
+namespace {
+
+// FNV-1a (64bit)
+void HashBytes(uint64_t& hash, const void* data, size_t size) {
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+}
+
+void HashMatrix(uint64_t& hash, const KamataEngine::Matrix4x4& m) { HashBytes(hash, m.m, sizeof(m.m)); }
+
+} // namespace
+
+uint64_t GameWorld::ComputeStateHash() const {
+	uint64_t hash = 14695981039346656037ull;
+	HashMatrix(hash, railCamera_->GetViewProjection().matView);
+	HashMatrix(hash, player_->GetWorldTransform().matWorld_);
+	for (const PlayerBullet* bullet : player_->GetBullets()) {
+		HashMatrix(hash, bullet->GetWorldMatrix());
+	}
+	for (const Enemy* enemy : enemies_) {
+		HashMatrix(hash, enemy->GetWorldMatrix());
+	}
+	for (const EnemyBullet* bullet : enemyBullets_) {
+		HashMatrix(hash, bullet->GetWorldMatrix());
+	}
+	for (const Meteorite* meteor : meteoriteField_.GetMeteorites()) {
+		HashMatrix(hash, meteor->GetWorldMatrix());
+	}
+	HashBytes(hash, &score_, sizeof(score_));
+	return hash;
+}
+
+EnemyBullet* GameWorld::SpawnEnemyBullet(const KamataEngine::Vector3& position, const KamataEngine::Vector3& velocity) {
+	EnemyBullet* bullet = enemyBulletPool_.Acquire();
+	if (!bullet) {
+		return nullptr;
+	}
+	bullet->Initialize(&enemyBulletStore_, static_cast<uint32_t>(enemyBulletPool_.IndexOf(bullet)), position, velocity);
+	enemyBullets_.push_back(bullet);
+	return bullet;
+}
+
+void GameWorld::ReleaseEnemyBullet(EnemyBullet* bullet) {
+	enemyBulletStore_.Deactivate(static_cast<uint32_t>(enemyBulletPool_.IndexOf(bullet)));
+	enemyBulletPool_.Release(bullet);
+}
+
+void GameWorld::UpdateEnemyBullets() {
+	PROFILE_ZONE("GameWorld::UpdateEnemyBullets");
+	// 追尾の判断は弾ごとに、向きの変更・移動・寿命は全弾まとめて進める
+	enemyBulletGuidance_.Clear();
+	for (EnemyBullet* bullet : enemyBullets_) {
+		bullet->UpdateHoming(enemyBulletGuidance_);
+	}
+	enemyBulletGuidance_.Steer(enemyBulletStore_);
+	enemyBulletStore_.Integrate(EnemyBullet::kLifeStep);
+
+	std::erase_if(enemyBullets_, [this](EnemyBullet* bullet) {
+		if (bullet->IsDead()) {
+			ReleaseEnemyBullet(bullet);
+			return true;
+		}
+		return false;
+	});
+}
+
+void GameWorld::EnemySpawn(const KamataEngine::Vector3& position) {
+	Enemy* newEnemy = new Enemy();
+
+	assert(railCamera_ && "EnemySpawn: railCamera_ が null です");
+	KamataEngine::Vector3 playerPos = railCamera_->GetWorldTransform().translation_;
+
+	KamataEngine::Vector3 spawnPosWorld;
+	spawnPosWorld.x = playerPos.x + position.x;
+	spawnPosWorld.y = playerPos.y + position.y;
+	spawnPosWorld.z = playerPos.z + position.z;
+
+	newEnemy->SetPlayer(player_);
+
+	newEnemy->SetSpawnOrder(enemySpawnCount_);
+	newEnemy->Initialize(spawnPosWorld, RandomStream(seed_, RandomStreamId::kEnemyBase + enemySpawnCount_++));
+	newEnemy->SetTreeProxy(enemyTree_.CreateProxy(newEnemy->GetAABB(), newEnemy));
+
+	enemies_.push_back(newEnemy);
+}
+
+void GameWorld::UpdateEnemyTree() {
+	PROFILE_ZONE("GameWorld::UpdateEnemyTree");
+	// fat AABB からはみ出した敵だけ木に入れ直される
+	for (Enemy* enemy : enemies_) {
+		enemyTree_.MoveProxy(enemy->GetTreeProxy(), enemy->GetAABB(), enemy->GetWorldPosition() - enemy->GetPreviousWorldPosition());
+	}
+}
+
+void GameWorld::ApplyEnemyCommands() {
+	for (Enemy* enemy : enemies_) {
+		if (enemy->GetCommands().empty()) {
+			continue;
+		}
+		for (const EnemyCommand& command : enemy->GetCommands()) {
+			switch (command.type) {
+			case EnemyCommand::Type::FireBullet: {
+				EnemyBullet* newBullet = SpawnEnemyBullet(command.position, command.velocity);
+				if (newBullet) {
+					newBullet->SetHomingEnabled(true);
+					newBullet->SetHomingTarget(player_);
+					newBullet->SetSpeed(command.speed);
+				}
+				break;
+			}
+			case EnemyCommand::Type::Explosion:
+				RequestExplosion(command.position);
+				break;
+			case EnemyCommand::Type::AddScore:
+				AddScore(command.points);
+				break;
+			}
+		}
+		enemy->ClearCommands();
+	}
+}
+
+void GameWorld::LoadEnemyPopData() {
+	enemyPopCommands.str("");
+	enemyPopCommands.clear();
+
+	std::ifstream file;
+	file.open(enemyPopPath_);
+	assert(file.is_open());
+	enemyPopCommands << file.rdbuf();
+	file.close();
+
+	hasSpawnedEnemies_ = false;
+}
+
+void GameWorld::UpdateEnemyPopCommands() {
+	if (hasSpawnedEnemies_) {
+		return;
+	}
+
+	std::string line;
+	while (getline(enemyPopCommands, line)) {
+		std::istringstream line_stream(line);
+		std::string word;
+		getline(line_stream, word, ',');
+
+		if (word.find("//") == 0) {
+			continue;
+		}
+
+		if (word.find("POP") == 0) {
+			getline(line_stream, word, ',');
+			float x = (float)std::atof(word.c_str());
+			getline(line_stream, word, ',');
+			float y = (float)std::atof(word.c_str());
+			getline(line_stream, word, ',');
+			float z = (float)std::atof(word.c_str());
+			EnemySpawn(KamataEngine::Vector3(x, y, z));
+		} else if (word.find("WAIT") == 0) {
+			continue;
+		}
+	}
+
+	hasSpawnedEnemies_ = true;
+	enemyPopCommands.str("");
+	enemyPopCommands.clear();
+}
+
+void GameWorld::CheckAllCollisions() {
+	PROFILE_ZONE("GameWorld::CheckAllCollisions");
+	if (!player_)
+		return;
+
+	KamataEngine::Vector3 posA[3]{}, posB[3]{};
+	// 弾は 1 ステップで大きく動く (自弾 60、敵弾 10) ので、通った線分で判定する (BulletStore::SweepSphere)
+	// 敵は Enemy::kRadius、自弾は見た目 (Bullet.obj の半径 1.0) より少し小さい 0.8 (すり抜けは線分で防ぐので弾を大きくしない)
+	float radiusA[3] = {0.8f, 2.0f, Enemy::kRadius};
+	float radiusB[3] = {0.8f, 2.0f, 0.8f};
+	const std::vector<PlayerBullet*>& playerBullets = player_->GetBullets();
+
+	// --- 自キャラ vs 敵弾 (HP制に) ---
+	posA[0] = player_->GetWorldPosition();
+
+	// 回避中は無敵時間として、当たり判定を無効にする
+	bool isPlayerRolling = player_->IsRolling();
+
+	collisionCandidates_.clear();
+	collisionSlots_.clear();
+	for (uint32_t i = 0; i < enemyBullets_.size(); ++i) {
+		EnemyBullet* bullet = enemyBullets_[i];
+		if (!bullet || bullet->IsDead())
+			continue;
+
+		// 回避中は当たり判定を無効にする
+		if (isPlayerRolling) {
+			continue;
+		}
+
+		// ホーミングを失った弾（回避された弾）は当たり判定を無効にする
+		if (!bullet->IsHoming() && bullet->GetEvadedDeathTimer() >= 0.0f) {
+			continue; // 回避された弾は当たり判定を無効
+		}
+
+		collisionCandidates_.push_back(i);
+		collisionSlots_.push_back(bullet->GetSlot());
+	}
+
+	// 敵弾と比べるのは自機 1 つだけなので、空間ハッシュには入れず全弾をまとめて調べる (格子を作るほうが高くつく)
+	// 自機も動いているので、自機から見た弾の線分で判定する
+	enemyBulletStore_.SweepSphere(player_->GetPreviousWorldPosition(), posA[0], radiusA[0] + radiusB[0], collisionSlots_, collisionHits_);
+	for (size_t i = 0; i < collisionCandidates_.size(); ++i) {
+		if (collisionHits_[i]) {
+			EnemyBullet* bullet = enemyBullets_[collisionCandidates_[i]];
+
+			// Decrease HP and mark bullet dead. Only transition to game-over if player actually died.
+			player_->OnCollision();
+			bullet->OnCollision();
+
+			if (player_->IsDead()) {
+				return;
+			}
+			// Otherwise, continue checking other collisions (player lost a HP but still alive)
+		}
+	}
+
+	// 自キャラ vs 隕石 の判定
+	// 隕石は動かないので、出したときに入れた AABB 木から自機の箱と重なる隕石だけを調べる (毎ステップ空間ハッシュに入れ直さない)
+	posA[0] = player_->GetWorldPosition(); // プレイヤー位置
+	float playerRadius = radiusA[0];       // プレイヤー半径
+
+	meteoriteQueryResults_.clear();
+	meteoriteField_.GetTree().Query(MakeAABB(posA[0], playerRadius), [this](Meteorite* meteor) {
+		meteoriteQueryResults_.push_back(meteor);
+		return true;
+	});
+	for (Meteorite* meteor : meteoriteQueryResults_) {
+		if (meteor->IsDead())
+			continue;
+
+		posB[0] = meteor->GetWorldPosition();
+		float meteoriteRadius = meteor->GetRadius();
+		float distanceSquared = DistanceSquared(posA[0], posB[0]);
+		float combinedRadiusSquared = (playerRadius + meteoriteRadius) * (playerRadius + meteoriteRadius);
+
+		if (distanceSquared <= combinedRadiusSquared) {
+			player_->OnCollision();
+			meteor->OnCollision();
+
+			if (player_->IsDead()) {
+				return;
+			}
+		}
+	}
+
+	// 自弾 vs 敵キャラ
+	// 自弾が通った線分を空間ハッシュに入れ (線分の中点・線分を包む半径)、敵ごとに近くの弾だけを調べる
+	playerBulletGrid_.Reset(playerBullets.size());
+	for (uint32_t i = 0; i < playerBullets.size(); ++i) {
+		PlayerBullet* bullet = playerBullets[i];
+		if (bullet && !bullet->IsDead()) {
+			KamataEngine::Vector3 start = bullet->GetPreviousPosition();
+			KamataEngine::Vector3 end = bullet->GetWorldPosition();
+			KamataEngine::Vector3 center = (start + end) * 0.5f;
+			playerBulletGrid_.Insert(i, center, Length(end - start) * 0.5f + radiusB[2]);
+		}
+	}
+
+	const BulletStore& playerBulletStore = player_->GetBulletStore();
+	for (Enemy* enemy : enemies_) {
+		if (!enemy || enemy->IsDead())
+			continue;
+		// 画面外の敵も衝突判定は行う
+		posA[1] = enemy->GetWorldPosition();
+		posB[1] = enemy->GetPreviousWorldPosition();
+
+		// 敵もこのステップで動いた分だけ広く探す
+		collisionCandidates_.clear();
+		playerBulletGrid_.Query((posA[1] + posB[1]) * 0.5f, radiusA[2] + Length(posA[1] - posB[1]) * 0.5f, collisionCandidates_);
+		if (collisionCandidates_.empty())
+			continue;
+		// 全組み合わせで調べていた時と同じ順番 (発射順) で当てる
+		std::sort(collisionCandidates_.begin(), collisionCandidates_.end());
+
+		collisionSlots_.clear();
+		for (uint32_t index : collisionCandidates_) {
+			collisionSlots_.push_back(playerBullets[index]->GetSlot());
+		}
+		playerBulletStore.SweepSphere(posB[1], posA[1], radiusA[2] + radiusB[2], collisionSlots_, collisionHits_);
+
+		for (size_t i = 0; i < collisionCandidates_.size(); ++i) {
+			PlayerBullet* bullet = playerBullets[collisionCandidates_[i]];
+			// 先に別の敵に当たった弾は使わない
+			if (!collisionHits_[i] || bullet->IsDead())
+				continue;
+			enemy->OnCollision();
+			bullet->OnCollision();
+
+			if (enemy->IsDead()) {
+				hitCount++;
+				killsSinceSnapshot_++;
+			}
+		}
+	}
+
+	ApplyEnemyCommands();
+	enemies_.remove_if([this](Enemy* enemy) {
+		if (enemy && enemy->IsDead()) {
+			enemyTree_.DestroyProxy(enemy->GetTreeProxy());
+			delete enemy;
+			return true;
+		}
+		return false;
+	});
+}
+
+void GameWorld::UpdateTransforms() {
+	// 親 (レールカメラ) は RailCamera::Update で行列を設定済みなので、子の自機を作り直す
+	// 変わっていなければ UpdateMatrix は何もしない
+	if (player_) {
+		player_->GetWorldTransform().UpdateMatrix();
+	}
+}
+
+void GameWorld::UpdateMeteorites() {
+	// カメラの周りに出し、自機との距離で大きさを変える
+	meteoriteField_.Update(railCamera_->GetWorldTransform().translation_, player_->GetWorldPosition(), jobs_);
+}
+
+void GameWorld::UpdateScreenProjection() {
+	PROFILE_ZONE("GameWorld::UpdateScreenProjection");
+	if (!railCamera_) {
+		return;
+	}
+
+	screenProjection_.Begin(railCamera_->GetViewProjection());
+	for (Enemy* enemy : enemies_) {
+		enemy->SetScreenIndex(screenProjection_.Add(enemy->GetWorldPosition()));
+	}
+	screenProjection_.Project();
+
+	// 画面表示は敵ごとに自分の分だけを書き換えるので並列に更新する
+	enemyUpdateList_.assign(enemies_.begin(), enemies_.end());
+	ParallelFor(jobs_, enemyUpdateList_.size(), kEnemyScreenGrain, [this](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			enemyUpdateList_[i]->UpdateScreenPosition(screenProjection_);
+		}
+	});
+}
+
+void GameWorld::UpdateAimAssist() {
+	PROFILE_ZONE("GameWorld::UpdateAimAssist");
+	if (!railCamera_)
+		return;
+
+	for (Enemy* enemy : enemies_) {
+		if (enemy) {
+			enemy->SetAssistLocked(false);
+		}
+	}
+
+	// 1. スプライトの「見た目」の円の半径 (画面高さに対する比率)
+	const float kVisualRadius = kAimAssistVisualRadius;
+	// 2. アシストが反応する「判定」の円の半径 (画面高さに対する比率)
+	const float kDetectionRadius = 0.1f; // 0.1f
+
+	// 4. アスペクト比（縦横比）を取得
+	const float kAspect = (float)SimCamera::kScreenWidth / (float)SimCamera::kScreenHeight;
+
+	// 6. 敵の検索
+	// NDC空間での半径を計算する (ndc は画面幅方向がアスペクトで伸びているため補正が必要)
+	// kVisualRadius は画面HEIGHTに対する比率なので、NDCでの半径は (2 * kVisualRadius)
+	const float ndcVisualRadiusY = kVisualRadius * 2.0f;
+	// X方向のNDC半径はアスペクト比で割る（幅が大きいと NDC 単位での幅は小さくなる）
+	const float ndcVisualRadiusX = ndcVisualRadiusY / kAspect;
+
+	const float ndcDetectionRadiusY = kDetectionRadius * 2.0f;
+	const float ndcDetectionRadiusX = ndcDetectionRadiusY / kAspect;
+
+	// 正規化して比較するための初期閾値 (1.0 = 半径内)
+	float minNormalizedDistSq = 1.0f; // (normalized distance squared)
+	Enemy* bestTarget = nullptr;
+	KamataEngine::Vector2 bestTargetNdc = {0, 0};
+
+	// Camera position for distance check
+	KamataEngine::Vector3 cameraPos = railCamera_->GetWorldTransform().translation_;
+
+	const float kMaxAssistDistance = 3000.0f; // アシストが働く最大距離
+	const float kMaxAssistDistanceSq = kMaxAssistDistance * kMaxAssistDistance;
+
+	// 判定の円に写る範囲 (カメラを頂点とする円錐) を囲む箱に入っている敵だけを木から取り出す
+	// 円錐の奥の円の半径は、奥行き × NDC の半径 / 投影行列の [1][1] (縦横どちらの向きも同じになる)
+	const KamataEngine::Matrix4x4& viewMatrix = railCamera_->GetViewProjection().matView;
+	const KamataEngine::Matrix4x4& projMatrix = railCamera_->GetViewProjection().matProjection;
+	KamataEngine::Vector3 viewForward = {viewMatrix.m[0][2], viewMatrix.m[1][2], viewMatrix.m[2][2]};
+	KamataEngine::Vector3 viewOrigin = {
+	    -(viewMatrix.m[3][0] * viewMatrix.m[0][0] + viewMatrix.m[3][1] * viewMatrix.m[0][1] + viewMatrix.m[3][2] * viewMatrix.m[0][2]),
+	    -(viewMatrix.m[3][0] * viewMatrix.m[1][0] + viewMatrix.m[3][1] * viewMatrix.m[1][1] + viewMatrix.m[3][2] * viewMatrix.m[1][2]),
+	    -(viewMatrix.m[3][0] * viewMatrix.m[2][0] + viewMatrix.m[3][1] * viewMatrix.m[2][1] + viewMatrix.m[3][2] * viewMatrix.m[2][2]),
+	};
+	// 距離は cameraPos から測るので、視点とずれていてもその分奥まで含める
+	float coneLength = kMaxAssistDistance + Length(viewOrigin - cameraPos);
+	float coneRadius = coneLength * ndcDetectionRadiusY / projMatrix.m[1][1];
+	AABB coneBox = MergeAABB(MakeAABB(viewOrigin, 0.0f), MakeAABB(viewOrigin + viewForward * coneLength, coneRadius));
+
+	enemyQueryResults_.clear();
+	enemyTree_.Query(coneBox, [this](Enemy* enemy) {
+		enemyQueryResults_.push_back(enemy);
+		return true;
+	});
+
+	for (Enemy* enemy : enemyQueryResults_) {
+		if (!enemy || enemy->IsDead()) {
+			continue;
+		}
+
+		// 距離でフィルタ（遠い敵はアシスト対象外）
+		KamataEngine::Vector3 enemyPos = enemy->GetWorldPosition();
+		float dx = enemyPos.x - cameraPos.x;
+		float dy = enemyPos.y - cameraPos.y;
+		float dz = enemyPos.z - cameraPos.z;
+		float distSq = dx * dx + dy * dy + dz * dz;
+		if (distSq > kMaxAssistDistanceSq) {
+			continue;
+		}
+
+		// 画面外の敵は除外
+		ScreenPoint point = screenProjection_.Get(enemy->GetScreenIndex());
+		if (!point.isOnScreen) {
+			continue;
+		}
+		const KamataEngine::Vector2& ndc = point.ndc;
+
+		// 正規化した距離を計算 (各軸で半径で割る)
+		float normX = ndc.x / ndcDetectionRadiusX;
+		float normY = ndc.y / ndcDetectionRadiusY;
+		float normalizedDistSq = (normX * normX) + (normY * normY);
+
+		// 判定円の中で、最も中心に近い敵を探す (正規化距離で比較)
+		if (normalizedDistSq < minNormalizedDistSq) {
+			minNormalizedDistSq = normalizedDistSq; // 最終的に bestTarget の正規化距離(2乗) が入る
+			bestTarget = enemy;
+			bestTargetNdc = ndc;
+		}
+	}
+
+	// 9. ターゲットが見つかったらアシスト適用
+	// WASDで視点移動中は吸い寄せを無効化
+	bool isViewMoving = input_.PushKey(SimKey::W) || input_.PushKey(SimKey::S) || input_.PushKey(SimKey::A) || input_.PushKey(SimKey::D);
+
+	if (bestTarget && !isViewMoving) {
+		// アシスト自体は「判定」円で見つかったら実行（WASDが押されていない時のみ）
+		railCamera_->ApplyAimAssist(bestTargetNdc.x, bestTargetNdc.y);
+
+		float visualNormX = bestTargetNdc.x / ndcVisualRadiusX;
+		float visualNormY = bestTargetNdc.y / ndcVisualRadiusY;
+		float visualNormDistSq = (visualNormX * visualNormX) + (visualNormY * visualNormY);
+
+		if (visualNormDistSq <= 1.0f) {
+			bestTarget->SetAssistLocked(true);
+		}
+	}
+}
+
+void GameWorld::RequestExplosion(const KamataEngine::Vector3& position) {
+	if (!explosionEmitter_) {
+		return;
+	}
+
+	explosionEmitter_->EmitBurst(
+	    position, // 発生座標
+	    10,       // 粒の数
+	    4.0f,     // 速度
+	    40.0f,    // 寿命 (30フレーム)
+	    10.0f,    // 開始スケール
+	    0.0f      // 終了スケール
+	);
+}
+
+void GameWorld::UpdateMinimap() {
+	PROFILE_ZONE("GameWorld::UpdateMinimap");
+	if (!player_) {
+		return;
+	}
+	KamataEngine::Vector3 playerPos = player_->GetWorldPosition();
+
+	// Rotate the player minimap sprite to match movement direction on XZ plane.
+	// Convert player movement (world X,Z) to minimap axes: mx = dx, my = -dz (minimap Y is -world Z).
+	float dx = playerPos.x - lastPlayerPos_.x;
+	float dz = playerPos.z - lastPlayerPos_.z;
+	const float kMoveThresholdSq = 0.0001f; // squared threshold to ignore tiny jitter
+	float moveDistSq = dx * dx + dz * dz;
+	if (moveDistSq > kMoveThresholdSq) {
+		float mx = dx;
+		float my = -dz;
+		float angle = std::atan2(my, mx);
+		// Sprite's default up direction -> adjust by +90 degrees (pi/2)
+		minimapPlayerRotation_ = angle + kPI / 2.0f;
+		lastPlayerPos_ = playerPos;
+	}
+
+	// この処理はミニマップにＥｎｅｍｙを移すために絶対に必要だから消しちゃダメ
+	//  2. 敵アイコンの位置を更新
+	minimapEnemyPositions_.clear();
+	// 敵リスト (enemies_) を走査
+	for (Enemy* enemy : enemies_) {
+		// 生きていて、スプライトの最大数を超えていない場合
+		if (enemy && !enemy->IsDead() && minimapEnemyPositions_.size() < kMaxMinimapEnemies) {
+			KamataEngine::Vector3 enemyPos = enemy->GetWorldPosition(); //
+			minimapEnemyPositions_.push_back(ConvertWorldToMinimap(enemyPos, playerPos));
+		}
+	}
+
+	// 3. 敵弾アイコンの更新
+	minimapEnemyBulletPositions_.clear();
+	for (EnemyBullet* eb : enemyBullets_) {
+		if (!eb || eb->IsDead())
+			continue;
+		if (minimapEnemyBulletPositions_.size() >= kMaxMinimapEnemyBullets)
+			break;
+		KamataEngine::Vector3 bpos = eb->GetWorldPosition();
+		minimapEnemyBulletPositions_.push_back(ConvertWorldToMinimap(bpos, playerPos));
+	}
+}
+
+KamataEngine::Vector2 GameWorld::ConvertWorldToMinimap(const KamataEngine::Vector3& worldPos, const KamataEngine::Vector3& playerPos) {
+
+	// 1. 自機からの相対座標 (XZ平面のみ)
+	float relativeX = worldPos.x - playerPos.x;
+	float relativeZ = worldPos.z - playerPos.z;
+
+	// 2. ミニマップのスケールを適用 (ワールドのZ+ を ミニマップのY+ (上) に)
+	float minimapOffsetX = relativeX * kMinimapScale;
+	float minimapOffsetY = relativeZ * kMinimapScale * -1.0f; // Y軸反転
+
+	// 3. ミニマップの中心座標を計算
+	KamataEngine::Vector2 minimapCenterPos = {
+	    kMinimapPosition.x + kMinimapSize.x * 0.5f,
+	    kMinimapPosition.y - kMinimapSize.y * 0.5f // 左下アンカー基準
+	};
+
+	// 4. 中心の座標にオフセットを加える
+	KamataEngine::Vector2 finalPos = {minimapCenterPos.x + minimapOffsetX, minimapCenterPos.y + minimapOffsetY};
+
+	// 5. ミニマップの範囲内に座標をクランプ (はみ出さないように)
+	float minX = kMinimapPosition.x;
+	float maxX = kMinimapPosition.x + kMinimapSize.x;
+	float minY = kMinimapPosition.y - kMinimapSize.y; // Yは上(小)・下(大)
+	float maxY = kMinimapPosition.y;
+
+	finalPos.x = std::clamp(finalPos.x, minX, maxX);
+	finalPos.y = std::clamp(finalPos.y, minY, maxY);
+
+	return finalPos;
+}
+
+// Score handling
+void GameWorld::AddScore(int points) {
+	if (points <= 0)
+		return;
+	score_ += points;
+	if (score_ > kMaxScore_)
+		score_ = kMaxScore_;
+
+	// If score reaches or exceeds 200, request clear the scene at a safe point
+	if (score_ >= 600) {
+		requestSceneClear_ = true;
+	}
+}
\ No newline at end of file
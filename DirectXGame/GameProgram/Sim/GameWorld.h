@@ -0,0 +1,285 @@
+#pragma once
+#include "Enemy.h"
+#include "BulletStore.h"
+#include "DynamicAABBTree.h"
+#include "HomingGuidance.h"
+#include "JobSystem.h"
+#include "MeteoriteField.h"
+#include "ObjectPool.h"
+#include "ParticleEmitter.h"
+#include "Player.h"
+#include "RailCamera.h"
+#include "RandomStream.h"
+#include "ScreenProjection.h"
+#include "SimClock.h"
+#include "SimInput.h"
+#include "SpatialHashGrid.h"
+#include "ViewFrustum.h"
+#include "WorldSnapshot.h"
+#include <list>
+#include <sstream>
+#include <string>
+#include <vector>
+
+float Distance(const KamataEngine::Vector3& v1, const KamataEngine::Vector3& v2);
+KamataEngine::Vector3 Lerp(const KamataEngine::Vector3& start, const KamataEngine::Vector3& end, float t);
+
+/// <summary>
+/// ゲームプレイ部分のシミュレーション (描画・音・OS に依存しない)
+/// GameScene と headless 実行の両方から使う
+/// </summary>
+class GameWorld {
+public:
+	// UpdateGame の結果
+	enum class Result {
+		Continue,      // そのまま続行
+		GameOver,      // ゲームオーバーへ
+		Clear,         // クリアへ（ワールドはリセット済み）
+		ReturnToTitle, // タイトルへ（ワールドはリセット済み）
+	};
+
+	GameWorld();
+	~GameWorld();
+
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="enemyPopPath">敵発生データ(csv)のパス</param>
+	/// <param name="seed">乱数の種 (同じ種と同じ入力なら同じ結果になる)</param>
+	void Initialize(const std::string& enemyPopPath, uint32_t seed);
+
+	/// <summary>
+	/// 敵・隕石・爆発パーティクルの更新を並列にするジョブシステム (null なら全部呼び出したスレッドで更新する)
+	/// 並列に回すのは要素ごとに自分の状態だけを書き換える処理なので、スレッド数によらず結果は同じ
+	/// </summary>
+	void SetJobSystem(JobSystem* jobs) { jobs_ = jobs; }
+
+	// 入力（1ステップに1回 SetKeys する）
+	SimInput& GetInput() { return input_; }
+
+	/// <summary>
+	/// タイトルに戻すためのリセット
+	/// </summary>
+	void Reset();
+
+	// 以下の Update 系は 1 回で SimClock::kStepSeconds だけ進める
+
+	// タイトル→ゲームの遷移中の更新
+	void UpdateTransition();
+	// イントロを開始する（自機を開始位置へ、敵を出現させる）
+	void StartIntro();
+	// イントロの更新（終わったら true）
+	bool UpdateIntro();
+	// ゲーム中の更新
+	Result UpdateGame();
+	// ゲームオーバー演出の更新（タイトルへ戻るときは true、ワールドはリセット済み）
+	bool UpdateGameOver();
+
+	/// <summary>
+	/// 描画用のスナップショットを作る
+	/// 効果音用のイベントは前回のスナップショット以降の分をまとめて渡す
+	/// </summary>
+	/// <param name="alpha">前のステップとの補間係数 (SimClock::GetAlpha)</param>
+	void BuildSnapshot(WorldSnapshot& snapshot, float alpha = 1.0f);
+
+	/// <summary>
+	/// 現在の状態 (自機・カメラ・敵・弾・隕石の行列とスコア) のハッシュ
+	/// 記録を再生したときに同じゲームプレイになったかの確認に使う
+	/// </summary>
+	uint64_t ComputeStateHash() const;
+
+	void CheckAllCollisions();
+
+	/// <summary>
+	/// 敵弾をプールから取り出して発射する
+	/// </summary>
+	/// <returns>プールが満杯なら nullptr (弾は出ない)</returns>
+	EnemyBullet* SpawnEnemyBullet(const KamataEngine::Vector3& position, const KamataEngine::Vector3& velocity);
+	// 敵弾の最大数を変える (敵弾が 1 つも無いときだけ呼べる)
+	void ReserveEnemyBullets(size_t capacity) {
+		enemyBulletPool_.Reserve(capacity);
+		enemyBulletStore_.Reserve(capacity);
+	}
+	// 敵弾の追尾と移動を 1 ステップ進め、消えた弾をプールに戻す
+	void UpdateEnemyBullets();
+	const ObjectPool<EnemyBullet>& GetEnemyBulletPool() const { return enemyBulletPool_; }
+	const std::vector<EnemyBullet*>& GetEnemyBullets() const { return enemyBullets_; }
+	const std::list<Enemy*>& GetEnemies() const { return enemies_; }
+
+	void LoadEnemyPopData();
+	void UpdateEnemyPopCommands();
+	void EnemySpawn(const KamataEngine::Vector3& position);
+	const DynamicAABBTree<Enemy*>& GetEnemyTree() const { return enemyTree_; }
+
+	// 今のカメラで敵をまとめて投影し、敵の画面表示を更新する (エイムアシストとロックオンより先に呼ぶ)
+	void UpdateScreenProjection();
+	const ScreenProjection& GetScreenProjection() const { return screenProjection_; }
+
+	void UpdateAimAssist();
+
+	// 隕石群の更新 (離れた隕石を消し、カメラの周りに補充する)
+	void UpdateMeteorites();
+	const MeteoriteField& GetMeteoriteField() const { return meteoriteField_; }
+
+	void RequestExplosion(const KamataEngine::Vector3& position);
+
+	/// <returns>ミニマップ上のスクリーン座標</returns>
+	KamataEngine::Vector2 ConvertWorldToMinimap(const KamataEngine::Vector3& worldPos, const KamataEngine::Vector3& playerPos);
+
+	// Score handling (made public so other game objects can award points)
+	void AddScore(int points);
+	int GetScore() const { return score_; }
+
+	Player* GetPlayer() { return player_; }
+	RailCamera* GetRailCamera() { return railCamera_; }
+
+	bool hasSpawnedEnemies_ = false;
+
+	// エイムアシスト円の見た目の半径 (画面高さに対する比率)
+	static inline const float kAimAssistVisualRadius = 0.08f;
+
+	// ミニマップ設定値
+	static inline const KamataEngine::Vector2 kMinimapPosition = {10.0f, 710.0f}; // 描画基準位置 (左下)
+	static inline const KamataEngine::Vector2 kMinimapSize = {200.0f, 200.0f};    // 背景スプライトのサイズ
+	static inline const float kMinimapScale = 0.03f;                              // ワールド座標 -> ミニマップ座標の縮尺
+
+	// ミニマップに表示する最大数
+	static const size_t kMaxMinimapEnemies = 100;
+	static const size_t kMaxMinimapEnemyBullets = 100;
+
+	// 同時に出せる敵弾の数 (ホーミング弾は 10 秒ごと・寿命 10 秒なので余裕を持たせる)
+	static const size_t kMaxEnemyBullets = 256;
+
+	// 当たり判定のグリッドのセルの大きさ (自弾が 1 ステップで進む 60 より少し大きく)
+	static inline const float kCollisionCellSize = 64.0f;
+	// 敵の AABB 木の余白
+	static inline const float kEnemyTreeMargin = 20.0f;
+	// 敵の更新を並列にするときの 1 ジョブの敵の数
+	static const size_t kEnemyUpdateGrain = 16;
+	// 敵の画面表示の更新は軽いので大きめに区切る
+	static const size_t kEnemyScreenGrain = 64;
+
+	// 描画の視錐台カリングに使うモデルの半径 (obj の頂点の原点からの最大距離)
+	static inline const float kEnemyModelRadius = 77.4f;       // boat.obj
+	static inline const float kEnemyBulletModelRadius = 7.7f;  // bulletEnemy.obj
+	static inline const float kPlayerBulletModelRadius = 1.1f; // Bullet.obj
+	static inline const float kParticleModelRadius = 1.8f;     // flare.obj
+	static inline const float kMeteoriteModelRadius = 5.0f;    // meteorite.obj
+
+private:
+	float DistanceSquared(const KamataEngine::Vector3& v1, const KamataEngine::Vector3& v2);
+
+	void UpdateMinimap();
+
+	// ゲームオーバーへ
+	void TransitionToGameOver();
+
+	// 敵弾をプールに戻す
+	void ReleaseEnemyBullet(EnemyBullet* bullet);
+
+	// 動いた敵の箱を敵の木に反映する (Enemy::Update の後に呼ぶ)
+	void UpdateEnemyTree();
+
+	// 敵が貯めた変更 (弾・爆発・得点) を敵の並び順に反映する
+	// スレッド数によらず同じ順になる。死んだ敵を消す前に呼ぶ
+	void ApplyEnemyCommands();
+
+	// 変換の階層を親から順に更新する (レールカメラ → 自機。RailCamera::Update の後に呼ぶ)
+	void UpdateTransforms();
+
+	// ステップ開始時の行列を補間用に保存する
+	void SavePreviousTransforms();
+
+	SimInput input_;
+
+	Player* player_ = nullptr;
+	RailCamera* railCamera_ = nullptr;
+
+	KamataEngine::Vector3 railcameraPos = {0, 5, -50};
+	KamataEngine::Vector3 railcameraRad = {0, 0, 0};
+
+	std::string enemyPopPath_;
+	// 敵弾はプールが持ち、enemyBullets_ は使用中の弾を指す
+	// 位置・速度・寿命はプールと同じ番号で enemyBulletStore_ に置く
+	ObjectPool<EnemyBullet> enemyBulletPool_{kMaxEnemyBullets};
+	BulletStore enemyBulletStore_{kMaxEnemyBullets};
+	std::vector<EnemyBullet*> enemyBullets_;
+	// 追尾する敵弾の向きをまとめて変える
+	HomingGuidance enemyBulletGuidance_;
+	std::stringstream enemyPopCommands;
+	// 乱数の種 (敵は出すたびにこの種から自分の系列を作る)
+	uint32_t seed_ = 0;
+	uint64_t enemySpawnCount_ = 0;
+	std::list<Enemy*> enemies_;
+	// 並列に更新するために敵を並べ直したもの (並列に回す前に毎回作り直す)
+	std::vector<Enemy*> enemyUpdateList_;
+	// 敵の検索用の木 (エイムアシストとホーミング弾を撃つ敵の検索で共有する)
+	// 敵は 1 ステップに数ユニットしか動かないので、余白を大きめにして入れ直しを減らす
+	DynamicAABBTree<Enemy*> enemyTree_{kEnemyTreeMargin};
+	std::vector<Enemy*> enemyQueryResults_;
+	// 敵の画面投影の表 (ステップごとに 1 度作り、敵の画面表示・エイムアシスト・ロックオンで共有する)
+	ScreenProjection screenProjection_;
+
+	int hitCount = 0;
+	// 前回のスナップショット以降のイベント数 (効果音用)
+	int shotsSinceSnapshot_ = 0;
+	int killsSinceSnapshot_ = 0;
+
+	// ワープ (リセット・イントロ開始) 直後は補間しない
+	bool snapInterpolation_ = true;
+
+	// スナップショットで見えないモデルを描画リストから外す (描画する時点の補間したカメラで作る)
+	ViewFrustum snapshotFrustum_;
+
+	KamataEngine::Vector3 playerIntroStartPosition_ = {0.0f, -3.0f, -30.0f};
+	KamataEngine::Vector3 playerIntroTargetPosition_ = {0.0f, -3.0f, 20.0f};
+	float gameIntroTimer_ = 0.0f;
+	const float kGameIntroDuration_ = 120.0f;
+	bool isGameIntroFinished_ = false;
+
+	float gameOverTimer_ = 0.0f;
+
+	MeteoriteField meteoriteField_;
+
+	// 当たり判定の broadphase (毎ステップ作り直す。配列は使い回す)
+	SpatialHashGrid playerBulletGrid_{kCollisionCellSize};
+	std::vector<uint32_t> collisionCandidates_;
+	std::vector<Meteorite*> meteoriteQueryResults_;
+	// 候補の弾のスロットと、線分の判定の結果
+	std::vector<uint32_t> collisionSlots_;
+	std::vector<uint8_t> collisionHits_;
+
+	ParticleEmitter* explosionEmitter_ = nullptr;
+
+	JobSystem* jobs_ = nullptr;
+
+	// ミニマップ上のアイコン位置
+	std::vector<KamataEngine::Vector2> minimapEnemyPositions_;
+	std::vector<KamataEngine::Vector2> minimapEnemyBulletPositions_;
+	float minimapPlayerRotation_ = 0.0f;
+
+	// 最後に記録したプレイヤー位置（ミニマップ回転の判定用）
+	KamataEngine::Vector3 lastPlayerPos_ = {0.0f, 0.0f, 0.0f};
+
+	float homingSpawnTimer_ = 0.0f;
+	// Enemyミサイルの間隔 (秒)
+	const float kHomingIntervalSeconds_ = 10.0f;
+	const float kHomingMaxDistance_ = 3000.0f;
+	const float kHomingBulletSpeed_ = 8.0f; // requested speed
+
+	// デバッグ: ゲーム開始から指定秒数でタイトルに戻す
+	bool debug10 = true; // 有効化フラグ
+	// デバッグ10秒タイマー
+	float debug10ElapsedSec_ = 0.0f;      // 経過秒数
+	const float kDebug10Seconds = 100.0f; // タイトルへ戻すまでの秒数（100秒）
+
+	// ゲームタイマー（秒）: 自動ゲームオーバー判定に使用
+	float gameSceneTimer_ = 0.0f;
+
+	// スコア
+	int score_ = 0;
+	const int kMaxScore_ = 9999;
+
+	// 安全にシーンクリア遷移をリクエストするフラグ
+	bool requestSceneClear_ = false;
+};
@@ -0,0 +1,261 @@
+#include "HomingGuidance.h"
+#include "BulletStore.h"
+#include "Simd.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// これより短い速度・距離・垂直成分 (の 2 乗) は向きが決まらないものとして扱う
+const float kEpsilonSq = 1.0e-6f;
+
+// sin / cos のテイラー展開の係数 (θ^2 の多項式として Horner 法で計算する)
+const float kCos1 = -1.0f / 2.0f;
+const float kCos2 = 1.0f / 24.0f;
+const float kCos3 = -1.0f / 720.0f;
+const float kCos4 = 1.0f / 40320.0f;
+const float kSin1 = -1.0f / 6.0f;
+const float kSin2 = 1.0f / 120.0f;
+const float kSin3 = -1.0f / 5040.0f;
+const float kSin4 = 1.0f / 362880.0f;
+
+#ifndef MT_SSE2
+// 1 発分 (SIMD 版と同じ式。SSE2 が無いときに使う)
+KamataEngine::Vector3 SteerOne(const KamataEngine::Vector3& pos, const KamataEngine::Vector3& vel, const KamataEngine::Vector3& target, const KamataEngine::Vector3& targetVel, float maxTurn,
+                               HomingGuidance::Law law, float navigationGain) {
+	float speedSq = vel.x * vel.x + vel.y * vel.y + vel.z * vel.z;
+	float rx = target.x - pos.x;
+	float ry = target.y - pos.y;
+	float rz = target.z - pos.z;
+	float distSq = rx * rx + ry * ry + rz * rz;
+	if (!(speedSq > kEpsilonSq) || !(distSq > kEpsilonSq)) {
+		return vel;
+	}
+
+	float speed = std::sqrt(speedSq);
+	float invSpeed = 1.0f / speed;
+	float cx = vel.x * invSpeed;
+	float cy = vel.y * invSpeed;
+	float cz = vel.z * invSpeed;
+
+	// 向かいたい向き d
+	float dx, dy, dz;
+	if (law == HomingGuidance::Law::PurePursuit) {
+		float invDist = 1.0f / std::sqrt(distSq);
+		dx = rx * invDist;
+		dy = ry * invDist;
+		dz = rz * invDist;
+	} else {
+		// 視線の角速度 ω = r × (目標の速度 - 弾の速度) / |r|^2 を gain 倍し、今の向きを ω × c だけ回す
+		float ux = targetVel.x - vel.x;
+		float uy = targetVel.y - vel.y;
+		float uz = targetVel.z - vel.z;
+		float k = navigationGain / distSq;
+		float wx = (ry * uz - rz * uy) * k;
+		float wy = (rz * ux - rx * uz) * k;
+		float wz = (rx * uy - ry * ux) * k;
+		dx = cx + (wy * cz - wz * cy);
+		dy = cy + (wz * cx - wx * cz);
+		dz = cz + (wx * cy - wy * cx);
+		float invLen = 1.0f / std::sqrt(dx * dx + dy * dy + dz * dz);
+		dx *= invLen;
+		dy *= invLen;
+		dz *= invLen;
+	}
+
+	// d の c に垂直な成分の向きへ、c を θ だけ回す
+	float dot = cx * dx + cy * dy + cz * dz;
+	float px = dx - cx * dot;
+	float py = dy - cy * dot;
+	float pz = dz - cz * dot;
+	float perpSq = px * px + py * py + pz * pz;
+
+	float theta = std::clamp(maxTurn, 0.0f, HomingGuidance::kMaxTurnLimit);
+	float t = theta * theta;
+	float cosTheta = 1.0f + t * (kCos1 + t * (kCos2 + t * (kCos3 + t * kCos4)));
+	float sinTheta = theta * (1.0f + t * (kSin1 + t * (kSin2 + t * (kSin3 + t * kSin4))));
+
+	// ほぼ同じ向き・真後ろ (垂直成分が無い) と、θ 以内で届くときは d にそろえる
+	float nx = dx;
+	float ny = dy;
+	float nz = dz;
+	if (!(perpSq < kEpsilonSq) && !(dot >= cosTheta)) {
+		float s = sinTheta / std::sqrt(perpSq);
+		nx = cx * cosTheta + px * s;
+		ny = cy * cosTheta + py * s;
+		nz = cz * cosTheta + pz * s;
+	}
+	float scale = speed / std::sqrt(nx * nx + ny * ny + nz * nz);
+	return {nx * scale, ny * scale, nz * scale};
+}
+#endif
+
+} // namespace
+
+void HomingGuidance::SetLaw(Law law, float navigationGain) {
+	law_ = law;
+	navigationGain_ = navigationGain;
+}
+
+void HomingGuidance::Clear() {
+	count_ = 0;
+	slots_.clear();
+	targetX_.clear();
+	targetY_.clear();
+	targetZ_.clear();
+	targetVelX_.clear();
+	targetVelY_.clear();
+	targetVelZ_.clear();
+	maxTurn_.clear();
+}
+
+void HomingGuidance::Add(uint32_t slot, const KamataEngine::Vector3& targetPos, const KamataEngine::Vector3& targetVelocity, float maxTurn) {
+	slots_.push_back(slot);
+	targetX_.push_back(targetPos.x);
+	targetY_.push_back(targetPos.y);
+	targetZ_.push_back(targetPos.z);
+	targetVelX_.push_back(targetVelocity.x);
+	targetVelY_.push_back(targetVelocity.y);
+	targetVelZ_.push_back(targetVelocity.z);
+	maxTurn_.push_back(maxTurn);
+	++count_;
+}
+
+void HomingGuidance::Steer(BulletStore& store) {
+	if (count_ == 0) {
+		return;
+	}
+
+	// 余りのレーンは速度 0 (止まっている弾) にして、何もしないようにする
+	size_t padded = RoundUpToLanes(count_);
+	targetX_.resize(padded, 0.0f);
+	targetY_.resize(padded, 0.0f);
+	targetZ_.resize(padded, 0.0f);
+	targetVelX_.resize(padded, 0.0f);
+	targetVelY_.resize(padded, 0.0f);
+	targetVelZ_.resize(padded, 0.0f);
+	maxTurn_.resize(padded, 0.0f);
+	posX_.assign(padded, 0.0f);
+	posY_.assign(padded, 0.0f);
+	posZ_.assign(padded, 0.0f);
+	velX_.assign(padded, 0.0f);
+	velY_.assign(padded, 0.0f);
+	velZ_.assign(padded, 0.0f);
+
+	// 飛び飛びのスロットから連続した配列に集める
+	for (size_t i = 0; i < count_; ++i) {
+		KamataEngine::Vector3 pos = store.GetPosition(slots_[i]);
+		KamataEngine::Vector3 vel = store.GetVelocity(slots_[i]);
+		posX_[i] = pos.x;
+		posY_[i] = pos.y;
+		posZ_[i] = pos.z;
+		velX_[i] = vel.x;
+		velY_[i] = vel.y;
+		velZ_[i] = vel.z;
+	}
+
+#ifdef MT_SSE2
+	const __m128 epsilonSq = _mm_set1_ps(kEpsilonSq);
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 gain = _mm_set1_ps(navigationGain_);
+	const __m128 turnLimit = _mm_set1_ps(kMaxTurnLimit);
+	const bool isPursuit = law_ == Law::PurePursuit;
+
+	// mask のレーンは a、それ以外は b
+	auto select = [](__m128 mask, __m128 a, __m128 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); };
+	auto dot3 = [](__m128 ax, __m128 ay, __m128 az, __m128 bx, __m128 by, __m128 bz) {
+		return _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_mul_ps(az, bz));
+	};
+
+	for (size_t i = 0; i < padded; i += kSimdLanes) {
+		__m128 vx = _mm_loadu_ps(&velX_[i]);
+		__m128 vy = _mm_loadu_ps(&velY_[i]);
+		__m128 vz = _mm_loadu_ps(&velZ_[i]);
+		__m128 rx = _mm_sub_ps(_mm_loadu_ps(&targetX_[i]), _mm_loadu_ps(&posX_[i]));
+		__m128 ry = _mm_sub_ps(_mm_loadu_ps(&targetY_[i]), _mm_loadu_ps(&posY_[i]));
+		__m128 rz = _mm_sub_ps(_mm_loadu_ps(&targetZ_[i]), _mm_loadu_ps(&posZ_[i]));
+
+		__m128 speedSq = dot3(vx, vy, vz, vx, vy, vz);
+		__m128 distSq = dot3(rx, ry, rz, rx, ry, rz);
+		__m128 valid = _mm_and_ps(_mm_cmpgt_ps(speedSq, epsilonSq), _mm_cmpgt_ps(distSq, epsilonSq));
+		// 無効なレーンも 0 で割らないように 1 にしておく
+		speedSq = select(valid, speedSq, one);
+		distSq = select(valid, distSq, one);
+
+		__m128 speed = _mm_sqrt_ps(speedSq);
+		__m128 invSpeed = _mm_div_ps(one, speed);
+		__m128 cx = _mm_mul_ps(vx, invSpeed);
+		__m128 cy = _mm_mul_ps(vy, invSpeed);
+		__m128 cz = _mm_mul_ps(vz, invSpeed);
+
+		// 向かいたい向き d
+		__m128 dx, dy, dz;
+		if (isPursuit) {
+			__m128 invDist = _mm_div_ps(one, _mm_sqrt_ps(distSq));
+			dx = _mm_mul_ps(rx, invDist);
+			dy = _mm_mul_ps(ry, invDist);
+			dz = _mm_mul_ps(rz, invDist);
+		} else {
+			// 視線の角速度 ω = r × (目標の速度 - 弾の速度) / |r|^2 を gain 倍し、今の向きを ω × c だけ回す
+			__m128 ux = _mm_sub_ps(_mm_loadu_ps(&targetVelX_[i]), vx);
+			__m128 uy = _mm_sub_ps(_mm_loadu_ps(&targetVelY_[i]), vy);
+			__m128 uz = _mm_sub_ps(_mm_loadu_ps(&targetVelZ_[i]), vz);
+			__m128 k = _mm_div_ps(gain, distSq);
+			__m128 wx = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(ry, uz), _mm_mul_ps(rz, uy)), k);
+			__m128 wy = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(rz, ux), _mm_mul_ps(rx, uz)), k);
+			__m128 wz = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(rx, uy), _mm_mul_ps(ry, ux)), k);
+			dx = _mm_add_ps(cx, _mm_sub_ps(_mm_mul_ps(wy, cz), _mm_mul_ps(wz, cy)));
+			dy = _mm_add_ps(cy, _mm_sub_ps(_mm_mul_ps(wz, cx), _mm_mul_ps(wx, cz)));
+			dz = _mm_add_ps(cz, _mm_sub_ps(_mm_mul_ps(wx, cy), _mm_mul_ps(wy, cx)));
+			__m128 invLen = _mm_div_ps(one, _mm_sqrt_ps(dot3(dx, dy, dz, dx, dy, dz)));
+			dx = _mm_mul_ps(dx, invLen);
+			dy = _mm_mul_ps(dy, invLen);
+			dz = _mm_mul_ps(dz, invLen);
+		}
+
+		// d の c に垂直な成分の向きへ、c を θ だけ回す
+		__m128 dot = dot3(cx, cy, cz, dx, dy, dz);
+		__m128 px = _mm_sub_ps(dx, _mm_mul_ps(cx, dot));
+		__m128 py = _mm_sub_ps(dy, _mm_mul_ps(cy, dot));
+		__m128 pz = _mm_sub_ps(dz, _mm_mul_ps(cz, dot));
+		__m128 perpSq = dot3(px, py, pz, px, py, pz);
+
+		__m128 theta = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(&maxTurn_[i]), _mm_setzero_ps()), turnLimit);
+		__m128 t = _mm_mul_ps(theta, theta);
+		__m128 cosTheta = _mm_add_ps(_mm_set1_ps(kCos3), _mm_mul_ps(t, _mm_set1_ps(kCos4)));
+		cosTheta = _mm_add_ps(_mm_set1_ps(kCos2), _mm_mul_ps(t, cosTheta));
+		cosTheta = _mm_add_ps(_mm_set1_ps(kCos1), _mm_mul_ps(t, cosTheta));
+		cosTheta = _mm_add_ps(one, _mm_mul_ps(t, cosTheta));
+		__m128 sinTheta = _mm_add_ps(_mm_set1_ps(kSin3), _mm_mul_ps(t, _mm_set1_ps(kSin4)));
+		sinTheta = _mm_add_ps(_mm_set1_ps(kSin2), _mm_mul_ps(t, sinTheta));
+		sinTheta = _mm_add_ps(_mm_set1_ps(kSin1), _mm_mul_ps(t, sinTheta));
+		sinTheta = _mm_mul_ps(theta, _mm_add_ps(one, _mm_mul_ps(t, sinTheta)));
+
+		// ほぼ同じ向き・真後ろ (垂直成分が無い) と、θ 以内で届くときは d にそろえる
+		__m128 snap = _mm_or_ps(_mm_cmplt_ps(perpSq, epsilonSq), _mm_cmpge_ps(dot, cosTheta));
+		__m128 s = _mm_div_ps(sinTheta, _mm_sqrt_ps(select(snap, one, perpSq)));
+		__m128 nx = select(snap, dx, _mm_add_ps(_mm_mul_ps(cx, cosTheta), _mm_mul_ps(px, s)));
+		__m128 ny = select(snap, dy, _mm_add_ps(_mm_mul_ps(cy, cosTheta), _mm_mul_ps(py, s)));
+		__m128 nz = select(snap, dz, _mm_add_ps(_mm_mul_ps(cz, cosTheta), _mm_mul_ps(pz, s)));
+
+		// 丸め誤差で伸び縮みした分を直して元の速さを掛ける
+		__m128 scale = _mm_div_ps(speed, _mm_sqrt_ps(dot3(nx, ny, nz, nx, ny, nz)));
+		_mm_storeu_ps(&velX_[i], select(valid, _mm_mul_ps(nx, scale), vx));
+		_mm_storeu_ps(&velY_[i], select(valid, _mm_mul_ps(ny, scale), vy));
+		_mm_storeu_ps(&velZ_[i], select(valid, _mm_mul_ps(nz, scale), vz));
+	}
+#else
+	for (size_t i = 0; i < count_; ++i) {
+		KamataEngine::Vector3 vel = SteerOne({posX_[i], posY_[i], posZ_[i]}, {velX_[i], velY_[i], velZ_[i]}, {targetX_[i], targetY_[i], targetZ_[i]}, {targetVelX_[i], targetVelY_[i], targetVelZ_[i]},
+		                                     maxTurn_[i], law_, navigationGain_);
+		velX_[i] = vel.x;
+		velY_[i] = vel.y;
+		velZ_[i] = vel.z;
+	}
+#endif
+
+	// 元のスロットに書き戻す
+	for (size_t i = 0; i < count_; ++i) {
+		store.SetVelocity(slots_[i], {velX_[i], velY_[i], velZ_[i]});
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <math/Vector3.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class BulletStore;
+
+/// <summary>
+/// 追尾弾の誘導 (1 ステップに曲がれる角度の上限つき)
+/// 命中・追尾の解除・旋回角の決定は弾のクラスで行い、向きの計算だけをここに集めて SSE2 で 4 発ずつまとめて処理する
+/// 三角関数は使わず、内積・外積と 旋回角の sin / cos の多項式近似 で向きを回す (速さは変えない)
+///
+/// 使い方:
+///   guidance.Clear();
+///   for (bullet...) bullet->UpdateHoming(guidance); // 追尾する弾は guidance.Add(slot, targetPos, targetVelocity, maxTurn)
+///   guidance.Steer(store);
+///   store.Integrate(lifeStep);
+/// </summary>
+class HomingGuidance {
+public:
+	// 誘導則
+	enum class Law {
+		// 目標の位置へ向ける
+		PurePursuit,
+		// 視線 (弾 → 目標) が回った角度の navigationGain 倍だけ向きを回す
+		ProportionalNavigation,
+	};
+
+	// maxTurn の上限 (ラジアン)。これ以下なら sin / cos の近似誤差は 1e-6 程度に収まる
+	static inline const float kMaxTurnLimit = 1.0f;
+
+	/// <summary>
+	/// 誘導則を選ぶ (既定は PurePursuit)
+	/// </summary>
+	/// <param name="navigationGain">ProportionalNavigation の比例係数 (3〜5 が目安)</param>
+	void SetLaw(Law law, float navigationGain = 3.0f);
+
+	// 登録した弾を空にする (容量は使い回す)
+	void Clear();
+
+	/// <summary>
+	/// 向きを変える弾を登録する
+	/// </summary>
+	/// <param name="slot">BulletStore のスロット</param>
+	/// <param name="targetVelocity">目標の 1 ステップの移動量 (ProportionalNavigation で使う)</param>
+	/// <param name="maxTurn">このステップで曲がれる角度 (ラジアン、kMaxTurnLimit で頭打ち)</param>
+	void Add(uint32_t slot, const KamataEngine::Vector3& targetPos, const KamataEngine::Vector3& targetVelocity, float maxTurn);
+
+	/// <summary>
+	/// 登録した弾の速度を store から読み、向きを変えて書き戻す
+	/// 向きの差が maxTurn 以内なら目標の向きにそろえ、超えるなら maxTurn だけ回す
+	/// 止まっている弾と目標に重なっている弾は変えない
+	/// </summary>
+	void Steer(BulletStore& store);
+
+	size_t GetCount() const { return count_; }
+
+private:
+	Law law_ = Law::PurePursuit;
+	float navigationGain_ = 3.0f;
+
+	size_t count_ = 0;
+	std::vector<uint32_t> slots_;
+
+	// 入力 (SoA。Steer で SIMD の幅の倍数まで埋める)
+	std::vector<float> targetX_, targetY_, targetZ_;
+	std::vector<float> targetVelX_, targetVelY_, targetVelZ_;
+	std::vector<float> maxTurn_;
+
+	// Steer の作業用 (弾の位置・速度を集めて、新しい速度を入れる)
+	std::vector<float> posX_, posY_, posZ_;
+	std::vector<float> velX_, velY_, velZ_;
+};
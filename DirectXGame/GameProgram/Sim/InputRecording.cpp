@@ -0,0 +1,124 @@
+#include "InputRecording.h"
+#include <fstream>
+#include <utility>
+
+namespace {
+
+const char kMagic[4] = {'S', 'R', 'E', 'C'};
+
+// 実行環境のバイト順によらずリトルエンディアンで読み書きする
+void WriteU32(std::ofstream& file, uint32_t value) {
+	char bytes[4];
+	for (int i = 0; i < 4; ++i) {
+		bytes[i] = static_cast<char>((value >> (i * 8)) & 0xFFu);
+	}
+	file.write(bytes, sizeof(bytes));
+}
+
+void WriteU64(std::ofstream& file, uint64_t value) {
+	WriteU32(file, static_cast<uint32_t>(value & 0xFFFFFFFFu));
+	WriteU32(file, static_cast<uint32_t>(value >> 32));
+}
+
+bool ReadU32(std::ifstream& file, uint32_t& value) {
+	unsigned char bytes[4];
+	if (!file.read(reinterpret_cast<char*>(bytes), sizeof(bytes))) {
+		return false;
+	}
+	value = 0;
+	for (int i = 0; i < 4; ++i) {
+		value |= static_cast<uint32_t>(bytes[i]) << (i * 8);
+	}
+	return true;
+}
+
+bool ReadU64(std::ifstream& file, uint64_t& value) {
+	uint32_t low = 0;
+	uint32_t high = 0;
+	if (!ReadU32(file, low) || !ReadU32(file, high)) {
+		return false;
+	}
+	value = (static_cast<uint64_t>(high) << 32) | low;
+	return true;
+}
+
+} // namespace
+
+void InputRecording::Reset(uint32_t seed) {
+	seed_ = seed;
+	finalHash_ = 0;
+	masks_.clear();
+}
+
+bool InputRecording::Save(const std::string& path) const {
+	std::ofstream file(path, std::ios::binary);
+	if (!file.is_open()) {
+		return false;
+	}
+
+	// 同じキーを押し続けているステップがほとんどなので、連続する同じマスクをまとめる
+	uint32_t runCount = 0;
+	for (size_t i = 0; i < masks_.size(); ++i) {
+		if (i == 0 || masks_[i] != masks_[i - 1]) {
+			runCount++;
+		}
+	}
+
+	file.write(kMagic, sizeof(kMagic));
+	WriteU32(file, kVersion);
+	WriteU32(file, seed_);
+	WriteU32(file, static_cast<uint32_t>(masks_.size()));
+	WriteU64(file, finalHash_);
+	WriteU32(file, runCount);
+
+	size_t i = 0;
+	while (i < masks_.size()) {
+		size_t end = i + 1;
+		while (end < masks_.size() && masks_[end] == masks_[i]) {
+			end++;
+		}
+		WriteU32(file, masks_[i]);
+		WriteU32(file, static_cast<uint32_t>(end - i));
+		i = end;
+	}
+	return file.good();
+}
+
+bool InputRecording::Load(const std::string& path) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open()) {
+		return false;
+	}
+
+	char magic[4] = {};
+	uint32_t version = 0;
+	uint32_t seed = 0;
+	uint32_t stepCount = 0;
+	uint64_t finalHash = 0;
+	uint32_t runCount = 0;
+	if (!file.read(magic, sizeof(magic)) || !ReadU32(file, version) || !ReadU32(file, seed) || !ReadU32(file, stepCount) || !ReadU64(file, finalHash) || !ReadU32(file, runCount)) {
+		return false;
+	}
+	if (std::char_traits<char>::compare(magic, kMagic, sizeof(kMagic)) != 0 || version != kVersion) {
+		return false;
+	}
+
+	std::vector<uint32_t> masks;
+	masks.reserve(stepCount);
+	for (uint32_t run = 0; run < runCount; ++run) {
+		uint32_t mask = 0;
+		uint32_t length = 0;
+		if (!ReadU32(file, mask) || !ReadU32(file, length) || length > stepCount - masks.size()) {
+			return false;
+		}
+		masks.insert(masks.end(), length, mask);
+	}
+	if (masks.size() != stepCount) {
+		return false;
+	}
+
+	seed_ = seed;
+	finalHash_ = finalHash;
+	masks_ = std::move(masks);
+	return true;
+}
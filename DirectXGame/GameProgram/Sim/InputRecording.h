@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// 入力の記録と再生
+/// 乱数のシードと、固定ステップごとに SimInput::SetKeys に渡したキーのビットマスクを保存する
+/// (トリガーは前ステップとの差分で求まるので押下状態だけで足りる)
+/// 同じシード・同じ入力で回せば同じゲームプレイになるので、ビルド間の計測比較や長時間テストに使う
+///
+/// ファイル形式 (リトルエンディアン):
+///   "SREC" / バージョン / シード / ステップ数 / 最終状態のハッシュ (64bit) / ラン数
+///   以降は (マスク, 連続ステップ数) の組がラン数だけ続く
+/// </summary>
+class InputRecording {
+public:
+	static const uint32_t kVersion = 1;
+
+	/// <summary>
+	/// 記録を空にして新しいシードで始める
+	/// </summary>
+	void Reset(uint32_t seed);
+
+	// 1ステップ分の押下状態を追加する
+	void Append(uint32_t pushMask) { masks_.push_back(pushMask); }
+
+	uint32_t GetSeed() const { return seed_; }
+	size_t GetStepCount() const { return masks_.size(); }
+	uint32_t GetMask(size_t step) const { return masks_[step]; }
+
+	// 記録終了時の GameWorld::ComputeStateHash (0 なら未設定)
+	uint64_t GetFinalHash() const { return finalHash_; }
+	void SetFinalHash(uint64_t hash) { finalHash_ = hash; }
+
+	/// <summary>
+	/// ファイルに書き出す
+	/// </summary>
+	/// <returns>書き出せたら true</returns>
+	bool Save(const std::string& path) const;
+
+	/// <summary>
+	/// ファイルから読み込む (失敗したら中身は変わらない)
+	/// </summary>
+	/// <returns>読み込めたら true</returns>
+	bool Load(const std::string& path);
+
+private:
+	uint32_t seed_ = 0;
+	uint64_t finalHash_ = 0;
+	// メモリ上はステップごとに展開して持つ (1時間で 216000 ステップ ≒ 860KB)
+	std::vector<uint32_t> masks_;
+};
+
+/// <summary>
+/// 記録を先頭から 1 ステップずつ取り出す
+/// </summary>
+class InputReplayer {
+public:
+	explicit InputReplayer(const InputRecording& recording) : recording_(recording) {}
+
+	// まだ再生していないステップがあるか
+	bool HasNext() const { return step_ < recording_.GetStepCount(); }
+
+	// 次のステップの押下状態 (最後まで再生したら 0 を返し続ける)
+	uint32_t Next() { return HasNext() ? recording_.GetMask(step_++) : 0u; }
+
+	size_t GetStep() const { return step_; }
+
+	// 先頭に戻す
+	void Rewind() { step_ = 0; }
+
+private:
+	const InputRecording& recording_;
+	size_t step_ = 0;
+};
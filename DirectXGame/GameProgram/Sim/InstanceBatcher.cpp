@@ -0,0 +1,70 @@
+#include "InstanceBatcher.h"
+#include "WorldSnapshot.h"
+
+void InstanceBatcher::Clear() {
+	pending_.clear();
+	keys_.clear();
+	instances_.clear();
+	batches_.clear();
+}
+
+void InstanceBatcher::Add(DrawLayer layer, DrawModel model, const KamataEngine::Matrix4x4& world, const KamataEngine::Vector4& color) {
+	pending_.push_back({world, color});
+	keys_.push_back(MakeKey(layer, model));
+}
+
+void InstanceBatcher::AddMatrices(DrawLayer layer, DrawModel model, const std::vector<KamataEngine::Matrix4x4>& worlds, const KamataEngine::Vector4& color) {
+	uint8_t key = MakeKey(layer, model);
+	for (const KamataEngine::Matrix4x4& world : worlds) {
+		pending_.push_back({world, color});
+	}
+	keys_.insert(keys_.end(), worlds.size(), key);
+}
+
+void InstanceBatcher::AddParticles(DrawLayer layer, DrawModel model, const std::vector<ParticleInstance>& particles) {
+	uint8_t key = MakeKey(layer, model);
+	for (const ParticleInstance& particle : particles) {
+		float s = particle.scale;
+		const KamataEngine::Vector3& p = particle.position;
+		// 対角に大きさ、4 行目に位置
+		pending_.push_back({{s, 0.0f, 0.0f, 0.0f, 0.0f, s, 0.0f, 0.0f, 0.0f, 0.0f, s, 0.0f, p.x, p.y, p.z, 1.0f}, particle.color});
+	}
+	keys_.insert(keys_.end(), particles.size(), key);
+}
+
+void InstanceBatcher::AddSnapshot(const WorldSnapshot& snapshot) {
+	Add(DrawLayer::Player, DrawModel::Player, snapshot.playerMatrix);
+	AddParticles(DrawLayer::Player, DrawModel::Particle, snapshot.exhaustParticles);
+	AddMatrices(DrawLayer::Player, DrawModel::PlayerBullet, snapshot.playerBullets);
+
+	AddParticles(DrawLayer::Explosion, DrawModel::Particle, snapshot.explosionParticles);
+
+	AddMatrices(DrawLayer::Enemy, DrawModel::Enemy, snapshot.enemies);
+	AddMatrices(DrawLayer::Enemy, DrawModel::EnemyBullet, snapshot.enemyBullets);
+	AddMatrices(DrawLayer::Enemy, DrawModel::Meteorite, snapshot.meteorites);
+}
+
+void InstanceBatcher::Build() {
+	// まとまりごとの数を数えて、詰めたときの先頭位置を決める
+	uint32_t counts[kKeyCount] = {};
+	for (uint8_t key : keys_) {
+		counts[key]++;
+	}
+
+	uint32_t offsets[kKeyCount] = {};
+	uint32_t offset = 0;
+	batches_.clear();
+	for (size_t key = 0; key < kKeyCount; ++key) {
+		offsets[key] = offset;
+		if (counts[key] > 0) {
+			batches_.push_back({static_cast<DrawLayer>(key / kModelCount), static_cast<DrawModel>(key % kModelCount), offset, counts[key]});
+		}
+		offset += counts[key];
+	}
+
+	// 追加順のまま、それぞれの位置に書き込む
+	instances_.resize(pending_.size());
+	for (size_t i = 0; i < pending_.size(); ++i) {
+		instances_[offsets[keys_[i]]++] = pending_[i];
+	}
+}
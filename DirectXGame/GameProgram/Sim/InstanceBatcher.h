@@ -0,0 +1,96 @@
+#pragma once
+#include "Particle.h"
+#include <math/Matrix4x4.h>
+#include <math/Vector4.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct WorldSnapshot;
+
+// 描画するモデル (WorldRenderer が実際のモデルを割り当てる)
+// 同じ層の中ではこの順番で描く
+enum class DrawModel : uint8_t {
+	Player,
+	Particle,
+	PlayerBullet,
+	Enemy,
+	EnemyBullet,
+	Meteorite,
+	Count,
+};
+
+// 描く順番のまとまり (GameScene が天球の前後で描き分ける)
+enum class DrawLayer : uint8_t {
+	Player,
+	Explosion,
+	Enemy,
+	Count,
+};
+
+// インスタンス 1 個分 (GPU の定数バッファと同じ並び: float4x4 + float4)
+struct InstanceData {
+	KamataEngine::Matrix4x4 world;
+	KamataEngine::Vector4 color;
+};
+
+// 同じ 層・モデル のインスタンスの連続した範囲 (1 回の描画にまとめられる単位)
+struct InstanceBatch {
+	DrawLayer layer;
+	DrawModel model;
+	uint32_t first;
+	uint32_t count;
+};
+
+/// <summary>
+/// 描画するインスタンスを モデル ごとのまとまりに並べ替えて詰める
+/// 追加はどの順番でもよく、Build で 層 → モデル の順に (同じまとまりの中は追加順のまま) 1 本の配列に詰める
+/// 描画の API には依存しないので、ヘッドレスでも同じ結果になる
+///
+/// 使い方:
+///   batcher.Clear();
+///   batcher.AddSnapshot(snapshot);
+///   batcher.Build();
+///   for (const InstanceBatch& batch : batcher.GetBatches()) { ... &batcher.GetInstances()[batch.first] から batch.count 個 ... }
+/// </summary>
+class InstanceBatcher {
+public:
+	/// <summary>
+	/// 容量を残したまま中身を空にする
+	/// </summary>
+	void Clear();
+
+	void Add(DrawLayer layer, DrawModel model, const KamataEngine::Matrix4x4& world, const KamataEngine::Vector4& color = kWhite);
+	void AddMatrices(DrawLayer layer, DrawModel model, const std::vector<KamataEngine::Matrix4x4>& worlds, const KamataEngine::Vector4& color = kWhite);
+	// パーティクルは 位置・大きさ から行列を組み立てる (回転しない)
+	void AddParticles(DrawLayer layer, DrawModel model, const std::vector<ParticleInstance>& particles);
+
+	/// <summary>
+	/// スナップショットのモデルを全部追加する
+	/// </summary>
+	void AddSnapshot(const WorldSnapshot& snapshot);
+
+	/// <summary>
+	/// 追加したインスタンスを まとまり ごとに詰めて、まとまりの一覧を作る (数え上げソートなので O(n))
+	/// </summary>
+	void Build();
+
+	// Build 後の まとまり (層 → モデル の順、空のものは含まない)
+	const std::vector<InstanceBatch>& GetBatches() const { return batches_; }
+	// Build 後の詰めたインスタンス
+	const std::vector<InstanceData>& GetInstances() const { return instances_; }
+
+private:
+	static inline const KamataEngine::Vector4 kWhite = {1.0f, 1.0f, 1.0f, 1.0f};
+	static const size_t kModelCount = static_cast<size_t>(DrawModel::Count);
+	static const size_t kKeyCount = static_cast<size_t>(DrawLayer::Count) * kModelCount;
+
+	static uint8_t MakeKey(DrawLayer layer, DrawModel model) { return static_cast<uint8_t>(static_cast<size_t>(layer) * kModelCount + static_cast<size_t>(model)); }
+
+	// 追加された順のインスタンスと、その まとまり の番号
+	std::vector<InstanceData> pending_;
+	std::vector<uint8_t> keys_;
+
+	std::vector<InstanceData> instances_;
+	std::vector<InstanceBatch> batches_;
+};
@@ -0,0 +1,145 @@
+#include "JobSystem.h"
+#include "Profiler.h"
+#include <cassert>
+
+namespace {
+
+// 呼び出したスレッドがどのジョブシステムの何番のスレッドか
+thread_local const JobSystem* tlsOwner = nullptr;
+thread_local size_t tlsQueueIndex = 0;
+
+} // namespace
+
+JobSystem::JobSystem(size_t workerCount) {
+	for (size_t i = 0; i < workerCount + 1; ++i) {
+		queues_.push_back(std::make_unique<WorkerQueue>());
+	}
+	for (size_t i = 0; i < workerCount; ++i) {
+		threads_.emplace_back(&JobSystem::WorkerMain, this, i + 1);
+	}
+}
+
+JobSystem::~JobSystem() {
+	// 積まれたままのジョブを捨てるとその Counter が 0 にならないので、全部実行してから止める
+	Job job;
+	while (TryGetJob(GetQueueIndex(), job)) {
+		Execute(job);
+	}
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex_);
+		stop_ = true;
+	}
+	sleepCondition_.notify_all();
+	for (std::thread& thread : threads_) {
+		thread.join();
+	}
+	assert(pending_.load(std::memory_order_acquire) == 0);
+}
+
+size_t JobSystem::DefaultWorkerCount() {
+	unsigned int cores = std::thread::hardware_concurrency();
+	return cores > 1 ? cores - 1 : 0;
+}
+
+size_t JobSystem::GetQueueIndex() const { return tlsOwner == this ? tlsQueueIndex : 0; }
+
+void JobSystem::Run(const Job& job) {
+	if (job.counter) {
+		job.counter->value.fetch_add(1, std::memory_order_relaxed);
+	}
+	if (threads_.empty() || !Push(GetQueueIndex(), job)) {
+		// 積めなければその場で実行する
+		Execute(job);
+		return;
+	}
+
+	// 寝ているスレッドを起こす (ロックしてから起こさないと、寝る直前のスレッドが気付かないことがある)
+	{ std::lock_guard<std::mutex> lock(sleepMutex_); }
+	sleepCondition_.notify_one();
+}
+
+void JobSystem::Wait(Counter& counter) {
+	size_t queueIndex = GetQueueIndex();
+	Job job;
+	while (counter.value.load(std::memory_order_acquire) > 0) {
+		if (TryGetJob(queueIndex, job)) {
+			Execute(job);
+		} else {
+			std::this_thread::yield();
+		}
+	}
+}
+
+bool JobSystem::Push(size_t queueIndex, const Job& job) {
+	WorkerQueue& queue = *queues_[queueIndex];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.count == kQueueCapacity) {
+		return false;
+	}
+	queue.jobs[(queue.first + queue.count) % kQueueCapacity] = job;
+	queue.count++;
+	pending_.fetch_add(1, std::memory_order_release);
+	return true;
+}
+
+bool JobSystem::TryGetJob(size_t queueIndex, Job& job) {
+	if (pending_.load(std::memory_order_acquire) <= 0) {
+		return false;
+	}
+
+	// 自分のキューは後ろから (直前に積んだ、キャッシュに残っているもの)
+	{
+		WorkerQueue& queue = *queues_[queueIndex];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.count > 0) {
+			queue.count--;
+			job = queue.jobs[(queue.first + queue.count) % kQueueCapacity];
+			pending_.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+
+	// 他のスレッドのキューは前から (大きな塊の残りを取る)
+	for (size_t i = 1; i < queues_.size(); ++i) {
+		WorkerQueue& queue = *queues_[(queueIndex + i) % queues_.size()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.count > 0) {
+			job = queue.jobs[queue.first];
+			queue.first = (queue.first + 1) % kQueueCapacity;
+			queue.count--;
+			pending_.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+	return false;
+}
+
+void JobSystem::Execute(const Job& job) {
+	{
+		PROFILE_ZONE("JobSystem::Execute");
+		job.function(job.data, job.begin, job.end);
+	}
+	if (job.counter) {
+		job.counter->value.fetch_sub(1, std::memory_order_release);
+	}
+}
+
+void JobSystem::WorkerMain(size_t index) {
+	tlsOwner = this;
+	tlsQueueIndex = index;
+
+	Job job;
+	for (;;) {
+		if (TryGetJob(index, job)) {
+			Execute(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(sleepMutex_);
+		sleepCondition_.wait(lock, [this]() { return stop_ || pending_.load(std::memory_order_acquire) > 0; });
+		// 止めるのは積まれたジョブが無くなってから (実行中のジョブが積んだ分も残さない)
+		if (stop_ && pending_.load(std::memory_order_acquire) <= 0) {
+			return;
+		}
+	}
+}
@@ -0,0 +1,149 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/// <summary>
+/// 仕事を盗み合うジョブシステム (work stealing)
+/// スレッドごとに仕事の両端キューを持ち、自分のキューは後ろから (最後に積んだものから)、
+/// 他のスレッドのキューは前から (古いものから) 取る。待っている間も仕事を手伝うので、ジョブの中から ParallelFor を呼んでもよい
+/// ジョブは 関数ポインタ + データ + 範囲 だけなので、積んでもメモリを確保しない
+///
+/// 並列に回す処理は、要素ごとに自分の状態だけを書き換えるようにする
+/// 要素の追加・削除 (構造の変更) は、範囲ごとの結果を集めて ParallelFor が戻った後にまとめて行う
+///
+/// 使い方:
+///   JobSystem jobs(JobSystem::DefaultWorkerCount());
+///   jobs.ParallelFor(enemies.size(), 32, [&](size_t begin, size_t end) {
+///       for (size_t i = begin; i < end; ++i) enemies[i]->Update();
+///   });
+/// </summary>
+class JobSystem {
+public:
+	// 範囲 [begin, end) を処理する関数
+	using JobFunction = void (*)(void* data, size_t begin, size_t end);
+
+	// 終わっていないジョブの数 (0 になったら完了)
+	struct Counter {
+		std::atomic<int32_t> value{0};
+	};
+
+	struct Job {
+		JobFunction function = nullptr;
+		void* data = nullptr;
+		size_t begin = 0;
+		size_t end = 0;
+		// 終わったら 1 減らす (null なら何もしない)
+		Counter* counter = nullptr;
+	};
+
+	// 1 スレッドのキューに積めるジョブの数 (あふれたら積まずにその場で実行する)
+	static const size_t kQueueCapacity = 1024;
+
+	/// <summary>
+	/// workerCount 本のスレッドを立てる (0 なら ParallelFor も呼び出したスレッドだけで順に実行する)
+	/// 作ったスレッドも仕事をするので、使うスレッドは workerCount + 1 本
+	/// </summary>
+	explicit JobSystem(size_t workerCount);
+	// 積まれたままのジョブを全部実行してから、スレッドを止める
+	~JobSystem();
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	// 論理コア数 - 1 (作ったスレッドの分を引く)
+	static size_t DefaultWorkerCount();
+
+	/// <summary>
+	/// ジョブを積む (job.counter があれば先に 1 増やす)
+	/// </summary>
+	void Run(const Job& job);
+
+	/// <summary>
+	/// counter が 0 になるまで、他のジョブを手伝いながら待つ
+	/// </summary>
+	void Wait(Counter& counter);
+
+	/// <summary>
+	/// [0, count) を grain 個ずつの範囲に分けて function(begin, end) を並列に呼び、全部終わってから戻る
+	/// 範囲の区切りはスレッド数によらず同じ (最後以外は grain 個)。1 つ目の範囲は呼び出したスレッドで実行する
+	/// </summary>
+	template <typename Function>
+	void ParallelFor(size_t count, size_t grain, Function&& function);
+
+	size_t GetWorkerCount() const { return threads_.size(); }
+
+private:
+	// 1 スレッド分の両端キュー (固定長のリング)
+	struct WorkerQueue {
+		std::mutex mutex;
+		Job jobs[kQueueCapacity];
+		size_t first = 0;
+		size_t count = 0;
+	};
+
+	void WorkerMain(size_t index);
+	// 呼び出したスレッドのキューの番号 (このジョブシステムのスレッドでなければ 0)
+	size_t GetQueueIndex() const;
+	bool Push(size_t queueIndex, const Job& job);
+	// 自分のキューの後ろ、なければ他のキューの前から取る
+	bool TryGetJob(size_t queueIndex, Job& job);
+	static void Execute(const Job& job);
+
+	// 0 番は作ったスレッド (と、このジョブシステムのスレッドでない呼び出し元) が使う
+	std::vector<std::unique_ptr<WorkerQueue>> queues_;
+	std::vector<std::thread> threads_;
+
+	// 積まれていて、まだ誰も取っていないジョブの数
+	std::atomic<int32_t> pending_{0};
+	std::mutex sleepMutex_;
+	std::condition_variable sleepCondition_;
+	bool stop_ = false;
+};
+
+template <typename Function>
+void JobSystem::ParallelFor(size_t count, size_t grain, Function&& function) {
+	grain = std::max<size_t>(grain, 1);
+	if (count <= grain || threads_.empty()) {
+		for (size_t begin = 0; begin < count; begin += grain) {
+			function(begin, std::min(begin + grain, count));
+		}
+		return;
+	}
+
+	using FunctionType = std::remove_reference_t<Function>;
+	Counter counter;
+	Job job;
+	job.function = [](void* data, size_t begin, size_t end) { (*static_cast<FunctionType*>(data))(begin, end); };
+	job.data = const_cast<void*>(static_cast<const void*>(std::addressof(function)));
+	job.counter = &counter;
+	for (size_t begin = grain; begin < count; begin += grain) {
+		job.begin = begin;
+		job.end = std::min(begin + grain, count);
+		Run(job);
+	}
+	function(0, grain);
+	Wait(counter);
+}
+
+/// <summary>
+/// jobs が null なら呼び出したスレッドで順に実行する (範囲の区切りは同じ)
+/// </summary>
+template <typename Function>
+void ParallelFor(JobSystem* jobs, size_t count, size_t grain, Function&& function) {
+	if (jobs) {
+		jobs->ParallelFor(count, grain, std::forward<Function>(function));
+		return;
+	}
+	grain = std::max<size_t>(grain, 1);
+	for (size_t begin = 0; begin < count; begin += grain) {
+		function(begin, std::min(begin + grain, count));
+	}
+}
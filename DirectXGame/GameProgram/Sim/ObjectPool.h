@@ -0,0 +1,85 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// 固定容量のオブジェクトプール
+/// 最初にまとめて確保した領域を使い回すので、Acquire / Release ではメモリ確保をしない
+/// 取り出したオブジェクトは前回の使用時の状態が残っているので、呼び出し側で Initialize し直す
+/// </summary>
+template <typename T> class ObjectPool {
+public:
+	ObjectPool() = default;
+	explicit ObjectPool(size_t capacity) { Reserve(capacity); }
+
+	ObjectPool(const ObjectPool&) = delete;
+	ObjectPool& operator=(const ObjectPool&) = delete;
+
+	/// <summary>
+	/// 容量を設定して全スロットを空きにする (使用中のオブジェクトが無いときだけ呼べる)
+	/// </summary>
+	void Reserve(size_t capacity) {
+		assert(activeCount_ == 0);
+		slots_ = std::vector<T>(capacity);
+		freeIndices_.resize(capacity);
+		// 先頭のスロットから順に使われるように逆順に積む
+		for (size_t i = 0; i < capacity; ++i) {
+			freeIndices_[i] = static_cast<uint32_t>(capacity - 1 - i);
+		}
+		highWaterMark_ = 0;
+		failedCount_ = 0;
+	}
+
+	/// <summary>
+	/// 空きスロットを 1 つ取り出す (O(1))
+	/// </summary>
+	/// <returns>満杯なら nullptr</returns>
+	T* Acquire() {
+		if (freeIndices_.empty()) {
+			failedCount_++;
+			return nullptr;
+		}
+		uint32_t index = freeIndices_.back();
+		freeIndices_.pop_back();
+		activeCount_++;
+		if (activeCount_ > highWaterMark_) {
+			highWaterMark_ = activeCount_;
+		}
+		return &slots_[index];
+	}
+
+	/// <summary>
+	/// Acquire したオブジェクトを返す (O(1))
+	/// </summary>
+	void Release(T* object) {
+		assert(Owns(object));
+		assert(activeCount_ > 0);
+		freeIndices_.push_back(static_cast<uint32_t>(object - slots_.data()));
+		activeCount_--;
+	}
+
+	// スロットの番号 (0 ～ 容量-1)。SoA の配列を同じ番号で引くのに使う
+	size_t IndexOf(const T* object) const {
+		assert(Owns(object));
+		return static_cast<size_t>(object - slots_.data());
+	}
+
+	bool Owns(const T* object) const { return !slots_.empty() && object >= slots_.data() && object < slots_.data() + slots_.size(); }
+
+	size_t GetCapacity() const { return slots_.size(); }
+	// 使用中の数
+	size_t GetActiveCount() const { return activeCount_; }
+	// 同時に使用した最大数 (容量の見直しに使う)
+	size_t GetHighWaterMark() const { return highWaterMark_; }
+	// 満杯で取り出せなかった回数
+	size_t GetFailedCount() const { return failedCount_; }
+
+private:
+	std::vector<T> slots_;
+	std::vector<uint32_t> freeIndices_;
+	size_t activeCount_ = 0;
+	size_t highWaterMark_ = 0;
+	size_t failedCount_ = 0;
+};
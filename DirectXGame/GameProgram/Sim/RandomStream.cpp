@@ -0,0 +1,65 @@
+#include "RandomStream.h"
+#include <cmath>
+
+namespace {
+
+// 近い種・系列番号 (1, 2, 3...) でも状態がばらけるようにかき混ぜる (SplitMix64)
+uint64_t SplitMix64(uint64_t x) {
+	x += 0x9E3779B97F4A7C15ull;
+	x = (x ^ (x >> 30u)) * 0xBF58476D1CE4E5B9ull;
+	x = (x ^ (x >> 27u)) * 0x94D049BB133111EBull;
+	return x ^ (x >> 31u);
+}
+
+} // namespace
+
+void RandomStream::Seed(uint64_t seed, uint64_t stream) {
+	// PCG の初期化手順 (状態 0 から 1 回進めて種を足し、もう 1 回進める)
+	state_ = 0;
+	increment_ = (SplitMix64(stream) << 1u) | 1u;
+	NextUInt();
+	state_ += SplitMix64(seed);
+	NextUInt();
+}
+
+KamataEngine::Vector3 RandomStream::UnitVector() {
+	// 円盤の中の点 (u, v) を球面に写す
+	for (;;) {
+		float u = Range(-1.0f, 1.0f);
+		float v = Range(-1.0f, 1.0f);
+		float s = u * u + v * v;
+		if (s < 1.0f && s > 0.0f) {
+			float k = 2.0f * std::sqrt(1.0f - s);
+			return {u * k, v * k, 1.0f - 2.0f * s};
+		}
+	}
+}
+
+KamataEngine::Vector3 RandomStream::InUnitSphere() {
+	// 立方体の中の点から球の中のものだけ取る (約 52% が当たる)
+	for (;;) {
+		KamataEngine::Vector3 p = {Range(-1.0f, 1.0f), Range(-1.0f, 1.0f), Range(-1.0f, 1.0f)};
+		if (p.x * p.x + p.y * p.y + p.z * p.z < 1.0f) {
+			return p;
+		}
+	}
+}
+
+void RandomStream::FillRange(float* out, size_t count, float min, float max) {
+	for (size_t i = 0; i < count; ++i) {
+		out[i] = Range(min, max);
+	}
+}
+
+void RandomStream::FillUnitVectors(KamataEngine::Vector3* out, size_t count) {
+	for (size_t i = 0; i < count; ++i) {
+		out[i] = UnitVector();
+	}
+}
+
+void RandomStream::FillInSphere(KamataEngine::Vector3* out, size_t count, float radius) {
+	for (size_t i = 0; i < count; ++i) {
+		KamataEngine::Vector3 p = InUnitSphere();
+		out[i] = {p.x * radius, p.y * radius, p.z * radius};
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <math/Vector3.h>
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// 種と系列番号で決まる乱数列 (PCG32)
+/// 状態は 16 バイトで、グローバルな状態を持たないので、サブシステムや敵ごとに 1 本ずつ持てば
+/// 更新の順番やスレッドに関係なく、同じ種から同じ結果になる (リプレイや並列更新の前提)
+/// 種が同じでも系列番号が違えば独立した乱数列になる。番号は下の RandomStreamId に集める
+///
+/// 使い方:
+///   RandomStream random(seed, RandomStreamId::kMeteorite);
+///   float scale = random.Range(1.0f, 5.0f);
+///   KamataEngine::Vector3 dir = random.UnitVector();
+/// </summary>
+class RandomStream {
+public:
+	RandomStream() { Seed(0, 0); }
+	RandomStream(uint64_t seed, uint64_t stream) { Seed(seed, stream); }
+
+	/// <summary>
+	/// 種と系列番号から乱数列を作り直す
+	/// </summary>
+	void Seed(uint64_t seed, uint64_t stream);
+
+	// 32 ビットの一様な整数
+	uint32_t NextUInt() {
+		uint64_t old = state_;
+		state_ = old * kMultiplier + increment_;
+		uint32_t xorShifted = static_cast<uint32_t>(((old >> 18u) ^ old) >> 27u);
+		uint32_t rotate = static_cast<uint32_t>(old >> 59u);
+		return (xorShifted >> rotate) | (xorShifted << ((0u - rotate) & 31u));
+	}
+
+	// [0, bound) の整数 (掛け算で縮めるので、偏りは bound / 2^32 以下)
+	uint32_t NextBelow(uint32_t bound) { return static_cast<uint32_t>((static_cast<uint64_t>(NextUInt()) * bound) >> 32u); }
+
+	// [min, max] の整数 (max も含む)
+	int32_t RangeInt(int32_t min, int32_t max) { return min + static_cast<int32_t>(NextBelow(static_cast<uint32_t>(max - min) + 1u)); }
+
+	// [0, 1) の実数 (上位 24 ビットを使うので float で表せる値にちょうど乗る)
+	float NextFloat() { return static_cast<float>(NextUInt() >> 8u) * (1.0f / 16777216.0f); }
+
+	// [min, max) の実数
+	float Range(float min, float max) { return min + (max - min) * NextFloat(); }
+
+	// 1.0f か -1.0f
+	float NextSign() { return (NextUInt() & 0x80000000u) ? -1.0f : 1.0f; }
+
+	// 球面上に一様な単位ベクトル (三角関数を使わない Marsaglia の方法)
+	KamataEngine::Vector3 UnitVector();
+
+	// 半径 1 の球の中に一様な点
+	KamataEngine::Vector3 InUnitSphere();
+
+	// まとめて作る (1 個ずつ呼ぶのと同じ値が同じ順番で入る)
+	void FillRange(float* out, size_t count, float min, float max);
+	void FillUnitVectors(KamataEngine::Vector3* out, size_t count);
+	void FillInSphere(KamataEngine::Vector3* out, size_t count, float radius);
+
+private:
+	static const uint64_t kMultiplier = 6364136223846793005ull;
+
+	uint64_t state_ = 0;
+	// 系列ごとに違う奇数
+	uint64_t increment_ = 1;
+};
+
+// ゲームで使う乱数の系列番号 (ここに集めて重ならないようにする)
+namespace RandomStreamId {
+const uint64_t kMeteorite = 1;
+const uint64_t kExplosion = 2;
+const uint64_t kEngineExhaust = 3;
+const uint64_t kConfetti = 4;
+// 敵は 出した順番 を足した番号で 1 体ずつ別の系列を持つ
+const uint64_t kEnemyBase = 0x10000;
+} // namespace RandomStreamId
@@ -0,0 +1,174 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/// <summary>
+/// 名前で引く、参照カウント付きのリソース置き場 (モデルのポインタやテクスチャのハンドルなど)
+/// 同じ名前を何度 Acquire しても読み込むのは最初の 1 回だけで、2 回目からは同じものを共有する
+/// 読み込み中 (Store 前) の名前を Acquire したときは、Store されたときに onReady が呼ばれる
+/// 全員が Release したら destroy を呼んで消す。読み込み中なら名前は Store まで残し、その間の Acquire は同じ読み込みを待つ
+///
+/// 使い方:
+///   ResourceRegistry<Model*> models([](Model*& model) { delete model; });
+///   if (models.Acquire("boat", [&](Model* const& model) { boat = model; })) {
+///       models.Store("boat", Model::CreateFromOBJ("boat", true), seconds, bytes);   // 初めての名前だけ読み込む
+///   }
+///   ...
+///   models.Release("boat");
+/// </summary>
+template <typename Resource> class ResourceRegistry {
+public:
+	// 最後の参照が外れたときに呼ぶ
+	using Destroyer = void (*)(Resource& resource);
+	// 読み込み済みになったときに呼ぶ
+	using ReadyCallback = std::function<void(const Resource& resource)>;
+
+	struct Stats {
+		// 置いてある名前の数 (読み込み中を含む) と、参照の合計
+		size_t resourceCount = 0;
+		size_t referenceCount = 0;
+		// 読み込んだ回数と、読み込まずに共有した回数
+		size_t loadCount = 0;
+		size_t shareCount = 0;
+		// 読み込みにかかった時間の合計 (秒)
+		double loadSeconds = 0.0;
+		// 置いてあるリソースのメモリの見積もり (バイト)
+		uint64_t bytes = 0;
+	};
+
+	explicit ResourceRegistry(Destroyer destroy = nullptr) : destroy_(destroy) {}
+	// 参照が残っているものも消す
+	~ResourceRegistry() {
+		for (std::pair<const std::string, Entry>& pair : entries_) {
+			if (pair.second.isReady && destroy_) {
+				destroy_(pair.second.resource);
+			}
+		}
+	}
+
+	ResourceRegistry(const ResourceRegistry&) = delete;
+	ResourceRegistry& operator=(const ResourceRegistry&) = delete;
+
+	/// <summary>
+	/// name の参照を 1 増やす。読み込み済みなら onReady をその場で、読み込み中なら Store のときに呼ぶ
+	/// </summary>
+	/// <returns>初めての名前なら true (呼び出し側で読み込んで Store する)</returns>
+	bool Acquire(const std::string& name, ReadyCallback onReady = nullptr) {
+		std::pair<typename std::unordered_map<std::string, Entry>::iterator, bool> result = entries_.try_emplace(name);
+		Entry& entry = result.first->second;
+		entry.referenceCount++;
+		stats_.referenceCount++;
+		if (result.second) {
+			stats_.resourceCount++;
+			stats_.loadCount++;
+		} else {
+			stats_.shareCount++;
+		}
+
+		if (onReady) {
+			if (entry.isReady) {
+				onReady(entry.resource);
+			} else {
+				entry.waiters.push_back(std::move(onReady));
+			}
+		}
+		return result.second;
+	}
+
+	/// <summary>
+	/// Acquire が true を返した名前に、読み込んだものを入れて待っている onReady を呼ぶ
+	/// 読み込み中に全員が Release したままなら、その場で消す (読み込み時間も数えない)
+	/// </summary>
+	void Store(const std::string& name, Resource resource, double loadSeconds, uint64_t bytes) {
+		typename std::unordered_map<std::string, Entry>::iterator it = entries_.find(name);
+		assert(it != entries_.end() && !it->second.isReady);
+		if (it == entries_.end() || it->second.referenceCount == 0) {
+			if (destroy_) {
+				destroy_(resource);
+			}
+			if (it != entries_.end()) {
+				stats_.resourceCount--;
+				entries_.erase(it);
+			}
+			return;
+		}
+		Entry& entry = it->second;
+		entry.resource = std::move(resource);
+		entry.bytes = bytes;
+		entry.isReady = true;
+		stats_.bytes += bytes;
+		stats_.loadSeconds += loadSeconds;
+
+		// onReady の中で Acquire されてもよいように取り出してから呼ぶ (onReady の中で Release はしない)
+		std::vector<ReadyCallback> waiters = std::move(entry.waiters);
+		entry.waiters.clear();
+		const Resource& stored = entry.resource;
+		for (ReadyCallback& waiter : waiters) {
+			waiter(stored);
+		}
+	}
+
+	/// <summary>
+	/// 参照を 1 減らし、0 になったら消す
+	/// 読み込み中なら名前を残して Store で消す (その前にまた Acquire されたら、同じ読み込みを使う)
+	/// </summary>
+	void Release(const std::string& name) {
+		typename std::unordered_map<std::string, Entry>::iterator it = entries_.find(name);
+		assert(it != entries_.end());
+		if (it == entries_.end()) {
+			return;
+		}
+		Entry& entry = it->second;
+		assert(entry.referenceCount > 0);
+		entry.referenceCount--;
+		stats_.referenceCount--;
+		if (entry.referenceCount > 0) {
+			return;
+		}
+		if (!entry.isReady) {
+			// 待っていたのは Release した側なので、Store で呼ばないように捨てる
+			entry.waiters.clear();
+			return;
+		}
+		stats_.bytes -= entry.bytes;
+		if (destroy_) {
+			destroy_(entry.resource);
+		}
+		stats_.resourceCount--;
+		entries_.erase(it);
+	}
+
+	// 読み込み済みのものを返す (無いか読み込み中なら null)
+	const Resource* Find(const std::string& name) const {
+		typename std::unordered_map<std::string, Entry>::const_iterator it = entries_.find(name);
+		return it != entries_.end() && it->second.isReady ? &it->second.resource : nullptr;
+	}
+
+	// name の参照の数 (無ければ 0)
+	size_t GetReferenceCount(const std::string& name) const {
+		typename std::unordered_map<std::string, Entry>::const_iterator it = entries_.find(name);
+		return it != entries_.end() ? it->second.referenceCount : 0;
+	}
+
+	const Stats& GetStats() const { return stats_; }
+
+private:
+	struct Entry {
+		Resource resource{};
+		uint64_t bytes = 0;
+		size_t referenceCount = 0;
+		bool isReady = false;
+		// 読み込み中に Acquire したものの onReady
+		std::vector<ReadyCallback> waiters;
+	};
+
+	Destroyer destroy_ = nullptr;
+	std::unordered_map<std::string, Entry> entries_;
+	Stats stats_;
+};
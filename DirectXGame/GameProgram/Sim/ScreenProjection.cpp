@@ -0,0 +1,101 @@
+#include "ScreenProjection.h"
+#include "MT.h"
+#include "SimCamera.h"
+#include "Simd.h"
+#include <cmath>
+
+void ScreenProjection::Begin(const SimCamera& camera) {
+	view_ = camera.matView;
+	viewProjection_ = Multiply(camera.matView, camera.matProjection);
+	cameraRoll_ = std::atan2(view_.m[0][1], view_.m[1][1]);
+
+	count_ = 0;
+	worldX_.clear();
+	worldY_.clear();
+	worldZ_.clear();
+}
+
+int32_t ScreenProjection::Add(const KamataEngine::Vector3& worldPos) {
+	worldX_.push_back(worldPos.x);
+	worldY_.push_back(worldPos.y);
+	worldZ_.push_back(worldPos.z);
+	return static_cast<int32_t>(count_++);
+}
+
+void ScreenProjection::Project() {
+	size_t padded = RoundUpToLanes(count_);
+	worldX_.resize(padded, 0.0f);
+	worldY_.resize(padded, 0.0f);
+	worldZ_.resize(padded, 0.0f);
+	viewX_.resize(padded);
+	viewY_.resize(padded);
+	viewZ_.resize(padded);
+	clipW_.resize(padded);
+	ndcX_.resize(padded);
+	ndcY_.resize(padded);
+
+	const KamataEngine::Matrix4x4& v = view_;
+	const KamataEngine::Matrix4x4& vp = viewProjection_;
+
+#ifdef MT_SSE2
+	const __m128 zero = _mm_setzero_ps();
+	for (size_t i = 0; i < padded; i += kSimdLanes) {
+		__m128 x = _mm_loadu_ps(&worldX_[i]);
+		__m128 y = _mm_loadu_ps(&worldY_[i]);
+		__m128 z = _mm_loadu_ps(&worldZ_[i]);
+
+		// 行ベクトル × 行列 (x * m[0][c] + y * m[1][c] + z * m[2][c] + m[3][c])
+		auto transform = [&](const KamataEngine::Matrix4x4& m, int c) {
+			__m128 r = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(m.m[0][c])), _mm_mul_ps(y, _mm_set1_ps(m.m[1][c])));
+			r = _mm_add_ps(r, _mm_mul_ps(z, _mm_set1_ps(m.m[2][c])));
+			return _mm_add_ps(r, _mm_set1_ps(m.m[3][c]));
+		};
+
+		_mm_storeu_ps(&viewX_[i], transform(v, 0));
+		_mm_storeu_ps(&viewY_[i], transform(v, 1));
+		_mm_storeu_ps(&viewZ_[i], transform(v, 2));
+
+		__m128 clipX = transform(vp, 0);
+		__m128 clipY = transform(vp, 1);
+		__m128 clipW = transform(vp, 3);
+		_mm_storeu_ps(&clipW_[i], clipW);
+
+		// w が正でない点は割らずに 0 にしておく (Get でカメラの後ろ扱いになる)
+		__m128 valid = _mm_cmpgt_ps(clipW, zero);
+		__m128 safeW = _mm_or_ps(_mm_and_ps(valid, clipW), _mm_andnot_ps(valid, _mm_set1_ps(1.0f)));
+		_mm_storeu_ps(&ndcX_[i], _mm_and_ps(_mm_div_ps(clipX, safeW), valid));
+		_mm_storeu_ps(&ndcY_[i], _mm_and_ps(_mm_div_ps(clipY, safeW), valid));
+	}
+#else
+	for (size_t i = 0; i < padded; ++i) {
+		float x = worldX_[i];
+		float y = worldY_[i];
+		float z = worldZ_[i];
+		viewX_[i] = x * v.m[0][0] + y * v.m[1][0] + z * v.m[2][0] + v.m[3][0];
+		viewY_[i] = x * v.m[0][1] + y * v.m[1][1] + z * v.m[2][1] + v.m[3][1];
+		viewZ_[i] = x * v.m[0][2] + y * v.m[1][2] + z * v.m[2][2] + v.m[3][2];
+
+		float clipX = x * vp.m[0][0] + y * vp.m[1][0] + z * vp.m[2][0] + vp.m[3][0];
+		float clipY = x * vp.m[0][1] + y * vp.m[1][1] + z * vp.m[2][1] + vp.m[3][1];
+		float clipW = x * vp.m[0][3] + y * vp.m[1][3] + z * vp.m[2][3] + vp.m[3][3];
+		clipW_[i] = clipW;
+		ndcX_[i] = clipW > 0.0f ? clipX / clipW : 0.0f;
+		ndcY_[i] = clipW > 0.0f ? clipY / clipW : 0.0f;
+	}
+#endif
+}
+
+ScreenPoint ScreenProjection::Get(int32_t index) const {
+	ScreenPoint point;
+	if (index < 0 || static_cast<size_t>(index) >= count_) {
+		return point;
+	}
+
+	point.view = {viewX_[index], viewY_[index], viewZ_[index]};
+	point.isInFront = point.view.z > 0.0f && clipW_[index] > 0.0f;
+	if (point.isInFront) {
+		point.ndc = {ndcX_[index], ndcY_[index]};
+		point.isOnScreen = point.ndc.x >= -1.0f && point.ndc.x <= 1.0f && point.ndc.y >= -1.0f && point.ndc.y <= 1.0f;
+	}
+	return point;
+}
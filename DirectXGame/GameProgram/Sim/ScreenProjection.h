@@ -0,0 +1,83 @@
+#pragma once
+#include <math/Matrix4x4.h>
+#include <math/Vector2.h>
+#include <math/Vector3.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class SimCamera;
+
+// 1 点分の投影結果
+struct ScreenPoint {
+	// ビュー座標 (前方が +z)
+	KamataEngine::Vector3 view = {0.0f, 0.0f, 0.0f};
+	// 正規化デバイス座標 (isInFront のときだけ意味がある)
+	KamataEngine::Vector2 ndc = {0.0f, 0.0f};
+	// カメラの前にあるか (ビューの z とクリップの w がどちらも正)
+	bool isInFront = false;
+	// NDC の [-1, 1] に入っているか
+	bool isOnScreen = false;
+};
+
+/// <summary>
+/// 1 ステップ分の画面投影の表
+/// ビュー行列と射影行列を掛けた行列を 1 度だけ作り、登録した点をまとめて (SSE2 で 4 点ずつ) 投影する
+/// 敵の画面表示・エイムアシスト・ロックオンは同じ表を読むので、同じステップの中で画面内判定が食い違わない
+///
+/// 使い方:
+///   projection.Begin(camera);
+///   for (enemy...) enemy->SetScreenIndex(projection.Add(enemy->GetWorldPosition()));
+///   projection.Project();
+///   ScreenPoint point = projection.Get(enemy->GetScreenIndex());
+/// </summary>
+class ScreenProjection {
+public:
+	// どの点も指していない番号
+	static const int32_t kInvalidIndex = -1;
+
+	/// <summary>
+	/// 表を空にし、camera の行列で投影する準備をする
+	/// </summary>
+	void Begin(const SimCamera& camera);
+
+	/// <summary>
+	/// 投影する点を登録する
+	/// </summary>
+	/// <returns>Get に渡す番号</returns>
+	int32_t Add(const KamataEngine::Vector3& worldPos);
+
+	/// <summary>
+	/// 登録した点をまとめて投影する
+	/// </summary>
+	void Project();
+
+	/// <summary>
+	/// 登録した点の投影結果 (kInvalidIndex や範囲外の番号ではカメラの後ろ扱いの結果を返す)
+	/// </summary>
+	ScreenPoint Get(int32_t index) const;
+
+	size_t GetCount() const { return count_; }
+	// カメラのロール (ロックオン表示の回転に使う)
+	float GetCameraRoll() const { return cameraRoll_; }
+
+private:
+	KamataEngine::Matrix4x4 view_ = {};
+	KamataEngine::Matrix4x4 viewProjection_ = {};
+	float cameraRoll_ = 0.0f;
+
+	size_t count_ = 0;
+
+	// 入力のワールド座標 (SoA。Project で SIMD の幅の倍数まで 0 で埋める)
+	std::vector<float> worldX_;
+	std::vector<float> worldY_;
+	std::vector<float> worldZ_;
+
+	// 出力
+	std::vector<float> viewX_;
+	std::vector<float> viewY_;
+	std::vector<float> viewZ_;
+	std::vector<float> clipW_;
+	std::vector<float> ndcX_;
+	std::vector<float> ndcY_;
+};
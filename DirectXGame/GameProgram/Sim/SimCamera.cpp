@@ -0,0 +1,31 @@
+#include "SimCamera.h"
+#include "MT.h"
+#include <cmath>
+
+void SimCamera::Initialize() {
+	matView = {};
+	matView.m[0][0] = 1.0f;
+	matView.m[1][1] = 1.0f;
+	matView.m[2][2] = 1.0f;
+	matView.m[3][3] = 1.0f;
+	hasPrevious_ = false;
+	UpdateProjectionMatrix();
+}
+
+void SimCamera::UpdateProjectionMatrix() {
+	// 左手系の透視投影行列 (KamataEngine::MathUtility::MakePerspectiveFovMatrix と同じ)
+	float cot = 1.0f / std::tan(fovAngleY / 2.0f);
+	matProjection = {};
+	matProjection.m[0][0] = cot / aspectRatio;
+	matProjection.m[1][1] = cot;
+	matProjection.m[2][2] = farZ / (farZ - nearZ);
+	matProjection.m[2][3] = 1.0f;
+	matProjection.m[3][2] = -nearZ * farZ / (farZ - nearZ);
+}
+
+KamataEngine::Matrix4x4 SimCamera::GetInterpolatedView(float alpha) const {
+	if (!hasPrevious_) {
+		return matView;
+	}
+	return LerpMatrix(matViewPrev_, matView, alpha);
+}
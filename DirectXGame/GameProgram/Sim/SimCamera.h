@@ -0,0 +1,55 @@
+#pragma once
+#include <math/Matrix4x4.h>
+#include <math/Vector3.h>
+
+/// <summary>
+/// シミュレーション用カメラ (ビュー行列と射影行列のみ保持する)
+/// 描画側は KamataEngine::Camera にコピーして転送する
+/// </summary>
+class SimCamera {
+public:
+	// 画面サイズ (WinApp::kWindowWidth / kWindowHeight と同じ値)
+	static const int kScreenWidth = 1280;
+	static const int kScreenHeight = 720;
+
+	// 垂直方向視野角
+	float fovAngleY = 45.0f * 3.141592654f / 180.0f;
+	// ビューポートのアスペクト比
+	float aspectRatio = (float)16 / 9;
+	// 深度限界（手前側）
+	float nearZ = 0.1f;
+	// 深度限界（奥側）
+	float farZ = 50000.0f;
+
+	// ビュー行列
+	KamataEngine::Matrix4x4 matView = {};
+	// 射影行列
+	KamataEngine::Matrix4x4 matProjection = {};
+
+	/// <summary>
+	/// 初期化 (ビュー行列を単位行列、射影行列を透視投影にする)
+	/// </summary>
+	void Initialize();
+
+	/// <summary>
+	/// 射影行列を更新する
+	/// </summary>
+	void UpdateProjectionMatrix();
+
+	/// <summary>
+	/// ステップ開始時のビュー行列を補間用に保存する
+	/// </summary>
+	void SavePrevious() {
+		matViewPrev_ = matView;
+		hasPrevious_ = true;
+	}
+
+	/// <summary>
+	/// 前のステップと現在のビュー行列を補間した行列
+	/// </summary>
+	KamataEngine::Matrix4x4 GetInterpolatedView(float alpha) const;
+
+private:
+	KamataEngine::Matrix4x4 matViewPrev_ = {};
+	bool hasPrevious_ = false;
+};
@@ -0,0 +1,24 @@
+#include "SimClock.h"
+
+void SimClock::Reset() {
+	accumulator_ = 0.0;
+	stepCount_ = 0;
+}
+
+int SimClock::Advance(float elapsedSeconds) {
+	if (elapsedSeconds < 0.0f) {
+		elapsedSeconds = 0.0f;
+	}
+	if (elapsedSeconds > kMaxFrameSeconds) {
+		elapsedSeconds = kMaxFrameSeconds;
+	}
+	accumulator_ += elapsedSeconds;
+
+	int steps = 0;
+	while (accumulator_ >= kStepSeconds) {
+		accumulator_ -= kStepSeconds;
+		steps++;
+	}
+	stepCount_ += steps;
+	return steps;
+}
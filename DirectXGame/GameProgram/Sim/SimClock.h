@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+
+/// <summary>
+/// 固定ステップのシミュレーション時計
+/// 実経過時間を溜めて kStepSeconds ごとにシミュレーションを進め、
+/// 余りの割合 (0～1) を描画時の補間に使う
+/// </summary>
+class SimClock {
+public:
+	// 1ステップの秒数 (ゲームの速度はこの値で決まる)
+	static inline const float kStepSeconds = 1.0f / 60.0f;
+	// 1フレームで溜める最大の経過時間 (止まった後に大量のステップを回さないため)
+	static inline const float kMaxFrameSeconds = 0.25f;
+
+	/// <summary>
+	/// 溜めた時間を捨てて最初からにする
+	/// </summary>
+	void Reset();
+
+	/// <summary>
+	/// 実経過時間を加え、このフレームで進めるステップ数を返す
+	/// </summary>
+	/// <param name="elapsedSeconds">前のフレームからの実経過時間 (秒)</param>
+	int Advance(float elapsedSeconds);
+
+	// 最後のステップから次のステップまでの割合 (描画の補間係数)
+	float GetAlpha() const { return static_cast<float>(accumulator_ / kStepSeconds); }
+
+	// これまでに進めたステップ数
+	uint64_t GetStepCount() const { return stepCount_; }
+
+private:
+	double accumulator_ = 0.0;
+	uint64_t stepCount_ = 0;
+};
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+
+// シミュレーションが参照するキー (DirectInput のキーコードに依存しない)
+enum class SimKey : uint8_t {
+	W,
+	A,
+	S,
+	D,
+	R,
+	Left,
+	Right,
+	Space,
+	LShift,
+	RShift,
+	kCount,
+};
+
+/// <summary>
+/// シミュレーション用の入力状態
+/// 1フレームに1回 SetKeys で押下状態をビットマスクで渡す
+/// </summary>
+class SimInput {
+public:
+	/// <summary>
+	/// このフレームの押下状態を設定する (トリガーは前フレームとの差分で求める)
+	/// </summary>
+	void SetKeys(uint32_t pushMask) {
+		prevMask_ = pushMask_;
+		pushMask_ = pushMask;
+	}
+
+	/// <summary>
+	/// 押下状態をすべて離した状態に戻す
+	/// </summary>
+	void Clear() {
+		pushMask_ = 0;
+		prevMask_ = 0;
+	}
+
+	bool PushKey(SimKey key) const { return (pushMask_ & Bit(key)) != 0; }
+	bool TriggerKey(SimKey key) const { return (pushMask_ & Bit(key)) != 0 && (prevMask_ & Bit(key)) == 0; }
+
+	uint32_t GetPushMask() const { return pushMask_; }
+
+	static uint32_t Bit(SimKey key) { return 1u << static_cast<uint32_t>(key); }
+
+private:
+	uint32_t pushMask_ = 0;
+	uint32_t prevMask_ = 0;
+};
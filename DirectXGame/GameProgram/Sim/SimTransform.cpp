@@ -0,0 +1,58 @@
+#include "SimTransform.h"
+#include "MT.h"
+
+namespace {
+
+bool SameVector(const KamataEngine::Vector3& a, const KamataEngine::Vector3& b) { return a.x == b.x && a.y == b.y && a.z == b.z; }
+
+} // namespace
+
+void SimTransform::Initialize() {
+	matWorld_ = {};
+	matWorld_.m[0][0] = 1.0f;
+	matWorld_.m[1][1] = 1.0f;
+	matWorld_.m[2][2] = 1.0f;
+	matWorld_.m[3][3] = 1.0f;
+	// 使い回すときに前の寿命の行列と補間しないようにする
+	hasPrevious_ = false;
+	// 単位行列は scale_ などから作ったものではないので、次の UpdateMatrix で必ず作る
+	dirty_ = true;
+	version_++;
+}
+
+void SimTransform::UpdateMatrix() {
+	uint32_t parentVersion = parent_ ? parent_->version_ : 0;
+	if (!dirty_ && parent_ == builtParent_ && parentVersion == builtParentVersion_ && SameVector(scale_, builtScale_) && SameVector(rotation_, builtRotation_) &&
+	    SameVector(translation_, builtTranslation_)) {
+		return;
+	}
+
+	// スケール、回転、平行移動を合成して行列を計算する
+	matWorld_ = MakeAffineMatrix(scale_, rotation_, translation_);
+
+	if (parent_) {
+		matWorld_ = Multiply(matWorld_, parent_->matWorld_);
+	}
+
+	builtScale_ = scale_;
+	builtRotation_ = rotation_;
+	builtTranslation_ = translation_;
+	builtParent_ = parent_;
+	builtParentVersion_ = parentVersion;
+	dirty_ = false;
+	version_++;
+}
+
+void SimTransform::SetWorldMatrix(const KamataEngine::Matrix4x4& matWorld) {
+	matWorld_ = matWorld;
+	// scale_ などとは対応しないので、UpdateMatrix を呼ぶと作り直す
+	dirty_ = true;
+	version_++;
+}
+
+KamataEngine::Matrix4x4 SimTransform::GetInterpolatedMatrix(float alpha) const {
+	if (!hasPrevious_) {
+		return matWorld_;
+	}
+	return LerpMatrix(matWorldPrev_, matWorld_, alpha);
+}
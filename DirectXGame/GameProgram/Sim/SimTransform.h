@@ -0,0 +1,85 @@
+#pragma once
+#include <math/Matrix4x4.h>
+#include <math/Vector3.h>
+#include <cstdint>
+
+/// <summary>
+/// シミュレーション用のワールド変換 (定数バッファを持たない)
+/// KamataEngine::WorldTransform と同じメンバ名で、描画側はこの行列をコピーして転送する
+/// 行列は前回作ったときのスケール・回転・座標と親の版を覚えておき、どれかが変わったときだけ作り直す
+/// (1 ステップに何度 UpdateMatrix を呼んでも、作り直しは変わった分の 1 回だけ)
+/// </summary>
+class SimTransform {
+public:
+	// ローカルスケール
+	KamataEngine::Vector3 scale_ = {1, 1, 1};
+	// X,Y,Z軸回りのローカル回転角
+	KamataEngine::Vector3 rotation_ = {0, 0, 0};
+	// ローカル座標
+	KamataEngine::Vector3 translation_ = {0, 0, 0};
+	// ローカル → ワールド変換行列
+	KamataEngine::Matrix4x4 matWorld_ = {};
+	// 親となるワールド変換へのポインタ
+	const SimTransform* parent_ = nullptr;
+
+	/// <summary>
+	/// 初期化 (単位行列にする)
+	/// </summary>
+	void Initialize();
+
+	/// <summary>
+	/// スケール、回転、平行移動からワールド行列を計算する
+	/// 前回から値も親の行列も変わっていなければ何もしない。親は先に更新しておくこと
+	/// </summary>
+	void UpdateMatrix();
+
+	/// <summary>
+	/// ワールド行列を直接設定する (スケール・回転・座標から作らない変換用)
+	/// 子は版が変わったのを見て、次の UpdateMatrix で作り直す
+	/// </summary>
+	void SetWorldMatrix(const KamataEngine::Matrix4x4& matWorld);
+
+	/// <summary>
+	/// 次の UpdateMatrix で必ず作り直す
+	/// </summary>
+	void MarkDirty() { dirty_ = true; }
+
+	// 行列を作り直すたびに増える番号 (子が親の行列の変化を知るのに使う)
+	uint32_t GetVersion() const { return version_; }
+
+	/// <summary>
+	/// ステップ開始時の行列を補間用に保存する
+	/// </summary>
+	void SavePrevious() {
+		matWorldPrev_ = matWorld_;
+		hasPrevious_ = true;
+	}
+
+	/// <summary>
+	/// 前のステップと現在の行列を補間した行列 (保存前なら現在の行列)
+	/// </summary>
+	/// <param name="alpha">0 で前のステップ、1 で現在</param>
+	KamataEngine::Matrix4x4 GetInterpolatedMatrix(float alpha) const;
+
+	// ワールド座標の取得
+	KamataEngine::Vector3 GetWorldPosition() const { return {matWorld_.m[3][0], matWorld_.m[3][1], matWorld_.m[3][2]}; }
+	// 前のステップのワールド座標 (保存前なら現在の座標)。連続的な当たり判定に使う
+	KamataEngine::Vector3 GetPreviousWorldPosition() const {
+		return hasPrevious_ ? KamataEngine::Vector3{matWorldPrev_.m[3][0], matWorldPrev_.m[3][1], matWorldPrev_.m[3][2]} : GetWorldPosition();
+	}
+
+private:
+	// 前のステップのワールド行列 (描画の補間用)
+	KamataEngine::Matrix4x4 matWorldPrev_ = {};
+	bool hasPrevious_ = false;
+
+	// matWorld_ を作ったときの値
+	KamataEngine::Vector3 builtScale_ = {};
+	KamataEngine::Vector3 builtRotation_ = {};
+	KamataEngine::Vector3 builtTranslation_ = {};
+	const SimTransform* builtParent_ = nullptr;
+	uint32_t builtParentVersion_ = 0;
+
+	uint32_t version_ = 0;
+	bool dirty_ = true;
+};
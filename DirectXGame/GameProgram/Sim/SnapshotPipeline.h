@@ -0,0 +1,116 @@
+#pragma once
+#include "JobSystem.h"
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+/// <summary>
+/// シミュレーションと描画を 1 フレームずらして同時に回すための、フレームの受け渡し (ダブルバッファ)
+/// シミュレーションが裏のフレームに次の状態を書いている間に、描画は表のフレーム (1 つ前の結果) を読む
+/// 書き終わるのを待ってから表と裏を入れ替えるので、同じフレームを同時に読み書きすることはない
+///
+/// 裏で作っている間 (Kick から Sync まで)、作る側が触るもの (ワールドなど) には他から触らない
+/// 作る側に渡す入力は、Kick の前に GetBack() のフレームに書いておく
+///
+/// 使い方:
+///   SnapshotPipeline<WorldSnapshot> pipeline(&jobs, [&](WorldSnapshot& next) { world.UpdateGame(); world.BuildSnapshot(next); });
+///   // 毎フレーム
+///   pipeline.Sync();             // 前に頼んだ分を待って表と裏を入れ替える
+///   pipeline.Kick();             // 次の分を裏で作り始める
+///   Draw(pipeline.GetFront());   // その間に前の分を描画する
+/// </summary>
+template <typename Frame>
+class SnapshotPipeline {
+public:
+	// 裏のフレームに次の状態を書く
+	using Producer = std::function<void(Frame& frame)>;
+
+	/// <summary>
+	/// jobs のスレッドで producer を呼ぶ (jobs が null かワーカーが無ければ Kick の中で作り終わる)
+	/// </summary>
+	SnapshotPipeline(JobSystem* jobs, Producer producer) : jobs_(jobs), producer_(std::move(producer)) {}
+	// 作っている途中なら終わるのを待つ (入れ替えはしない)
+	~SnapshotPipeline() { Wait(); }
+
+	SnapshotPipeline(const SnapshotPipeline&) = delete;
+	SnapshotPipeline& operator=(const SnapshotPipeline&) = delete;
+
+	/// <summary>
+	/// 裏のフレームを作り始める (前に頼んだ分を Sync していなければ先に Sync する)
+	/// </summary>
+	void Kick();
+
+	/// <summary>
+	/// 頼んだ分が終わるのを (ジョブを手伝いながら) 待ち、表と裏を入れ替える
+	/// </summary>
+	/// <returns>新しいフレームに入れ替えたか (何も頼んでいなければ false)</returns>
+	bool Sync();
+
+	// 作っている途中か
+	bool IsBusy() const { return busy_; }
+
+	// 描画側が読むフレーム
+	Frame& GetFront() { return frames_[front_]; }
+	const Frame& GetFront() const { return frames_[front_]; }
+	// 次に作るフレーム (作っていない間だけ触ってよい)
+	Frame& GetBack() {
+		assert(!busy_);
+		return frames_[front_ ^ 1];
+	}
+
+private:
+	static void ProduceJob(void* data, size_t begin, size_t end);
+	void Wait();
+
+	JobSystem* jobs_ = nullptr;
+	Producer producer_;
+	Frame frames_[2];
+	size_t front_ = 0;
+	bool busy_ = false;
+	JobSystem::Counter pending_;
+};
+
+template <typename Frame>
+void SnapshotPipeline<Frame>::Kick() {
+	if (busy_) {
+		Sync();
+	}
+	busy_ = true;
+	if (!jobs_) {
+		producer_(frames_[front_ ^ 1]);
+		return;
+	}
+
+	JobSystem::Job job;
+	job.function = &SnapshotPipeline::ProduceJob;
+	job.data = this;
+	job.begin = 0;
+	job.end = 1;
+	job.counter = &pending_;
+	jobs_->Run(job);
+}
+
+template <typename Frame>
+bool SnapshotPipeline<Frame>::Sync() {
+	if (!busy_) {
+		return false;
+	}
+	Wait();
+	busy_ = false;
+	front_ ^= 1;
+	return true;
+}
+
+template <typename Frame>
+void SnapshotPipeline<Frame>::ProduceJob(void* data, size_t, size_t) {
+	SnapshotPipeline& pipeline = *static_cast<SnapshotPipeline*>(data);
+	pipeline.producer_(pipeline.frames_[pipeline.front_ ^ 1]);
+}
+
+template <typename Frame>
+void SnapshotPipeline<Frame>::Wait() {
+	if (jobs_) {
+		jobs_->Wait(pending_);
+	}
+}
@@ -0,0 +1,70 @@
+#include "SpatialHashGrid.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+SpatialHashGrid::SpatialHashGrid(float cellSize) : cellSize_(cellSize), inverseCellSize_(1.0f / cellSize) { assert(cellSize > 0.0f); }
+
+void SpatialHashGrid::Reset(size_t expectedCount) {
+	entries_.clear();
+	maxRadius_ = 0.0f;
+
+	// 要素数の 2 倍以上の 2 のべき乗にして、バケツあたりの要素を少なく保つ
+	size_t bucketCount = 16;
+	while (bucketCount < expectedCount * 2) {
+		bucketCount *= 2;
+	}
+	buckets_.assign(bucketCount, -1);
+}
+
+int32_t SpatialHashGrid::ToCell(float value) const { return static_cast<int32_t>(std::floor(value * inverseCellSize_)); }
+
+size_t SpatialHashGrid::BucketOf(int32_t cellX, int32_t cellY, int32_t cellZ) const {
+	uint32_t hash = static_cast<uint32_t>(cellX) * 73856093u ^ static_cast<uint32_t>(cellY) * 19349663u ^ static_cast<uint32_t>(cellZ) * 83492791u;
+	return hash & (buckets_.size() - 1);
+}
+
+void SpatialHashGrid::Insert(uint32_t id, const KamataEngine::Vector3& position, float radius) {
+	assert(!buckets_.empty());
+	Entry entry;
+	entry.cellX = ToCell(position.x);
+	entry.cellY = ToCell(position.y);
+	entry.cellZ = ToCell(position.z);
+	entry.id = id;
+
+	size_t bucket = BucketOf(entry.cellX, entry.cellY, entry.cellZ);
+	entry.next = buckets_[bucket];
+	buckets_[bucket] = static_cast<int32_t>(entries_.size());
+	entries_.push_back(entry);
+
+	maxRadius_ = std::max(maxRadius_, radius);
+}
+
+void SpatialHashGrid::Query(const KamataEngine::Vector3& position, float radius, std::vector<uint32_t>& out) const {
+	if (entries_.empty()) {
+		return;
+	}
+
+	// 登録した球の中心が入り得るセルの範囲
+	float reach = radius + maxRadius_;
+	int32_t minX = ToCell(position.x - reach);
+	int32_t minY = ToCell(position.y - reach);
+	int32_t minZ = ToCell(position.z - reach);
+	int32_t maxX = ToCell(position.x + reach);
+	int32_t maxY = ToCell(position.y + reach);
+	int32_t maxZ = ToCell(position.z + reach);
+
+	for (int32_t z = minZ; z <= maxZ; ++z) {
+		for (int32_t y = minY; y <= maxY; ++y) {
+			for (int32_t x = minX; x <= maxX; ++x) {
+				// 同じバケツに別のセルが混ざっていることがあるので、セルの座標も比べる
+				for (int32_t i = buckets_[BucketOf(x, y, z)]; i >= 0; i = entries_[i].next) {
+					const Entry& entry = entries_[i];
+					if (entry.cellX == x && entry.cellY == y && entry.cellZ == z) {
+						out.push_back(entry.id);
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <math/Vector3.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// 当たり判定の broadphase 用の一様グリッド (空間ハッシュ)
+/// 1 つの当たり判定レイヤー (例: 自弾) を毎フレーム作り直し、近くにいる可能性のあるものだけを問い合わせる
+/// 配列は使い回すので、数が増えない限り作り直しでメモリ確保はしない
+///
+/// 使い方:
+///   grid.Reset(bullets.size());
+///   for (i...) grid.Insert(i, bullets[i]->GetWorldPosition(), bulletRadius);
+///   grid.Query(enemyPos, enemyRadius, candidates); // candidates の球の判定は呼び出し側で行う
+/// </summary>
+class SpatialHashGrid {
+public:
+	/// <param name="cellSize">セルの一辺 (当たり判定の直径より少し大きいくらいが良い)</param>
+	explicit SpatialHashGrid(float cellSize);
+
+	/// <summary>
+	/// 空にする
+	/// </summary>
+	/// <param name="expectedCount">これから Insert する数 (ハッシュ表の大きさを決める)</param>
+	void Reset(size_t expectedCount);
+
+	/// <summary>
+	/// 球を登録する (中心のセルにだけ入れ、半径は問い合わせ範囲を広げて扱う)
+	/// </summary>
+	/// <param name="id">呼び出し側の番号 (配列のインデックスなど)</param>
+	void Insert(uint32_t id, const KamataEngine::Vector3& position, float radius);
+
+	/// <summary>
+	/// 中心 position・半径 radius の球と重なる可能性のある id を out の末尾に追加する
+	/// 同じ id は 1 度しか入らない。順番はバラバラなので、必要なら呼び出し側で並べ替える
+	/// </summary>
+	void Query(const KamataEngine::Vector3& position, float radius, std::vector<uint32_t>& out) const;
+
+	size_t GetCount() const { return entries_.size(); }
+
+private:
+	struct Entry {
+		int32_t cellX;
+		int32_t cellY;
+		int32_t cellZ;
+		uint32_t id;
+		int32_t next; // 同じバケツの次の要素 (-1 で終わり)
+	};
+
+	int32_t ToCell(float value) const;
+	size_t BucketOf(int32_t cellX, int32_t cellY, int32_t cellZ) const;
+
+	float cellSize_;
+	float inverseCellSize_;
+	// 登録した球の最大半径 (問い合わせ範囲をこの分広げる)
+	float maxRadius_ = 0.0f;
+
+	// バケツごとの先頭の要素 (-1 で空)。大きさは 2 のべき乗
+	std::vector<int32_t> buckets_;
+	std::vector<Entry> entries_;
+};
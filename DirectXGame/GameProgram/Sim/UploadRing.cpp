@@ -0,0 +1,76 @@
+#include "UploadRing.h"
+#include <algorithm>
+
+void UploadRing::Initialize(uint64_t capacity) {
+	capacity_ = capacity / kAlignment * kAlignment;
+	head_ = 0;
+	tail_ = 0;
+	used_ = 0;
+	highWater_ = 0;
+	frameBytes_ = 0;
+	firstMark_ = 0;
+	markCount_ = 0;
+}
+
+uint64_t UploadRing::Allocate(uint64_t size) {
+	uint64_t aligned = (size + kAlignment - 1) / kAlignment * kAlignment;
+	if (aligned == 0 || aligned > capacity_) {
+		return kInvalidOffset;
+	}
+	if (used_ == 0) {
+		// 空なら先頭からやり直す (末尾で飛ばす分が出にくい)
+		head_ = 0;
+		tail_ = 0;
+	}
+
+	uint64_t offset = kInvalidOffset;
+	uint64_t skipped = 0;
+	if (head_ >= tail_ && used_ < capacity_) {
+		// 使用中の範囲は [tail_, head_)。後ろに入らなければ末尾を飛ばして先頭に戻る
+		if (capacity_ - head_ >= aligned) {
+			offset = head_;
+		} else if (tail_ >= aligned) {
+			offset = 0;
+			skipped = capacity_ - head_;
+		}
+	} else if (head_ < tail_ && tail_ - head_ >= aligned) {
+		// 一度先頭に戻っているので、空きは [head_, tail_)
+		offset = head_;
+	}
+	if (offset == kInvalidOffset) {
+		return kInvalidOffset;
+	}
+
+	head_ = offset + aligned;
+	used_ += skipped + aligned;
+	frameBytes_ += skipped + aligned;
+	highWater_ = std::max(highWater_, used_);
+	return offset;
+}
+
+void UploadRing::FinishFrame(uint64_t fence) {
+	if (frameBytes_ == 0) {
+		return;
+	}
+	if (markCount_ == kMaxFramesInFlight) {
+		// 入りきらないときは一番新しいフレームにまとめる (空くのが遅くなるだけで、早く空くことはない)
+		FrameMark& newest = marks_[(firstMark_ + markCount_ - 1) % kMaxFramesInFlight];
+		newest.fence = std::max(newest.fence, fence);
+		newest.end = head_;
+		newest.bytes += frameBytes_;
+	} else {
+		marks_[(firstMark_ + markCount_) % kMaxFramesInFlight] = {fence, head_, frameBytes_};
+		markCount_++;
+	}
+	frameBytes_ = 0;
+}
+
+void UploadRing::Retire(uint64_t completedFence) {
+	while (markCount_ > 0 && marks_[firstMark_].fence <= completedFence) {
+		const FrameMark& mark = marks_[firstMark_];
+		tail_ = mark.end;
+		used_ -= mark.bytes;
+		firstMark_ = (firstMark_ + 1) % kMaxFramesInFlight;
+		markCount_--;
+	}
+}
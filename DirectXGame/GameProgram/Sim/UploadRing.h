@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// 1 本のバッファをフレームごとに前から切り出して使い回すリングアロケータ (位置の計算だけで、メモリは持たない)
+/// 切り出した範囲は、そのフレームの GPU の処理が終わった (フェンスの値が届いた) ときにまとめて空く
+/// 切り出しは定数バッファの境界 (256 バイト) にそろえる。末尾に入りきらなければ先頭に戻る
+///
+/// 使い方:
+///   ring.Retire(completedFence);      // GPU が終えたフレームの分を空ける
+///   uint64_t offset = ring.Allocate(sizeof(ConstBufferData));
+///   if (offset != UploadRing::kInvalidOffset) { ... バッファの先頭 + offset に書き込む ... }
+///   ring.FinishFrame(frameFence);     // このフレームの分は frameFence が届いたら空く
+/// </summary>
+class UploadRing {
+public:
+	// 定数バッファビューのアドレスの境界 (D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT)
+	static const uint64_t kAlignment = 256;
+	// 同時に GPU に渡っているフレームの最大数 (超えたら新しいフレームとまとめて空ける)
+	static const size_t kMaxFramesInFlight = 4;
+	static const uint64_t kInvalidOffset = UINT64_MAX;
+
+	/// <summary>
+	/// 容量を決めて全部空ける (capacity は kAlignment の倍数に切り下げる)
+	/// </summary>
+	void Initialize(uint64_t capacity);
+
+	/// <summary>
+	/// size バイトを切り出して先頭の位置を返す (空きが無ければ kInvalidOffset)
+	/// </summary>
+	uint64_t Allocate(uint64_t size);
+
+	/// <summary>
+	/// ここまでに切り出した分を、fence の値が届いたら空くフレームとして閉じる
+	/// </summary>
+	void FinishFrame(uint64_t fence);
+
+	/// <summary>
+	/// completedFence 以下のフェンスで閉じたフレームの分を空ける
+	/// </summary>
+	void Retire(uint64_t completedFence);
+
+	uint64_t GetCapacity() const { return capacity_; }
+	// 使用中のバイト数 (境界合わせと末尾の飛ばした分を含む)
+	uint64_t GetUsed() const { return used_; }
+	uint64_t GetHighWaterMark() const { return highWater_; }
+
+private:
+	// 閉じたフレームの 終わりの位置 と 使ったバイト数
+	struct FrameMark {
+		uint64_t fence;
+		uint64_t end;
+		uint64_t bytes;
+	};
+
+	uint64_t capacity_ = 0;
+	// 次に切り出す位置と、まだ空いていない一番古い位置
+	uint64_t head_ = 0;
+	uint64_t tail_ = 0;
+	uint64_t used_ = 0;
+	uint64_t highWater_ = 0;
+	// 閉じていないフレームで使ったバイト数
+	uint64_t frameBytes_ = 0;
+
+	// 古い順 (marks_[firstMark_] から markCount_ 個)
+	FrameMark marks_[kMaxFramesInFlight] = {};
+	size_t firstMark_ = 0;
+	size_t markCount_ = 0;
+};
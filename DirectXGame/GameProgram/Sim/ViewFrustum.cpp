@@ -0,0 +1,100 @@
+#include "ViewFrustum.h"
+#include "Simd.h"
+#include <algorithm>
+#include <cmath>
+
+void ViewFrustum::SetViewProjection(const KamataEngine::Matrix4x4& viewProjection) {
+	const KamataEngine::Matrix4x4& m = viewProjection;
+	// クリップ座標の各成分は 行列の列 と (x, y, z, 1) の内積
+	auto column = [&m](int c, float sign, int w) {
+		return Plane{m.m[0][w] + sign * m.m[0][c], m.m[1][w] + sign * m.m[1][c], m.m[2][w] + sign * m.m[2][c], m.m[3][w] + sign * m.m[3][c]};
+	};
+	planes_[0] = column(0, 1.0f, 3);  // 左   -w <= x
+	planes_[1] = column(0, -1.0f, 3); // 右    x <= w
+	planes_[2] = column(1, 1.0f, 3);  // 下   -w <= y
+	planes_[3] = column(1, -1.0f, 3); // 上    y <= w
+	planes_[4] = {m.m[0][2], m.m[1][2], m.m[2][2], m.m[3][2]}; // 手前 0 <= z
+	planes_[5] = column(2, -1.0f, 3); // 奥    z <= w
+
+	// 距離を半径と比べられるように正規化する
+	for (Plane& plane : planes_) {
+		float length = std::sqrt(plane.a * plane.a + plane.b * plane.b + plane.c * plane.c);
+		if (length > 0.0f) {
+			float inv = 1.0f / length;
+			plane.a *= inv;
+			plane.b *= inv;
+			plane.c *= inv;
+			plane.d *= inv;
+		}
+	}
+}
+
+bool ViewFrustum::IsSphereVisible(const KamataEngine::Vector3& center, float radius) const {
+	for (const Plane& plane : planes_) {
+		if (plane.a * center.x + plane.b * center.y + plane.c * center.z + plane.d < -radius) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void ViewFrustum::CullSpheres(const float* x, const float* y, const float* z, const float* radius, size_t count, std::vector<uint32_t>& visible) const {
+	size_t i = 0;
+#ifdef MT_SSE2
+	for (; i + kSimdLanes <= count; i += kSimdLanes) {
+		__m128 px = _mm_loadu_ps(&x[i]);
+		__m128 py = _mm_loadu_ps(&y[i]);
+		__m128 pz = _mm_loadu_ps(&z[i]);
+		__m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&radius[i]));
+
+		// 6 枚の平面すべての内側 (半径分の余裕込み) にある球だけビットが残る
+		__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (const Plane& plane : planes_) {
+			__m128 distance = _mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(plane.a)), _mm_mul_ps(py, _mm_set1_ps(plane.b)));
+			distance = _mm_add_ps(distance, _mm_mul_ps(pz, _mm_set1_ps(plane.c)));
+			distance = _mm_add_ps(distance, _mm_set1_ps(plane.d));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negRadius));
+		}
+
+		int mask = _mm_movemask_ps(inside);
+		for (size_t lane = 0; lane < kSimdLanes; ++lane) {
+			if (mask & (1 << lane)) {
+				visible.push_back(static_cast<uint32_t>(i + lane));
+			}
+		}
+	}
+#endif
+	// SIMD の幅に足りない残り (SSE2 が無ければ全部)
+	for (; i < count; ++i) {
+		if (IsSphereVisible({x[i], y[i], z[i]}, radius[i])) {
+			visible.push_back(static_cast<uint32_t>(i));
+		}
+	}
+}
+
+void ViewFrustum::CullMatrices(std::vector<KamataEngine::Matrix4x4>& matrices, float modelRadius) {
+	size_t count = matrices.size();
+	x_.resize(count);
+	y_.resize(count);
+	z_.resize(count);
+	radius_.resize(count);
+	for (size_t i = 0; i < count; ++i) {
+		const KamataEngine::Matrix4x4& m = matrices[i];
+		x_[i] = m.m[3][0];
+		y_[i] = m.m[3][1];
+		z_[i] = m.m[3][2];
+		// 各軸の拡大率 (行の長さ) の最大で半径を広げる
+		float scaleSq = std::max({m.m[0][0] * m.m[0][0] + m.m[0][1] * m.m[0][1] + m.m[0][2] * m.m[0][2], m.m[1][0] * m.m[1][0] + m.m[1][1] * m.m[1][1] + m.m[1][2] * m.m[1][2],
+		                          m.m[2][0] * m.m[2][0] + m.m[2][1] * m.m[2][1] + m.m[2][2] * m.m[2][2]});
+		radius_[i] = modelRadius * std::sqrt(scaleSq);
+	}
+
+	visible_.clear();
+	CullSpheres(x_.data(), y_.data(), z_.data(), radius_.data(), count, visible_);
+
+	// 見える行列を前に詰める (visible_ は小さい順なので上書きしても読む前に消えない)
+	for (size_t i = 0; i < visible_.size(); ++i) {
+		matrices[i] = matrices[visible_[i]];
+	}
+	matrices.resize(visible_.size());
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <math/Matrix4x4.h>
+#include <math/Vector3.h>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// 視錐台カリング
+/// view * projection の行列から 6 枚の平面を取り出し、境界球が視錐台と重なるかを判定する
+/// まとめて判定するときは SoA の配列を SSE2 で 4 個ずつ処理する
+///
+/// 使い方:
+///   frustum.SetViewProjection(Multiply(matView, matProjection));
+///   frustum.CullMatrices(snapshot.meteorites, kMeteoriteModelRadius); // 見えない隕石を描画リストから外す
+/// </summary>
+class ViewFrustum {
+public:
+	/// <summary>
+	/// 行ベクトル × 行列 の view * projection から平面を作る (クリップ空間の z は D3D と同じ 0〜w)
+	/// </summary>
+	void SetViewProjection(const KamataEngine::Matrix4x4& viewProjection);
+
+	/// <summary>
+	/// 球が視錐台と重なるか (境界付近では見えない球も true になることがある)
+	/// </summary>
+	bool IsSphereVisible(const KamataEngine::Vector3& center, float radius) const;
+
+	/// <summary>
+	/// SoA の球をまとめて判定し、見える球の番号を visible の末尾に小さい順に追加する
+	/// </summary>
+	void CullSpheres(const float* x, const float* y, const float* z, const float* radius, size_t count, std::vector<uint32_t>& visible) const;
+
+	/// <summary>
+	/// ワールド行列の並びから見えないものを取り除く (並び順は保つ)
+	/// 境界球は 行列の平行移動成分 を中心、modelRadius × 行列の最大の拡大率 を半径とする
+	/// </summary>
+	/// <param name="modelRadius">モデルの頂点の原点からの最大距離</param>
+	void CullMatrices(std::vector<KamataEngine::Matrix4x4>& matrices, float modelRadius);
+
+	/// <summary>
+	/// パーティクルなど、position (Vector3) と scale (float) を持つものの並びから見えないものを取り除く (並び順は保つ)
+	/// 境界球は 位置 を中心、modelRadius × 大きさ を半径とする
+	/// </summary>
+	template <typename Instance>
+	void CullInstances(std::vector<Instance>& instances, float modelRadius);
+
+private:
+	// a * x + b * y + c * z + d >= 0 が内側 (a, b, c は正規化済み)
+	struct Plane {
+		float a;
+		float b;
+		float c;
+		float d;
+	};
+
+	static const size_t kPlaneCount = 6;
+	Plane planes_[kPlaneCount] = {};
+
+	// CullMatrices / CullInstances の作業用 (容量は使い回す)
+	std::vector<float> x_;
+	std::vector<float> y_;
+	std::vector<float> z_;
+	std::vector<float> radius_;
+	std::vector<uint32_t> visible_;
+};
+
+template <typename Instance>
+void ViewFrustum::CullInstances(std::vector<Instance>& instances, float modelRadius) {
+	size_t count = instances.size();
+	x_.resize(count);
+	y_.resize(count);
+	z_.resize(count);
+	radius_.resize(count);
+	for (size_t i = 0; i < count; ++i) {
+		x_[i] = instances[i].position.x;
+		y_[i] = instances[i].position.y;
+		z_[i] = instances[i].position.z;
+		radius_[i] = modelRadius * std::abs(instances[i].scale);
+	}
+
+	visible_.clear();
+	CullSpheres(x_.data(), y_.data(), z_.data(), radius_.data(), count, visible_);
+
+	for (size_t i = 0; i < visible_.size(); ++i) {
+		instances[i] = instances[visible_[i]];
+	}
+	instances.resize(visible_.size());
+}
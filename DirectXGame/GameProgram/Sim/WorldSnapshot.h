@@ -0,0 +1,61 @@
+#pragma once
+#include "Enemy.h"
+#include "Particle.h"
+#include <math/Matrix4x4.h>
+#include <math/Vector2.h>
+#include <vector>
+
+/// <summary>
+/// 描画する時点のワールドの状態 (描画側はこれだけを参照して描画する)
+/// モデルの行列とパーティクルの並びは、視錐台の外のものを除いてある
+/// </summary>
+struct WorldSnapshot {
+	// カメラ
+	KamataEngine::Matrix4x4 matView = {};
+	KamataEngine::Matrix4x4 matProjection = {};
+
+	// 自機
+	KamataEngine::Matrix4x4 playerMatrix = {};
+	std::vector<KamataEngine::Matrix4x4> playerBullets;
+	// 排気パーティクル
+	std::vector<ParticleInstance> exhaustParticles;
+
+	// 爆発パーティクル
+	std::vector<ParticleInstance> explosionParticles;
+
+	// 敵 (enemyScreens はスプライトを描く敵だけなので、enemies とは並びが対応しない)
+	std::vector<KamataEngine::Matrix4x4> enemies;
+	std::vector<EnemyScreenState> enemyScreens;
+	std::vector<KamataEngine::Matrix4x4> enemyBullets;
+
+	// 隕石
+	std::vector<KamataEngine::Matrix4x4> meteorites;
+
+	// ミニマップ
+	std::vector<KamataEngine::Vector2> minimapEnemies;
+	std::vector<KamataEngine::Vector2> minimapEnemyBullets;
+	float minimapPlayerRotation = 0.0f;
+
+	int score = 0;
+
+	// 前回のスナップショット以降に発生したイベント (効果音用)
+	bool playerShot = false;
+	int enemiesKilled = 0;
+
+	/// <summary>
+	/// 容量を残したまま中身を空にする
+	/// </summary>
+	void Clear() {
+		playerBullets.clear();
+		exhaustParticles.clear();
+		explosionParticles.clear();
+		enemies.clear();
+		enemyScreens.clear();
+		enemyBullets.clear();
+		meteorites.clear();
+		minimapEnemies.clear();
+		minimapEnemyBullets.clear();
+		playerShot = false;
+		enemiesKilled = 0;
+	}
+};
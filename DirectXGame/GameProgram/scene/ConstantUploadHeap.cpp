@@ -0,0 +1,68 @@
+#include "ConstantUploadHeap.h"
+#include <cassert>
+#include <cstring>
+
+ConstantUploadHeap::~ConstantUploadHeap() {
+	if (buffer_.Get() && mapped_) {
+		buffer_->Unmap(0, nullptr);
+	}
+}
+
+void ConstantUploadHeap::Initialize(ID3D12Device* device, uint64_t capacity) {
+	device_ = device;
+	CreateBuffer(capacity);
+}
+
+void ConstantUploadHeap::CreateBuffer(uint64_t capacity) {
+	if (buffer_.Get() && mapped_) {
+		buffer_->Unmap(0, nullptr);
+		mapped_ = nullptr;
+	}
+
+	// CPU から書き込んで GPU がそのまま読むバッファ
+	D3D12_HEAP_PROPERTIES heapProps{};
+	heapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
+	D3D12_RESOURCE_DESC resourceDesc{};
+	resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+	resourceDesc.Width = capacity;
+	resourceDesc.Height = 1;
+	resourceDesc.DepthOrArraySize = 1;
+	resourceDesc.MipLevels = 1;
+	resourceDesc.SampleDesc.Count = 1;
+	resourceDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+	HRESULT result = device_->CreateCommittedResource(&heapProps, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&buffer_));
+	assert(SUCCEEDED(result));
+
+	// 作ってから捨てるまで Map したままにする
+	result = buffer_->Map(0, nullptr, reinterpret_cast<void**>(&mapped_));
+	assert(SUCCEEDED(result));
+	baseAddress_ = buffer_->GetGPUVirtualAddress();
+
+	ring_.Initialize(capacity);
+}
+
+void ConstantUploadHeap::BeginFrame() {
+	// 前のフレームの分を閉じる
+	// DirectXCommon::PostDraw は GPU の完了を待ってから戻るので、前のフレームまではもう読み終わっている
+	ring_.FinishFrame(frame_);
+	ring_.Retire(frame_);
+	frame_++;
+
+	// 足りなかったら倍にする (どのフレームも読み終わっているので作り直してよい)
+	if (overflowed_) {
+		overflowed_ = false;
+		CreateBuffer(ring_.GetCapacity() * 2);
+	}
+}
+
+bool ConstantUploadHeap::Allocate(const void* data, size_t size, D3D12_GPU_VIRTUAL_ADDRESS& address) {
+	uint64_t offset = ring_.Allocate(size);
+	if (offset == UploadRing::kInvalidOffset) {
+		overflowed_ = true;
+		return false;
+	}
+	std::memcpy(mapped_ + offset, data, size);
+	address = baseAddress_ + offset;
+	return true;
+}
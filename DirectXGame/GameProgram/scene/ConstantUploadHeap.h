@@ -0,0 +1,49 @@
+#pragma once
+#include "UploadRing.h"
+#include <d3d12.h>
+#include <wrl.h>
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// フレームの間だけ使う定数をまとめて置く アップロードヒープ
+/// 1 本の大きなバッファを常に Map したまま UploadRing で 256 バイト単位に切り出すので、
+/// 描画するものが増えても定数バッファを 1 個ずつ作らない
+///
+/// 使い方:
+///   heap.BeginFrame();
+///   D3D12_GPU_VIRTUAL_ADDRESS address;
+///   if (heap.Allocate(&data, sizeof(data), address)) { commandList->SetGraphicsRootConstantBufferView(index, address); }
+/// </summary>
+class ConstantUploadHeap {
+public:
+	~ConstantUploadHeap();
+
+	void Initialize(ID3D12Device* device, uint64_t capacity);
+
+	/// <summary>
+	/// フレームの始めに呼ぶ (前のフレームの分を空ける。前のフレームで足りなかったら作り直して広げる)
+	/// </summary>
+	void BeginFrame();
+
+	/// <summary>
+	/// data を size バイト書き込んで、定数バッファビューに渡すアドレスを返す (空きが無ければ false)
+	/// </summary>
+	bool Allocate(const void* data, size_t size, D3D12_GPU_VIRTUAL_ADDRESS& address);
+
+	uint64_t GetCapacity() const { return ring_.GetCapacity(); }
+
+private:
+	void CreateBuffer(uint64_t capacity);
+
+	ID3D12Device* device_ = nullptr;
+	Microsoft::WRL::ComPtr<ID3D12Resource> buffer_;
+	uint8_t* mapped_ = nullptr;
+	D3D12_GPU_VIRTUAL_ADDRESS baseAddress_ = 0;
+
+	UploadRing ring_;
+	// フェンスの代わりのフレーム番号
+	uint64_t frame_ = 0;
+	// 今のフレームで切り出せなかったか
+	bool overflowed_ = false;
+};
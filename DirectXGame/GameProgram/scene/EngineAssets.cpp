@@ -0,0 +1,88 @@
+#include "EngineAssets.h"
+#include <base/TextureManager.h>
+#include <chrono>
+
+namespace {
+
+// Model と TextureManager が読みに行くフォルダ (どちらも既定の Resources/ を使っている)
+const char* kResourceDirectory = "Resources/";
+
+// GPU に置いた頂点とインデックスのバイト数
+uint64_t EstimateModelBytes(KamataEngine::Model* model) {
+	uint64_t bytes = 0;
+	if (model) {
+		for (const std::unique_ptr<KamataEngine::Mesh>& mesh : model->GetMeshes()) {
+			bytes += mesh->GetVertices().size() * sizeof(KamataEngine::Mesh::VertexPosNormalUv);
+			bytes += mesh->GetIndices().size() * sizeof(uint32_t);
+		}
+	}
+	return bytes;
+}
+
+// 1 枚目のミップを RGBA8 として見積もる
+uint64_t EstimateTextureBytes(uint32_t handle) {
+	D3D12_RESOURCE_DESC desc = KamataEngine::TextureManager::GetInstance()->GetResoureDesc(handle);
+	return desc.Width * desc.Height * desc.DepthOrArraySize * 4;
+}
+
+double SecondsSince(std::chrono::steady_clock::time_point start) { return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); }
+
+} // namespace
+
+EngineAssets::EngineAssets(AssetLoader& loader) : loader_(loader), models_([](KamataEngine::Model*& model) { delete model; }) {}
+
+void EngineAssets::RequestModel(const std::string& name, KamataEngine::Model*& model, std::function<void()> then) {
+	bool isNew = models_.Acquire(name, [&model, then](KamataEngine::Model* const& shared) {
+		model = shared;
+		if (then) {
+			then();
+		}
+	});
+	if (!isNew) {
+		// 読み込み済みならもう入っていて、読み込み中なら仕上がったときに入る
+		return;
+	}
+	loader_.Request(std::string(kResourceDirectory) + name + "/" + name + ".obj", [this, name]() { CreateModel(name); });
+}
+
+void EngineAssets::RequestTexture(const std::string& fileName, uint32_t& handle, std::function<void()> then) {
+	bool isNew = textures_.Acquire(fileName, [&handle, then](const uint32_t& shared) {
+		handle = shared;
+		if (then) {
+			then();
+		}
+	});
+	if (!isNew) {
+		return;
+	}
+	loader_.Request(std::string(kResourceDirectory) + fileName, [this, fileName]() { CreateTexture(fileName); });
+}
+
+KamataEngine::Model* EngineAssets::LoadModel(const std::string& name) {
+	if (models_.Acquire(name)) {
+		CreateModel(name);
+	}
+	// 裏で読み込み中なら、ここで仕上げを待たずに null を返す
+	KamataEngine::Model* const* model = models_.Find(name);
+	return model ? *model : nullptr;
+}
+
+uint32_t EngineAssets::LoadTexture(const std::string& fileName) {
+	if (textures_.Acquire(fileName)) {
+		CreateTexture(fileName);
+	}
+	const uint32_t* handle = textures_.Find(fileName);
+	return handle ? *handle : 0;
+}
+
+void EngineAssets::CreateModel(const std::string& name) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	KamataEngine::Model* model = KamataEngine::Model::CreateFromOBJ(name, true);
+	models_.Store(name, model, SecondsSince(start), EstimateModelBytes(model));
+}
+
+void EngineAssets::CreateTexture(const std::string& fileName) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	uint32_t handle = KamataEngine::TextureManager::Load(fileName);
+	textures_.Store(fileName, handle, SecondsSince(start), EstimateTextureBytes(handle));
+}
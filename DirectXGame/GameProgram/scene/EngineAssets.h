@@ -0,0 +1,49 @@
+#pragma once
+#include "AssetLoader.h"
+#include "ResourceRegistry.h"
+#include <3d/Model.h>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+/// <summary>
+/// KamataEngine のモデル・テクスチャを名前で共有する (参照カウント付き)
+/// 同じ名前は最初の 1 回だけ読み込み、2 回目からは読み込み済み (または読み込み中) のものを渡す
+/// 裏で読むものは AssetLoader でファイルを先に読み、仕上げ (メインスレッド) でエンジンの読み込み (解析・デコード・GPU へのアップロード) を呼ぶ
+/// 結果は仕上がったときに model / handle に入るので、入れ先は Release するまで生きていること
+///
+/// モデルは最後の Release で消す。テクスチャはエンジンが終了まで持っているので、参照を数えるだけ
+/// </summary>
+class EngineAssets {
+public:
+	explicit EngineAssets(AssetLoader& loader);
+
+	EngineAssets(const EngineAssets&) = delete;
+	EngineAssets& operator=(const EngineAssets&) = delete;
+
+	// Resources/<name>/<name>.obj (と MTL・テクスチャ) を裏で読み、仕上げで Model::CreateFromOBJ した結果を model に入れて then を呼ぶ
+	void RequestModel(const std::string& name, KamataEngine::Model*& model, std::function<void()> then = nullptr);
+	// Resources/<fileName> を裏で読み、仕上げで TextureManager::Load した結果を handle に入れて then を呼ぶ
+	void RequestTexture(const std::string& fileName, uint32_t& handle, std::function<void()> then = nullptr);
+
+	// その場で読む (タイトル画面で使うもの)
+	KamataEngine::Model* LoadModel(const std::string& name);
+	uint32_t LoadTexture(const std::string& fileName);
+
+	// Request / Load 1 回につき 1 回呼ぶ
+	void ReleaseModel(const std::string& name) { models_.Release(name); }
+	void ReleaseTexture(const std::string& fileName) { textures_.Release(fileName); }
+
+	// 読み込んだ回数・共有した回数・読み込みの時間・メモリの見積もり
+	const ResourceRegistry<KamataEngine::Model*>::Stats& GetModelStats() const { return models_.GetStats(); }
+	const ResourceRegistry<uint32_t>::Stats& GetTextureStats() const { return textures_.GetStats(); }
+
+private:
+	// エンジンで読み込んで置き場に入れる (初めての名前のときだけ呼ぶ)
+	void CreateModel(const std::string& name);
+	void CreateTexture(const std::string& fileName);
+
+	AssetLoader& loader_;
+	ResourceRegistry<KamataEngine::Model*> models_;
+	ResourceRegistry<uint32_t> textures_;
+};
@@ -1,43 +1,29 @@
 #include "GaneScene.h"
+#include "EngineAssets.h"
+#include "Profiler.h"
 #include "3d/AxisIndicator.h"
 #include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstdlib>
-#include <fstream>
-
-KamataEngine::Vector3 Lerp(const KamataEngine::Vector3& start, const KamataEngine:: Vector3& end, float t) {
-	t = std::clamp(t, 0.0f, 1.0f);
-	return start + (end - start) * t;
-}
-float Distance(const KamataEngine::Vector3& v1, const KamataEngine::Vector3& v2) {
-	float dx = v1.x - v2.x;
-	float dy = v1.y - v2.y;
-	float dz = v1.z - v2.z;
-	return std::sqrt(dx * dx + dy * dy + dz * dz);
-}
-float GameScene::DistanceSquared(const Vector3& v1, const Vector3& v2) {
-	float dx = v1.x - v2.x;
-	float dy = v1.y - v2.y;
-	float dz = v1.z - v2.z;
-	return dx * dx + dy * dy + dz * dz;
-}
+#include <random>
 
 GameScene::GameScene() {}
 
 GameScene::~GameScene() {
-	delete modelPlayer_;
-	delete modelEnemy_;
-	delete modelSkydome_;
-	delete modelTitleObject_;
-	delete modelMeteorite_;
-	delete modelEnemyBullet_; // 敵弾モデルを解放（追加）
-	for (Meteorite* meteor : meteorites_) {
-		delete meteor;
-	}
-	delete player_;
+	// 裏で回しているシミュレーションと読み込み中のファイルを待ってから、入れ先を消す
+	delete pipeline_;
+	delete assetLoader_;
+	if (isRecording_ && world_) {
+		recording_.SetFinalHash(world_->ComputeStateHash());
+		recording_.Save(recordingPath_);
+	}
+	delete world_;
+	delete jobSystem_;
+	delete worldRenderer_;
 	delete skydome_;
-	delete railCamera_;
+	// 借りていたモデルは worldRenderer_ が返した後、置き場と一緒に消える (テクスチャはエンジンが持っている)
+	delete assets_;
 	delete reticleSprite_;
 	delete transitionSprite_;
 	delete taitoruSprite_;
@@ -46,12 +32,9 @@ GameScene::~GameScene() {
 	delete lightSprite_;
 	delete leftSprite_;
 	delete shiftSprite_; // Shiftスプライトを解放
-	delete explosionEmitter_;
-	delete modelParticle_;
 	delete minimapSprite_;
 	delete minimapPlayerSprite_;
 	// シーンのクリア
-	delete clearEmitter_;
 	delete clearSprite_;
 	for (KamataEngine::Sprite* sprite : minimapEnemySprites_) {
 		delete sprite;
@@ -61,12 +44,6 @@ GameScene::~GameScene() {
 		delete sprite;
 	}
 	minimapEnemyBulletSprites_.clear();
-	for (EnemyBullet* bullet : enemyBullets_) {
-		delete bullet;
-	}
-	for (Enemy* enemy : enemies_) {
-		delete enemy;
-	}
 
 	// delete score digit sprites
 	for (KamataEngine::Sprite* s : scoreDigitSprites_) {
@@ -74,142 +51,166 @@ GameScene::~GameScene() {
 	}
 }
 
+void GameScene::StartRecording(const std::string& path) {
+	recordingPath_ = path;
+	isRecording_ = true;
+}
+
+bool GameScene::StartReplay(const std::string& path) {
+	if (!recording_.Load(path)) {
+		return false;
+	}
+	replayer_.Rewind();
+	isReplaying_ = true;
+	// 再生中の入力をそのまま記録し直すことはしない
+	isRecording_ = false;
+	return true;
+}
+
 void GameScene::Initialize() {
+	PROFILE_ZONE("GameScene::Initialize");
 	dxCommon_ = DirectXCommon::GetInstance();
 	input_ = Input::GetInstance();
 	audio_ = Audio::GetInstance();
 
-	player_ = new Player();
-	skydome_ = new Skydome();
+	KamataEngine::Vector2 screenCenter = {WinApp::kWindowWidth / 2.0f, WinApp::kWindowHeight / 2.0f};
 
-	modelPlayer_ = KamataEngine::Model::CreateFromOBJ("fly2", true);
-	modelEnemy_ = KamataEngine::Model::CreateFromOBJ("boat", true);
-	modelSkydome_ = Model::CreateFromOBJ("skydome", true);
-	modelTitleObject_ = Model::CreateFromOBJ("title", true);
+	// 裏での読み込みとシミュレーションは同じスレッドを使う (起動時の読み込みとゲームでスレッドを二重に立てない)
+	jobSystem_ = new JobSystem(JobSystem::DefaultWorkerCount());
 
-	// 敵弾用のOBJモデルを読み込む（ファイル名: Resources/bulletEnemy.obj を想定）
-	modelEnemyBullet_ = KamataEngine::Model::CreateFromOBJ("bulletEnemy", true);
+	// モデルとテクスチャは名前で共有する (ゲーム中に使うものは assetLoader_ で裏で読む)
+	assetLoader_ = new AssetLoader(jobSystem_);
+	assets_ = new EngineAssets(*assetLoader_);
 
-	modelMeteorite_ = KamataEngine::Model::CreateFromOBJ("meteorite", true);
-	meteoriteSpawnTimer_ = 0;
+	// --- タイトル画面で使うものはここで読み込む ---
+	modelTitleObject_ = assets_->LoadModel("title");
 
-	transitionTextureHandle_ = KamataEngine::TextureManager::Load("black.png");
+	transitionTextureHandle_ = assets_->LoadTexture("black.png");
 	transitionSprite_ = KamataEngine::Sprite::Create(transitionTextureHandle_, {0, 0});
-	KamataEngine::Vector2 screenCenter = {WinApp::kWindowWidth / 2.0f, WinApp::kWindowHeight / 2.0f};
 	transitionSprite_->SetPosition(screenCenter);
 	transitionSprite_->SetAnchorPoint({0.5f, 0.5f});
 	transitionSprite_->SetSize({0.0f, 0.0f});
 
-	reticleTextureHandle_ = KamataEngine::TextureManager::Load("reticle.png");
-	reticleSprite_ = KamataEngine::Sprite::Create(reticleTextureHandle_, {0, 0});
-	reticleSprite_->SetPosition(screenCenter);
-	reticleSprite_->SetAnchorPoint({0.5f, 0.5f});
-
-	taitoruTextureHandle_ = KamataEngine::TextureManager::Load("sousa.png");
+	taitoruTextureHandle_ = assets_->LoadTexture("sousa.png");
 	taitoruSprite_ = KamataEngine::Sprite::Create(taitoruTextureHandle_, {0, 0});
 
-	aimAssistCircleTextureHandle_ = KamataEngine::TextureManager::Load("aimCircle.png");
-	aimAssistCircleSprite_ = KamataEngine::Sprite::Create(aimAssistCircleTextureHandle_, {0, 0});
-	aimAssistCircleSprite_->SetSize({0.0f, 0.0f});
+	camera_.Initialize();
 
-	modelParticle_ = KamataEngine::Model::CreateFromOBJ("flare", true);
-	explosionEmitter_ = new ParticleEmitter();
-	if (explosionEmitter_) {
-		explosionEmitter_->Initialize(modelParticle_);
-	}
+	worldTransformTitleObject_.Initialize();
+	worldTransformTitleObject_.translation_ = {0.0f, 0.0f, -43.0f};
+	worldTransformTitleObject_.UpdateMatrix();
 
-	// シーンクリア用アセット
-	clearTextureHandle_ = KamataEngine::TextureManager::Load("kuria.png");
-	clearSprite_ = KamataEngine::Sprite::Create(clearTextureHandle_, {0, 0});
-	if (clearSprite_) {
-		// kuria.png を画面全体にかぶせる
-		clearSprite_->SetAnchorPoint({0.0f, 0.0f});
-		clearSprite_->SetPosition({0.0f, 0.0f});
-		clearSprite_->SetSize({(float)WinApp::kWindowWidth, (float)WinApp::kWindowHeight});
-	}
+	// --- ゲーム中に使うものは裏で読み込み、タイトル画面の間に少しずつ仕上げる ---
+	// (タイトルから抜ける暗転の途中で残りを全部仕上げる)
 
-	clearEmitter_ = new ParticleEmitter();
-	if (clearEmitter_) {
-		clearEmitter_->Initialize(modelParticle_);
-	}
+	// スカイドームのモデルは後から渡す (Update は先に回るので変換だけ先に初期化しておく)
+	skydome_ = new Skydome();
+	skydome_->Initialize(nullptr, &camera_);
+	assets_->RequestModel("skydome", modelSkydome_, [this]() { skydome_->SetModel(modelSkydome_); });
 
-	// コンフェッティ用スプライトテクスチャ
-	confettiTextureHandle_ = KamataEngine::TextureManager::Load("confetti.png");
-	confettiParticles_.resize(kMaxConfetti_);
-	for (size_t i = 0; i < kMaxConfetti_; ++i) {
-		confettiParticles_[i].sprite = KamataEngine::Sprite::Create(confettiTextureHandle_, {0, 0});
-		if (confettiParticles_[i].sprite) {
-			confettiParticles_[i].sprite->SetSize({8.0f, 8.0f});
-			confettiParticles_[i].sprite->SetAnchorPoint({0.5f, 0.5f});
-			confettiParticles_[i].active = false;
-			// デフォルト色: 白
-			confettiParticles_[i].sprite->SetColor({1.0f, 1.0f, 1.0f, 1.0f});
-		}
-	}
+	worldRenderer_ = new WorldRenderer();
+	worldRenderer_->Initialize(*assets_);
 
-	if (aimAssistCircleSprite_) {
-		aimAssistCircleSprite_->SetPosition(screenCenter);    // 画面中央
-		aimAssistCircleSprite_->SetAnchorPoint({0.5f, 0.5f}); // 中央基点
+	assets_->RequestTexture("reticle.png", reticleTextureHandle_, [this, screenCenter]() {
+		reticleSprite_ = KamataEngine::Sprite::Create(reticleTextureHandle_, {0, 0});
+		reticleSprite_->SetPosition(screenCenter);
+		reticleSprite_->SetAnchorPoint({0.5f, 0.5f});
+	});
 
-		// (例: スプライトを少し半透明にする)
-		aimAssistCircleSprite_->SetColor({1.0f, 1.0f, 1.0f, 0.5f});
-	}
+	assets_->RequestTexture("aimCircle.png", aimAssistCircleTextureHandle_, [this, screenCenter]() {
+		aimAssistCircleSprite_ = KamataEngine::Sprite::Create(aimAssistCircleTextureHandle_, {0, 0});
+		if (aimAssistCircleSprite_) {
+			// スプライトのサイズを「真円」に設定 (kAimAssistVisualRadius を使用)
+			float pixelDiameterY = WinApp::kWindowHeight * GameWorld::kAimAssistVisualRadius * 2.0f;
+			float pixelDiameterX = pixelDiameterY; // ピクセルで真円
+			aimAssistCircleSprite_->SetSize({pixelDiameterX, pixelDiameterY});
 
-	minimapTextureHandle_ = KamataEngine::TextureManager::Load("minimap.png");
-	greenBoxTextureHandle_ = KamataEngine::TextureManager::Load("greenBox.png");
-	minimapPlayerTextureHandle_ = KamataEngine::TextureManager::Load("player.png");
-	// ミニマップ上の敵弾アイコンは元の赤いテクスチャを使用（変更を取り消し）
-	minimapEnemyBulletTextureHandle_ = KamataEngine::TextureManager::Load("missileRedBox.png");
+			aimAssistCircleSprite_->SetPosition(screenCenter);    // 画面中央
+			aimAssistCircleSprite_->SetAnchorPoint({0.5f, 0.5f}); // 中央基点
+
+			// (例: スプライトを少し半透明にする)
+			aimAssistCircleSprite_->SetColor({1.0f, 1.0f, 1.0f, 0.5f});
+		}
+	});
+
+	// シーンクリア用アセット
+	assets_->RequestTexture("kuria.png", clearTextureHandle_, [this]() {
+		clearSprite_ = KamataEngine::Sprite::Create(clearTextureHandle_, {0, 0});
+		if (clearSprite_) {
+			// kuria.png を画面全体にかぶせる
+			clearSprite_->SetAnchorPoint({0.0f, 0.0f});
+			clearSprite_->SetPosition({0.0f, 0.0f});
+			clearSprite_->SetSize({(float)WinApp::kWindowWidth, (float)WinApp::kWindowHeight});
+		}
+	});
+
+	// コンフェッティ用スプライトテクスチャ
+	confettiParticles_.resize(kMaxConfetti_);
+	assets_->RequestTexture("confetti.png", confettiTextureHandle_, [this]() {
+		for (size_t i = 0; i < kMaxConfetti_; ++i) {
+			confettiParticles_[i].sprite = KamataEngine::Sprite::Create(confettiTextureHandle_, {0, 0});
+			if (confettiParticles_[i].sprite) {
+				confettiParticles_[i].sprite->SetSize({8.0f, 8.0f});
+				confettiParticles_[i].sprite->SetAnchorPoint({0.5f, 0.5f});
+				confettiParticles_[i].active = false;
+				// デフォルト色: 白
+				confettiParticles_[i].sprite->SetColor({1.0f, 1.0f, 1.0f, 1.0f});
+			}
+		}
+	});
 
 	// 1. ミニマップ背景
-	minimapSprite_ = KamataEngine::Sprite::Create(minimapTextureHandle_, {0, 0});
-	minimapSprite_->SetPosition(kMinimapPosition_);
-	minimapSprite_->SetAnchorPoint({0.0f, 1.0f}); // 左下をアンカーに
-	minimapSprite_->SetSize(kMinimapSize_);
+	assets_->RequestTexture("minimap.png", minimapTextureHandle_, [this]() {
+		minimapSprite_ = KamataEngine::Sprite::Create(minimapTextureHandle_, {0, 0});
+		minimapSprite_->SetPosition(GameWorld::kMinimapPosition);
+		minimapSprite_->SetAnchorPoint({0.0f, 1.0f}); // 左下をアンカーに
+		minimapSprite_->SetSize(GameWorld::kMinimapSize);
+	});
 
 	// 2. ミニマップ上の自機
-	minimapPlayerSprite_ = KamataEngine::Sprite::Create(minimapPlayerTextureHandle_, {0, 0});
-	minimapPlayerSprite_->SetAnchorPoint({0.5f, 0.5f}); // 中央をアンカーに
-	minimapPlayerSprite_->SetSize({10.0f, 10.0f});      // 仮サイズ
+	assets_->RequestTexture("player.png", minimapPlayerTextureHandle_, [this]() {
+		minimapPlayerSprite_ = KamataEngine::Sprite::Create(minimapPlayerTextureHandle_, {0, 0});
+		minimapPlayerSprite_->SetAnchorPoint({0.5f, 0.5f}); // 中央をアンカーに
+		minimapPlayerSprite_->SetSize({10.0f, 10.0f});      // 仮サイズ
+	});
 
 	// 3. ミニマップ上の敵 (あらかじめ最大数作成し、非表示にしておく)
-	minimapEnemySprites_.resize(kMaxMinimapEnemies_);
-	for (size_t i = 0; i < kMaxMinimapEnemies_; ++i) {
-		minimapEnemySprites_[i] = KamataEngine::Sprite::Create(greenBoxTextureHandle_, {0, 0});
-		minimapEnemySprites_[i]->SetAnchorPoint({0.5f, 0.5f});
-		minimapEnemySprites_[i]->SetSize({8.0f, 8.0f});           // 敵は少し小さく
-		minimapEnemySprites_[i]->SetPosition({-100.0f, -100.0f}); // 初期位置は画面外
-	}
+	assets_->RequestTexture("greenBox.png", greenBoxTextureHandle_, [this]() {
+		minimapEnemySprites_.resize(GameWorld::kMaxMinimapEnemies);
+		for (size_t i = 0; i < GameWorld::kMaxMinimapEnemies; ++i) {
+			minimapEnemySprites_[i] = KamataEngine::Sprite::Create(greenBoxTextureHandle_, {0, 0});
+			minimapEnemySprites_[i]->SetAnchorPoint({0.5f, 0.5f});
+			minimapEnemySprites_[i]->SetSize({8.0f, 8.0f});           // 敵は少し小さく
+			minimapEnemySprites_[i]->SetPosition({-100.0f, -100.0f}); // 初期位置は画面外
+		}
+	});
 
 	// 4. ミニマップ上の敵弾 (あらかじめ最大数作成し、非表示にしておく)
-	minimapEnemyBulletSprites_.resize(kMaxMinimapEnemyBullets_);
-	for (size_t i = 0; i < kMaxMinimapEnemyBullets_; ++i) {
-		minimapEnemyBulletSprites_[i] = KamataEngine::Sprite::Create(minimapEnemyBulletTextureHandle_, {0, 0});
-		minimapEnemyBulletSprites_[i]->SetAnchorPoint({0.5f, 0.5f});
-		minimapEnemyBulletSprites_[i]->SetSize({6.0f, 6.0f});
-		minimapEnemyBulletSprites_[i]->SetPosition({-100.0f, -100.0f});
-	}
+	// ミニマップ上の敵弾アイコンは元の赤いテクスチャを使用（変更を取り消し）
+	assets_->RequestTexture("missileRedBox.png", minimapEnemyBulletTextureHandle_, [this]() {
+		minimapEnemyBulletSprites_.resize(GameWorld::kMaxMinimapEnemyBullets);
+		for (size_t i = 0; i < GameWorld::kMaxMinimapEnemyBullets; ++i) {
+			minimapEnemyBulletSprites_[i] = KamataEngine::Sprite::Create(minimapEnemyBulletTextureHandle_, {0, 0});
+			minimapEnemyBulletSprites_[i]->SetAnchorPoint({0.5f, 0.5f});
+			minimapEnemyBulletSprites_[i]->SetSize({6.0f, 6.0f});
+			minimapEnemyBulletSprites_[i]->SetPosition({-100.0f, -100.0f});
+		}
+	});
 
 	// --- ビットマップフォントの初期化 ---
-    digitTextureHandles_.resize(10);
-    // Load textures for digits 1..9 by their names (as user stated), and try 0 if present
-    for (int i = 1; i <= 9; ++i) {
-        uint32_t h = 0;
-        std::string base = std::to_string(i);
-        // Try with common extensions first to avoid showing error dialogs from Load when called with bare name
-        h = KamataEngine::TextureManager::Load((base + ".png").c_str());
-        if (h == 0) h = KamataEngine::TextureManager::Load((base + ".PNG").c_str());
-        if (h == 0) h = KamataEngine::TextureManager::Load(base.c_str());
-        digitTextureHandles_[i] = h;
-    }
-    // Try to load '0' if available; otherwise leave 0 handle
-    {
-        uint32_t h0 = 0;
-        h0 = KamataEngine::TextureManager::Load("0.png");
-        if (h0 == 0) h0 = KamataEngine::TextureManager::Load("0.PNG");
-        if (h0 == 0) h0 = KamataEngine::TextureManager::Load("0");
-        digitTextureHandles_[0] = h0;
-    }
+	digitTextureHandles_.resize(10);
+	// Load textures for digits 1..9 by their names (as user stated), then '0' if present
+	for (int i : {1, 2, 3, 4, 5, 6, 7, 8, 9, 0}) {
+		std::string base = std::to_string(i);
+		assets_->RequestTexture(base + ".png", digitTextureHandles_[i], [this, i, base]() {
+			// Try with common extensions first to avoid showing error dialogs from Load when called with bare name
+			uint32_t& h = digitTextureHandles_[i];
+			if (h == 0) h = KamataEngine::TextureManager::Load(base + ".PNG");
+			if (h == 0) h = KamataEngine::TextureManager::Load(base);
+			// 数字が読めるたびに表示を作り直す (起動時の 10 回だけ)
+			UpdateScoreSprites();
+		});
+	}
 
 	// Create 4 digit sprites (thousands, hundreds, tens, ones)
 	scoreDigitSprites_.resize(4);
@@ -227,106 +228,248 @@ void GameScene::Initialize() {
 		}
 	}
 
-	// Ensure initial score display is updated (show 0000 if 0 texture exists)
-	UpdateScoreSprites();
+	// 右/左キー表示用スプライト
+	// テクスチャ名は Resources に配置した "light.png" と "left.png" を想定
+	// 位置は毎フレームの更新時に再計算されるため、ここではウィンドウサイズ依存の初期位置のみ設定
+	assets_->RequestTexture("light.png", lightTextureHandle_, [this]() {
+		lightSprite_ = KamataEngine::Sprite::Create(lightTextureHandle_, {0, 0});
+		if (lightSprite_) {
+			// グループオフセットを適用して右にずらす
+			float groupX = static_cast<float>(WinApp::kWindowWidth) - 2.0f * 80.0f + controlGroupOffset_;
+			lightSprite_->SetAnchorPoint({1.0f, 1.0f});
+			lightSprite_->SetSize({80.0f, 80.0f});
+			lightSprite_->SetPosition({groupX, (float)WinApp::kWindowHeight - 20.0f});
+			lightSprite_->SetColor({1.0f, 1.0f, 1.0f, 0.5f});
+		}
+	});
+	assets_->RequestTexture("left.png", leftTextureHandle_, [this]() {
+		leftSprite_ = KamataEngine::Sprite::Create(leftTextureHandle_, {0, 0});
+		if (leftSprite_) {
+			float groupX = static_cast<float>(WinApp::kWindowWidth) - 3.0f * 80.0f - 16.0f + controlGroupOffset_;
+			leftSprite_->SetAnchorPoint({1.0f, 1.0f});
+			leftSprite_->SetSize({80.0f, 80.0f});
+			leftSprite_->SetPosition({groupX, (float)WinApp::kWindowHeight - 20.0f});
+			leftSprite_->SetColor({1.0f, 1.0f, 1.0f, 0.5f});
+		}
+	});
+	assets_->RequestTexture("shift.png", shiftTextureHandle_, [this]() { // Shift画像
+		shiftSprite_ = KamataEngine::Sprite::Create(shiftTextureHandle_, {0, 0});
+		if (shiftSprite_) {
+			shiftSprite_->SetAnchorPoint({1.0f, 1.0f});
+			// 横長: 幅1.5倍, 高さは矢印基準サイズ
+			shiftSprite_->SetSize({80.0f * 1.5f, 80.0f});
+			// 初期配置: light の右側に少しずらして上に置く（グループオフセット適用）
+			float controlSizeInit = 80.0f;
+			float verticalGapInit = 8.0f;
+			float lightRightXInit = static_cast<float>(WinApp::kWindowWidth) - 2.0f * controlSizeInit + controlGroupOffset_;
+			float shiftRightXInit = lightRightXInit + controlSizeInit + shiftExtraRight_;
+			float shiftBottomYInit = static_cast<float>(WinApp::kWindowHeight) - 20.0f - controlSizeInit - verticalGapInit - shiftExtraUp_;
+			shiftSprite_->SetPosition({shiftRightXInit, shiftBottomYInit});
+			shiftSprite_->SetColor({1.0f, 1.0f, 1.0f, 0.5f});
+		}
+	});
 
-	camera_.Initialize();
+	KamataEngine::AxisIndicator::GetInstance()->SetVisible(true);
 
-	playerIntroTargetPosition_ = {0.0f, -3.0f, 20.0f};
-	playerIntroStartPosition_ = playerIntroTargetPosition_;
-	playerIntroStartPosition_.z += -50.0f;
+	// 乱数の種 (再生時は記録したときと同じ種から始める)
+	uint32_t seed = isReplaying_ ? recording_.GetSeed() : std::random_device{}();
+	if (isRecording_) {
+		recording_.Reset(seed);
+	}
+	confettiRandom_.Seed(seed, RandomStreamId::kConfetti);
 
-	player_->Initialize(modelPlayer_, &camera_, playerIntroStartPosition_);
-	// Initialize last player position for minimap rotation tracking
-	lastPlayerPos_ = player_->GetWorldPosition();
+	world_ = new GameWorld();
+	world_->Initialize("Resources/enemyPop.csv", seed);
+	world_->SetJobSystem(jobSystem_);
+	// シミュレーションは描画している間に jobSystem_ のスレッドで次のフレームを進める (ワーカーが無ければ Update の中で進める)
+	pipeline_ = new SnapshotPipeline<SimulationFrame>(jobSystem_, [this](SimulationFrame& frame) { SimulateFrame(frame); });
+	world_->BuildSnapshot(pipeline_->GetFront().snapshot);
 
-	skydome_->Initialize(modelSkydome_, &camera_);
-	worldTransformTitleObject_.Initialize();
-	worldTransformTitleObject_.translation_ = {0.0f, 0.0f, -43.0f};
-	worldTransformTitleObject_.UpdateMatrix();
+	clock_.Reset();
+	lastFrameTime_ = std::chrono::steady_clock::now();
 
-	KamataEngine::AxisIndicator::GetInstance()->SetVisible(true);
+	hitSoundHandle_ = audio_->LoadWave("./sound/parry.wav");
 
-	railCamera_ = new RailCamera();
-	railCamera_->Initialize(railcameraPos, railcameraRad);
-	cameraPositionAnchor_.Initialize();
-	player_->SetParent(&railCamera_->GetWorldTransform());
-	player_->SetRailCamera(railCamera_);
-	player_->SetEnemies(&enemies_);
+	// ワーカーが無ければ読み込みは終わっているので、最初のフレームの分だけ仕上げておく
+	assetLoader_->Finalize(kAssetFinalizeSeconds);
+}
 
-	LoadEnemyPopData();
-	hitSoundHandle_ = audio_->LoadWave("./sound/parry.wav");
+uint32_t GameScene::MakeSimKeyMask() const {
+	// DirectInput のキーコードとシミュレーション用キーの対応
+	struct KeyBinding {
+		BYTE dik;
+		SimKey key;
+	};
+	static const KeyBinding kBindings[] = {
+	    {DIK_W, SimKey::W},         {DIK_A, SimKey::A},       {DIK_S, SimKey::S},         {DIK_D, SimKey::D},           {DIK_R, SimKey::R},
+	    {DIK_LEFT, SimKey::Left},   {DIK_RIGHT, SimKey::Right}, {DIK_SPACE, SimKey::Space}, {DIK_LSHIFT, SimKey::LShift}, {DIK_RSHIFT, SimKey::RShift},
+	};
 
-	// ホーミング弾生成タイマー初期化
-	homingSpawnTimer_ = kHomingIntervalFrames_; // 最初のショットが間隔後に発生するようタイマー初期化
+	uint32_t mask = 0;
+	for (const KeyBinding& binding : kBindings) {
+		if (input_->PushKey(binding.dik)) {
+			mask |= SimInput::Bit(binding.key);
+		}
+	}
+	return mask;
+}
 
-	// ミニマップ用テクスチャ等の初期化を行った後に、右/左キー表示用スプライトを初期化
-	// テクスチャ名は Resources に配置した "light.png" と "left.png" を想定
-	lightTextureHandle_ = KamataEngine::TextureManager::Load("light.png");
-	leftTextureHandle_ = KamataEngine::TextureManager::Load("left.png");
-	shiftTextureHandle_ = KamataEngine::TextureManager::Load("shift.png"); // Shift画像
+void GameScene::ApplySnapshot(const WorldSnapshot& snapshot) {
+	PROFILE_ZONE("GameScene::ApplySnapshot");
+	// 効果音
+	if (snapshot.playerShot) {
+		audio_->playAudio(shotSound_, hitSoundHandle_, false, 0.5f);
+	}
+	for (int i = 0; i < snapshot.enemiesKilled; ++i) {
+		audio_->playAudio(hitSound_, hitSoundHandle_, false, 0.7f);
+	}
 
-	// スプライト生成
-	lightSprite_ = KamataEngine::Sprite::Create(lightTextureHandle_, {0, 0});
-	leftSprite_ = KamataEngine::Sprite::Create(leftTextureHandle_, {0, 0});
-	shiftSprite_ = KamataEngine::Sprite::Create(shiftTextureHandle_, {0, 0});
+	if (snapshot.score != score_) {
+		score_ = snapshot.score;
+		UpdateScoreSprites();
+	}
 
-	if (lightSprite_) {
-		// グループオフセットを適用して右にずらす
-		float groupX = static_cast<float>(WinApp::kWindowWidth) - 2.0f * 80.0f + controlGroupOffset_;
-		lightSprite_->SetAnchorPoint({1.0f, 1.0f});
-		lightSprite_->SetSize({80.0f, 80.0f});
-		lightSprite_->SetPosition({groupX, (float)WinApp::kWindowHeight - 20.0f});
-		lightSprite_->SetColor({1.0f, 1.0f, 1.0f, 0.5f});
+	// カメラはレールカメラの行列を使う
+	if (sceneState == SceneState::TransitionFromGame || sceneState == SceneState::GameIntro || sceneState == SceneState::Game || sceneState == SceneState::over) {
+		camera_.matView = snapshot.matView;
+		camera_.matProjection = snapshot.matProjection;
+		camera_.TransferMatrix();
 	}
-	if (leftSprite_) {
-		float groupX = static_cast<float>(WinApp::kWindowWidth) - 3.0f * 80.0f - 16.0f + controlGroupOffset_;
-		leftSprite_->SetAnchorPoint({1.0f, 1.0f});
-		leftSprite_->SetSize({80.0f, 80.0f});
-		leftSprite_->SetPosition({groupX, (float)WinApp::kWindowHeight - 20.0f});
-		leftSprite_->SetColor({1.0f, 1.0f, 1.0f, 0.5f});
+
+	// ミニマップ
+	PROFILE_ZONE("GameScene::Minimap");
+	if (minimapPlayerSprite_) {
+		// 1. 自機アイコンをミニマップ中央に設定
+		KamataEngine::Vector2 minimapCenterPos = {GameWorld::kMinimapPosition.x + GameWorld::kMinimapSize.x * 0.5f, GameWorld::kMinimapPosition.y - GameWorld::kMinimapSize.y * 0.5f};
+		minimapPlayerSprite_->SetPosition(minimapCenterPos);
+		minimapPlayerSprite_->SetRotation(snapshot.minimapPlayerRotation);
 	}
-	if (shiftSprite_) {
-		shiftSprite_->SetAnchorPoint({1.0f, 1.0f});
-		// 横長: 幅1.5倍, 高さは矢印基準サイズ
-		shiftSprite_->SetSize({80.0f * 1.5f, 80.0f});
-		// 初期配置: light の右側に少しずらして上に置く（グループオフセット適用）
-		float controlSizeInit = 80.0f;
-		float verticalGapInit = 8.0f;
-		float lightRightXInit = static_cast<float>(WinApp::kWindowWidth) - 2.0f * controlSizeInit + controlGroupOffset_;
-		float shiftRightXInit = lightRightXInit + controlSizeInit + shiftExtraRight_;
-		float shiftBottomYInit = static_cast<float>(WinApp::kWindowHeight) - 20.0f - controlSizeInit - verticalGapInit - shiftExtraUp_;
-		shiftSprite_->SetPosition({shiftRightXInit, shiftBottomYInit});
-		shiftSprite_->SetColor({1.0f, 1.0f, 1.0f, 0.5f});
+	// 2. 敵アイコン / 敵弾アイコンの位置、残りのスプライトは非表示（画面外へ）
+	const KamataEngine::Vector2 kHiddenPos = {-100.0f, -100.0f};
+	for (size_t i = 0; i < minimapEnemySprites_.size(); ++i) {
+		minimapEnemySprites_[i]->SetPosition(i < snapshot.minimapEnemies.size() ? snapshot.minimapEnemies[i] : kHiddenPos);
+	}
+	for (size_t i = 0; i < minimapEnemyBulletSprites_.size(); ++i) {
+		minimapEnemyBulletSprites_[i]->SetPosition(i < snapshot.minimapEnemyBullets.size() ? snapshot.minimapEnemyBullets[i] : kHiddenPos);
 	}
+}
 
-	// スプライトの初期位置を右下に設定（毎フレームの更新時に再計算されるため、ここではウィンドウサイズ依存の初期位置のみ設定）
-	if (lightSprite_) {
-		float groupX = static_cast<float>(WinApp::kWindowWidth) - 2.0f * 80.0f + controlGroupOffset_;
-		lightSprite_->SetPosition({groupX, (float)WinApp::kWindowHeight - 20.0f});
+void GameScene::SimulateFrame(SimulationFrame& frame) {
+	// ワーカースレッドで呼ばれる (ワールドと流れだけを触り、描画・音・スプライトには触れない)
+	PROFILE_ZONE("GameScene::SimulateFrame");
+	frame.stepStates.clear();
+	for (uint32_t keys : frame.stepKeys) {
+		frame.stepStates.push_back(flow_.GetState());
+		world_->GetInput().SetKeys(keys);
+		flow_.Step(*world_);
+	}
+	frame.state = flow_.GetState();
+	frame.transitionTimer = flow_.GetTransitionTimer();
+	world_->BuildSnapshot(frame.snapshot, frame.alpha);
+}
+
+void GameScene::PresentFrame(const SimulationFrame& frame) {
+	PROFILE_ZONE("GameScene::PresentFrame");
+	// ステップ単位の演出は、シミュレーションに渡した入力とそのステップの状態で進める
+	for (size_t i = 0; i < frame.stepKeys.size(); ++i) {
+		stepInput_.SetKeys(frame.stepKeys[i]);
+		UpdateStep(frame.stepStates[i]);
 	}
-	if (leftSprite_) {
-		float groupX = static_cast<float>(WinApp::kWindowWidth) - 3.0f * 80.0f - 16.0f + controlGroupOffset_;
-		leftSprite_->SetPosition({groupX, (float)WinApp::kWindowHeight - 20.0f});
+
+	if (frame.state != sceneState) {
+		ChangeSceneState(frame.state);
 	}
-	if (shiftSprite_) {
-		float controlSizeInit = 80.0f;
-		float verticalGapInit = 8.0f;
-		float lightRightXInit = static_cast<float>(WinApp::kWindowWidth) - 2.0f * controlSizeInit + controlGroupOffset_;
-		float shiftRightXInit = lightRightXInit + controlSizeInit + shiftExtraRight_;
-		float shiftBottomYInit = static_cast<float>(WinApp::kWindowHeight) - 20.0f - controlSizeInit - verticalGapInit - shiftExtraUp_;
-		shiftSprite_->SetPosition({shiftRightXInit, shiftBottomYInit});
+	transitionTimer_ = static_cast<float>(frame.transitionTimer);
+
+	// 暗転・明転の円の大きさ
+	if (sceneState == SceneState::TransitionToGame || sceneState == SceneState::TransitionFromGame) {
+		float maxScale = sqrtf(powf(WinApp::kWindowWidth, 2) + powf(WinApp::kWindowHeight, 2));
+		float progress = std::fmin(transitionTimer_ / static_cast<float>(GameFlow::kTransitionSteps), 1.0f);
+		float scale = 0.0f;
+		if (sceneState == SceneState::TransitionToGame) {
+			scale = (1.0f - cosf(progress * 3.14159265f / 2.0f)) * maxScale;
+		} else {
+			scale = (1.0f - sinf(progress * 3.14159265f / 2.0f)) * maxScale;
+		}
+		transitionSprite_->SetSize({scale, scale});
+	}
+
+	ApplySnapshot(frame.snapshot);
+}
+
+void GameScene::ChangeSceneState(SceneState state) {
+	if (state == SceneState::Start || state == SceneState::Clear) {
+		// タイトル・クリア画面はレールカメラを使わない
+		camera_.Initialize();
+		camera_.TransferMatrix();
+	} else if (state != SceneState::TransitionToGame) {
+		// 画面が暗転しきったので、まだ仕上がっていないアセットをここで待つ (ここからゲーム中のものを描く)
+		assetLoader_->FinalizeAll();
 	}
+	if (sceneState == SceneState::Clear) {
+		confettiActive_ = false;
+	}
+	sceneState = state;
 }
 
 void GameScene::Update() {
+	PROFILE_ZONE("GameScene::Update");
+	// 前のフレームからの実経過時間だけシミュレーションを進める
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	float elapsedSeconds = std::chrono::duration<float>(now - lastFrameTime_).count();
+	lastFrameTime_ = now;
+
+	// 裏で読み終わったアセットを少しずつ仕上げる
+	if (!assetLoader_->IsDone()) {
+		assetLoader_->Finalize(kAssetFinalizeSeconds);
+	}
+
+	// 前のフレームで頼んだシミュレーションの結果を受け取り、演出・音・カメラに反映する (このフレームはこれを描画する)
+	{
+		PROFILE_ZONE("GameScene::WaitSimulation");
+		pipeline_->Sync();
+	}
+	PresentFrame(pipeline_->GetFront());
+
+	// 次のフレームの入力を決めて、描画している間に裏でシミュレーションを進める
+	uint32_t keyMask = MakeSimKeyMask();
+	latchedKeyMask_ |= keyMask;
+
+	SimulationFrame& next = pipeline_->GetBack();
+	next.stepKeys.clear();
+	int steps = clock_.Advance(elapsedSeconds);
+	for (int i = 0; i < steps; ++i) {
+		uint32_t stepMask = latchedKeyMask_;
+		if (isReplaying_) {
+			if (replayer_.HasNext()) {
+				stepMask = replayer_.Next();
+			} else {
+				// 最後まで再生したらキーボード入力に戻す
+				isReplaying_ = false;
+			}
+		}
+		if (isRecording_) {
+			recording_.Append(stepMask);
+		}
+		next.stepKeys.push_back(stepMask);
+		latchedKeyMask_ = keyMask;
+	}
+
+	// 最後のステップから経過した分だけ補間して描画する
+	next.alpha = clock_.GetAlpha();
+	pipeline_->Kick();
+}
 
+void GameScene::UpdateStep(SceneState state) {
+	PROFILE_ZONE("GameScene::UpdateStep");
 	skydome_->Update();
 
 	// 右／左キーの押下状態に応じてスプライトの明るさを切替
-	if (input_) {
-		bool rightPressed = input_->PushKey(DIK_RIGHT);
-		bool leftPressed = input_->PushKey(DIK_LEFT);
+	// 再生中も表示が合うように、シミュレーションに渡した入力を見る
+	const SimInput& simInput = stepInput_;
+	{
+		bool rightPressed = simInput.PushKey(SimKey::Right);
+		bool leftPressed = simInput.PushKey(SimKey::Left);
 
 		if (lightSprite_) {
 			if (rightPressed) {
@@ -385,10 +528,10 @@ void GameScene::Update() {
 	}
 
 	// Shift の表示（Shift 押下時は点滅）
-	if (shiftSprite_ && input_) {
-		bool shiftPressed = input_->PushKey(DIK_RSHIFT) || input_->PushKey(DIK_LSHIFT);
-		bool aPressed = input_->PushKey(DIK_A);
-		bool dPressed = input_->PushKey(DIK_D);
+	if (shiftSprite_) {
+		bool shiftPressed = simInput.PushKey(SimKey::RShift) || simInput.PushKey(SimKey::LShift);
+		bool aPressed = simInput.PushKey(SimKey::A);
+		bool dPressed = simInput.PushKey(SimKey::D);
 		if (shiftPressed && (aPressed || dPressed)) {
 			shiftBlinkTimer_++;
 			const int blinkPeriod = 8;
@@ -401,13 +544,9 @@ void GameScene::Update() {
 		}
 	}
 
-	switch (sceneState) {
+	// 画面の流れ (状態の切り替え) は GameFlow が決める。ここではそのステップの状態に合わせた演出だけを進める
+	switch (state) {
 	case SceneState::Start: {
-		if (input_->TriggerKey(DIK_SPACE)) {
-			sceneState = SceneState::TransitionToGame;
-			transitionTimer_ = 0.0f;
-			gameSceneTimer_ = 0;
-		}
 		titleAnimationTimer_++;
 		const int32_t cycleFrames = kTitleRotateFrames + kTitlePauseFrames;
 		int32_t timeInCycle = titleAnimationTimer_ % cycleFrames;
@@ -421,329 +560,6 @@ void GameScene::Update() {
 		worldTransformTitleObject_.UpdateMatrix();
 		break;
 	}
-	case SceneState::TransitionToGame: {
-		transitionTimer_++;
-		float maxScale = sqrtf(powf(WinApp::kWindowWidth, 2) + powf(WinApp::kWindowHeight, 2));
-		float progress = std::fmin(transitionTimer_ / kTransitionTime, 1.0f);
-		float easedProgress = 1.0f - cosf(progress * 3.14159265f / 2.0f);
-		float scale = easedProgress * maxScale;
-		transitionSprite_->SetSize({scale, scale});
-		if (transitionTimer_ >= kTransitionTime) {
-			sceneState = SceneState::TransitionFromGame;
-			transitionTimer_ = 0.0f;
-		}
-		break;
-	}
-	case SceneState::TransitionFromGame: {
-		transitionTimer_++;
-		float maxScale = sqrtf(powf(WinApp::kWindowWidth, 2) + powf(WinApp::kWindowHeight, 2));
-		float progress = std::fmin(transitionTimer_ / kTransitionTime, 1.0f);
-		float easedProgress = sinf(progress * 3.14159265f / 2.0f);
-		float scale = (1.0f - easedProgress) * maxScale;
-		transitionSprite_->SetSize({scale, scale});
-
-		if (transitionTimer_ >= kTransitionTime) {
-			sceneState = SceneState::GameIntro;
-			gameIntroTimer_ = 0.0f;
-			player_->GetWorldTransform().translation_ = playerIntroStartPosition_;
-			player_->GetWorldTransform().UpdateMatrix();
-			isGameIntroFinished_ = false;
-			UpdateEnemyPopCommands();
-		}
-
-		if (railCamera_) {
-			railCamera_->Update();
-			// アンカー更新
-			cameraPositionAnchor_.translation_ = railCamera_->GetWorldTransform().translation_;
-			cameraPositionAnchor_.UpdateMatrix();
-		}
-		if (player_)
-			player_->GetWorldTransform().UpdateMatrix();
-		camera_.matView = railCamera_->GetViewProjection().matView;
-		camera_.matProjection = railCamera_->GetViewProjection().matProjection;
-		camera_.TransferMatrix();
-		break;
-	}
-	case SceneState::GameIntro: {
-		gameIntroTimer_++;
-
-		float t = gameIntroTimer_ / kGameIntroDuration_;
-		t = 1.0f - std::pow(1.0f - t, 3.0f);
-		t = std::clamp(t, 0.0f, 1.0f);
-
-		player_->GetWorldTransform().translation_ = Lerp(playerIntroStartPosition_, playerIntroTargetPosition_, t);
-		player_->GetWorldTransform().UpdateMatrix();
-
-		UpdateAimAssist();
-		railCamera_->Update();
-
-		if (explosionEmitter_) {
-			explosionEmitter_->Update();
-		}
-
-		// アンカー更新
-		cameraPositionAnchor_.translation_ = railCamera_->GetWorldTransform().translation_;
-		cameraPositionAnchor_.UpdateMatrix();
-		camera_.matView = railCamera_->GetViewProjection().matView;
-		camera_.matProjection = railCamera_->GetViewProjection().matProjection;
-		camera_.TransferMatrix();
-
-		const float kArrivalThreshold = 0.1f;
-		if (gameIntroTimer_ >= kGameIntroDuration_ || Distance(player_->GetWorldTransform().translation_, playerIntroTargetPosition_) < kArrivalThreshold) {
-			player_->GetWorldTransform().translation_ = playerIntroTargetPosition_;
-			player_->GetWorldTransform().UpdateMatrix();
-			sceneState = SceneState::Game;
-			isGameIntroFinished_ = true;
-			gameSceneTimer_ = 0;
-
-			// Gameが始まってから移動するようにする
-			if (railCamera_) {
-				railCamera_->SetCanMove(true);
-			}
-
-			// デバッグ10秒タイマーをリセット（ゲーム開始時にカウント開始）
-			// これにより、ゲーム開始から kDebug10Seconds 秒後に自動でタイトルへ戻る
-			debug10ElapsedSec_ = 0.0f;
-		}
-		break;
-	}
-	case SceneState::Game: {
-
-		// デバッグ: ゲーム開始から10秒でタイトルへ戻す処理
-		// 有効な場合、毎フレーム（60FPS 想定で）経過秒数を加算し、指定秒数経過後にタイトルへ遷移する
-		if (debug10 && isGameIntroFinished_) {
-			const float kDeltaSec = 1.0f / 60.0f; // フレーム毎の秒換算（概算）
-			debug10ElapsedSec_ += kDeltaSec;
-			if (debug10ElapsedSec_ >= kDebug10Seconds) {
-				// 10秒経過したのでタイトルへ戻す（リセット処理）
-				sceneState = SceneState::Start;
-				debug10ElapsedSec_ = 0.0f;
-				
-				camera_.Initialize();
-				camera_.TransferMatrix();
-				if (railCamera_) {
-					railCamera_->Reset();
-				}
-				if (player_) {
-					player_->ResetRotation();
-					player_->GetWorldTransform().translation_ = playerIntroStartPosition_;
-					player_->GetWorldTransform().UpdateMatrix();
-					player_->ResetParticles();
-					player_->ResetBullets();
-				}
-				
-				for (Enemy* enemy : enemies_) {
-					delete enemy;
-				}
-				enemies_.clear();
-				for (EnemyBullet* bullet : enemyBullets_) {
-					delete bullet;
-				}
-				enemyBullets_.clear();
-				
-				for (Meteorite* meteor : meteorites_) {
-					delete meteor;
-				}
-				meteorites_.clear();
-				meteoriteSpawnTimer_ = 0;
-				
-				LoadEnemyPopData();
-				hasSpawnedEnemies_ = false;
-				
-				// 処理を終えてこのフレームの残りの Game 処理をスキップ
-				break;
-			}
-		}
-
-		// --- 自動ゲームオーバー(25秒) / タイマー更新 ---
-		if (isGameIntroFinished_) {
-			const float kDeltaSecGame = 1.0f / 60.0f; // 60FPS 想定
-			gameSceneTimer_ += kDeltaSecGame;
-			const float kAutoGameOverSeconds = 40.0f; // 25秒でゲームオーバー
-			if (gameSceneTimer_ >= kAutoGameOverSeconds) {
-				// 時間切れ -> ゲームオーバー
-				TransitionToClearScene2();
-				break;
-			}
-		}
-
-		// --- デバッグ
-		//gameSceneTimer_++;
-		// --- デバッグ用: 1秒でクリア (60フレーム) ---
-		// removed old frame-based debug clear
-
-		// --- 通常のゲーム処理 ---
-		railCamera_->Update();
-		cameraPositionAnchor_.translation_ = railCamera_->GetWorldTransform().translation_;
-		cameraPositionAnchor_.UpdateMatrix();
-		camera_.matView = railCamera_->GetViewProjection().matView;
-		camera_.matProjection = railCamera_->GetViewProjection().matProjection;
-		camera_.TransferMatrix();
-
-		UpdateAimAssist();
-
-		if (explosionEmitter_) {
-			explosionEmitter_->Update();
-		}
-
-		if (isGameIntroFinished_) {
-			const int kSpawnsPerFrame = 1;
-			meteoriteSpawnTimer_--;
-			if (meteoriteSpawnTimer_ <= 0) {
-				for (int i = 0; i < kSpawnsPerFrame; ++i) {
-					 SpawnMeteorite();
-				}
-				// 隕石の数
-				meteoriteSpawnTimer_ = 1;
-			}
-
-			// Playerを先に更新して、最新の位置を取得できるようにする
-			player_->Update();
-
-			// 回避処理（Player更新後に実行）>
-			player_->EvadeBullets(enemyBullets_);
-
-			for (Enemy* enemy : enemies_) {
-				enemy->Update();
-			}
-
-			
-			for (Meteorite* meteor : meteorites_) {
-				if (meteor) {
-					// Playerの位置を渡して更新（近づくと大きくなる処理のため）>
-					meteor->Update(player_->GetWorldPosition());
-				}
-			}
-			
-
-			// 弾の更新（Player更新後なので、最新のPlayer位置を追尾できる）>
-			for (EnemyBullet* bullet : enemyBullets_) {
-				bullet->Update();
-			}
-
-			if (homingSpawnTimer_ > 0) {
-				homingSpawnTimer_--;
-			} else {
-				Enemy* shooter = nullptr;
-				KamataEngine::Vector3 playerPosForHoming = player_->GetWorldPosition();
-				float maxDistSq = kHomingMaxDistance_ * kHomingMaxDistance_;
-				// この距離にPlayerが近づくとEnemyが弾を撃たなくなります
-				const float kMinHomingDistance = 1000.0f;
-				float minDistSq = kMinHomingDistance * kMinHomingDistance;
-				for (Enemy* enemy : enemies_) {
-					if (!enemy || enemy->IsDead())
-						continue;
-					KamataEngine::Vector3 epos = enemy->GetWorldPosition();
-					float dx = epos.x - playerPosForHoming.x;
-					float dy = epos.y - playerPosForHoming.y;
-					float dz = epos.z - playerPosForHoming.z;
-					float distSq = dx * dx + dy * dy + dz * dz;
-					if (distSq <= maxDistSq && distSq > minDistSq) {
-						shooter = enemy;
-						break;
-					}
-				}
-
-				if (shooter) {
-
-					KamataEngine::Vector3 moveBullet = shooter->GetWorldPosition();
-					KamataEngine::Vector3 playerPos = player_->GetWorldPosition();
-					KamataEngine::Vector3 toPlayer = playerPos - moveBullet;
-					float len = std::sqrt(toPlayer.x * toPlayer.x + toPlayer.y * toPlayer.y + toPlayer.z * toPlayer.z);
-					if (len > 0.001f) {
-						toPlayer.x /= len;
-						toPlayer.y /= len;
-						toPlayer.z /= len;
-					}
-					KamataEngine::Vector3 vel = {toPlayer.x * kHomingBulletSpeed_, toPlayer.y * kHomingBulletSpeed_, toPlayer.z * kHomingBulletSpeed_};
-
-					EnemyBullet* newBullet = new EnemyBullet();
-					//newBullet->Initialize(modelEnemy_, moveBullet, vel); // 生成時に enemy 弾モデルを渡す
-					newBullet->Initialize(modelEnemyBullet_, moveBullet, vel); // 敵弾用モデルで初期化
-					newBullet->SetHomingEnabled(true);
-					newBullet->SetHomingTarget(player_);
-					newBullet->SetSpeed(kHomingBulletSpeed_);
-					AddEnemyBullet(newBullet);
-
-					// reset timer
-					homingSpawnTimer_ = kHomingIntervalFrames_;
-				}
-			}
-
-			enemyBullets_.remove_if([](EnemyBullet* bullet) {
-				if (bullet && bullet->IsDead()) {
-					delete bullet;
-					return true;
-				}
-				return false;
-			});
-			CheckAllCollisions();
-
-			if (player_ && minimapPlayerSprite_) { // player_ が null でないか確認
-				KamataEngine::Vector3 playerPos = player_->GetWorldPosition();
-
-				// 1. 自機アイコンをミニマップ中央に設定
-				KamataEngine::Vector2 minimapCenterPos = {kMinimapPosition_.x + kMinimapSize_.x * 0.5f, kMinimapPosition_.y - kMinimapSize_.y * 0.5f};
-				minimapPlayerSprite_->SetPosition(minimapCenterPos);
-
-				// Rotate the player minimap sprite to match movement direction on XZ plane.
-				// Convert player movement (world X,Z) to minimap axes: mx = dx, my = -dz (minimap Y is -world Z).
-				float dx = playerPos.x - lastPlayerPos_.x;
-				float dz = playerPos.z - lastPlayerPos_.z;
-				const float kMoveThresholdSq = 0.0001f; // squared threshold to ignore tiny jitter
-				float moveDistSq = dx * dx + dz * dz;
-				if (moveDistSq > kMoveThresholdSq) {
-					float mx = dx;
-					float my = -dz;
-					float angle = std::atan2(my, mx);
-					// Sprite's default up direction -> adjust by +90 degrees (pi/2)
-					const float kPI = 3.14159265f;
-					minimapPlayerSprite_->SetRotation(angle + kPI / 2.0f);
-					lastPlayerPos_ = playerPos;
-				}
-
-				// この処理はミニマップにＥｎｅｍｙを移すために絶対に必要だから消しちゃダメ
-				//  2. 敵アイコンの位置を更新
-				size_t activeEnemyCount = 0;
-				// 敵リスト (enemies_) を走査
-				for (Enemy* enemy : enemies_) {
-					// 生きていて、スプライトの最大数を超えていない場合
-					if (enemy && !enemy->IsDead() && activeEnemyCount < kMaxMinimapEnemies_) {
-						KamataEngine::Vector3 enemyPos = enemy->GetWorldPosition(); //
-						KamataEngine::Vector2 minimapPos = ConvertWorldToMinimap(enemyPos, playerPos);
-						minimapEnemySprites_[activeEnemyCount]->SetPosition(minimapPos);
-						activeEnemyCount++;
-					}
-				}
-
-				// 3. 敵弾アイコンの更新
-				size_t activeBulletCount = 0;
-				for (EnemyBullet* eb : enemyBullets_) {
-					if (!eb || eb->IsDead()) continue;
-					if (activeBulletCount >= kMaxMinimapEnemyBullets_) break;
-					KamataEngine::Vector3 bpos = eb->GetWorldPosition();
-					KamataEngine::Vector2 bmin = ConvertWorldToMinimap(bpos, playerPos);
-					minimapEnemyBulletSprites_[activeBulletCount]->SetPosition(bmin);
-					activeBulletCount++;
-				}
-
-				// 4. 残りのスプライトを非表示（画面外へ）
-				for (size_t i = activeEnemyCount; i < kMaxMinimapEnemies_; ++i) {
-					minimapEnemySprites_[i]->SetPosition({-100.0f, -100.0f});
-				}
-				for (size_t i = activeBulletCount; i < kMaxMinimapEnemyBullets_; ++i) {
-					minimapEnemyBulletSprites_[i]->SetPosition({-100.0f, -100.0f});
-				}
-			}
-
-		} else { // イントロ中
-			if (player_) {
-				player_->GetWorldTransform().UpdateMatrix();
-			}
-		}
-
-		break;
-	}
 	case SceneState::Clear:
 		// ensure skydome drawn etc handled in Draw
 		// Start confetti when entering Clear
@@ -755,6 +571,7 @@ void GameScene::Update() {
 
 		// spawn sprite confetti from top of screen
 		if (confettiActive_) {
+			PROFILE_ZONE("GameScene::ConfettiSpawn");
 			confettiSpawnTimer_++;
 			if (confettiSpawnTimer_ >= 3) {
 				confettiSpawnTimer_ = 0;
@@ -763,19 +580,19 @@ void GameScene::Update() {
 					for (auto& c : confettiParticles_) {
 						if (!c.active && c.sprite) {
 							// place at very top across full screen width
-							float x = static_cast<float>(std::rand()) / RAND_MAX * (float)WinApp::kWindowWidth;
+							float x = confettiRandom_.NextFloat() * (float)WinApp::kWindowWidth;
 							float y = -20.0f; // slightly above the top
 							c.pos = {x, y};
-							c.vel = {(static_cast<float>(std::rand()) / RAND_MAX - 0.5f) * 1.5f, 1.5f + static_cast<float>(std::rand()) / RAND_MAX * 2.0f};
-							c.rotation = (static_cast<float>(std::rand()) / RAND_MAX) * 6.28f;
-							c.rotVel = (static_cast<float>(std::rand()) / RAND_MAX - 0.5f) * 0.2f;
-							c.life = 120 + (MT::GetRand() % 120);
+							c.vel = {(confettiRandom_.NextFloat() - 0.5f) * 1.5f, 1.5f + confettiRandom_.NextFloat() * 2.0f};
+							c.rotation = confettiRandom_.NextFloat() * 6.28f;
+							c.rotVel = (confettiRandom_.NextFloat() - 0.5f) * 0.2f;
+							c.life = confettiRandom_.RangeInt(120, 239);
 							c.age = 0;
 							c.active = true;
 							// random bright color
 							float r, g, b;
-							int pattern = std::rand() % 6;                                  // 6パターン
-							float randomValue = static_cast<float>(std::rand()) / RAND_MAX; // 0.0f ～ 1.0f
+							int pattern = confettiRandom_.RangeInt(0, 5);   // 6パターン
+							float randomValue = confettiRandom_.NextFloat(); // 0.0f ～ 1.0f
 
 							switch (pattern) {
 							case 0:
@@ -820,136 +637,60 @@ void GameScene::Update() {
 		}
 
 		// update confetti particles
-		for (auto& c : confettiParticles_) {
-			if (!c.active || !c.sprite)
-				continue;
-			c.age++;
-			c.pos.x += c.vel.x;
-			c.pos.y += c.vel.y;
-			c.vel.y += 0.02f; // gravity
-			c.rotation += c.rotVel;
-			c.sprite->SetPosition(c.pos);
-			c.sprite->SetRotation(c.rotation);
-			// fade out near end
-			if (c.age > c.life) {
-				c.active = false;
-				c.sprite->SetPosition({-100.0f, -100.0f});
+		{
+			PROFILE_ZONE("GameScene::ConfettiUpdate");
+			for (auto& c : confettiParticles_) {
+				if (!c.active || !c.sprite)
+					continue;
+				c.age++;
+				c.pos.x += c.vel.x;
+				c.pos.y += c.vel.y;
+				c.vel.y += 0.02f; // gravity
+				c.rotation += c.rotVel;
+				c.sprite->SetPosition(c.pos);
+				c.sprite->SetRotation(c.rotation);
+				// fade out near end
+				if (c.age > c.life) {
+					c.active = false;
+					c.sprite->SetPosition({-100.0f, -100.0f});
+				}
 			}
 		}
-
-		// allow return to title
-		if (input_->TriggerKey(DIK_SPACE)) {
-			confettiActive_ = false;
-			sceneState = SceneState::Start;
-			// reset as before...
-			// ...existing reset code omitted for brevity...
-		}
+		// タイトルへ戻るのは GameFlow が決める (紙吹雪は ChangeSceneState で止める)
 		break;
 
-	case SceneState::over:
-		gameOverTimer_++;
-
-		if (player_) {
-			player_->UpdateGameOver(gameOverTimer_);
-		}
-
-		if (railCamera_) {
-			cameraPositionAnchor_.translation_ = railCamera_->GetWorldTransform().translation_;
-			cameraPositionAnchor_.UpdateMatrix();
-
-			camera_.matView = railCamera_->GetViewProjection().matView;
-			camera_.matProjection = railCamera_->GetViewProjection().matProjection;
-			camera_.TransferMatrix();
-		}
-
-		// --- リセット処理 ---
-		if (input_->TriggerKey(DIK_SPACE) || gameOverTimer_ >= 90) {
-			sceneState = SceneState::Start;
-			gameOverTimer_ = 0;
-
-			camera_.Initialize();
-			camera_.TransferMatrix();
-
-			if (railCamera_) {
-				railCamera_->Reset();
-			}
-
-			if (player_) {
-				player_->ResetRotation();
-				player_->GetWorldTransform().translation_ = playerIntroStartPosition_;
-				player_->GetWorldTransform().UpdateMatrix();
-				player_->ResetParticles();
-				player_->ResetBullets();
-			}
-
-			for (Enemy* enemy : enemies_) {
-				delete enemy;
-			}
-			enemies_.clear();
-			for (EnemyBullet* bullet : enemyBullets_) {
-				delete bullet;
-			}
-			enemyBullets_.clear();
-			for (Meteorite* meteor : meteorites_) {
-				delete meteor;
-			}
-			meteorites_.clear();
-			meteoriteSpawnTimer_ = 0;
-
-			LoadEnemyPopData();
-			hasSpawnedEnemies_ = false;
-		}
+	default:
 		break;
 	}
-
-	// Deferred scene clear: perform transition at a safe point after game update
-	if (requestSceneClear_ && sceneState == SceneState::Game) {
-		requestSceneClear_ = false;
-		TransitionToClearScene();
-	}
 }
 
 void GameScene::Draw() {
+	PROFILE_ZONE("GameScene::Draw");
 	ID3D12GraphicsCommandList* commandList = dxCommon_->GetCommandList();
 
 	dxCommon_->ClearDepthBuffer();
 
+	// 描画は表のフレームだけを読む (裏では次のフレームのシミュレーションが進んでいる)
+	const WorldSnapshot& snapshot = pipeline_->GetFront().snapshot;
+
 	KamataEngine::Model::PreDraw(commandList);
 
 	if (sceneState == SceneState::Start || sceneState == SceneState::TransitionToGame) {
 		modelTitleObject_->Draw(worldTransformTitleObject_, camera_);
 	} else if (sceneState == SceneState::GameIntro || sceneState == SceneState::Game || sceneState == SceneState::TransitionFromGame || sceneState == SceneState::over) {
 
-		player_->Draw();
+		worldRenderer_->BuildInstances(snapshot);
+		worldRenderer_->DrawInstances(DrawLayer::Player, camera_);
 		skydome_->Draw();
 
-		if (explosionEmitter_) {
-			explosionEmitter_->Draw(camera_);
-		}
-
-		if ((sceneState == SceneState::Game && isGameIntroFinished_) || sceneState == SceneState::over) {
-			for (Enemy* enemy : enemies_) {
-				if (enemy)
-					enemy->Draw(camera_);
-			}
-			for (EnemyBullet* bullet : enemyBullets_) {
-				if (bullet)
-					bullet->Draw(camera_);
-			}
+		worldRenderer_->DrawInstances(DrawLayer::Explosion, camera_);
 
-			for (Meteorite* meteor : meteorites_) {
-				if (meteor) {
-					meteor->Draw(camera_);
-				}
-			}
+		if (sceneState == SceneState::Game || sceneState == SceneState::over) {
+			worldRenderer_->DrawInstances(DrawLayer::Enemy, camera_);
 		}
 	} else if (sceneState == SceneState::Clear) {
 		// draw skydome so background exists
 		skydome_->Draw();
-		// draw any particles for clear
-		if (clearEmitter_) {
-			clearEmitter_->Draw(camera_);
-		}
 	}
 
 	KamataEngine::Model::PostDraw();
@@ -974,17 +715,13 @@ void GameScene::Draw() {
 			aimAssistCircleSprite_->Draw();
 		}
 
-		if (sceneState == SceneState::Game && isGameIntroFinished_) {
-			for (Enemy* enemy : enemies_) {
-				if (enemy) {
-					enemy->DrawSprite();
-				}
-			}
+		if (sceneState == SceneState::Game) {
+			worldRenderer_->DrawEnemySprites(snapshot);
 		}
 	}
 
 	// ミニマップと矢印キー表示はゲームシーンのみ表示
-	if (sceneState == SceneState::Game && isGameIntroFinished_) {
+	if (sceneState == SceneState::Game) {
 		if (minimapSprite_) {
 			minimapSprite_->Draw(); // 背景
 		}
@@ -1036,507 +773,6 @@ void GameScene::Draw() {
 	KamataEngine::Sprite::PostDraw();
 }
 
-void GameScene::AddEnemyBullet(EnemyBullet* bullet) {
-	if (bullet)
-		enemyBullets_.push_back(bullet);
-}
-
-void GameScene::EnemySpawn(const Vector3& position) {
-	Enemy* newEnemy = new Enemy();
-
-	assert(railCamera_ && "EnemySpawn: railCamera_ が null です");
-	KamataEngine::Vector3 playerPos = railCamera_->GetWorldTransform().translation_;
-
-	KamataEngine::Vector3 spawnPosWorld;
-	spawnPosWorld.x = playerPos.x + position.x;
-	spawnPosWorld.y = playerPos.y + position.y;
-	spawnPosWorld.z = playerPos.z + position.z;
-
-	newEnemy->SetPlayer(player_);
-	newEnemy->SetGameScene(this);
-	newEnemy->SetCamera(&camera_);
-
-	newEnemy->Initialize(modelEnemy_, spawnPosWorld);
-
-	enemies_.push_back(newEnemy);
-}
-
-void GameScene::LoadEnemyPopData() {
-	enemyPopCommands.str("");
-	enemyPopCommands.clear();
-
-	std::ifstream file;
-	file.open("Resources/enemyPop.csv");
-	assert(file.is_open());
-	enemyPopCommands << file.rdbuf();
-	file.close();
-
-	hasSpawnedEnemies_ = false;
-}
-
-void GameScene::UpdateEnemyPopCommands() {
-	if (hasSpawnedEnemies_) {
-		return;
-	}
-
-	std::string line;
-	while (getline(enemyPopCommands, line)) {
-		std::istringstream line_stream(line);
-		std::string word;
-		getline(line_stream, word, ',');
-
-		if (word.find("//") == 0) {
-			continue;
-		}
-
-		if (word.find("POP") == 0) {
-			getline(line_stream, word, ',');
-			float x = (float)std::atof(word.c_str());
-			getline(line_stream, word, ',');
-			float y = (float)std::atof(word.c_str());
-			getline(line_stream, word, ',');
-			float z = (float)std::atof(word.c_str());
-			EnemySpawn(Vector3(x, y, z));
-		} else if (word.find("WAIT") == 0) {
-			continue;
-		}
-	}
-
-	hasSpawnedEnemies_ = true;
-	enemyPopCommands.str("");
-	enemyPopCommands.clear();
-}
-
-void GameScene::CheckAllCollisions() {
-	if (!player_)
-		return;
-
-	if (sceneState == SceneState::over || sceneState == SceneState::GameIntro) {
-		return;
-	}
-
-	KamataEngine::Vector3 posA[3]{}, posB[3]{};
-	float radiusA[3] = {0.8f, 2.0f, 0.8f};
-	float radiusB[3] = {0.8f, 2.0f, 10.8f};
-	const std::list<PlayerBullet*>& playerBullets = player_->GetBullets();
-
-	// --- 自キャラ vs 敵弾 (HP制に) ---
-	posA[0] = player_->GetWorldPosition();
-	
-	// 回避中は無敵時間として、当たり判定を無効にする
-	bool isPlayerRolling = player_->IsRolling();
-	
-	for (EnemyBullet* bullet : enemyBullets_) {
-		if (!bullet || bullet->IsDead())
-			continue;
-
-		
-		// 回避中は当たり判定を無効にする
-		if (isPlayerRolling) {
-			continue;
-		}
-		
-		// ホーミングを失った弾（回避された弾）は当たり判定を無効にする
-		if (!bullet->IsHoming() && bullet->GetEvadedDeathTimer() >= 0) {
-			continue; // 回避された弾は当たり判定を無効
-		}
-		
-		posB[0] = bullet->GetWorldPosition();
-		float distanceSquared = DistanceSquared(posA[0], posB[0]);
-		float combinedRadiusSquared = (radiusA[0] + radiusB[0]) * (radiusA[0] + radiusB[0]);
-		if (distanceSquared <= combinedRadiusSquared) {
-
-			// Decrease HP and mark bullet dead. Only transition to game-over if player actually died.
-			player_->OnCollision();
-			bullet->OnCollision();
-
-			if (player_->IsDead()) {
-				TransitionToClearScene2();
-				return;
-			}
-			// Otherwise, continue checking other collisions (player lost a HP but still alive)
-		}
-	}
-
-	/*
-	// 自キャラ vs 隕石 の判定
-	posA[0] = player_->GetWorldPosition(); // プレイヤー位置
-	float playerRadius = radiusA[0];       // プレイヤー半径
-
-	for (Meteorite* meteor : meteorites_) {
-	    if (!meteor || meteor->IsDead())
-	        continue;
-
-	    posB[0] = meteor->GetWorldPosition();
-	    float meteoriteRadius = meteor->GetRadius();
-	    float distanceSquared = DistanceSquared(posA[0], posB[0]);
-	    float combinedRadiusSquared = (playerRadius + meteoriteRadius) * (playerRadius + meteoriteRadius);
-
-	    if (distanceSquared <= combinedRadiusSquared) {
-	        player_->OnCollision();
-	        meteor->OnCollision();
-
-	        if (player_->IsDead()) {
-	            TransitionToClearScene2();
-	            return;
-	        }
-	    }
-	}
-	*/
-
-	// 自弾 vs 敵キャラ
-	// 変更: 画面外の敵は多くの処理で不要なのでスキップして負荷を下げる
-	for (Enemy* enemy : enemies_) {
-		if (!enemy || enemy->IsDead())
-			continue;
-		// 画面外の敵は衝突判定やエイムアシスト用の行列演算を行わない
-		// (Collision should be checked regardless of on-screen state)
-		// if (!enemy->IsOnScreen())
-		// 	continue;
-		posA[1] = enemy->GetWorldPosition();
-		for (PlayerBullet* bullet : playerBullets) {
-			if (!bullet || bullet->IsDead())
-				continue;
-			posB[1] = bullet->GetWorldPosition();
-			float distanceSquared = DistanceSquared(posA[1], posB[1]);
-			float combinedRadiusSquared = (radiusA[2] + radiusB[2]) * (radiusA[2] + radiusB[2]);
-			if (distanceSquared <= combinedRadiusSquared) {
-				enemy->OnCollision();
-				bullet->OnCollision();
-
-				if (enemy->IsDead()) {
-					hitCount++;
-					audio_->playAudio(hitSound_, hitSoundHandle_, false, 0.7f);
-				}
-			}
-		}
-	}
-
-	enemies_.remove_if([](Enemy* enemy) {
-		if (enemy && enemy->IsDead()) {
-			delete enemy;
-			return true;
-		}
-		return false;
-	});
-}
-
-void GameScene::TransitionToClearScene() {
-	// Change: go to Clear scene so player sees clear screen instead of immediately returning to title
-	sceneState = SceneState::Clear;
-
-	// reset score on clear
-	score_ = 0;
-	UpdateScoreSprites();
-	requestSceneClear_ = false;
-
-	gameOverTimer_ = 0; // (念のためタイマー系もリセット)
-	hitCount = 0;       // 撃破数リセット
-	hitCount2 = 0;
-
-	camera_.Initialize();
-	camera_.TransferMatrix();
-
-	if (railCamera_) {
-		railCamera_->Reset();
-	}
-
-	if (player_) {
-		player_->ResetRotation();
-		player_->GetWorldTransform().translation_ = playerIntroStartPosition_;
-		player_->GetWorldTransform().UpdateMatrix();
-		player_->ResetParticles();
-		player_->ResetBullets(); // (弾のリセットも行う)
-	}
-
-	for (Enemy* enemy : enemies_) {
-		delete enemy;
-	}
-	enemies_.clear();
-	for (EnemyBullet* bullet : enemyBullets_) {
-		delete bullet;
-	}
-	enemyBullets_.clear();
-
-	for (Meteorite* meteor : meteorites_) {
-		delete meteor;
-	}
-	meteorites_.clear();
-	meteoriteSpawnTimer_ = 0;
-
-	LoadEnemyPopData();
-	hasSpawnedEnemies_ = false;
-}
-
-void GameScene::TransitionToClearScene2() {
-	sceneState = SceneState::over;
-	// reset score on game over
-	score_ = 0;
-	UpdateScoreSprites();
-	requestSceneClear_ = false;
-	gameOverTimer_ = 0;
-	hitCount2 = 0;
-}
-
-void GameScene::SpawnMeteorite() {
-	assert(railCamera_);
-	assert(modelMeteorite_);
-
-	KamataEngine::Vector3 cameraPos = railCamera_->GetWorldTransform().translation_;
-
-	float randomYaw = (static_cast<float>(std::rand()) / RAND_MAX) * (KamataEngine::MathUtility::PI * 2.0f);
-
-	float randomPitchFactor = (static_cast<float>(std::rand()) / RAND_MAX) * 2.0f - 1.0f; // -1.0f ～ 1.0f
-	float randomPitch = std::acos(randomPitchFactor) - (KamataEngine::MathUtility::PI / 2.0f);
-
-	KamataEngine::Vector3 randomDir;
-	randomDir.x = std::cos(randomPitch) * std::sin(randomYaw);
-	randomDir.y = std::sin(randomPitch);
-	randomDir.z = std::cos(randomPitch) * std::cos(randomYaw);
-	randomDir = KamataEngine::MathUtility::Normalize(randomDir);
-
-	// この距離に隕石が発生する
-	const float kSpawnDistance = 800.0f;
-
-	KamataEngine::Vector3 offset = randomDir * kSpawnDistance;
-	KamataEngine::Vector3 spawnPos = cameraPos + offset;
-
-	// スケールと半径をランダム
-	const float kBaseRadius = 2.0f;
-	const float kMinScale = 1.0f;
-	const float kMaxScale = 5.0f;
-
-	float randFactor = static_cast<float>(std::rand()) / RAND_MAX;
-	float randomBaseScale = kMinScale + (randFactor * (kMaxScale - kMinScale));
-	float randomRadius = kBaseRadius * randomBaseScale;
-	Meteorite* newMeteor = new Meteorite();
-	newMeteor->Initialize(modelMeteorite_, spawnPos, randomBaseScale, randomRadius);
-	meteorites_.push_back(newMeteor);
-}
-
-
-void GameScene::UpdateMeteorites() {
-	// 　この数値より離れたら隕石を消去
-	const float kDespawnDistanceSq = 0.0f * 0.0f;
-	KamataEngine::Vector3 playerPos = railCamera_->GetWorldTransform().translation_;
-
-	for (Meteorite* meteor : meteorites_) {
-
-		meteor->Update(playerPos);
-		float distSq = DistanceSquared(playerPos, meteor->GetWorldPosition());
-
-		if (distSq > kDespawnDistanceSq) {
-			meteor->OnCollision();
-		}
-	}
-
-	meteorites_.remove_if([](Meteorite* meteor) {
-		if (meteor && meteor->IsDead()) {
-			delete meteor;
-			return true;
-		}
-		return false;
-	});
-}
-
-KamataEngine::Vector3 GameScene::ProjectToNDC(const KamataEngine::Vector3& worldPos) {
-	if (!railCamera_) {
-		return {0.0f, 0.0f, -1.0f};
-	}
-
-	const KamataEngine::Matrix4x4& viewMatrix = railCamera_->GetViewProjection().matView;
-	const KamataEngine::Matrix4x4& projMatrix = railCamera_->GetViewProjection().matProjection;
-
-	KamataEngine::Vector3 viewPos;
-	viewPos.x = worldPos.x * viewMatrix.m[0][0] + worldPos.y * viewMatrix.m[1][0] + worldPos.z * viewMatrix.m[2][0] + 1.0f * viewMatrix.m[3][0];
-	viewPos.y = worldPos.x * viewMatrix.m[0][1] + worldPos.y * viewMatrix.m[1][1] + worldPos.z * viewMatrix.m[2][1] + 1.0f * viewMatrix.m[3][1];
-	viewPos.z = worldPos.x * viewMatrix.m[0][2] + worldPos.y * viewMatrix.m[1][2] + worldPos.z * viewMatrix.m[2][2] + 1.0f * viewMatrix.m[3][2];
-
-	if (viewPos.z < 0.0f) {
-		return {0.0f, 0.0f, -1.0f};
-	}
-
-	float clipX = viewPos.x * projMatrix.m[0][0] + viewPos.y * projMatrix.m[1][0] + viewPos.z * projMatrix.m[2][0] + 1.0f * projMatrix.m[3][0];
-	float clipY = viewPos.x * projMatrix.m[0][1] + viewPos.y * projMatrix.m[1][1] + viewPos.z * projMatrix.m[2][1] + 1.0f * projMatrix.m[3][1];
-	float clipZ = viewPos.x * projMatrix.m[0][2] + viewPos.y * projMatrix.m[1][2] + viewPos.z * projMatrix.m[2][2] + 1.0f * projMatrix.m[3][2];
-
-	float w_clip = viewPos.x * projMatrix.m[0][3] + viewPos.y * projMatrix.m[1][3] + viewPos.z * projMatrix.m[2][3] + 1.0f * projMatrix.m[3][3];
-
-	if (std::abs(w_clip) < 0.001f || w_clip < 0.0f) {
-		return {0.0f, 0.0f, -1.0f};
-	}
-
-	float ndcX = clipX / w_clip;
-	float ndcY = clipY / w_clip;
-	float ndcZ = clipZ / w_clip;
-
-	return {ndcX, ndcY, ndcZ};
-}
-
-void GameScene::UpdateAimAssist() {
-	if (!railCamera_)
-		return;
-
-	// (リセット処理: user_104.txt で追加済み)
-	for (Enemy* enemy : enemies_) {
-		if (enemy) {
-			enemy->SetAssistLocked(false);
-		}
-	}
-
-	// 1. スプライトの「見た目」の円の半径 (画面高さに対する比率)
-	const float kVisualRadius = 0.08f;
-	// 2. アシストが反応する「判定」の円の半径 (画面高さに対する比率)
-	const float kDetectionRadius = 0.1f; // 0.1f
-
-	// 4. アスペクト比（縦横比）を取得
-	const float kAspect = (float)KamataEngine::WinApp::kWindowWidth / (float)KamataEngine::WinApp::kWindowHeight;
-
-	// 5. スプライトのサイズを「真円」に設定 (kVisualRadius を使用)
-	if (aimAssistCircleSprite_) {
-		float pixelDiameterY = KamataEngine::WinApp::kWindowHeight * kVisualRadius * 2.0f;
-		float pixelDiameterX = pixelDiameterY; // ピクセルで真円
-		aimAssistCircleSprite_->SetSize({pixelDiameterX, pixelDiameterY});
-	}
-
-	// 6. 敵の検索
-	// NDC空間での半径を計算する (ndc は画面幅方向がアスペクトで伸びているため補正が必要)
-	// kVisualRadius は画面HEIGHTに対する比率なので、NDCでの半径は (2 * kVisualRadius)
-	const float ndcVisualRadiusY = kVisualRadius * 2.0f;
-	// X方向のNDC半径はアスペクト比で割る（幅が大きいと NDC 単位での幅は小さくなる）
-	const float ndcVisualRadiusX = ndcVisualRadiusY / kAspect;
-
-	const float ndcDetectionRadiusY = kDetectionRadius * 2.0f;
-	const float ndcDetectionRadiusX = ndcDetectionRadiusY / kAspect;
-
-	// 正規化して比較するための初期閾値 (1.0 = 半径内)
-	float minNormalizedDistSq = 1.0f; // (normalized distance squared)
-	Enemy* bestTarget = nullptr;
-	KamataEngine::Vector3 bestTargetNdc = {0, 0, 0};
-
-	// Camera position for distance check
-	KamataEngine::Vector3 cameraPos = railCamera_->GetWorldTransform().translation_;
-
-	const float kMaxAssistDistance = 3000.0f; // アシストが働く最大距離
-	const float kMaxAssistDistanceSq = kMaxAssistDistance * kMaxAssistDistance;
-
-	for (Enemy* enemy : enemies_) {
-		if (!enemy || enemy->IsDead()) {
-			continue;
-		}
-
-		// 距離でフィルタ（遠い敵はアシスト対象外）
-		KamataEngine::Vector3 enemyPos = enemy->GetWorldPosition();
-		float dx = enemyPos.x - cameraPos.x;
-		float dy = enemyPos.y - cameraPos.y;
-		float dz = enemyPos.z - cameraPos.z;
-		float distSq = dx * dx + dy * dy + dz * dz;
-		if (distSq > kMaxAssistDistanceSq) {
-			continue;
-		}
-
-		// 画面外の敵は早期除外
-		if (!enemy->IsOnScreen()) {
-			continue;
-		}
-
-		KamataEngine::Vector3 ndc = ProjectToNDC(enemy->GetWorldPosition());
-
-		if (ndc.z < 0.0f) {
-			continue;
-		}
-
-		// 正規化した距離を計算 (各軸で半径で割る)
-		float normX = ndc.x / ndcDetectionRadiusX;
-		float normY = ndc.y / ndcDetectionRadiusY;
-		float normalizedDistSq = (normX * normX) + (normY * normY);
-
-		// 判定円の中で、最も中心に近い敵を探す (正規化距離で比較)
-		if (normalizedDistSq < minNormalizedDistSq) {
-			minNormalizedDistSq = normalizedDistSq; // 最終的に bestTarget の正規化距離(2乗) が入る
-			bestTarget = enemy;
-			bestTargetNdc = ndc;
-		}
-	}
-
-	// 9. ターゲットが見つかったらアシスト適用
-	// WASDで視点移動中は吸い寄せを無効化
-	KamataEngine::Input* input = KamataEngine::Input::GetInstance();
-	bool isViewMoving = input->PushKey(DIK_W) || input->PushKey(DIK_S) || input->PushKey(DIK_A) || input->PushKey(DIK_D);
-	
-	if (bestTarget && !isViewMoving) {
-		// アシスト自体は「判定」円で見つかったら実行（WASDが押されていない時のみ）
-		railCamera_->ApplyAimAssist(bestTargetNdc.x, bestTargetNdc.y);
-
-		float visualNormX = bestTargetNdc.x / ndcVisualRadiusX;
-		float visualNormY = bestTargetNdc.y / ndcVisualRadiusY;
-		float visualNormDistSq = (visualNormX * visualNormX) + (visualNormY * visualNormY);
-
-		if (visualNormDistSq <= 1.0f) {
-			bestTarget->SetAssistLocked(true);
-		}
-	}
-}
-
-void GameScene::RequestExplosion(const KamataEngine::Vector3& position) {
-	if (!explosionEmitter_) {
-		return;
-	}
-
-	explosionEmitter_->EmitBurst(
-	    position, // 発生座標
-	    10,       // 粒の数
-	    4.0f,     // 速度
-	    40.0f,    // 寿命 (30フレーム)
-	    10.0f,    // 開始スケール
-	    0.0f      // 終了スケール
-	);
-}
-
-KamataEngine::Vector2 GameScene::ConvertWorldToMinimap(const KamataEngine::Vector3& worldPos, const KamataEngine::Vector3& playerPos) {
-
-	// 1. 自機からの相対座標 (XZ平面のみ)
-	float relativeX = worldPos.x - playerPos.x;
-	float relativeZ = worldPos.z - playerPos.z;
-
-	// 2. ミニマップのスケールを適用 (ワールドのZ+ を ミニマップのY+ (上) に)
-	float minimapOffsetX = relativeX * kMinimapScale_;
-	float minimapOffsetY = relativeZ * kMinimapScale_ * -1.0f; // Y軸反転
-
-	// 3. ミニマップの中心座標を計算
-	KamataEngine::Vector2 minimapCenterPos = {
-	    kMinimapPosition_.x + kMinimapSize_.x * 0.5f,
-	    kMinimapPosition_.y - kMinimapSize_.y * 0.5f // 左下アンカー基準
-	};
-
-	// 4. 中心の座標にオフセットを加える
-	KamataEngine::Vector2 finalPos = {minimapCenterPos.x + minimapOffsetX, minimapCenterPos.y + minimapOffsetY};
-
-	// 5. ミニマップの範囲内に座標をクランプ (はみ出さないように)
-	float minX = kMinimapPosition_.x;
-	float maxX = kMinimapPosition_.x + kMinimapSize_.x;
-	float minY = kMinimapPosition_.y - kMinimapSize_.y; // Yは上(小)・下(大)
-	float maxY = kMinimapPosition_.y;
-
-	finalPos.x = std::clamp(finalPos.x, minX, maxX);
-	finalPos.y = std::clamp(finalPos.y, minY, maxY);
-
-	return finalPos;
-}
-
-// Score handling
-void GameScene::AddScore(int points) {
-	if (points <= 0) return;
-	score_ += points;
-	if (score_ > kMaxScore_) score_ = kMaxScore_;
-	UpdateScoreSprites();
-
-	// If score reaches or exceeds 200, request clear the scene at a safe point
-	if (sceneState == SceneState::Game && score_ >= 600) {
-		requestSceneClear_ = true;
-	}
-}
-
 void GameScene::UpdateScoreSprites() {
 	int display = score_;
 	// clamp
@@ -1,87 +1,112 @@
 #pragma once
-#include "AABB.h"
-#include "Enemy.h"
+#include "AssetLoader.h"
+#include "EngineAssets.h"
+#include "GameFlow.h"
+#include "GameWorld.h"
+#include "InputRecording.h"
 #include "KamataEngine.h"
-#include "Player.h"
-#include "RailCamera.h"
+#include "SnapshotPipeline.h"
 #include "Skydome.h"
-#include "../../Meteorite.h"
-#include <sstream>
+#include "WorldRenderer.h"
+#include "WorldSnapshot.h"
+#include <chrono>
+#include <string>
 #include <vector>
 using namespace KamataEngine;
 
-float Distance(const Vector3& v1, const Vector3& v2);
-Vector3 Lerp(const Vector3& start, const Vector3& end, float t);
-
 class GameScene {
 public:
 	GameScene();
 	~GameScene();
 
+	// 入力と乱数の種を記録し、シーンの終了時に path へ書き出す (Initialize より前に呼ぶ)
+	void StartRecording(const std::string& path);
+	// path に記録した入力を再生する (Initialize より前に呼ぶ。読めなければ false)
+	bool StartReplay(const std::string& path);
+
 	void Initialize();
 	void Update();
 	void Draw();
 
-	void CheckAllCollisions();
-
-	void TransitionToClearScene();
-
-	void TransitionToClearScene2();
-
-	void AddEnemyBullet(EnemyBullet* enemyBullet);
-	const std::list<EnemyBullet*>& GetEnemyBullets() const { return enemyBullets_; }
-
-	void LoadEnemyPopData();
-	void UpdateEnemyPopCommands();
-	void EnemySpawn(const Vector3& position);
-
-	void UpdateAimAssist();
-	KamataEngine::Vector3 ProjectToNDC(const KamataEngine::Vector3& worldPos);
-
-	void SpawnMeteorite();
-	void UpdateMeteorites();
-
-	void RequestExplosion(const KamataEngine::Vector3& position);
-
-	bool hasSpawnedEnemies_ = false;
-
-	// Score handling (made public so other game objects can award points)
-	void AddScore(int points);
 	void UpdateScoreSprites();
 
 private:
+	using SceneState = GameFlow::State;
+
+	// シミュレーションの 1 フレーム分 (メインスレッドが入力を書き、ワーカーが結果を書く)
+	struct SimulationFrame {
+		// 入力: ステップごとのキー
+		std::vector<uint32_t> stepKeys;
+		// 入力: 最後のステップからの補間の割合
+		float alpha = 1.0f;
+		// 結果: 各ステップを始めたときの状態
+		std::vector<SceneState> stepStates;
+		// 結果: 最後のステップの後の状態
+		SceneState state = SceneState::Start;
+		int transitionTimer = 0;
+		WorldSnapshot snapshot;
+	};
+
+	// DirectInput の押下状態をシミュレーション用の入力に変換する
+	uint32_t MakeSimKeyMask() const;
+	// frame の入力でワールドと画面の流れを進め、スナップショットを取る (ワーカースレッドで呼ばれる)
+	void SimulateFrame(SimulationFrame& frame);
+	// シミュレーションの結果を演出・音・カメラに反映する
+	void PresentFrame(const SimulationFrame& frame);
+	// 固定ステップ 1 回分の演出 (state はそのステップを始めたときの状態)
+	void UpdateStep(SceneState state);
+	// 状態が切り替わったときの処理
+	void ChangeSceneState(SceneState state);
+	// スナップショットを音とカメラ、ミニマップに反映する
+	void ApplySnapshot(const WorldSnapshot& snapshot);
+
 	DirectXCommon* dxCommon_ = nullptr;
 	Input* input_ = nullptr;
 	Audio* audio_ = nullptr;
 
-	Player* player_ = nullptr;
+	// ゲームプレイのシミュレーション
+	GameWorld* world_ = nullptr;
+	// シミュレーションの並列化と裏での読み込みに使うスレッド (world_ と assetLoader_ より後に消す)
+	JobSystem* jobSystem_ = nullptr;
+	// タイトル → ゲーム → クリア / ゲームオーバーの流れ (world_ と一緒にワーカーで進める)
+	GameFlow flow_;
+	// シミュレーションと描画の受け渡し (描画している間に裏で次のフレームを進める。world_ より先に消す)
+	SnapshotPipeline<SimulationFrame>* pipeline_ = nullptr;
+	// 演出用に、各ステップでシミュレーションに渡した入力を再現する
+	SimInput stepInput_;
+
+	// ゲーム中に使うモデルとテクスチャの読み込み (タイトル画面の間に裏で読む)
+	AssetLoader* assetLoader_ = nullptr;
+	// モデルとテクスチャの置き場 (名前で共有する。worldRenderer_ より後に消す)
+	EngineAssets* assets_ = nullptr;
+	// 1 フレームに仕上げに使ってよい時間 (秒)
+	const double kAssetFinalizeSeconds = 0.004;
+	WorldRenderer* worldRenderer_ = nullptr;
+
+	// 固定ステップの時計 (描画のフレームレートとは独立してシミュレーションを進める)
+	SimClock clock_;
+	std::chrono::steady_clock::time_point lastFrameTime_;
+	// ステップが回らなかったフレームで押されたキーも次のステップに渡す
+	uint32_t latchedKeyMask_ = 0;
+
+	// 入力の記録と再生 (ステップ単位なので描画のフレームレートが変わっても同じ結果になる)
+	InputRecording recording_;
+	InputReplayer replayer_{recording_};
+	std::string recordingPath_;
+	bool isRecording_ = false;
+	bool isReplaying_ = false;
+
 	Skydome* skydome_ = nullptr;
-	Model* modelSkydome_ = nullptr;
-	RailCamera* railCamera_ = nullptr;
+	Model* modelSkydome_ = nullptr; // assets_ から借りている
 
 	KamataEngine::Sprite* reticleSprite_ = nullptr;
 	uint32_t reticleTextureHandle_ = 0;
 
-	Model* modelPlayer_ = nullptr;
-	Model* modelEnemy_ = nullptr;
-	// 敵弾用の3Dモデル（OBJ）を格納するポインタ
-	Model* modelEnemyBullet_ = nullptr;
-
-	Vector3 railcameraPos = {0, 5, -50};
-	Vector3 railcameraRad = {0, 0, 0};
-
-	std::list<EnemyBullet*> enemyBullets_;
-	std::stringstream enemyPopCommands;
-	std::list<Enemy*> enemies_;
-
 	int32_t titleAnimationTimer_ = 0;
 	const int32_t kTitleRotateFrames = 60;
 	const int32_t kTitlePauseFrames = 60;
 
-	int hitCount = 0;
-	int hitCount2 = 0;
-
-	Model* modelTitleObject_ = nullptr;
+	Model* modelTitleObject_ = nullptr; // assets_ から借りている
 	WorldTransform worldTransformTitleObject_;
 
 	// 右／左キーを示すスプライト
@@ -103,52 +128,29 @@ private:
 	// 矢印グループ全体を右に移動するオフセット（ピクセル）
 	float controlGroupOffset_ = 16.0f; // 矢印と Shift を一緒に右へ移動する量
 
-	enum class SceneState { Start, TransitionToGame, TransitionFromGame, GameIntro, Game, Clear, over };
+	// 表示しているフレームの状態
 	SceneState sceneState = SceneState::Start;
 
-	float DistanceSquared(const KamataEngine::Vector3& v1, const KamataEngine::Vector3& v2);
-
 	KamataEngine::Sprite* transitionSprite_ = nullptr;
 	uint32_t transitionTextureHandle_ = 0;
 	float transitionTimer_ = 0.0f;
-	const float kTransitionTime = 30.0f;
 
 	int hitSoundHandle_ = 0;
 	int hitSound_ = -1;
 
-	Vector3 playerIntroStartPosition_ = {0.0f, -3.0f, -30.0f};
-	Vector3 playerIntroTargetPosition_ = {0.0f, -3.0f, 20.0f};
-	float gameIntroTimer_ = 0.0f;
-	const float kGameIntroDuration_ = 120.0f;
-	bool isGameIntroFinished_ = false;
+	// 自機の発射音 (hitSoundHandle_ と同じ音を使う)
+	int shotSound_ = -1;
 
 	Camera camera_ = {};
 
-	float gameOverTimer_ = 0.0f;
-	bool debugAutoClearEnabled_ = true;
-	int debugAutoClearTimer_ = 0; // frames
-	const int kDebugAutoClearFrames = 60; // ~1 second at 60 FPS
-
-	// カメラ位置アンカー
-	WorldTransform cameraPositionAnchor_;
-	
-	KamataEngine::Model* modelMeteorite_;
-	std::list<Meteorite*> meteorites_;
-	int meteoriteSpawnTimer_;
-	int meteoriteUpdateCounter_;
-
 	KamataEngine::Sprite* taitoruSprite_ = nullptr;
 	uint32_t taitoruTextureHandle_ = 0;
 
 	KamataEngine::Sprite* aimAssistCircleSprite_ = nullptr;
 	uint32_t aimAssistCircleTextureHandle_ = 0;
 
-	KamataEngine::Model* modelParticle_ = nullptr;
-	ParticleEmitter* explosionEmitter_ = nullptr;
-
 	KamataEngine::Sprite* clearSprite_ = nullptr;
 	uint32_t clearTextureHandle_ = 0;
-	ParticleEmitter* clearEmitter_ = nullptr;
 	int confettiSpawnTimer_ = 0;
 	bool confettiActive_ = false;
 
@@ -163,6 +165,8 @@ private:
 		int age = 0;
 	};
 	std::vector<ConfettiParticle> confettiParticles_;
+	// 紙吹雪の位置・動き・色に使う乱数列 (演出だけなのでワールドとは別の系列)
+	RandomStream confettiRandom_;
 	uint32_t confettiTextureHandle_ = 0;
 	const size_t kMaxConfetti_ = 200;
 
@@ -174,47 +178,16 @@ private:
 	uint32_t minimapPlayerTextureHandle_ = 0;
 
 	// ミニマップ上の敵アイコン (事前に最大数確保する)
-	static const size_t kMaxMinimapEnemies_ = 100; // 例: 最大100体
 	std::vector<KamataEngine::Sprite*> minimapEnemySprites_;
 
 	// ミニマップの敵弾アイコン
-	static const size_t kMaxMinimapEnemyBullets_ = 100;
 	std::vector<KamataEngine::Sprite*> minimapEnemyBulletSprites_;
 	uint32_t minimapEnemyBulletTextureHandle_ = 0;
 
-	// ミニマップ設定値
-	const KamataEngine::Vector2 kMinimapPosition_ = {10.0f, 710.0f}; // 描画基準位置 (左下)
-	const KamataEngine::Vector2 kMinimapSize_ = {200.0f, 200.0f};    // 背景スプライトのサイズ
-	const float kMinimapScale_ = 0.03f;                              // ワールド座標 -> ミニマップ座標の縮尺
-
-	/// <returns>ミニマップ上のスクリーン座標</returns>
-	KamataEngine::Vector2 ConvertWorldToMinimap(const KamataEngine::Vector3& worldPos, const KamataEngine::Vector3& playerPos);
-
-	// 最後に記録したプレイヤー位置（ミニマップ回転の判定用）
-	KamataEngine::Vector3 lastPlayerPos_ = {0.0f, 0.0f, 0.0f};
-
-	int homingSpawnTimer_ = 0;
-	// Enemyミサイルの間隔
-	const int kHomingIntervalFrames_ = 60 * 10;
-	const float kHomingMaxDistance_ = 3000.0f;
-	const float kHomingBulletSpeed_ = 8.0f; // requested speed
-
-	// デバッグ: ゲーム開始から指定秒数でタイトルに戻す
-	bool debug10 = true;            // 有効化フラグ
-	// デバッグ10秒タイマー
-	float debug10ElapsedSec_ = 0.0f; // 経過秒数
-	const float kDebug10Seconds = 100.0f; // タイトルへ戻すまでの秒数（100秒）
-
-	// ゲームタイマー（秒）: 自動ゲームオーバー判定に使用
-	float gameSceneTimer_ = 0.0f;
-
 	// カウント表示 (ビットマップフォント用)
 	int score_ = 0; // 表示スコア
 	const int kMaxScore_ = 9999;
 
-	// 安全にシーンクリア遷移をリクエストするフラグ
-	bool requestSceneClear_ = false;
-
 	// デジットテクスチャハンドル (0..9)
 	std::vector<uint32_t> digitTextureHandles_;
 	// 表示用スプライト (4桁)
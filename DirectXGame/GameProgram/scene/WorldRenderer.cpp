@@ -0,0 +1,155 @@
+#include "WorldRenderer.h"
+#include "EngineAssets.h"
+#include <3d/ObjectColor.h>
+#include <3d/WorldTransform.h>
+#include <base/DirectXCommon.h>
+
+namespace {
+
+// DrawModel の順のモデル名 (Resources/<名前>/<名前>.obj)
+const char* const kModelNames[] = {"fly2", "flare", "Bullet", "boat", "bulletEnemy", "meteorite"};
+static_assert(sizeof(kModelNames) / sizeof(kModelNames[0]) == static_cast<size_t>(DrawModel::Count), "kModelNames must match DrawModel");
+
+const char* kTargetTexture = "redbox.png";
+const char* kIndicatorTexture = "indicator.png";
+const char* kAssistLockTexture = "lockongreen.png";
+
+} // namespace
+
+WorldRenderer::~WorldRenderer() {
+	// モデルとテクスチャは他と共有しているので、借りた分を返すだけ
+	if (assets_) {
+		for (const char* name : kModelNames) {
+			assets_->ReleaseModel(name);
+		}
+		assets_->ReleaseTexture(kTargetTexture);
+		assets_->ReleaseTexture(kIndicatorTexture);
+		assets_->ReleaseTexture(kAssistLockTexture);
+	}
+	for (EnemySprites& sprites : enemySprites_) {
+		delete sprites.target;
+		delete sprites.indicator;
+		delete sprites.assistLock;
+	}
+}
+
+void WorldRenderer::Initialize(EngineAssets& assets) {
+	assets_ = &assets;
+	for (size_t i = 0; i < static_cast<size_t>(DrawModel::Count); ++i) {
+		assets.RequestModel(kModelNames[i], models_[i]);
+	}
+
+	assets.RequestTexture(kTargetTexture, targetTextureHandle_);
+	assets.RequestTexture(kIndicatorTexture, indicatorTextureHandle_);
+	assets.RequestTexture(kAssistLockTexture, assistLockTextureHandle_);
+
+	// インスタンス 1 個で 512 バイト (行列と色で 256 バイトずつ) なので 2048 個分。足りなければ次のフレームで広げる
+	constantHeap_.Initialize(KamataEngine::DirectXCommon::GetInstance()->GetDevice(), 1024 * 1024);
+}
+
+void WorldRenderer::BuildInstances(const WorldSnapshot& snapshot) {
+	batcher_.Clear();
+	batcher_.AddSnapshot(snapshot);
+	batcher_.Build();
+	constantHeap_.BeginFrame();
+}
+
+void WorldRenderer::DrawInstances(DrawLayer layer, const KamataEngine::Camera& camera) {
+	// ライトとカメラは層の中で共通 (Model::PreDraw でパイプラインは設定済み)
+	KamataEngine::ModelCommon* modelCommon = KamataEngine::ModelCommon::GetInstance();
+	ID3D12GraphicsCommandList* commandList = modelCommon->GetCommandList();
+	modelCommon->LightCommand();
+	commandList->SetGraphicsRootConstantBufferView(static_cast<UINT>(KamataEngine::Model::RoomParameter::kCamera), camera.GetConstBuffer()->GetGPUVirtualAddress());
+
+	for (const InstanceBatch& batch : batcher_.GetBatches()) {
+		if (batch.layer == layer) {
+			DrawBatch(batch, commandList);
+		}
+	}
+}
+
+void WorldRenderer::DrawBatch(const InstanceBatch& batch, ID3D12GraphicsCommandList* commandList) {
+	const UINT worldTransformIndex = static_cast<UINT>(KamataEngine::Model::RoomParameter::kWorldTransform);
+	const UINT objectColorIndex = static_cast<UINT>(KamataEngine::Model::RoomParameter::kObjectColor);
+	const UINT materialIndex = static_cast<UINT>(KamataEngine::Model::RoomParameter::kMaterial);
+	const UINT textureIndex = static_cast<UINT>(KamataEngine::Model::RoomParameter::kTexture);
+
+	KamataEngine::Model* model = models_[static_cast<size_t>(batch.model)];
+	const std::vector<InstanceData>& instances = batcher_.GetInstances();
+	for (uint32_t i = batch.first; i < batch.first + batch.count; ++i) {
+		// シェーダーの定数バッファと同じ形で書き込む
+		KamataEngine::ConstBufferDataWorldTransform world = {instances[i].world};
+		KamataEngine::ConstBufferDataObjectColor color = {instances[i].color};
+		D3D12_GPU_VIRTUAL_ADDRESS worldAddress = 0;
+		D3D12_GPU_VIRTUAL_ADDRESS colorAddress = 0;
+		if (!constantHeap_.Allocate(&world, sizeof(world), worldAddress) || !constantHeap_.Allocate(&color, sizeof(color), colorAddress)) {
+			// 入りきらない分はこのフレームだけ描かない (次のフレームでヒープが広がる)
+			return;
+		}
+		commandList->SetGraphicsRootConstantBufferView(worldTransformIndex, worldAddress);
+		commandList->SetGraphicsRootConstantBufferView(objectColorIndex, colorAddress);
+		for (const std::unique_ptr<KamataEngine::Mesh>& mesh : model->GetMeshes()) {
+			mesh->Draw(commandList, materialIndex, textureIndex);
+		}
+	}
+}
+
+WorldRenderer::EnemySprites& WorldRenderer::GetEnemySprites(size_t index) {
+	while (enemySprites_.size() <= index) {
+		EnemySprites sprites;
+		sprites.target = KamataEngine::Sprite::Create(targetTextureHandle_, {0, 0});
+		if (sprites.target) {
+			sprites.target->SetSize({50.0f, 50.0f});
+			sprites.target->SetColor({1.0f, 0.0f, 0.0f, 1.0f});
+			sprites.target->SetAnchorPoint({0.5f, 0.5f});
+		}
+		sprites.indicator = KamataEngine::Sprite::Create(indicatorTextureHandle_, {0, 0});
+		if (sprites.indicator) {
+			sprites.indicator->SetSize({40.0f, 40.0f});
+			sprites.indicator->SetAnchorPoint({0.5f, 0.5f});
+		}
+		sprites.assistLock = KamataEngine::Sprite::Create(assistLockTextureHandle_, {0, 0});
+		if (sprites.assistLock) {
+			sprites.assistLock->SetColor({0.0f, 1.0f, 0.0f, 1.0f}); // 緑色
+			sprites.assistLock->SetAnchorPoint({0.5f, 0.5f});
+		}
+		enemySprites_.push_back(sprites);
+	}
+	return enemySprites_[index];
+}
+
+void WorldRenderer::DrawEnemySprites(const WorldSnapshot& snapshot) {
+	for (size_t i = 0; i < snapshot.enemyScreens.size(); ++i) {
+		const EnemyScreenState& state = snapshot.enemyScreens[i];
+		EnemySprites& sprites = GetEnemySprites(i);
+
+		if (state.isOnScreen) {
+			sprites.target->SetPosition(state.screenPosition);
+			sprites.target->SetRotation(state.targetRotation);
+			sprites.target->SetSize({state.targetSize, state.targetSize});
+			sprites.assistLock->SetPosition(state.screenPosition);
+		}
+		sprites.assistLock->SetSize({state.assistLockSize, state.assistLockSize});
+		sprites.assistLock->SetRotation(state.assistLockRotation);
+
+		if (state.isOnScreen) {
+			if (state.useGreenLock) {
+				sprites.assistLock->Draw();
+			} else {
+				sprites.target->Draw();
+			}
+		}
+
+		// 画面外 かつ インジケーター表示距離内の場合のみ、方向インジケーターを描画する
+		if (state.isOffScreen && state.showDirectionIndicator) {
+			sprites.indicator->SetPosition(state.indicatorPosition);
+			sprites.indicator->SetRotation(state.indicatorRotation);
+			sprites.indicator->Draw();
+		}
+
+		if (state.isAssistLocked) {
+			// アシストロックオン中はロックオンスプライトも描画する
+			sprites.assistLock->Draw();
+		}
+	}
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "ConstantUploadHeap.h"
+#include "EngineAssets.h"
+#include "InstanceBatcher.h"
+#include "WorldSnapshot.h"
+#include <2d/Sprite.h>
+#include <3d/Camera.h>
+#include <3d/Model.h>
+#include <vector>
+
+/// <summary>
+/// GameWorld のスナップショットを KamataEngine で描画する
+/// モデルは InstanceBatcher で モデル ごとのまとまりに詰めてから、まとまり単位で描く
+/// ワールド行列と色の定数は ConstantUploadHeap からフレームごとに切り出す (WorldTransform・ObjectColor は作らない)
+/// </summary>
+class WorldRenderer {
+public:
+	WorldRenderer() = default;
+	~WorldRenderer();
+
+	// モデルとテクスチャは assets から借りる (描画は assets の読み込みが全部仕上がってから。assets はこれより長く生きていること)
+	void Initialize(EngineAssets& assets);
+
+	// スナップショットのモデルを まとまり ごとに詰める (DrawInstances の前に 1 フレーム 1 回)
+	void BuildInstances(const WorldSnapshot& snapshot);
+	// 層のまとまりを描く
+	// Player: 自機・排気パーティクル・自弾 / Explosion: 爆発パーティクル / Enemy: 敵・敵弾・隕石
+	void DrawInstances(DrawLayer layer, const KamataEngine::Camera& camera);
+	// 敵のロックオン表示・方向インジケーター
+	void DrawEnemySprites(const WorldSnapshot& snapshot);
+
+private:
+	// 1体分のロックオン表示スプライト
+	struct EnemySprites {
+		KamataEngine::Sprite* target = nullptr;
+		KamataEngine::Sprite* indicator = nullptr;
+		KamataEngine::Sprite* assistLock = nullptr;
+	};
+
+	// 1 つのまとまりを描く (Model::Draw と同じルートパラメータに、切り出した定数のアドレスを渡す)
+	// KamataEngine の Model にはインスタンス描画が無いので、詰めた範囲を順に描く (インスタンス描画にするときはここだけ替える)
+	void DrawBatch(const InstanceBatch& batch, ID3D12GraphicsCommandList* commandList);
+	EnemySprites& GetEnemySprites(size_t index);
+
+	// DrawModel の順 (assets_ から借りている)
+	EngineAssets* assets_ = nullptr;
+	KamataEngine::Model* models_[static_cast<size_t>(DrawModel::Count)] = {};
+
+	InstanceBatcher batcher_;
+	ConstantUploadHeap constantHeap_;
+
+	uint32_t targetTextureHandle_ = 0;
+	uint32_t indicatorTextureHandle_ = 0;
+	uint32_t assistLockTextureHandle_ = 0;
+	std::vector<EnemySprites> enemySprites_;
+};
@@ -7,6 +7,8 @@ class Skydome {
 public:
 
 	void Initialize(KamataEngine::Model* model, KamataEngine::Camera* camera);
+	// モデルを後から読み込むとき用 (Draw より前に設定する)
+	void SetModel(KamataEngine::Model* model) { model_ = model; }
 	void Update();
 	void Draw();
 
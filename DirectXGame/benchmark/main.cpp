@@ -0,0 +1,740 @@
+#include "AssetLoader.h"
+#include "BulletStore.h"
+#include "DynamicAABBTree.h"
+#include "Enemy.h"
+#include "EnemyBullet.h"
+#include "GameWorld.h"
+#include "HomingGuidance.h"
+#include "InstanceBatcher.h"
+#include "JobSystem.h"
+#include "Meteorite.h"
+#include "MeteoriteField.h"
+#include "ParticleEmitter.h"
+#include "PlayerBullet.h"
+#include "RandomStream.h"
+#include "ResourceRegistry.h"
+#include "ScreenProjection.h"
+#include "UploadRing.h"
+#include "ViewFrustum.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+// ゲームプレイのホットパスを 10～100k 体で計測するベンチマーク
+// 使い方: ShootingBench [最大数] [ケース名の一部]
+// 出力: 1体あたりの ns と 1フレームあたりのメモリ確保回数
+
+namespace {
+
+// --- メモリ確保回数の計測 ---
+std::atomic<uint64_t> gAllocationCount{0};
+
+// 置き換えた new / delete はすべてここを通す (GCC が new と free の組み合わせを警告しないよう、インライン展開させない)
+#if defined(__GNUC__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define BENCH_NOINLINE __declspec(noinline)
+#else
+#define BENCH_NOINLINE
+#endif
+
+BENCH_NOINLINE void* CountedAllocate(size_t size, size_t alignment) {
+	gAllocationCount.fetch_add(1, std::memory_order_relaxed);
+	if (size == 0) {
+		size = 1;
+	}
+	void* p = nullptr;
+	if (alignment <= alignof(std::max_align_t)) {
+		p = std::malloc(size);
+	} else {
+#if defined(_MSC_VER)
+		p = _aligned_malloc(size, alignment);
+#else
+		// aligned_alloc はサイズが alignment の倍数でないといけない
+		p = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+	}
+	if (!p) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+BENCH_NOINLINE void CountedFree(void* p, size_t alignment) noexcept {
+#if defined(_MSC_VER)
+	if (alignment > alignof(std::max_align_t)) {
+		_aligned_free(p);
+		return;
+	}
+#else
+	(void)alignment;
+#endif
+	std::free(p);
+}
+
+} // namespace
+
+void* operator new(size_t size) { return CountedAllocate(size, 0); }
+void* operator new[](size_t size) { return CountedAllocate(size, 0); }
+void* operator new(size_t size, std::align_val_t alignment) { return CountedAllocate(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment) { return CountedAllocate(size, static_cast<size_t>(alignment)); }
+void operator delete(void* p) noexcept { CountedFree(p, 0); }
+void operator delete[](void* p) noexcept { CountedFree(p, 0); }
+void operator delete(void* p, size_t) noexcept { CountedFree(p, 0); }
+void operator delete[](void* p, size_t) noexcept { CountedFree(p, 0); }
+void operator delete(void* p, std::align_val_t alignment) noexcept { CountedFree(p, static_cast<size_t>(alignment)); }
+void operator delete[](void* p, std::align_val_t alignment) noexcept { CountedFree(p, static_cast<size_t>(alignment)); }
+void operator delete(void* p, size_t, std::align_val_t alignment) noexcept { CountedFree(p, static_cast<size_t>(alignment)); }
+void operator delete[](void* p, size_t, std::align_val_t alignment) noexcept { CountedFree(p, static_cast<size_t>(alignment)); }
+
+namespace {
+
+// 1フレーム・準備にかかってよい時間の上限 (これを超えそうなら以降の数はスキップする)
+const double kMaxFrameSeconds = 0.5;
+const double kMaxSetupSeconds = 2.0;
+// 1ケースで計測に使う時間の目安
+const double kTargetCaseSeconds = 0.5;
+
+// 再現性のある位置を作る (xorshift32)
+class Random {
+public:
+	explicit Random(uint32_t seed) : state_(seed ? seed : 1u) {}
+	float Range(float min, float max) {
+		state_ ^= state_ << 13;
+		state_ ^= state_ >> 17;
+		state_ ^= state_ << 5;
+		return min + (max - min) * (static_cast<float>(state_ & 0xFFFFFF) / static_cast<float>(0xFFFFFF));
+	}
+
+private:
+	uint32_t state_;
+};
+
+// 最適化で計算ごと消されないように結果を流し込む
+volatile float gSink = 0.0f;
+
+// 1 ケース分の準備とフレーム処理
+struct Case {
+	const char* name;
+	// count 体を用意して、1フレーム分の処理を返す
+	std::function<std::function<void()>(size_t count)> setup;
+};
+
+std::string ResourcePath(const char* file) { return std::string(SHOOTING_RESOURCE_DIR) + file; }
+
+// 自機の前方 (カメラに写る範囲) に並べる
+KamataEngine::Vector3 InFront(Random& random) { return {random.Range(-400.0f, 400.0f), random.Range(-200.0f, 200.0f), random.Range(500.0f, 2500.0f)}; }
+
+// 敵がうろつく範囲 (Enemy::Update で最大 4500) に散らした箱と、それを入れた AABB 木
+struct BoxField {
+	std::vector<AABB> boxes;
+	std::vector<int32_t> proxies;
+	DynamicAABBTree<uint32_t> tree{20.0f};
+	// 1フレームに問い合わせる位置
+	std::vector<KamataEngine::Vector3> queries;
+	std::vector<uint32_t> results;
+};
+
+std::shared_ptr<BoxField> MakeBoxField(size_t count) {
+	auto field = std::make_shared<BoxField>();
+	Random random(9);
+	for (uint32_t i = 0; i < count; ++i) {
+		AABB box = MakeAABB({random.Range(-4500.0f, 4500.0f), random.Range(-500.0f, 500.0f), random.Range(-4500.0f, 4500.0f)}, Enemy::kRadius);
+		field->boxes.push_back(box);
+		field->proxies.push_back(field->tree.CreateProxy(box, i));
+	}
+	for (int i = 0; i < 64; ++i) {
+		field->queries.push_back({random.Range(-4500.0f, 4500.0f), 0.0f, random.Range(-4500.0f, 4500.0f)});
+	}
+	field->results.reserve(count);
+	return field;
+}
+
+// 起動時に読むものと同じ種類のファイル (Resources/<名前>/<名前>.obj と Resources 直下の画像)
+std::vector<std::string> ListStartupAssets() {
+	std::vector<std::string> paths;
+	for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(ResourcePath(""))) {
+		std::filesystem::path path = entry.path();
+		if (entry.is_directory()) {
+			std::filesystem::path obj = path / (path.filename().string() + ".obj");
+			if (std::filesystem::exists(obj)) {
+				paths.push_back(obj.string());
+			}
+		} else if (path.extension() == ".png") {
+			paths.push_back(path.string());
+		}
+	}
+	std::sort(paths.begin(), paths.end());
+	return paths;
+}
+
+// 問い合わせの箱の半径と、近い順に取る数
+const float kBoxQueryRadius = 300.0f;
+const size_t kNearestCount = 4;
+
+std::vector<Case> MakeCases() {
+	std::vector<Case> cases;
+
+	// 自弾 vs 敵、自機 vs 敵弾 (それぞれ count 個、当たらない位置に置く)
+	cases.push_back({"CheckAllCollisions", [](size_t count) {
+		                 auto world = std::make_shared<GameWorld>();
+		                 world->Initialize(ResourcePath("enemyPop.csv"), 1);
+		                 world->GetPlayer()->ReserveBullets(count);
+		                 world->ReserveEnemyBullets(count);
+		                 Random random(1);
+		                 for (size_t i = 0; i < count; ++i) {
+			                 world->EnemySpawn(InFront(random));
+			                 world->GetPlayer()->SpawnBullet({random.Range(-400.0f, 400.0f), 5000.0f, random.Range(500.0f, 2500.0f)}, {0.0f, 0.0f, 0.0f});
+			                 world->SpawnEnemyBullet({random.Range(-400.0f, 400.0f), -5000.0f, random.Range(500.0f, 2500.0f)}, {0.0f, 0.0f, 0.0f});
+		                 }
+		                 return std::function<void()>([world]() { world->CheckAllCollisions(); });
+	                 }});
+
+	// 弾をプールから count 個出して全部戻す (発射と消滅の繰り返し)
+	cases.push_back({"Player::SpawnBullet", [](size_t count) {
+		                 auto world = std::make_shared<GameWorld>();
+		                 world->Initialize(ResourcePath("enemyPop.csv"), 1);
+		                 world->GetPlayer()->ReserveBullets(count);
+		                 return std::function<void()>([world, count]() {
+			                 Player* player = world->GetPlayer();
+			                 for (size_t i = 0; i < count; ++i) {
+				                 player->SpawnBullet({0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 60.0f});
+			                 }
+			                 player->ResetBullets();
+		                 });
+	                 }});
+
+	// 画面内の敵からアシスト対象を探す
+	cases.push_back({"UpdateAimAssist", [](size_t count) {
+		                 auto world = std::make_shared<GameWorld>();
+		                 world->Initialize(ResourcePath("enemyPop.csv"), 1);
+		                 world->UpdateTransition();
+		                 Random random(2);
+		                 for (size_t i = 0; i < count; ++i) {
+			                 world->EnemySpawn(InFront(random));
+		                 }
+		                 world->UpdateScreenProjection();
+		                 return std::function<void()>([world]() { world->UpdateAimAssist(); });
+	                 }});
+
+	// 敵が自機の周りにうろついている場合 (Enemy::Update で最大 4500 離れる)
+	cases.push_back({"UpdateAimAssist(spread)", [](size_t count) {
+		                 auto world = std::make_shared<GameWorld>();
+		                 world->Initialize(ResourcePath("enemyPop.csv"), 1);
+		                 world->UpdateTransition();
+		                 Random random(2);
+		                 for (size_t i = 0; i < count; ++i) {
+			                 world->EnemySpawn({random.Range(-4500.0f, 4500.0f), random.Range(-500.0f, 500.0f), random.Range(-4500.0f, 4500.0f)});
+		                 }
+		                 world->UpdateScreenProjection();
+		                 return std::function<void()>([world]() { world->UpdateAimAssist(); });
+	                 }});
+
+	// 生きているパーティクルの更新
+	cases.push_back({"ParticleEmitter::Update", [](size_t count) {
+		                 auto emitter = std::make_shared<ParticleEmitter>();
+		                 emitter->Initialize(count);
+		                 emitter->EmitBurst({0.0f, 0.0f, 0.0f}, static_cast<int>(count), 0.1f, 1.0e9f, 1.0f, 0.0f);
+		                 return std::function<void()>([emitter]() { emitter->Update(); });
+	                 }});
+
+	// パーティクルの更新をジョブシステムで並列に回す
+	cases.push_back({"ParticleEmitter::Update(jobs)", [](size_t count) {
+		                 auto emitter = std::make_shared<ParticleEmitter>();
+		                 emitter->Initialize(count);
+		                 emitter->EmitBurst({0.0f, 0.0f, 0.0f}, static_cast<int>(count), 0.1f, 1.0e9f, 1.0f, 0.0f);
+		                 auto jobs = std::make_shared<JobSystem>(JobSystem::DefaultWorkerCount());
+		                 return std::function<void()>([emitter, jobs]() { emitter->Update(jobs.get()); });
+	                 }});
+
+	// 空のエミッタに count 個の爆発を出す
+	cases.push_back({"ParticleEmitter::EmitBurst", [](size_t count) {
+		                 auto emitter = std::make_shared<ParticleEmitter>();
+		                 emitter->Initialize(count);
+		                 return std::function<void()>([emitter, count]() {
+			                 emitter->Clear();
+			                 emitter->EmitBurst({0.0f, 0.0f, 0.0f}, static_cast<int>(count), 4.0f, 40.0f, 10.0f, 0.0f);
+		                 });
+	                 }});
+
+	// 生きているパーティクルを描画用の並びに書き出す
+	cases.push_back({"ParticleEmitter::CollectInstances", [](size_t count) {
+		                 auto emitter = std::make_shared<ParticleEmitter>();
+		                 emitter->Initialize(count);
+		                 emitter->EmitBurst({0.0f, 0.0f, 0.0f}, static_cast<int>(count), 0.1f, 1.0e9f, 1.0f, 0.0f);
+		                 auto instances = std::make_shared<std::vector<ParticleInstance>>();
+		                 return std::function<void()>([emitter, instances]() {
+			                 instances->clear();
+			                 emitter->CollectInstances(*instances, 0.5f);
+		                 });
+	                 }});
+
+	// スナップショット 1 枚分のインスタンスを まとまり ごとに詰める (count 個の隕石と同じ数の敵弾)
+	cases.push_back({"InstanceBatcher::Build", [](size_t count) {
+		                 auto snapshot = std::make_shared<WorldSnapshot>();
+		                 Random random(12);
+		                 for (size_t i = 0; i < count; ++i) {
+			                 KamataEngine::Vector3 position = InFront(random);
+			                 snapshot->meteorites.push_back(MakeTranslateMatrix(position));
+			                 snapshot->enemyBullets.push_back(MakeTranslateMatrix(position * 0.5f));
+		                 }
+		                 auto batcher = std::make_shared<InstanceBatcher>();
+		                 return std::function<void()>([snapshot, batcher]() {
+			                 batcher->Clear();
+			                 batcher->AddSnapshot(*snapshot);
+			                 batcher->Build();
+		                 });
+	                 }});
+
+	// 1 フレームに count 体分の定数 (行列と色) を切り出す (2 フレーム遅れで空く)
+	cases.push_back({"UploadRing::Allocate", [](size_t count) {
+		                 auto ring = std::make_shared<UploadRing>();
+		                 ring->Initialize(count * 2 * UploadRing::kAlignment * 3);
+		                 auto frame = std::make_shared<uint64_t>(0);
+		                 return std::function<void()>([ring, frame, count]() {
+			                 ++*frame;
+			                 ring->Retire(*frame > 2 ? *frame - 2 : 0);
+			                 uint64_t sum = 0;
+			                 for (size_t i = 0; i < count; ++i) {
+				                 sum += ring->Allocate(sizeof(KamataEngine::Matrix4x4));
+				                 sum += ring->Allocate(sizeof(KamataEngine::Vector4));
+			                 }
+			                 ring->FinishFrame(*frame);
+			                 gSink = gSink + static_cast<float>(sum & 1);
+		                 });
+	                 }});
+
+	// 起動時の読み込み: count 個のアセット (Resources のモデルと画像を順に繰り返す) を読み、全部仕上げる
+	// 仕上げは何もしないので、ファイルの読み込みとワーカーへの受け渡しの時間 (ローダーのスレッドを立てる分を含む)
+	for (bool useJobs : {false, true}) {
+		cases.push_back({useJobs ? "AssetLoader::Load(jobs)" : "AssetLoader::Load", [useJobs](size_t count) {
+			                 auto assets = std::make_shared<std::vector<std::string>>(ListStartupAssets());
+			                 return std::function<void()>([assets, count, useJobs]() {
+				                 JobSystem jobs(useJobs ? JobSystem::DefaultWorkerCount() : 0);
+				                 AssetLoader loader(useJobs ? &jobs : nullptr);
+				                 for (size_t i = 0; i < count; ++i) {
+					                 loader.Request((*assets)[i % assets->size()], nullptr);
+				                 }
+				                 loader.FinalizeAll();
+				                 gSink = gSink + static_cast<float>(loader.GetBytesRead() & 1);
+			                 });
+		                 }});
+	}
+
+	// 敵を count 体出すときに、1 体ずつモデル 1 つとテクスチャ 3 枚を名前で借りて返す
+	// 読み込む (Store する) のは準備のときの 1 回だけで、フレームの中では共有だけになる
+	cases.push_back({"ResourceRegistry::Acquire", [](size_t count) {
+		                 auto registry = std::make_shared<ResourceRegistry<uint32_t>>();
+		                 auto names = std::make_shared<std::vector<std::string>>(std::vector<std::string>{"boat", "redbox.png", "indicator.png", "lockongreen.png"});
+		                 for (size_t i = 0; i < names->size(); ++i) {
+			                 registry->Acquire((*names)[i]);
+			                 registry->Store((*names)[i], static_cast<uint32_t>(i + 1), 0.0, 1024);
+		                 }
+		                 return std::function<void()>([registry, names, count]() {
+			                 uint32_t sum = 0;
+			                 for (size_t i = 0; i < count; ++i) {
+				                 for (const std::string& name : *names) {
+					                 registry->Acquire(name, [&sum](const uint32_t& handle) { sum += handle; });
+				                 }
+			                 }
+			                 for (size_t i = 0; i < count; ++i) {
+				                 for (const std::string& name : *names) {
+					                 registry->Release(name);
+				                 }
+			                 }
+			                 gSink = gSink + static_cast<float>((sum + registry->GetStats().loadCount) & 1);
+		                 });
+	                 }});
+
+	// 敵の移動
+	cases.push_back({"Enemy::Update", [](size_t count) {
+		                 auto enemies = std::make_shared<std::vector<Enemy>>(count);
+		                 Random random(3);
+		                 for (size_t i = 0; i < count; ++i) {
+			                 (*enemies)[i].Initialize(InFront(random), RandomStream(1, RandomStreamId::kEnemyBase + i));
+		                 }
+		                 return std::function<void()>([enemies]() {
+			                 for (Enemy& enemy : *enemies) {
+				                 enemy.Update();
+			                 }
+		                 });
+	                 }});
+
+	// 敵の移動をジョブシステムで並列に回す (Enemy::Update と同じ敵、区切りは GameWorld と同じ)
+	cases.push_back({"Enemy::Update(jobs)", [](size_t count) {
+		                 auto enemies = std::make_shared<std::vector<Enemy>>(count);
+		                 Random random(3);
+		                 for (size_t i = 0; i < count; ++i) {
+			                 (*enemies)[i].Initialize(InFront(random), RandomStream(1, RandomStreamId::kEnemyBase + i));
+		                 }
+		                 auto jobs = std::make_shared<JobSystem>(JobSystem::DefaultWorkerCount());
+		                 return std::function<void()>([enemies, jobs]() {
+			                 jobs->ParallelFor(enemies->size(), GameWorld::kEnemyUpdateGrain, [&enemies](size_t begin, size_t end) {
+				                 for (size_t i = begin; i < end; ++i) {
+					                 (*enemies)[i].Update();
+				                 }
+			                 });
+		                 });
+	                 }});
+
+	// 敵をまとめて投影し、画面表示を更新する
+	cases.push_back({"GameWorld::UpdateScreenProjection", [](size_t count) {
+		                 auto world = std::make_shared<GameWorld>();
+		                 world->Initialize(ResourcePath("enemyPop.csv"), 1);
+		                 world->UpdateTransition();
+		                 Random random(3);
+		                 for (size_t i = 0; i < count; ++i) {
+			                 world->EnemySpawn(InFront(random));
+		                 }
+		                 return std::function<void()>([world]() { world->UpdateScreenProjection(); });
+	                 }});
+
+	// 投影だけ (表を作り直して SIMD で投影する)
+	cases.push_back({"ScreenProjection::Project", [](size_t count) {
+		                 auto camera = std::make_shared<SimCamera>();
+		                 camera->Initialize();
+		                 auto positions = std::make_shared<std::vector<KamataEngine::Vector3>>();
+		                 Random random(3);
+		                 for (size_t i = 0; i < count; ++i) {
+			                 positions->push_back(InFront(random));
+		                 }
+		                 auto projection = std::make_shared<ScreenProjection>();
+		                 return std::function<void()>([camera, positions, projection]() {
+			                 projection->Begin(*camera);
+			                 for (const KamataEngine::Vector3& position : *positions) {
+				                 projection->Add(position);
+			                 }
+			                 projection->Project();
+		                 });
+	                 }});
+
+	// 自機を追うホーミング弾
+	cases.push_back({"UpdateEnemyBullets(homing)", [](size_t count) {
+		                 auto world = std::make_shared<GameWorld>();
+		                 world->Initialize(ResourcePath("enemyPop.csv"), 1);
+		                 world->ReserveEnemyBullets(count);
+		                 Random random(4);
+		                 for (size_t i = 0; i < count; ++i) {
+			                 EnemyBullet* bullet =
+			                     world->SpawnEnemyBullet({random.Range(-3000.0f, 3000.0f), random.Range(-3000.0f, 3000.0f), random.Range(2000.0f, 3000.0f)}, {0.0f, 0.0f, -8.0f});
+			                 bullet->SetHomingEnabled(true);
+			                 bullet->SetHomingTarget(world->GetPlayer());
+			                 bullet->SetSpeed(8.0f);
+		                 }
+		                 return std::function<void()>([world]() { world->UpdateEnemyBullets(); });
+	                 }});
+
+	// 誘導の計算だけ (count 発を登録して向きを変える。速度は毎回元に戻すので毎回曲がる)
+	for (HomingGuidance::Law law : {HomingGuidance::Law::PurePursuit, HomingGuidance::Law::ProportionalNavigation}) {
+		bool isPursuit = law == HomingGuidance::Law::PurePursuit;
+		cases.push_back({isPursuit ? "HomingGuidance::Steer(pursuit)" : "HomingGuidance::Steer(pn)", [law](size_t count) {
+			                 auto store = std::make_shared<BulletStore>(count);
+			                 auto velocities = std::make_shared<std::vector<KamataEngine::Vector3>>();
+			                 auto guidance = std::make_shared<HomingGuidance>();
+			                 guidance->SetLaw(law);
+			                 Random random(10);
+			                 for (size_t i = 0; i < count; ++i) {
+				                 KamataEngine::Vector3 velocity = {random.Range(-8.0f, 8.0f), random.Range(-8.0f, 8.0f), random.Range(-8.0f, 8.0f)};
+				                 store->Activate(static_cast<uint32_t>(i), InFront(random), velocity, 1.0e9f);
+				                 velocities->push_back(velocity);
+			                 }
+			                 return std::function<void()>([store, velocities, guidance]() {
+				                 guidance->Clear();
+				                 for (size_t i = 0; i < velocities->size(); ++i) {
+					                 uint32_t slot = static_cast<uint32_t>(i);
+					                 store->SetVelocity(slot, (*velocities)[i]);
+					                 guidance->Add(slot, {0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, 0.05f + 0.001f * static_cast<float>(i % 300));
+				                 }
+				                 guidance->Steer(*store);
+			                 });
+		                 }});
+	}
+
+	// まっすぐ飛ぶ弾の移動 (SoA をまとめて進めるだけ)
+	cases.push_back({"BulletStore::Integrate", [](size_t count) {
+		                 auto store = std::make_shared<BulletStore>(count);
+		                 Random random(7);
+		                 for (size_t i = 0; i < count; ++i) {
+			                 store->Activate(static_cast<uint32_t>(i), InFront(random), {random.Range(-1.0f, 1.0f), random.Range(-1.0f, 1.0f), 60.0f}, 1.0e9f);
+		                 }
+		                 return std::function<void()>([store]() {
+			                 store->SavePrevious();
+			                 store->Integrate(1.0f);
+		                 });
+	                 }});
+
+	// 弾が通った線分と動く球の判定 (count 発全部を候補にする)
+	cases.push_back({"BulletStore::SweepSphere", [](size_t count) {
+		                 auto store = std::make_shared<BulletStore>(count);
+		                 auto slots = std::make_shared<std::vector<uint32_t>>();
+		                 auto hits = std::make_shared<std::vector<uint8_t>>();
+		                 Random random(8);
+		                 for (size_t i = 0; i < count; ++i) {
+			                 store->Activate(static_cast<uint32_t>(i), InFront(random), {random.Range(-1.0f, 1.0f), random.Range(-1.0f, 1.0f), 60.0f}, 1.0e9f);
+			                 slots->push_back(static_cast<uint32_t>(i));
+		                 }
+		                 store->Integrate(1.0f);
+		                 return std::function<void()>([store, slots, hits]() { store->SweepSphere({0.0f, 0.0f, 1000.0f}, {0.0f, 0.0f, 1001.0f}, 12.6f, *slots, *hits); });
+	                 }});
+
+	// 乱数をまとめて作る (count 個の一様な実数と単位ベクトル)
+	cases.push_back({"RandomStream::Fill", [](size_t count) {
+		                 auto random = std::make_shared<RandomStream>(1, RandomStreamId::kExplosion);
+		                 auto values = std::make_shared<std::vector<float>>(count);
+		                 auto directions = std::make_shared<std::vector<KamataEngine::Vector3>>(count);
+		                 return std::function<void()>([random, values, directions]() {
+			                 random->FillRange(values->data(), values->size(), -1.0f, 1.0f);
+			                 random->FillUnitVectors(directions->data(), directions->size());
+			                 gSink = (*values)[0] + (*directions)[0].x;
+		                 });
+	                 }});
+
+	// 自機の周りの隕石 (近づくと大きくなる)
+	cases.push_back({"Meteorite::Update", [](size_t count) {
+		                 auto meteorites = std::make_shared<std::vector<Meteorite>>(count);
+		                 Random random(5);
+		                 for (Meteorite& meteorite : *meteorites) {
+			                 float scale = random.Range(1.0f, 5.0f);
+			                 meteorite.Initialize({random.Range(-400.0f, 400.0f), random.Range(-400.0f, 400.0f), random.Range(-400.0f, 400.0f)}, scale, scale * 2.0f);
+		                 }
+		                 return std::function<void()>([meteorites]() {
+			                 KamataEngine::Vector3 playerPos = {0.0f, 0.0f, 0.0f};
+			                 for (Meteorite& meteorite : *meteorites) {
+				                 meteorite.Update(playerPos);
+			                 }
+		                 });
+	                 }});
+
+	// カメラの周りの隕石群 (密度の目標を count にして、移動するカメラの周りで出し入れする)
+	cases.push_back({"MeteoriteField::Update", [](size_t count) {
+		                 auto field = std::make_shared<MeteoriteField>();
+		                 field->Reserve(count, count);
+		                 auto cameraZ = std::make_shared<float>(0.0f);
+		                 return std::function<void()>([field, cameraZ]() {
+			                 *cameraZ += 10.0f;
+			                 KamataEngine::Vector3 cameraPos = {0.0f, 0.0f, *cameraZ};
+			                 field->Update(cameraPos, cameraPos);
+		                 });
+	                 }});
+
+	// カメラの周り全方向に散らした隕石の行列から、見えないものを外す (毎回元の並びから始める)
+	cases.push_back({"ViewFrustum::CullMatrices", [](size_t count) {
+		                 auto camera = std::make_shared<SimCamera>();
+		                 camera->Initialize();
+		                 auto matrices = std::make_shared<std::vector<KamataEngine::Matrix4x4>>();
+		                 Random random(4);
+		                 for (size_t i = 0; i < count; ++i) {
+			                 float scale = random.Range(1.0f, 10.0f);
+			                 matrices->push_back(MakeAffineMatrix({scale, scale, scale}, {0.0f, 0.0f, 0.0f}, {random.Range(-800.0f, 800.0f), random.Range(-800.0f, 800.0f), random.Range(-800.0f, 800.0f)}));
+		                 }
+		                 auto frustum = std::make_shared<ViewFrustum>();
+		                 frustum->SetViewProjection(Multiply(camera->matView, camera->matProjection));
+		                 auto visible = std::make_shared<std::vector<KamataEngine::Matrix4x4>>();
+		                 return std::function<void()>([matrices, frustum, visible]() {
+			                 *visible = *matrices;
+			                 frustum->CullMatrices(*visible, GameWorld::kMeteoriteModelRadius);
+		                 });
+	                 }});
+
+	// 自機と同じくレールカメラを親に持つ変換の行列の更新 (clean は値が変わっていないので作り直さない)
+	for (bool dirty : {false, true}) {
+		cases.push_back({dirty ? "SimTransform::UpdateMatrix(dirty)" : "SimTransform::UpdateMatrix(clean)", [dirty](size_t count) {
+			                 auto parent = std::make_shared<SimTransform>();
+			                 parent->Initialize();
+			                 parent->UpdateMatrix();
+			                 auto transforms = std::make_shared<std::vector<SimTransform>>(count);
+			                 for (SimTransform& transform : *transforms) {
+				                 transform.Initialize();
+				                 transform.parent_ = parent.get();
+				                 transform.rotation_ = {0.1f, 0.2f, 0.3f};
+				                 transform.UpdateMatrix();
+			                 }
+			                 return std::function<void()>([parent, transforms, dirty]() {
+				                 for (SimTransform& transform : *transforms) {
+					                 if (dirty) {
+						                 transform.translation_.z += 1.0f;
+					                 }
+					                 transform.UpdateMatrix();
+				                 }
+			                 });
+		                 }});
+	}
+
+	// ミニマップ座標への変換
+	cases.push_back({"ConvertWorldToMinimap", [](size_t count) {
+		                 auto world = std::make_shared<GameWorld>();
+		                 world->Initialize(ResourcePath("enemyPop.csv"), 1);
+		                 auto positions = std::make_shared<std::vector<KamataEngine::Vector3>>(count);
+		                 Random random(6);
+		                 for (KamataEngine::Vector3& position : *positions) {
+			                 position = {random.Range(-8000.0f, 8000.0f), 0.0f, random.Range(-8000.0f, 8000.0f)};
+		                 }
+		                 return std::function<void()>([world, positions]() {
+			                 KamataEngine::Vector3 playerPos = {0.0f, 0.0f, 0.0f};
+			                 float sum = 0.0f;
+			                 for (const KamataEngine::Vector3& position : *positions) {
+				                 KamataEngine::Vector2 p = world->ConvertWorldToMinimap(position, playerPos);
+				                 sum += p.x + p.y;
+			                 }
+			                 gSink = sum;
+		                 });
+	                 }});
+
+	// 64 か所で箱と重なるものを探す (木とすべて調べる場合の比較)
+	cases.push_back({"DynamicAABBTree::Query", [](size_t count) {
+		                 auto field = MakeBoxField(count);
+		                 return std::function<void()>([field]() {
+			                 for (const KamataEngine::Vector3& position : field->queries) {
+				                 field->results.clear();
+				                 field->tree.Query(MakeAABB(position, kBoxQueryRadius), [&field](uint32_t id) {
+					                 field->results.push_back(id);
+					                 return true;
+				                 });
+			                 }
+			                 gSink = static_cast<float>(field->results.size());
+		                 });
+	                 }});
+	cases.push_back({"BruteForce::Query", [](size_t count) {
+		                 auto field = MakeBoxField(count);
+		                 return std::function<void()>([field]() {
+			                 for (const KamataEngine::Vector3& position : field->queries) {
+				                 field->results.clear();
+				                 AABB query = MakeAABB(position, kBoxQueryRadius);
+				                 for (uint32_t i = 0; i < field->boxes.size(); ++i) {
+					                 if (IsCollisionAABB(field->boxes[i], query)) {
+						                 field->results.push_back(i);
+					                 }
+				                 }
+			                 }
+			                 gSink = static_cast<float>(field->results.size());
+		                 });
+	                 }});
+
+	// 64 か所で近い順に 4 つ探す
+	cases.push_back({"DynamicAABBTree::QueryNearest", [](size_t count) {
+		                 auto field = MakeBoxField(count);
+		                 return std::function<void()>([field]() {
+			                 for (const KamataEngine::Vector3& position : field->queries) {
+				                 field->results.clear();
+				                 field->tree.QueryNearest(position, kNearestCount, 1.0e9f, field->results, [](uint32_t) { return true; });
+			                 }
+			                 gSink = static_cast<float>(field->results.size());
+		                 });
+	                 }});
+	cases.push_back({"BruteForce::QueryNearest", [](size_t count) {
+		                 auto field = MakeBoxField(count);
+		                 auto distances = std::make_shared<std::vector<std::pair<float, uint32_t>>>(count);
+		                 return std::function<void()>([field, distances]() {
+			                 for (const KamataEngine::Vector3& position : field->queries) {
+				                 for (uint32_t i = 0; i < field->boxes.size(); ++i) {
+					                 (*distances)[i] = {DistanceSquaredToAABB(position, field->boxes[i]), i};
+				                 }
+				                 size_t nearest = std::min(kNearestCount, distances->size());
+				                 std::partial_sort(distances->begin(), distances->begin() + nearest, distances->end());
+				                 field->results.clear();
+				                 for (size_t i = 0; i < nearest; ++i) {
+					                 field->results.push_back((*distances)[i].second);
+				                 }
+			                 }
+			                 gSink = static_cast<float>(field->results.size());
+		                 });
+	                 }});
+
+	// 全部の箱を少しずつ動かす (余白からはみ出したものだけ入れ直される)
+	cases.push_back({"DynamicAABBTree::MoveProxy", [](size_t count) {
+		                 auto field = MakeBoxField(count);
+		                 auto random = std::make_shared<Random>(10);
+		                 return std::function<void()>([field, random]() {
+			                 for (size_t i = 0; i < field->boxes.size(); ++i) {
+				                 KamataEngine::Vector3 move = {random->Range(-3.0f, 3.0f), random->Range(-3.0f, 3.0f), random->Range(-3.0f, 3.0f)};
+				                 AABB& box = field->boxes[i];
+				                 box.min = {box.min.x + move.x, box.min.y + move.y, box.min.z + move.z};
+				                 box.max = {box.max.x + move.x, box.max.y + move.y, box.max.z + move.z};
+				                 field->tree.MoveProxy(field->proxies[i], box, move);
+			                 }
+		                 });
+	                 }});
+
+	return cases;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	size_t maxCount = 100000;
+	const char* filter = nullptr;
+	if (argc > 1) {
+		maxCount = static_cast<size_t>(std::strtoull(argv[1], nullptr, 10));
+	}
+	if (argc > 2) {
+		filter = argv[2];
+	}
+
+	const size_t kCounts[] = {10, 100, 1000, 10000, 100000};
+
+	std::printf("%-28s %8s %8s %12s %12s %14s\n", "case", "count", "frames", "ns/entity", "us/frame", "allocs/frame");
+	for (const Case& benchCase : MakeCases()) {
+		if (filter && !std::strstr(benchCase.name, filter)) {
+			continue;
+		}
+
+		bool tooSlow = false;
+		for (size_t count : kCounts) {
+			if (count > maxCount) {
+				break;
+			}
+			if (tooSlow) {
+				std::printf("%-28s %8zu %8s %12s %12s %14s\n", benchCase.name, count, "-", "skipped", "", "");
+				continue;
+			}
+
+			auto setupStart = std::chrono::steady_clock::now();
+			std::function<void()> frame = benchCase.setup(count);
+			double setupSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - setupStart).count();
+
+			// 1回目は確保済みの容量を作るための慣らし
+			auto warmStart = std::chrono::steady_clock::now();
+			frame();
+			double warmSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - warmStart).count();
+
+			int frames = static_cast<int>(kTargetCaseSeconds / (warmSeconds > 1.0e-9 ? warmSeconds : 1.0e-9));
+			if (frames < 1) {
+				frames = 1;
+			}
+			if (frames > 1000) {
+				frames = 1000;
+			}
+
+			uint64_t allocationsBefore = gAllocationCount.load(std::memory_order_relaxed);
+			auto start = std::chrono::steady_clock::now();
+			for (int i = 0; i < frames; ++i) {
+				frame();
+			}
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			uint64_t allocations = gAllocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+
+			double frameSeconds = seconds / frames;
+			std::printf(
+			    "%-28s %8zu %8d %12.2f %12.2f %14.2f\n", benchCase.name, count, frames, frameSeconds * 1.0e9 / static_cast<double>(count), frameSeconds * 1.0e6,
+			    static_cast<double>(allocations) / frames);
+			std::fflush(stdout);
+
+			// 次の数 (10倍) では長くなりすぎるなら打ち切る
+			// 準備が O(n^2) のものもあるので 100 倍で見積もる
+			if (frameSeconds * 10.0 > kMaxFrameSeconds || setupSeconds * 100.0 > kMaxSetupSeconds) {
+				tooSlow = true;
+			}
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,317 @@
+#include "GameWorld.h"
+#include "InstanceBatcher.h"
+#include "InputRecording.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "SnapshotPipeline.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+
+// ウィンドウ無しでゲームプレイのシミュレーションだけを回す
+// 使い方: ShootingHeadless [フレーム数] [乱数シード] [トレース出力先] [オプション]
+//   --record <ファイル> : 回した入力と乱数の種を記録する
+//   --replay <ファイル> : 記録した入力で回し、記録時と同じ状態になったか確かめる
+//   --soak <回数>       : 同じ入力で回数分繰り返し、毎回同じ状態になるか確かめる (長時間テスト用)
+//   --threads <数>      : ジョブシステムのワーカースレッド数 (省略時は使わずに 1 スレッドで回す。結果のハッシュは同じになる)
+//   --pipelined         : 描画側と同じく、前のフレームのスナップショットを詰めている間に次のフレームを裏で進める (結果のハッシュは同じになる)
+// トレースは USE_PROFILER (cmake -DSHOOTING_PROFILER=ON) のときだけ書き出す
+
+namespace {
+
+// 決まった乱数で入力を作る (同じシードなら同じ入力になる)
+class ScriptedInput {
+public:
+	explicit ScriptedInput(uint32_t seed) : state_(seed ? seed : 1u) {}
+
+	uint32_t Next(int frame) {
+		// 30フレームごとに移動方向を変える
+		if (frame % 30 == 0) {
+			moveMask_ = 0;
+			uint32_t r = Rand();
+			if (r & 1u) {
+				moveMask_ |= SimInput::Bit((r & 2u) ? SimKey::A : SimKey::D);
+			}
+			if (r & 4u) {
+				moveMask_ |= SimInput::Bit((r & 8u) ? SimKey::W : SimKey::S);
+			}
+			// たまに回避する
+			if ((r & 0x70u) == 0) {
+				moveMask_ |= SimInput::Bit(SimKey::LShift);
+			}
+		}
+		// 弾は撃ちっぱなし
+		return moveMask_ | SimInput::Bit(SimKey::Space);
+	}
+
+private:
+	uint32_t Rand() {
+		// xorshift32
+		state_ ^= state_ << 13;
+		state_ ^= state_ >> 17;
+		state_ ^= state_ << 5;
+		return state_;
+	}
+
+	uint32_t state_;
+	uint32_t moveMask_ = 0;
+};
+
+
+// 1 回分の実行結果
+struct RunStats {
+	int games = 0;
+	int gameOvers = 0;
+	int clears = 0;
+	int maxScore = 0;
+	int kills = 0;
+	size_t enemiesAlive = 0;
+	size_t maxEnemyBullets = 0;
+	size_t maxMeteorites = 0;
+	// 視錐台カリングで残った (描画する) 隕石の最大数
+	size_t maxVisibleMeteorites = 0;
+	// 弾プールの最大使用数
+	size_t playerBulletHighWater = 0;
+	size_t enemyBulletHighWater = 0;
+	// 描画側と同じく詰めたときの、1 フレームの最大のまとまり数・インスタンス数
+	size_t maxDrawBatches = 0;
+	size_t maxDrawInstances = 0;
+	double totalMs = 0.0;
+	uint64_t stateHash = 0;
+};
+
+// seed から始めて、frame 番目の入力を input から受け取りながら frames フレーム回す
+// pipelined なら、シミュレーション (jobs のスレッド) とスナップショットを詰める処理 (呼び出したスレッド) を 1 フレームずらして同時に回す
+RunStats Run(int frames, uint32_t seed, const std::function<uint32_t(int frame)>& input, JobSystem* jobs, bool pipelined) {
+	GameWorld world;
+	world.Initialize(std::string(SHOOTING_RESOURCE_DIR) + "enemyPop.csv", seed);
+	world.SetJobSystem(jobs);
+
+	enum class Phase { Intro, Game, GameOver };
+	Phase phase = Phase::Intro;
+	world.StartIntro();
+
+	RunStats stats;
+	InstanceBatcher batcher;
+
+	// 1 フレーム分シミュレーションを進め、描画側と同じく毎フレームスナップショットを取る
+	auto simulate = [&](int frame, WorldSnapshot& snapshot) {
+		world.GetInput().SetKeys(input(frame));
+
+		switch (phase) {
+		case Phase::Intro:
+			if (world.UpdateIntro()) {
+				phase = Phase::Game;
+				stats.games++;
+			}
+			break;
+		case Phase::Game:
+			switch (world.UpdateGame()) {
+			case GameWorld::Result::GameOver:
+				stats.gameOvers++;
+				phase = Phase::GameOver;
+				break;
+			case GameWorld::Result::Clear:
+				stats.clears++;
+				world.StartIntro();
+				phase = Phase::Intro;
+				break;
+			case GameWorld::Result::ReturnToTitle:
+				world.StartIntro();
+				phase = Phase::Intro;
+				break;
+			default:
+				break;
+			}
+			break;
+		case Phase::GameOver:
+			if (world.UpdateGameOver()) {
+				world.StartIntro();
+				phase = Phase::Intro;
+			}
+			break;
+		}
+
+		world.BuildSnapshot(snapshot);
+		// スナップショットは見えるものだけなので、数はワールドから取る
+		stats.maxEnemyBullets = std::max(stats.maxEnemyBullets, world.GetEnemyBullets().size());
+		stats.maxMeteorites = std::max(stats.maxMeteorites, world.GetMeteoriteField().GetMeteorites().size());
+	};
+
+	// スナップショットだけを見る (描画側の処理)
+	auto consume = [&](const WorldSnapshot& snapshot) {
+		stats.kills += snapshot.enemiesKilled;
+		if (snapshot.score > stats.maxScore) {
+			stats.maxScore = snapshot.score;
+		}
+		stats.maxVisibleMeteorites = std::max(stats.maxVisibleMeteorites, snapshot.meteorites.size());
+
+		batcher.Clear();
+		batcher.AddSnapshot(snapshot);
+		batcher.Build();
+		stats.maxDrawBatches = std::max(stats.maxDrawBatches, batcher.GetBatches().size());
+		stats.maxDrawInstances = std::max(stats.maxDrawInstances, batcher.GetInstances().size());
+	};
+
+	auto start = std::chrono::steady_clock::now();
+	if (pipelined) {
+		int nextFrame = 0;
+		SnapshotPipeline<WorldSnapshot> pipeline(jobs, [&](WorldSnapshot& snapshot) { simulate(nextFrame, snapshot); });
+		for (int frame = 0; frame < frames; ++frame) {
+			PROFILE_ZONE("Frame");
+			bool hasPrevious = pipeline.Sync();
+			nextFrame = frame;
+			pipeline.Kick();
+			if (hasPrevious) {
+				consume(pipeline.GetFront());
+			}
+		}
+		if (pipeline.Sync()) {
+			consume(pipeline.GetFront());
+		}
+	} else {
+		WorldSnapshot snapshot;
+		for (int frame = 0; frame < frames; ++frame) {
+			PROFILE_ZONE("Frame");
+			simulate(frame, snapshot);
+			consume(snapshot);
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	stats.totalMs = std::chrono::duration<double, std::milli>(end - start).count();
+	stats.enemiesAlive = world.GetEnemies().size();
+	stats.stateHash = world.ComputeStateHash();
+	stats.playerBulletHighWater = world.GetPlayer()->GetBulletPool().GetHighWaterMark();
+	stats.enemyBulletHighWater = world.GetEnemyBulletPool().GetHighWaterMark();
+	return stats;
+}
+
+void PrintStats(int frames, uint32_t seed, const RunStats& stats) {
+	std::printf("frames        : %d (seed %u)\n", frames, seed);
+	std::printf("total         : %.2f ms (%.2f us/frame)\n", stats.totalMs, frames > 0 ? stats.totalMs * 1000.0 / frames : 0.0);
+	std::printf("games         : %d (game over %d, clear %d)\n", stats.games, stats.gameOvers, stats.clears);
+	std::printf("kills         : %d (max score %d)\n", stats.kills, stats.maxScore);
+	std::printf("enemies alive : %zu\n", stats.enemiesAlive);
+	std::printf("max bullets   : %zu enemy bullets\n", stats.maxEnemyBullets);
+	std::printf("max meteorites: %zu (%zu drawn)\n", stats.maxMeteorites, stats.maxVisibleMeteorites);
+	std::printf("bullet pools  : player %zu/%zu, enemy %zu/%zu (high water / capacity)\n", stats.playerBulletHighWater, Player::kMaxBullets, stats.enemyBulletHighWater,
+	            GameWorld::kMaxEnemyBullets);
+	std::printf("draw batches  : %zu (max %zu instances)\n", stats.maxDrawBatches, stats.maxDrawInstances);
+	std::printf("state hash    : %016llx\n", static_cast<unsigned long long>(stats.stateHash));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	int frames = 60 * 60;
+	uint32_t seed = 1;
+	const char* tracePath = nullptr;
+	const char* recordPath = nullptr;
+	const char* replayPath = nullptr;
+	int soakRuns = 0;
+	int threads = -1;
+	bool pipelined = false;
+
+	int position = 0;
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+			recordPath = argv[++i];
+		} else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+			replayPath = argv[++i];
+		} else if (std::strcmp(argv[i], "--soak") == 0 && i + 1 < argc) {
+			soakRuns = std::atoi(argv[++i]);
+		} else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+			threads = std::atoi(argv[++i]);
+		} else if (std::strcmp(argv[i], "--pipelined") == 0) {
+			pipelined = true;
+		} else if (position == 0) {
+			frames = std::atoi(argv[i]);
+			position++;
+		} else if (position == 1) {
+			seed = static_cast<uint32_t>(std::strtoul(argv[i], nullptr, 10));
+			position++;
+		} else {
+			tracePath = argv[i];
+		}
+	}
+
+	// 入力を用意する (再生時は記録したフレーム数と種を使う)
+	InputRecording recording;
+	if (replayPath) {
+		if (!recording.Load(replayPath)) {
+			std::fprintf(stderr, "failed to load replay: %s\n", replayPath);
+			return 1;
+		}
+		frames = static_cast<int>(recording.GetStepCount());
+		seed = recording.GetSeed();
+	} else {
+		recording.Reset(seed);
+		ScriptedInput script(seed);
+		for (int frame = 0; frame < frames; ++frame) {
+			recording.Append(script.Next(frame));
+		}
+	}
+	auto input = [&recording](int frame) { return recording.GetMask(static_cast<size_t>(frame)); };
+
+	std::unique_ptr<JobSystem> jobs;
+	if (threads >= 0) {
+		jobs = std::make_unique<JobSystem>(static_cast<size_t>(threads));
+	}
+
+	RunStats stats = Run(frames, seed, input, jobs.get(), pipelined);
+	PrintStats(frames, seed, stats);
+	if (jobs) {
+		std::printf("job workers   : %zu (+ main thread)\n", jobs->GetWorkerCount());
+	}
+	if (pipelined) {
+		std::printf("pipelined     : simulation and snapshot consumption overlap by one frame\n");
+	}
+
+	int result = 0;
+	if (replayPath && recording.GetFinalHash() != 0) {
+		bool match = recording.GetFinalHash() == stats.stateHash;
+		std::printf("replay        : %s (recorded %016llx)\n", match ? "match" : "MISMATCH", static_cast<unsigned long long>(recording.GetFinalHash()));
+		if (!match) {
+			result = 1;
+		}
+	}
+
+	// 同じ入力で繰り返し、毎回同じ状態で終わるか確かめる
+	for (int run = 0; run < soakRuns; ++run) {
+		RunStats soak = Run(frames, seed, input, jobs.get(), pipelined);
+		bool match = soak.stateHash == stats.stateHash;
+		std::printf("soak %4d     : %.2f us/frame, hash %016llx %s\n", run + 1, frames > 0 ? soak.totalMs * 1000.0 / frames : 0.0, static_cast<unsigned long long>(soak.stateHash), match ? "ok" : "MISMATCH");
+		if (!match) {
+			result = 1;
+		}
+	}
+
+	if (recordPath) {
+		recording.SetFinalHash(stats.stateHash);
+		if (!recording.Save(recordPath)) {
+			std::fprintf(stderr, "failed to write recording: %s\n", recordPath);
+			return 1;
+		}
+		std::printf("recording     : %s\n", recordPath);
+	}
+
+#ifdef USE_PROFILER
+	if (tracePath) {
+		// リングバッファに残っている直近の区間だけが書き出される
+		if (!Profiler::WriteChromeTrace(tracePath)) {
+			std::fprintf(stderr, "failed to write trace: %s\n", tracePath);
+			return 1;
+		}
+		std::printf("trace         : %s\n", tracePath);
+	}
+#else
+	(void)tracePath;
+#endif
+	return result;
+}
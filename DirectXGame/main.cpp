@@ -1,10 +1,13 @@
 #include <KamataEngine.h>
 #include "GaneScene.h"
+#include "Profiler.h"
+#include <sstream>
+#include <string>
 
 using namespace KamataEngine;
 
 // Windowsアプリでのエントリーポイント(main関数)
-int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
+int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR lpCmdLine, int) {
 	WinApp* win = nullptr;
 	DirectXCommon* dxCommon = nullptr;
 	// 汎用機能
@@ -55,6 +58,21 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 
 	// ゲームシーンの初期化
 	gameScene = new GameScene();
+	// 入力の記録と再生
+	//   --record <ファイル> : 乱数の種とステップごとの入力を記録し、終了時に書き出す
+	//   --replay <ファイル> : 記録した入力で同じゲームプレイを再現する
+	std::istringstream args(lpCmdLine ? lpCmdLine : "");
+	std::string arg;
+	while (args >> arg) {
+		std::string path;
+		if (arg == "--record" && args >> path) {
+			gameScene->StartRecording(path);
+		} else if (arg == "--replay" && args >> path) {
+			if (!gameScene->StartReplay(path)) {
+				OutputDebugStringA(("failed to load replay: " + path + "\n").c_str());
+			}
+		}
+	}
 	gameScene->Initialize();
 
 	// メインループ
@@ -86,7 +104,17 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 		// ImGui描画
 		imguiManager->Draw();
 		// 描画終了
-		dxCommon->PostDraw();
+		{
+			PROFILE_ZONE("DirectXCommon::PostDraw");
+			dxCommon->PostDraw();
+		}
+
+#ifdef USE_PROFILER
+		// F12 で直近の計測結果を書き出す (chrome://tracing で開く)
+		if (input->TriggerKey(DIK_F12)) {
+			Profiler::WriteChromeTrace("trace.json");
+		}
+#endif
 	}
 	delete gameScene;
 	// 3Dモデル解放
@@ -0,0 +1,152 @@
+#include "Enemy.h"
+#include "GameWorld.h"
+#include "MT.h"
+#include "Meteorite.h"
+#include "Player.h"
+#include "PlayerBullet.h"
+#include "RailCamera.h"
+#include "SimInput.h"
+#include "TestCheck.h"
+#include <algorithm>
+#include <string>
+
+// GameWorld::CheckAllCollisions の当たり判定を、自機や敵を置き直して確かめる
+
+namespace {
+
+const uint32_t kSeed = 7;
+
+// 導入を終えてゲームを steps ステップ進めたワールドを作る (fire なら弾を撃ち続ける)
+void StartGame(GameWorld& world, int steps, bool fire = false) {
+	world.Initialize(std::string(SHOOTING_RESOURCE_DIR) + "enemyPop.csv", kSeed);
+	world.StartIntro();
+	while (!world.UpdateIntro()) {
+	}
+	for (int i = 0; i < steps; ++i) {
+		world.GetInput().SetKeys(fire ? SimInput::Bit(SimKey::Space) : 0u);
+		world.UpdateGame();
+	}
+}
+
+// ワールド座標の position に敵を出す (動いていないので前のステップの位置も同じ)
+Enemy* SpawnEnemyAt(GameWorld& world, const KamataEngine::Vector3& position) {
+	world.EnemySpawn(position - world.GetRailCamera()->GetWorldTransform().translation_);
+	return world.GetEnemies().back();
+}
+
+// このステップで一番長く動いた、生きている自弾
+PlayerBullet* FindFastestBullet(GameWorld& world) {
+	PlayerBullet* fastest = nullptr;
+	float fastestLength = 0.0f;
+	for (PlayerBullet* bullet : world.GetPlayer()->GetBullets()) {
+		if (!bullet || bullet->IsDead()) {
+			continue;
+		}
+		float length = Length(bullet->GetWorldPosition() - bullet->GetPreviousPosition());
+		if (length > fastestLength) {
+			fastest = bullet;
+			fastestLength = length;
+		}
+	}
+	return fastest;
+}
+
+bool Contains(const std::list<Enemy*>& enemies, const Enemy* enemy) { return std::find(enemies.begin(), enemies.end(), enemy) != enemies.end(); }
+
+// 自機をワールド座標の position に置く (前のステップの位置も同じにして、動いていないことにする)
+void PlacePlayer(Player& player, const KamataEngine::Vector3& position) {
+	SimTransform& transform = player.GetWorldTransform();
+	transform.SetWorldMatrix(MakeTranslateMatrix(position));
+	transform.SavePrevious();
+}
+
+// 自機と重なる隕石に当たると HP が 1 減り、隕石は壊れる
+void TestMeteoriteHitsPlayer() {
+	GameWorld world;
+	StartGame(world, 60);
+	const std::vector<Meteorite*>& meteorites = world.GetMeteoriteField().GetMeteorites();
+	CHECK(!meteorites.empty());
+	if (meteorites.empty()) {
+		return;
+	}
+
+	Meteorite* meteor = meteorites.front();
+	Player& player = *world.GetPlayer();
+	int hp = player.GetHp();
+	PlacePlayer(player, meteor->GetWorldPosition());
+	world.CheckAllCollisions();
+
+	CHECK(player.GetHp() == hp - 1);
+	CHECK(meteor->IsDead());
+}
+
+// どの隕石からも離れていれば当たらない
+void TestMeteoriteMissesPlayer() {
+	GameWorld world;
+	StartGame(world, 60);
+	Player& player = *world.GetPlayer();
+	int hp = player.GetHp();
+	PlacePlayer(player, {1.0e6f, 1.0e6f, 1.0e6f});
+	world.CheckAllCollisions();
+
+	CHECK(player.GetHp() == hp);
+	for (Meteorite* meteor : world.GetMeteoriteField().GetMeteorites()) {
+		CHECK(!meteor->IsDead());
+	}
+}
+
+// 1 ステップで敵を飛び越えた弾も、通った線分が敵と重なれば当たる
+// (ステップの始めと終わりの位置はどちらも敵から当たり判定の距離より離れているので、終わりの位置だけで調べると外れる)
+void TestFastBulletHitsEnemyWithinOneStep() {
+	GameWorld world;
+	StartGame(world, 30, true);
+	PlayerBullet* bullet = FindFastestBullet(world);
+	CHECK(bullet != nullptr);
+	if (!bullet) {
+		return;
+	}
+
+	KamataEngine::Vector3 start = bullet->GetPreviousPosition();
+	KamataEngine::Vector3 end = bullet->GetWorldPosition();
+	KamataEngine::Vector3 middle = (start + end) * 0.5f;
+	// 自弾の見た目の半径 (1.0) で見積もっても、両端は敵に届かない
+	const float kReach = Enemy::kRadius + 1.0f;
+	CHECK(Length(start - middle) > kReach);
+	CHECK(Length(end - middle) > kReach);
+
+	Enemy* enemy = SpawnEnemyAt(world, middle);
+	int hp = enemy->GetHp();
+	world.CheckAllCollisions();
+
+	CHECK(bullet->IsDead());
+	CHECK(Contains(world.GetEnemies(), enemy));
+	CHECK(enemy->GetHp() < hp);
+}
+
+// 通った線分から離れた敵には当たらない
+void TestBulletMissesDistantEnemy() {
+	GameWorld world;
+	StartGame(world, 30, true);
+	PlayerBullet* bullet = FindFastestBullet(world);
+	CHECK(bullet != nullptr);
+	if (!bullet) {
+		return;
+	}
+
+	Enemy* enemy = SpawnEnemyAt(world, bullet->GetWorldPosition() + KamataEngine::Vector3{0.0f, 1.0e5f, 0.0f});
+	int hp = enemy->GetHp();
+	world.CheckAllCollisions();
+
+	CHECK(!bullet->IsDead());
+	CHECK(enemy->GetHp() == hp);
+}
+
+} // namespace
+
+int main() {
+	TestMeteoriteHitsPlayer();
+	TestMeteoriteMissesPlayer();
+	TestFastBulletHitsEnemyWithinOneStep();
+	TestBulletMissesDistantEnemy();
+	return TEST_RESULT();
+}
@@ -0,0 +1,204 @@
+#include "DynamicAABBTree.h"
+#include "MT.h"
+#include "RandomStream.h"
+#include "TestCheck.h"
+#include <algorithm>
+#include <vector>
+
+// DynamicAABBTree に葉の追加・移動・削除をランダムに繰り返し、途中で木の形 (IsValid) と
+// Query / RayCast / QueryNearest の結果を、全部の葉を調べる総当たりと比べる
+
+using KamataEngine::Vector3;
+
+namespace {
+
+const uint64_t kSeed = 11;
+const int kStepCount = 4000;
+const int kCheckInterval = 50;
+const size_t kMaxObjectCount = 300;
+const float kWorldExtent = 100.0f;
+
+struct Object {
+	int32_t proxy = DynamicAABBTree<uint32_t>::kNull;
+	AABB box;
+	bool alive = false;
+};
+
+Vector3 RandomPoint(RandomStream& random) { return {random.Range(-kWorldExtent, kWorldExtent), random.Range(-kWorldExtent, kWorldExtent), random.Range(-kWorldExtent, kWorldExtent)}; }
+
+AABB RandomBox(RandomStream& random, const Vector3& center) { return MakeAABB(center, random.Range(0.5f, 4.0f)); }
+
+Vector3 Center(const AABB& box) { return {(box.min.x + box.max.x) * 0.5f, (box.min.y + box.max.y) * 0.5f, (box.min.z + box.max.z) * 0.5f}; }
+
+// --- 木への操作 ---
+
+void Create(DynamicAABBTree<uint32_t>& tree, std::vector<Object>& objects, RandomStream& random) {
+	Object object;
+	object.box = RandomBox(random, RandomPoint(random));
+	object.proxy = tree.CreateProxy(object.box, static_cast<uint32_t>(objects.size()));
+	object.alive = true;
+	objects.push_back(object);
+}
+
+// 生きている物をランダムに 1 つ選ぶ (いなければ nullptr)
+Object* PickAlive(std::vector<Object>& objects, RandomStream& random) {
+	std::vector<Object*> alive;
+	for (Object& object : objects) {
+		if (object.alive) {
+			alive.push_back(&object);
+		}
+	}
+	return alive.empty() ? nullptr : alive[random.NextBelow(static_cast<uint32_t>(alive.size()))];
+}
+
+// 少しずつ動かすのが普通で、たまに遠くへ飛ばす (fat AABB からはみ出して入れ直す場合を両方通す)
+void Move(DynamicAABBTree<uint32_t>& tree, Object& object, RandomStream& random) {
+	Vector3 center = Center(object.box);
+	Vector3 displacement;
+	if (random.NextBelow(8) == 0) {
+		displacement = RandomPoint(random) - center;
+	} else {
+		displacement = {random.Range(-3.0f, 3.0f), random.Range(-3.0f, 3.0f), random.Range(-3.0f, 3.0f)};
+	}
+	object.box = RandomBox(random, center + displacement);
+	tree.MoveProxy(object.proxy, object.box, displacement);
+}
+
+void Destroy(DynamicAABBTree<uint32_t>& tree, Object& object) {
+	tree.DestroyProxy(object.proxy);
+	object.alive = false;
+	object.proxy = DynamicAABBTree<uint32_t>::kNull;
+}
+
+// --- 総当たりとの比較 ---
+
+void CheckQuery(const DynamicAABBTree<uint32_t>& tree, const std::vector<Object>& objects, RandomStream& random) {
+	AABB box = MakeAABB(RandomPoint(random), random.Range(5.0f, 40.0f));
+	std::vector<uint32_t> found;
+	tree.Query(box, [&found](uint32_t id) {
+		found.push_back(id);
+		return true;
+	});
+	std::vector<uint32_t> expected;
+	for (uint32_t id = 0; id < objects.size(); ++id) {
+		if (objects[id].alive && IsCollisionAABB(tree.GetFatAABB(objects[id].proxy), box)) {
+			expected.push_back(id);
+		}
+	}
+	std::sort(found.begin(), found.end());
+	CHECK(found == expected);
+}
+
+void CheckRayCast(const DynamicAABBTree<uint32_t>& tree, const std::vector<Object>& objects, RandomStream& random) {
+	Vector3 origin = RandomPoint(random);
+	Vector3 direction = random.UnitVector();
+	const float maxDistance = 150.0f;
+
+	// maxDistance を返し続けると、交わる葉が全部来る
+	std::vector<std::pair<uint32_t, float>> found;
+	tree.RayCast(origin, direction, maxDistance, [&found, maxDistance](uint32_t id, float distance) {
+		found.push_back({id, distance});
+		return maxDistance;
+	});
+	std::vector<std::pair<uint32_t, float>> expected;
+	float nearestExpected = maxDistance + 1.0f;
+	for (uint32_t id = 0; id < objects.size(); ++id) {
+		float distance = 0.0f;
+		if (objects[id].alive && RayIntersectsAABB(origin, direction, maxDistance, tree.GetFatAABB(objects[id].proxy), distance)) {
+			expected.push_back({id, distance});
+			nearestExpected = std::min(nearestExpected, distance);
+		}
+	}
+	std::sort(found.begin(), found.end());
+	CHECK(found == expected);
+
+	// 当たった距離を返すと、探索が縮んでいっても一番近いものは必ず来る
+	float nearest = maxDistance + 1.0f;
+	tree.RayCast(origin, direction, maxDistance, [&nearest](uint32_t, float distance) {
+		nearest = std::min(nearest, distance);
+		return distance;
+	});
+	CHECK(nearest == nearestExpected);
+}
+
+void CheckQueryNearest(const DynamicAABBTree<uint32_t>& tree, const std::vector<Object>& objects, RandomStream& random) {
+	Vector3 point = RandomPoint(random);
+	const size_t count = 5;
+	const float maxDistance = 60.0f;
+	auto filter = [](uint32_t id) { return id % 3 != 0; };
+
+	std::vector<uint32_t> found;
+	tree.QueryNearest(point, count, maxDistance, found, filter);
+
+	std::vector<float> expected;
+	for (uint32_t id = 0; id < objects.size(); ++id) {
+		if (!objects[id].alive || !filter(id)) {
+			continue;
+		}
+		float distanceSq = DistanceSquaredToAABB(point, objects[id].box);
+		if (distanceSq <= maxDistance * maxDistance) {
+			expected.push_back(distanceSq);
+		}
+	}
+	std::sort(expected.begin(), expected.end());
+	expected.resize(std::min(expected.size(), count));
+
+	// 同じ距離の物は順番が決まらないので、距離の並びで比べる
+	CHECK(found.size() == expected.size());
+	for (size_t i = 0; i < found.size() && i < expected.size(); ++i) {
+		CHECK(objects[found[i]].alive && filter(found[i]));
+		CHECK(DistanceSquaredToAABB(point, objects[found[i]].box) == expected[i]);
+	}
+}
+
+void TestRandomOperationsMatchBruteForce() {
+	RandomStream random(kSeed, 0);
+	DynamicAABBTree<uint32_t> tree(2.0f);
+	std::vector<Object> objects;
+	size_t aliveCount = 0;
+
+	for (int step = 1; step <= kStepCount; ++step) {
+		uint32_t operation = random.NextBelow(10);
+		if (operation < 4) {
+			if (aliveCount < kMaxObjectCount) {
+				Create(tree, objects, random);
+				aliveCount++;
+			}
+		} else if (operation < 8) {
+			if (Object* object = PickAlive(objects, random)) {
+				Move(tree, *object, random);
+			}
+		} else {
+			if (Object* object = PickAlive(objects, random)) {
+				Destroy(tree, *object);
+				aliveCount--;
+			}
+		}
+
+		if (step % kCheckInterval != 0) {
+			continue;
+		}
+		CHECK(tree.IsValid());
+		CHECK(tree.GetProxyCount() == aliveCount);
+		CheckQuery(tree, objects, random);
+		CheckRayCast(tree, objects, random);
+		CheckQueryNearest(tree, objects, random);
+	}
+
+	// 全部消したら空の木に戻る
+	for (Object& object : objects) {
+		if (object.alive) {
+			Destroy(tree, object);
+		}
+	}
+	CHECK(tree.IsValid());
+	CHECK(tree.GetProxyCount() == 0);
+	CHECK(tree.GetHeight() == -1);
+}
+
+} // namespace
+
+int main() {
+	TestRandomOperationsMatchBruteForce();
+	return TEST_RESULT();
+}
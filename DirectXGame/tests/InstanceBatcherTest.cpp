@@ -0,0 +1,171 @@
+#include "InstanceBatcher.h"
+#include "Particle.h"
+#include "TestCheck.h"
+#include "WorldSnapshot.h"
+#include <cstddef>
+#include <vector>
+
+// InstanceBatcher が 層 → モデル の順に並べ、まとまりの範囲とインスタンスの中身を保つかを確かめる
+// (モデルごとにテクスチャは 1 枚なので、モデルの順に並べればテクスチャの切り替えもまとまる)
+
+using KamataEngine::Matrix4x4;
+using KamataEngine::Vector4;
+
+namespace {
+
+// 見分けがつくように、平行移動に番号を入れた行列
+Matrix4x4 Tagged(float tag) {
+	Matrix4x4 m = {};
+	m.m[0][0] = 1.0f;
+	m.m[1][1] = 1.0f;
+	m.m[2][2] = 1.0f;
+	m.m[3][0] = tag;
+	m.m[3][3] = 1.0f;
+	return m;
+}
+
+float TagOf(const InstanceData& instance) { return instance.world.m[3][0]; }
+
+bool SameColor(const Vector4& a, const Vector4& b) { return a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w; }
+
+// まとまりが隙間なく、重ならずに全インスタンスを覆い、層 → モデル の順に並んでいるか
+void CheckBatchLayout(const InstanceBatcher& batcher) {
+	const std::vector<InstanceBatch>& batches = batcher.GetBatches();
+	uint32_t next = 0;
+	for (size_t i = 0; i < batches.size(); ++i) {
+		CHECK(batches[i].first == next);
+		CHECK(batches[i].count > 0);
+		next += batches[i].count;
+		if (i > 0) {
+			bool ordered = batches[i - 1].layer < batches[i].layer || (batches[i - 1].layer == batches[i].layer && batches[i - 1].model < batches[i].model);
+			CHECK(ordered);
+		}
+	}
+	CHECK(next == batcher.GetInstances().size());
+}
+
+// 追加の順番を混ぜても 層 → モデル の順になり、同じまとまりの中は追加順のまま
+void TestMixedInputIsGrouped() {
+	InstanceBatcher batcher;
+	const Vector4 red = {1.0f, 0.0f, 0.0f, 1.0f};
+	batcher.Add(DrawLayer::Enemy, DrawModel::Meteorite, Tagged(1.0f));
+	batcher.Add(DrawLayer::Player, DrawModel::PlayerBullet, Tagged(2.0f), red);
+	batcher.Add(DrawLayer::Enemy, DrawModel::Enemy, Tagged(3.0f));
+	batcher.Add(DrawLayer::Enemy, DrawModel::Meteorite, Tagged(4.0f));
+	batcher.Add(DrawLayer::Player, DrawModel::Player, Tagged(5.0f));
+	batcher.Add(DrawLayer::Player, DrawModel::PlayerBullet, Tagged(6.0f));
+	batcher.Add(DrawLayer::Enemy, DrawModel::Enemy, Tagged(7.0f));
+	batcher.Add(DrawLayer::Explosion, DrawModel::Particle, Tagged(8.0f));
+	batcher.Build();
+
+	CheckBatchLayout(batcher);
+
+	struct Expected {
+		DrawLayer layer;
+		DrawModel model;
+		uint32_t first;
+		uint32_t count;
+	};
+	const Expected expected[] = {
+	    {DrawLayer::Player, DrawModel::Player, 0, 1},
+	    {DrawLayer::Player, DrawModel::PlayerBullet, 1, 2},
+	    {DrawLayer::Explosion, DrawModel::Particle, 3, 1},
+	    {DrawLayer::Enemy, DrawModel::Enemy, 4, 2},
+	    {DrawLayer::Enemy, DrawModel::Meteorite, 6, 2},
+	};
+	const std::vector<InstanceBatch>& batches = batcher.GetBatches();
+	CHECK(batches.size() == sizeof(expected) / sizeof(expected[0]));
+	for (size_t i = 0; i < batches.size() && i < sizeof(expected) / sizeof(expected[0]); ++i) {
+		CHECK(batches[i].layer == expected[i].layer);
+		CHECK(batches[i].model == expected[i].model);
+		CHECK(batches[i].first == expected[i].first);
+		CHECK(batches[i].count == expected[i].count);
+	}
+
+	const float expectedTags[] = {5.0f, 2.0f, 6.0f, 8.0f, 3.0f, 7.0f, 1.0f, 4.0f};
+	const std::vector<InstanceData>& instances = batcher.GetInstances();
+	CHECK(instances.size() == sizeof(expectedTags) / sizeof(expectedTags[0]));
+	for (size_t i = 0; i < instances.size() && i < sizeof(expectedTags) / sizeof(expectedTags[0]); ++i) {
+		CHECK(TagOf(instances[i]) == expectedTags[i]);
+	}
+	// 色はインスタンスと一緒に動く
+	CHECK(SameColor(instances[1].color, red));
+	CHECK(SameColor(instances[2].color, {1.0f, 1.0f, 1.0f, 1.0f}));
+}
+
+// パーティクルは 位置・大きさ の行列と色になる
+void TestParticlesBecomeScaledTranslations() {
+	InstanceBatcher batcher;
+	std::vector<ParticleInstance> particles(2);
+	particles[0].position = {1.0f, 2.0f, 3.0f};
+	particles[0].scale = 0.5f;
+	particles[0].color = {0.25f, 0.5f, 0.75f, 1.0f};
+	particles[1].position = {-4.0f, 5.0f, -6.0f};
+	particles[1].scale = 2.0f;
+	batcher.AddParticles(DrawLayer::Player, DrawModel::Particle, particles);
+	batcher.Build();
+
+	const std::vector<InstanceData>& instances = batcher.GetInstances();
+	CHECK(instances.size() == 2);
+	if (instances.size() != 2) {
+		return;
+	}
+	for (size_t i = 0; i < 2; ++i) {
+		const Matrix4x4& world = instances[i].world;
+		float s = particles[i].scale;
+		CHECK(world.m[0][0] == s && world.m[1][1] == s && world.m[2][2] == s && world.m[3][3] == 1.0f);
+		CHECK(world.m[0][1] == 0.0f && world.m[1][0] == 0.0f && world.m[2][0] == 0.0f && world.m[0][3] == 0.0f);
+		CHECK(world.m[3][0] == particles[i].position.x && world.m[3][1] == particles[i].position.y && world.m[3][2] == particles[i].position.z);
+		CHECK(SameColor(instances[i].color, particles[i].color));
+	}
+}
+
+// スナップショットからは、空でないモデルだけがまとまりになる
+void TestSnapshotSkipsEmptyGroups() {
+	WorldSnapshot snapshot;
+	snapshot.playerMatrix = Tagged(1.0f);
+	snapshot.enemies = {Tagged(2.0f), Tagged(3.0f)};
+	snapshot.meteorites = {Tagged(4.0f)};
+	snapshot.explosionParticles.resize(3);
+
+	InstanceBatcher batcher;
+	batcher.AddSnapshot(snapshot);
+	batcher.Build();
+
+	CheckBatchLayout(batcher);
+	const std::vector<InstanceBatch>& batches = batcher.GetBatches();
+	CHECK(batches.size() == 4);
+	if (batches.size() == 4) {
+		CHECK(batches[0].model == DrawModel::Player && batches[0].count == 1);
+		CHECK(batches[1].layer == DrawLayer::Explosion && batches[1].model == DrawModel::Particle && batches[1].count == 3);
+		CHECK(batches[2].model == DrawModel::Enemy && batches[2].count == 2);
+		CHECK(batches[3].model == DrawModel::Meteorite && batches[3].count == 1);
+	}
+}
+
+// Clear のあとは前のフレームの分が残らない
+void TestClearStartsOver() {
+	InstanceBatcher batcher;
+	batcher.Add(DrawLayer::Enemy, DrawModel::Enemy, Tagged(1.0f));
+	batcher.Add(DrawLayer::Player, DrawModel::Player, Tagged(2.0f));
+	batcher.Build();
+	batcher.Clear();
+	CHECK(batcher.GetBatches().empty());
+	CHECK(batcher.GetInstances().empty());
+
+	batcher.Add(DrawLayer::Enemy, DrawModel::EnemyBullet, Tagged(3.0f));
+	batcher.Build();
+	CheckBatchLayout(batcher);
+	CHECK(batcher.GetBatches().size() == 1);
+	CHECK(batcher.GetInstances().size() == 1 && TagOf(batcher.GetInstances()[0]) == 3.0f);
+}
+
+} // namespace
+
+int main() {
+	TestMixedInputIsGrouped();
+	TestParticlesBecomeScaledTranslations();
+	TestSnapshotSkipsEmptyGroups();
+	TestClearStartsOver();
+	return TEST_RESULT();
+}
@@ -0,0 +1,204 @@
+#include "JobSystem.h"
+#include "TestCheck.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// JobSystem の ParallelFor の範囲の分け方、入れ子の ParallelFor、キューがあふれたとき、止めるときに残ったジョブを確かめる
+
+namespace {
+
+// [0, count) の各番号が何回処理されたか
+class Coverage {
+public:
+	explicit Coverage(size_t count) : hits_(new std::atomic<int>[count]), count_(count) {
+		for (size_t i = 0; i < count; ++i) {
+			hits_[i] = 0;
+		}
+	}
+
+	void Mark(size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			hits_[i]++;
+		}
+	}
+
+	bool IsExactlyOnce() const {
+		for (size_t i = 0; i < count_; ++i) {
+			if (hits_[i] != 1) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+private:
+	std::unique_ptr<std::atomic<int>[]> hits_;
+	size_t count_;
+};
+
+// ワーカーの数によらず、[0, count) をちょうど 1 回ずつ処理する
+void TestParallelForCoversRangeOnce() {
+	const size_t kWorkerCounts[] = {0, 1, 3};
+	const size_t kCounts[] = {0, 1, 7, 64, 1000};
+	const size_t kGrains[] = {0, 1, 16, 64};
+	for (size_t workers : kWorkerCounts) {
+		JobSystem jobs(workers);
+		CHECK(jobs.GetWorkerCount() == workers);
+		for (size_t count : kCounts) {
+			for (size_t grain : kGrains) {
+				Coverage coverage(count);
+				jobs.ParallelFor(count, grain, [&coverage](size_t begin, size_t end) { coverage.Mark(begin, end); });
+				CHECK(coverage.IsExactlyOnce());
+
+				// jobs が null でも同じ
+				Coverage serial(count);
+				ParallelFor(nullptr, count, grain, [&serial](size_t begin, size_t end) { serial.Mark(begin, end); });
+				CHECK(serial.IsExactlyOnce());
+			}
+		}
+	}
+}
+
+// 入れ子の ParallelFor の外側と内側の数
+const size_t kOuter = 16;
+const size_t kInner = 500;
+
+// ジョブの中から ParallelFor を呼んでも終わる (待つ間は他のジョブを手伝う)
+void TestNestedParallelForCompletes() {
+	for (size_t workers : {size_t(0), size_t(1), size_t(3)}) {
+		JobSystem jobs(workers);
+		Coverage coverage(kOuter * kInner);
+		jobs.ParallelFor(kOuter, 1, [&](size_t begin, size_t end) {
+			for (size_t outer = begin; outer < end; ++outer) {
+				jobs.ParallelFor(kInner, 25, [&coverage, outer](size_t innerBegin, size_t innerEnd) { coverage.Mark(outer * kInner + innerBegin, outer * kInner + innerEnd); });
+			}
+		});
+		CHECK(coverage.IsExactlyOnce());
+	}
+}
+
+// ワーカーを 1 本だけ止めておくためのジョブ
+struct Blocker {
+	std::atomic<bool> started{false};
+	std::atomic<bool> release{false};
+
+	static void Run(void* data, size_t, size_t) {
+		Blocker& blocker = *static_cast<Blocker*>(data);
+		blocker.started = true;
+		while (!blocker.release.load()) {
+			std::this_thread::yield();
+		}
+	}
+};
+
+// 実行した回数と、呼び出したスレッドで実行したか
+struct Probe {
+	std::atomic<int> runs{0};
+	std::thread::id thread;
+
+	static void Run(void* data, size_t, size_t) {
+		Probe& probe = *static_cast<Probe*>(data);
+		probe.thread = std::this_thread::get_id();
+		probe.runs++;
+	}
+};
+
+// ワーカーが Blocker を実行し始めるまで待つ (止めている間、積んだジョブは誰も取らない)
+void StartBlocker(JobSystem& jobs, Blocker& blocker, JobSystem::Counter& counter) {
+	JobSystem::Job job;
+	job.function = &Blocker::Run;
+	job.data = &blocker;
+	job.counter = &counter;
+	jobs.Run(job);
+	while (!blocker.started.load()) {
+		std::this_thread::yield();
+	}
+}
+
+void RunProbe(JobSystem& jobs, Probe& probe, JobSystem::Counter& counter) {
+	JobSystem::Job job;
+	job.function = &Probe::Run;
+	job.data = &probe;
+	job.counter = &counter;
+	jobs.Run(job);
+}
+
+// キューが kQueueCapacity 個で埋まったら、それ以上は Run の中で実行する
+void TestOverflowRunsInline() {
+	JobSystem jobs(1);
+	Blocker blocker;
+	JobSystem::Counter counter;
+	StartBlocker(jobs, blocker, counter);
+
+	std::vector<Probe> queued(JobSystem::kQueueCapacity);
+	for (Probe& probe : queued) {
+		RunProbe(jobs, probe, counter);
+	}
+	// 全部積めているので、まだどれも実行されていない
+	int ranEarly = 0;
+	for (const Probe& probe : queued) {
+		ranEarly += probe.runs;
+	}
+	CHECK(ranEarly == 0);
+
+	Probe overflow;
+	RunProbe(jobs, overflow, counter);
+	CHECK(overflow.runs == 1);
+	CHECK(overflow.thread == std::this_thread::get_id());
+
+	blocker.release = true;
+	jobs.Wait(counter);
+	CHECK(counter.value == 0);
+	for (const Probe& probe : queued) {
+		CHECK(probe.runs == 1);
+	}
+}
+
+// 止めるときに積まれたままのジョブも実行し、Counter は 0 になる
+void TestDestructorDrainsQueue() {
+	const size_t kJobs = 200;
+	std::vector<Probe> probes(kJobs);
+	JobSystem::Counter counter;
+	{
+		JobSystem jobs(1);
+		Blocker blocker;
+		StartBlocker(jobs, blocker, counter);
+		for (Probe& probe : probes) {
+			RunProbe(jobs, probe, counter);
+		}
+		blocker.release = true;
+	}
+	CHECK(counter.value == 0);
+	for (const Probe& probe : probes) {
+		CHECK(probe.runs == 1);
+	}
+
+	// 寝ているワーカーを起こした直後に止めても、積んだジョブは実行される
+	int dropped = 0;
+	for (int i = 0; i < 200; ++i) {
+		Probe probe;
+		JobSystem::Counter single;
+		{
+			JobSystem jobs(1);
+			std::this_thread::sleep_for(std::chrono::microseconds(200));
+			RunProbe(jobs, probe, single);
+		}
+		if (probe.runs != 1 || single.value != 0) {
+			dropped++;
+		}
+	}
+	CHECK(dropped == 0);
+}
+
+} // namespace
+
+int main() {
+	TestParallelForCoversRangeOnce();
+	TestNestedParallelForCompletes();
+	TestOverflowRunsInline();
+	TestDestructorDrainsQueue();
+	return TEST_RESULT();
+}
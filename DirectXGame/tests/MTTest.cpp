@@ -0,0 +1,244 @@
+#include "MT.h"
+#include "TestCheck.h"
+#include <cmath>
+
+// MT の行列演算 (x64 では SSE2) を、教科書どおりのスカラーの計算と比べる
+// 単位行列・拡大率 0・正規直交でない (せん断のある) 行列を含める
+
+using KamataEngine::Matrix4x4;
+using KamataEngine::Vector3;
+
+namespace {
+
+const float kTolerance = 1e-4f;
+
+// --- スカラーの参照実装 ---
+
+Matrix4x4 ReferenceMultiply(const Matrix4x4& a, const Matrix4x4& b) {
+	Matrix4x4 result = {};
+	for (int i = 0; i < 4; ++i) {
+		for (int j = 0; j < 4; ++j) {
+			double sum = 0.0;
+			for (int k = 0; k < 4; ++k) {
+				sum += static_cast<double>(a.m[i][k]) * b.m[k][j];
+			}
+			result.m[i][j] = static_cast<float>(sum);
+		}
+	}
+	return result;
+}
+
+// 行ベクトル (x, y, z, w) × 行列
+void ReferenceTransform4(const float in[4], const Matrix4x4& m, double out[4]) {
+	for (int j = 0; j < 4; ++j) {
+		out[j] = 0.0;
+		for (int k = 0; k < 4; ++k) {
+			out[j] += static_cast<double>(in[k]) * m.m[k][j];
+		}
+	}
+}
+
+Vector3 ReferenceTransform(const Vector3& v, const Matrix4x4& m) {
+	float in[4] = {v.x, v.y, v.z, 1.0f};
+	double out[4];
+	ReferenceTransform4(in, m, out);
+	return {static_cast<float>(out[0] / out[3]), static_cast<float>(out[1] / out[3]), static_cast<float>(out[2] / out[3])};
+}
+
+double ReferenceW(const Vector3& v, const Matrix4x4& m) {
+	float in[4] = {v.x, v.y, v.z, 1.0f};
+	double out[4];
+	ReferenceTransform4(in, m, out);
+	return out[3];
+}
+
+Vector3 ReferenceTransformNormal(const Vector3& v, const Matrix4x4& m) {
+	float in[4] = {v.x, v.y, v.z, 0.0f};
+	double out[4];
+	ReferenceTransform4(in, m, out);
+	return {static_cast<float>(out[0]), static_cast<float>(out[1]), static_cast<float>(out[2])};
+}
+
+Matrix4x4 Identity() {
+	Matrix4x4 m = {};
+	for (int i = 0; i < 4; ++i) {
+		m.m[i][i] = 1.0f;
+	}
+	return m;
+}
+
+Matrix4x4 ReferenceScale(const Vector3& s) {
+	Matrix4x4 m = Identity();
+	m.m[0][0] = s.x;
+	m.m[1][1] = s.y;
+	m.m[2][2] = s.z;
+	return m;
+}
+
+// X → Y → Z の順に回す (MakeRotateXMatrix などと同じ向き)
+Matrix4x4 ReferenceRotate(const Vector3& r) {
+	Matrix4x4 x = Identity();
+	x.m[1][1] = std::cos(r.x);
+	x.m[1][2] = std::sin(r.x);
+	x.m[2][1] = -std::sin(r.x);
+	x.m[2][2] = std::cos(r.x);
+	Matrix4x4 y = Identity();
+	y.m[0][0] = std::cos(r.y);
+	y.m[0][2] = -std::sin(r.y);
+	y.m[2][0] = std::sin(r.y);
+	y.m[2][2] = std::cos(r.y);
+	Matrix4x4 z = Identity();
+	z.m[0][0] = std::cos(r.z);
+	z.m[0][1] = std::sin(r.z);
+	z.m[1][0] = -std::sin(r.z);
+	z.m[1][1] = std::cos(r.z);
+	return ReferenceMultiply(x, ReferenceMultiply(y, z));
+}
+
+Matrix4x4 ReferenceAffine(const Vector3& s, const Vector3& r, const Vector3& t) {
+	Matrix4x4 translate = Identity();
+	translate.m[3][0] = t.x;
+	translate.m[3][1] = t.y;
+	translate.m[3][2] = t.z;
+	return ReferenceMultiply(ReferenceScale(s), ReferenceMultiply(ReferenceRotate(r), translate));
+}
+
+// --- 比べる ---
+
+void CheckMatrixNear(const Matrix4x4& actual, const Matrix4x4& expected) {
+	for (int i = 0; i < 4; ++i) {
+		for (int j = 0; j < 4; ++j) {
+			CHECK_NEAR(actual.m[i][j], expected.m[i][j], kTolerance * (1.0f + std::abs(expected.m[i][j])));
+		}
+	}
+}
+
+void CheckVectorNear(const Vector3& actual, const Vector3& expected) {
+	CHECK_NEAR(actual.x, expected.x, kTolerance * (1.0f + std::abs(expected.x)));
+	CHECK_NEAR(actual.y, expected.y, kTolerance * (1.0f + std::abs(expected.y)));
+	CHECK_NEAR(actual.z, expected.z, kTolerance * (1.0f + std::abs(expected.z)));
+}
+
+// 行ごとにせん断と平行移動が入った、正規直交でない行列
+Matrix4x4 Skewed() {
+	Matrix4x4 m = {};
+	const float values[4][4] = {
+	    {2.0f, 0.5f, -0.25f, 0.0f},
+	    {0.3f, 1.5f, 0.75f, 0.0f},
+	    {-0.6f, 0.2f, 0.8f, 0.0f},
+	    {12.0f, -4.0f, 7.5f, 1.0f},
+	};
+	for (int i = 0; i < 4; ++i) {
+		for (int j = 0; j < 4; ++j) {
+			m.m[i][j] = values[i][j];
+		}
+	}
+	return m;
+}
+
+const Vector3 kPoints[] = {
+	{0.0f, 0.0f, 0.0f},
+	{1.0f, -2.0f, 3.0f},
+	{-50.0f, 12.5f, 800.0f},
+};
+
+void TestMultiply() {
+	Matrix4x4 identity = Identity();
+	Matrix4x4 skewed = Skewed();
+	Matrix4x4 zeroScale = ReferenceAffine({0.0f, 0.0f, 0.0f}, {0.3f, -1.2f, 2.0f}, {5.0f, 6.0f, 7.0f});
+	Matrix4x4 perspective = MakePerspectiveMatrix(0.45f, 16.0f / 9.0f, 0.1f, 1000.0f);
+
+	CheckMatrixNear(Multiply(identity, identity), identity);
+	CheckMatrixNear(Multiply(identity, skewed), skewed);
+	CheckMatrixNear(Multiply(skewed, identity), skewed);
+	CheckMatrixNear(Multiply(skewed, perspective), ReferenceMultiply(skewed, perspective));
+	CheckMatrixNear(Multiply(perspective, skewed), ReferenceMultiply(perspective, skewed));
+	CheckMatrixNear(Multiply(zeroScale, skewed), ReferenceMultiply(zeroScale, skewed));
+	CheckMatrixNear(Multiply(skewed, zeroScale), ReferenceMultiply(skewed, zeroScale));
+}
+
+void TestMakeAffineMatrix() {
+	const Vector3 kScales[] = {
+	    {1.0f, 1.0f, 1.0f},
+	    {0.0f, 0.0f, 0.0f},
+	    {2.0f, 0.5f, -3.0f},
+	    {0.0f, 1.0f, 4.0f},
+	};
+	const Vector3 kRotations[] = {
+	    {0.0f, 0.0f, 0.0f},
+	    {0.3f, -1.2f, 2.0f},
+	    {3.14159265f, 0.5f, -0.7f},
+	};
+	const Vector3 translate = {-20.0f, 3.5f, 100.0f};
+	for (const Vector3& scale : kScales) {
+		for (const Vector3& rotate : kRotations) {
+			CheckMatrixNear(MakeAffineMatrix(scale, rotate, translate), ReferenceAffine(scale, rotate, translate));
+		}
+	}
+	// 拡大 1・回転 0・移動 0 は単位行列
+	CheckMatrixNear(MakeAffineMatrix({1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}), Identity());
+}
+
+void TestTransform() {
+	Matrix4x4 matrices[] = {
+	    Identity(),
+	    Skewed(),
+	    ReferenceAffine({0.0f, 0.0f, 0.0f}, {0.3f, -1.2f, 2.0f}, {5.0f, 6.0f, 7.0f}),
+	    ReferenceMultiply(Skewed(), MakePerspectiveMatrix(0.45f, 16.0f / 9.0f, 0.1f, 1000.0f)),
+	};
+	for (const Matrix4x4& m : matrices) {
+		for (const Vector3& p : kPoints) {
+			// 透視の行列で w が 0 に近い点は使わない
+			if (std::abs(ReferenceW(p, m)) < 1e-3) {
+				continue;
+			}
+			CheckVectorNear(Transform(p, m), ReferenceTransform(p, m));
+			CheckVectorNear(TransformNormal(p, m), ReferenceTransformNormal(p, m));
+		}
+	}
+	// 単位行列はそのまま
+	CheckVectorNear(Transform(kPoints[1], Identity()), kPoints[1]);
+	// 拡大率 0 なら平行移動だけが残る
+	CheckVectorNear(Transform(kPoints[2], ReferenceAffine({0.0f, 0.0f, 0.0f}, {0.3f, -1.2f, 2.0f}, {5.0f, 6.0f, 7.0f})), {5.0f, 6.0f, 7.0f});
+}
+
+void TestInverse() {
+	Matrix4x4 identity = Identity();
+	CheckMatrixNear(Inverse(identity), identity);
+
+	// 正規直交でない行列: 掛けると単位行列に戻る
+	Matrix4x4 skewed = Skewed();
+	CheckMatrixNear(ReferenceMultiply(skewed, Inverse(skewed)), identity);
+	CheckMatrixNear(ReferenceMultiply(Inverse(skewed), skewed), identity);
+
+	// 回転と平行移動だけなら InverseRigid と Inverse は同じ
+	Matrix4x4 rigid = ReferenceAffine({1.0f, 1.0f, 1.0f}, {0.3f, -1.2f, 2.0f}, {-20.0f, 3.5f, 100.0f});
+	CheckMatrixNear(InverseRigid(rigid), Inverse(rigid));
+	CheckMatrixNear(ReferenceMultiply(rigid, InverseRigid(rigid)), identity);
+	CheckMatrixNear(InverseRigid(identity), identity);
+}
+
+void TestLerpMatrix() {
+	Matrix4x4 a = Skewed();
+	Matrix4x4 b = ReferenceAffine({2.0f, 0.5f, -3.0f}, {0.3f, -1.2f, 2.0f}, {5.0f, 6.0f, 7.0f});
+	CheckMatrixNear(LerpMatrix(a, b, 0.0f), a);
+	CheckMatrixNear(LerpMatrix(a, b, 1.0f), b);
+	Matrix4x4 half = {};
+	for (int i = 0; i < 4; ++i) {
+		for (int j = 0; j < 4; ++j) {
+			half.m[i][j] = (a.m[i][j] + b.m[i][j]) * 0.5f;
+		}
+	}
+	CheckMatrixNear(LerpMatrix(a, b, 0.5f), half);
+}
+
+} // namespace
+
+int main() {
+	TestMultiply();
+	TestMakeAffineMatrix();
+	TestTransform();
+	TestInverse();
+	TestLerpMatrix();
+	return TEST_RESULT();
+}
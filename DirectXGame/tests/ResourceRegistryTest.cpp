@@ -0,0 +1,117 @@
+#include "ResourceRegistry.h"
+#include "TestCheck.h"
+
+// ResourceRegistry の共有・参照カウントと、読み込み中に Release / Acquire されたときの振る舞いを確かめる
+// リソースは int で、destroy が呼ばれた回数と値を数える
+
+namespace {
+
+int destroyCount = 0;
+int lastDestroyed = 0;
+
+void CountDestroy(int& resource) {
+	destroyCount++;
+	lastDestroyed = resource;
+}
+
+void ResetDestroyCount() {
+	destroyCount = 0;
+	lastDestroyed = 0;
+}
+
+// 2 回目からの Acquire は読み込まずに同じものを共有し、最後の Release で 1 回だけ消える
+void TestShareAndRelease() {
+	ResetDestroyCount();
+	ResourceRegistry<int> registry(CountDestroy);
+	int first = 0;
+	int second = 0;
+	CHECK(registry.Acquire("a", [&first](const int& value) { first = value; }));
+	registry.Store("a", 5, 0.5, 100);
+	CHECK(first == 5);
+	CHECK(!registry.Acquire("a", [&second](const int& value) { second = value; }));
+	CHECK(second == 5);
+	CHECK(registry.GetReferenceCount("a") == 2);
+	CHECK(registry.GetStats().loadCount == 1);
+	CHECK(registry.GetStats().shareCount == 1);
+	CHECK(registry.GetStats().bytes == 100);
+
+	registry.Release("a");
+	CHECK(destroyCount == 0);
+	registry.Release("a");
+	CHECK(destroyCount == 1);
+	CHECK(lastDestroyed == 5);
+	CHECK(registry.Find("a") == nullptr);
+	CHECK(registry.GetStats().resourceCount == 0);
+	CHECK(registry.GetStats().referenceCount == 0);
+	CHECK(registry.GetStats().bytes == 0);
+}
+
+// 読み込み中の Acquire は Store を待ち、Store で全員の onReady が呼ばれる
+void TestAcquireWhileLoading() {
+	ResetDestroyCount();
+	ResourceRegistry<int> registry(CountDestroy);
+	int calls = 0;
+	CHECK(registry.Acquire("a", [&calls](const int&) { calls++; }));
+	CHECK(!registry.Acquire("a", [&calls](const int&) { calls++; }));
+	CHECK(registry.Find("a") == nullptr);
+	CHECK(calls == 0);
+	registry.Store("a", 7, 0.25, 10);
+	CHECK(calls == 2);
+	CHECK(registry.Find("a") != nullptr && *registry.Find("a") == 7);
+}
+
+// 読み込み中に全員が Release したら、Store で捨てられて読み込み時間も数えない
+void TestReleaseWhileLoading() {
+	ResetDestroyCount();
+	ResourceRegistry<int> registry(CountDestroy);
+	int calls = 0;
+	CHECK(registry.Acquire("a", [&calls](const int&) { calls++; }));
+	registry.Release("a");
+	CHECK(destroyCount == 0);
+	registry.Store("a", 3, 1.0, 10);
+	CHECK(calls == 0);
+	CHECK(destroyCount == 1);
+	CHECK(lastDestroyed == 3);
+	CHECK(registry.Find("a") == nullptr);
+	CHECK(registry.GetStats().resourceCount == 0);
+	CHECK(registry.GetStats().loadSeconds == 0.0);
+	CHECK(registry.GetStats().bytes == 0);
+
+	// 捨てた後の Acquire は、また読み込みから
+	CHECK(registry.Acquire("a"));
+}
+
+// 読み込み中に Release してまた Acquire したら、2 回目の読み込みはせず同じ Store を待つ
+void TestReacquireWhileLoading() {
+	ResetDestroyCount();
+	ResourceRegistry<int> registry(CountDestroy);
+	int released = 0;
+	int value = 0;
+	CHECK(registry.Acquire("a", [&released](const int&) { released++; }));
+	registry.Release("a");
+	CHECK(!registry.Acquire("a", [&value](const int& shared) { value = shared; }));
+	CHECK(registry.GetStats().loadCount == 1);
+	CHECK(registry.GetStats().resourceCount == 1);
+
+	registry.Store("a", 9, 0.5, 10);
+	// Release した側の onReady は呼ばない
+	CHECK(released == 0);
+	CHECK(value == 9);
+	CHECK(destroyCount == 0);
+	CHECK(registry.GetStats().loadSeconds == 0.5);
+	CHECK(registry.GetReferenceCount("a") == 1);
+
+	registry.Release("a");
+	CHECK(destroyCount == 1);
+	CHECK(registry.GetStats().resourceCount == 0);
+}
+
+} // namespace
+
+int main() {
+	TestShareAndRelease();
+	TestAcquireWhileLoading();
+	TestReleaseWhileLoading();
+	TestReacquireWhileLoading();
+	return TEST_RESULT();
+}
@@ -0,0 +1,170 @@
+#include "JobSystem.h"
+#include "SnapshotPipeline.h"
+#include "TestCheck.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+// SnapshotPipeline の Kick / Sync の順番、表と裏の入れ替え、jobs が null のとき、作っている途中で消したときを確かめる
+
+namespace {
+
+struct Frame {
+	// Kick の前に裏に書く入力
+	int input = 0;
+	// 作る側が書く (何回目に作ったか)
+	int produced = 0;
+	int output = 0;
+};
+
+// 作る側: 呼ばれた回数を数え、どのフレームに書いたかを覚える
+struct Producer {
+	std::atomic<int> calls{0};
+	Frame* lastFrame = nullptr;
+
+	void operator()(Frame& frame) {
+		lastFrame = &frame;
+		frame.produced = ++calls;
+		frame.output = frame.input * 10;
+	}
+};
+
+// jobs があってもなくても同じ順番になる
+void CheckKickSyncOrder(JobSystem* jobs) {
+	Producer producer;
+	SnapshotPipeline<Frame> pipeline(jobs, [&producer](Frame& frame) { producer(frame); });
+
+	// 何も頼んでいなければ Sync は何もしない
+	CHECK(!pipeline.IsBusy());
+	CHECK(!pipeline.Sync());
+	CHECK(producer.calls == 0);
+
+	Frame* first = &pipeline.GetFront();
+	for (int i = 1; i <= 4; ++i) {
+		Frame* front = &pipeline.GetFront();
+		Frame* back = &pipeline.GetBack();
+		CHECK(front != back);
+		back->input = i;
+
+		pipeline.Kick();
+		CHECK(pipeline.IsBusy());
+		// 作っている間も表は前のフレームのまま
+		CHECK(&pipeline.GetFront() == front);
+		CHECK(pipeline.GetFront().produced == i - 1);
+
+		CHECK(pipeline.Sync());
+		CHECK(!pipeline.IsBusy());
+		CHECK(producer.calls == i);
+		// 裏に書いたものが表になる
+		CHECK(producer.lastFrame == back);
+		CHECK(&pipeline.GetFront() == back);
+		CHECK(pipeline.GetFront().produced == i);
+		CHECK(pipeline.GetFront().output == i * 10);
+		// 2 つのフレームを交互に使う
+		CHECK((&pipeline.GetFront() == first) == (i % 2 == 0));
+	}
+
+	// Sync しないで続けて Kick すると、前の分を入れ替えてから次を作る
+	pipeline.Kick();
+	pipeline.Kick();
+	CHECK(producer.calls >= 5);
+	CHECK(pipeline.GetFront().produced == 5);
+	CHECK(pipeline.Sync());
+	CHECK(producer.calls == 6);
+	CHECK(pipeline.GetFront().produced == 6);
+	CHECK(!pipeline.Sync());
+	CHECK(pipeline.GetFront().produced == 6);
+}
+
+// jobs が null なら Kick の中で作り終わり、表と裏は Sync まで入れ替わらない
+void TestWithoutJobsRunsInline() {
+	Producer producer;
+	SnapshotPipeline<Frame> pipeline(nullptr, [&producer](Frame& frame) { producer(frame); });
+	pipeline.GetBack().input = 7;
+	pipeline.Kick();
+	CHECK(producer.calls == 1);
+	CHECK(pipeline.IsBusy());
+	CHECK(pipeline.GetFront().produced == 0);
+	CHECK(pipeline.Sync());
+	CHECK(pipeline.GetFront().output == 70);
+
+	CheckKickSyncOrder(nullptr);
+}
+
+// ワーカーで作っている間、表を読み続けられ、Sync は作り終わるまで待つ
+void TestWithJobsWaitsForProducer() {
+	JobSystem jobs(2);
+	CheckKickSyncOrder(&jobs);
+
+	std::atomic<bool> release{false};
+	std::atomic<int> calls{0};
+	SnapshotPipeline<Frame> pipeline(&jobs, [&](Frame& frame) {
+		while (!release.load()) {
+			std::this_thread::yield();
+		}
+		frame.produced = ++calls;
+	});
+	pipeline.Kick();
+	std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	CHECK(pipeline.IsBusy());
+	CHECK(pipeline.GetFront().produced == 0);
+	CHECK(calls == 0);
+
+	release = true;
+	CHECK(pipeline.Sync());
+	CHECK(calls == 1);
+	CHECK(pipeline.GetFront().produced == 1);
+}
+
+// ワーカーが無い JobSystem でも Kick の中で作り終わる
+void TestWithoutWorkersRunsInline() {
+	JobSystem jobs(0);
+	Producer producer;
+	SnapshotPipeline<Frame> pipeline(&jobs, [&producer](Frame& frame) { producer(frame); });
+	pipeline.Kick();
+	CHECK(producer.calls == 1);
+	CHECK(pipeline.Sync());
+	CHECK(pipeline.GetFront().produced == 1);
+
+	CheckKickSyncOrder(&jobs);
+}
+
+// 作っている途中で消しても、作り終わるのを待ってから消える
+void TestDestroyWhileBusy() {
+	JobSystem jobs(2);
+	std::atomic<bool> finished{false};
+	std::atomic<int> calls{0};
+	{
+		std::unique_ptr<SnapshotPipeline<Frame>> pipeline = std::make_unique<SnapshotPipeline<Frame>>(&jobs, [&](Frame& frame) {
+			calls++;
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			frame.produced = 1;
+			finished = true;
+		});
+		pipeline->Kick();
+		CHECK(pipeline->IsBusy());
+		pipeline.reset();
+		CHECK(finished);
+	}
+	CHECK(calls == 1);
+
+	// jobs が null で、Sync していないまま消しても大丈夫
+	{
+		Producer producer;
+		SnapshotPipeline<Frame> pipeline(nullptr, [&producer](Frame& frame) { producer(frame); });
+		pipeline.Kick();
+		CHECK(pipeline.IsBusy());
+		CHECK(producer.calls == 1);
+	}
+}
+
+} // namespace
+
+int main() {
+	TestWithoutJobsRunsInline();
+	TestWithJobsWaitsForProducer();
+	TestWithoutWorkersRunsInline();
+	TestDestroyWhileBusy();
+	return TEST_RESULT();
+}
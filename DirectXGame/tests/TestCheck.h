@@ -0,0 +1,46 @@
+#pragma once
+#include <cmath>
+#include <cstdio>
+
+// テスト用の小さな確認マクロ (失敗しても止めずに数え、main の最後に TEST_RESULT() で終了コードにする)
+// 使い方:
+//   CHECK(world.GetScore() == 0);
+//   CHECK_NEAR(v.x, 1.0f, 1e-5f);
+//   return TEST_RESULT();
+
+namespace test {
+
+inline int& FailureCount() {
+	static int count = 0;
+	return count;
+}
+
+inline void Fail(const char* file, int line, const char* expression) {
+	std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", file, line, expression);
+	FailureCount()++;
+}
+
+inline void FailNear(const char* file, int line, const char* expression, double actual, double expected, double tolerance) {
+	std::fprintf(stderr, "%s:%d: CHECK_NEAR failed: %s (%.9g, expected %.9g ± %.3g)\n", file, line, expression, actual, expected, tolerance);
+	FailureCount()++;
+}
+
+} // namespace test
+
+#define CHECK(expression)                                                                                                                                                                              \
+	do {                                                                                                                                                                                               \
+		if (!(expression)) {                                                                                                                                                                           \
+			test::Fail(__FILE__, __LINE__, #expression);                                                                                                                                               \
+		}                                                                                                                                                                                              \
+	} while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance)                                                                                                                                                        \
+	do {                                                                                                                                                                                               \
+		double checkActual = static_cast<double>(actual);                                                                                                                                              \
+		double checkExpected = static_cast<double>(expected);                                                                                                                                          \
+		if (!(std::abs(checkActual - checkExpected) <= static_cast<double>(tolerance))) {                                                                                                              \
+			test::FailNear(__FILE__, __LINE__, #actual, checkActual, checkExpected, static_cast<double>(tolerance));                                                                                   \
+		}                                                                                                                                                                                              \
+	} while (0)
+
+#define TEST_RESULT() (test::FailureCount() == 0 ? (std::printf("all checks passed\n"), 0) : (std::fprintf(stderr, "%d check(s) failed\n", test::FailureCount()), 1))
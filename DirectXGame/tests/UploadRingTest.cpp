@@ -0,0 +1,133 @@
+#include "TestCheck.h"
+#include "UploadRing.h"
+#include <cstdint>
+
+// UploadRing の切り出し位置・境界合わせ・フェンスでの解放・先頭への折り返しを確かめる
+// (ConstantUploadHeap は位置の計算をすべてこのリングに任せている)
+
+namespace {
+
+const uint64_t kA = UploadRing::kAlignment;
+
+// 切り出しは 256 バイト境界にそろい、容量も境界に切り下げる
+void TestOffsetsAreAligned() {
+	UploadRing ring;
+	ring.Initialize(4 * kA + 100);
+	CHECK(ring.GetCapacity() == 4 * kA);
+
+	uint64_t a = ring.Allocate(1);
+	uint64_t b = ring.Allocate(kA + 44);
+	uint64_t c = ring.Allocate(kA);
+	CHECK(a == 0);
+	CHECK(b == kA);
+	CHECK(c == 3 * kA);
+	CHECK(a % kA == 0 && b % kA == 0 && c % kA == 0);
+	CHECK(ring.GetUsed() == 4 * kA);
+
+	// 満杯・0 バイト・容量より大きいものは切り出せない
+	CHECK(ring.Allocate(1) == UploadRing::kInvalidOffset);
+	ring.Initialize(4 * kA);
+	CHECK(ring.Allocate(0) == UploadRing::kInvalidOffset);
+	CHECK(ring.Allocate(4 * kA + 1) == UploadRing::kInvalidOffset);
+	CHECK(ring.GetUsed() == 0);
+}
+
+// フレームはフェンスの値が届いた分だけ、古い順に空く
+void TestRetireByFence() {
+	UploadRing ring;
+	ring.Initialize(8 * kA);
+	ring.Allocate(kA);
+	ring.FinishFrame(1);
+	ring.Allocate(2 * kA);
+	ring.FinishFrame(2);
+	ring.Allocate(kA);
+	ring.FinishFrame(3);
+	CHECK(ring.GetUsed() == 4 * kA);
+
+	ring.Retire(0);
+	CHECK(ring.GetUsed() == 4 * kA);
+	ring.Retire(1);
+	CHECK(ring.GetUsed() == 3 * kA);
+	ring.Retire(1);
+	CHECK(ring.GetUsed() == 3 * kA);
+	ring.Retire(3);
+	CHECK(ring.GetUsed() == 0);
+	CHECK(ring.GetHighWaterMark() == 4 * kA);
+
+	// 何も切り出していないフレームは数に入らない
+	ring.FinishFrame(4);
+	CHECK(ring.GetUsed() == 0);
+}
+
+// 末尾に入りきらなければ飛ばして先頭に戻り、まだ空いていない範囲には重ならない
+void TestWrapAround() {
+	UploadRing ring;
+	ring.Initialize(4 * kA);
+
+	CHECK(ring.Allocate(2 * kA) == 0);
+	ring.FinishFrame(1);
+	CHECK(ring.Allocate(kA) == 2 * kA);
+	ring.FinishFrame(2);
+
+	// 1 フレーム目が終わるまでは入らない
+	CHECK(ring.Allocate(2 * kA) == UploadRing::kInvalidOffset);
+	ring.Retire(1);
+
+	// 末尾の 256 バイトでは足りないので飛ばし、空いた先頭を使う (飛ばした分も使用中に数える)
+	CHECK(ring.Allocate(2 * kA) == 0);
+	CHECK(ring.GetUsed() == 4 * kA);
+	CHECK(ring.Allocate(1) == UploadRing::kInvalidOffset);
+
+	// 2 フレーム目が空くと、その間だけが使える
+	ring.Retire(2);
+	CHECK(ring.GetUsed() == 3 * kA);
+	CHECK(ring.Allocate(kA) == 2 * kA);
+	CHECK(ring.Allocate(1) == UploadRing::kInvalidOffset);
+	ring.FinishFrame(3);
+
+	ring.Retire(3);
+	CHECK(ring.GetUsed() == 0);
+	// 空になったら先頭からやり直す
+	CHECK(ring.Allocate(3 * kA) == 0);
+}
+
+// 同時に渡っているフレームが上限を超えたら新しいフレームとまとめ、早く空くことはない
+void TestTooManyFramesInFlight() {
+	const uint64_t frames = UploadRing::kMaxFramesInFlight + 2;
+	UploadRing ring;
+	ring.Initialize(16 * kA);
+	for (uint64_t fence = 1; fence <= frames; ++fence) {
+		CHECK(ring.Allocate(kA) != UploadRing::kInvalidOffset);
+		ring.FinishFrame(fence);
+	}
+	CHECK(ring.GetUsed() == frames * kA);
+
+	// まとめられていないフレームはそれぞれのフェンスで空く
+	const uint64_t separate = UploadRing::kMaxFramesInFlight - 1;
+	ring.Retire(separate);
+	CHECK(ring.GetUsed() == (frames - separate) * kA);
+
+	// まとめたフレームは、まとめた中で一番新しいフェンスが届くまで空かない
+	for (uint64_t fence = separate + 1; fence < frames; ++fence) {
+		ring.Retire(fence);
+		CHECK(ring.GetUsed() == (frames - separate) * kA);
+	}
+	ring.Retire(frames);
+	CHECK(ring.GetUsed() == 0);
+
+	// まとめたあとも続けて使える
+	CHECK(ring.Allocate(kA) == 0);
+	ring.FinishFrame(frames + 1);
+	ring.Retire(frames + 1);
+	CHECK(ring.GetUsed() == 0);
+}
+
+} // namespace
+
+int main() {
+	TestOffsetsAreAligned();
+	TestRetireByFence();
+	TestWrapAround();
+	TestTooManyFramesInFlight();
+	return TEST_RESULT();
+}